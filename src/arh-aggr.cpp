@@ -0,0 +1,265 @@
+/* Copyright (C) 2019 ATgroup09
+*  Contact: atgroup09@gmail.com
+*
+*  This file is part of the HMI server component.
+*
+*  The code in this page is free software: you can
+*  redistribute it and/or modify it under the terms of the GNU
+*  General Public License (GNU GPL) as published by the Free Software
+*  Foundation, either version 3 of the License, or (at your option)
+*  any later version.  The code is distributed WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS
+*  FOR A PARTICULAR PURPOSE.  See the GNU GPL for more details.
+*
+*  As additional permission under GNU GPL version 3 section 7, you
+*  may distribute non-source (e.g., minimized or compacted) forms of
+*  that code without the copy of the GNU GPL normally required by
+*  section 4, provided you include this license notice and a URL
+*  through which recipients can access the Corresponding Source.
+*/
+
+#include "arh-aggr.h"
+
+
+/**
+@brief Names of functions
+*/
+const QString ArhAggr::NAME__MIN   = "min";
+const QString ArhAggr::NAME__MAX   = "max";
+const QString ArhAggr::NAME__AVG   = "avg";
+const QString ArhAggr::NAME__TWA   = "twa";
+const QString ArhAggr::NAME__FIRST = "first";
+const QString ArhAggr::NAME__LAST  = "last";
+const QString ArhAggr::NAME__COUNT = "count";
+
+
+/**
+@brief  Constructor.
+@param  None.
+@return None.
+*/
+ArhAggr::ArhAggr()
+{
+    mCount     = 0;
+    mMin       = 0.0;
+    mMax       = 0.0;
+    mSum       = 0.0;
+    mFirst     = 0.0;
+    mLast      = 0.0;
+    mSign      = 0;
+    mHeld      = false;
+    mLastStamp = 0;
+    mArea      = 0.0;
+    mWeight    = 0.0;
+}
+
+
+/**
+@brief  Add a valid sample.
+@param  StampIn - date and time of the sample (msec since epoch);
+@param  ValueIn - value;
+@param  SignIn - sign code.
+@return None.
+*/
+void ArhAggr::add(const qint64 StampIn, const double ValueIn, const qint32 SignIn)
+{
+    if(mHeld && StampIn > mLastStamp)
+    {
+        double Dt = static_cast<double>(StampIn-mLastStamp);
+        mArea  += mLast*Dt;
+        mWeight+= Dt;
+    }
+
+    if(mCount == 0)
+    {
+        mMin   = ValueIn;
+        mMax   = ValueIn;
+        mFirst = ValueIn;
+    }
+    else
+    {
+        if(ValueIn < mMin) mMin = ValueIn;
+        if(ValueIn > mMax) mMax = ValueIn;
+    }
+
+    mSum+= ValueIn;
+    mCount++;
+
+    mLast      = ValueIn;
+    mSign      = SignIn;
+    mHeld      = true;
+    mLastStamp = StampIn;
+}
+
+
+/**
+@brief  Add a failed sample.
+@param  StampIn - date and time of the sample (msec since epoch).
+@return None.
+@details The last value is weighted only up to StampIn.
+*/
+void ArhAggr::fail(const qint64 StampIn)
+{
+    if(mHeld && StampIn > mLastStamp)
+    {
+        double Dt = static_cast<double>(StampIn-mLastStamp);
+        mArea  += mLast*Dt;
+        mWeight+= Dt;
+    }
+
+    mHeld      = false;
+    mLastStamp = StampIn;
+}
+
+
+/**
+@brief  Start a new interval.
+@param  StampIn - date and time of the tick (msec since epoch).
+@return None.
+@details The last value is held into the new interval.
+*/
+void ArhAggr::restart(const qint64 StampIn)
+{
+    mCount     = 0;
+    mSum       = 0.0;
+    mArea      = 0.0;
+    mWeight    = 0.0;
+    mLastStamp = StampIn;
+}
+
+
+/**
+@brief  Check the interval has no samples.
+@param  None.
+@return True if empty, otherwise - False.
+*/
+bool ArhAggr::isEmpty() const
+{
+    return ((mCount == 0) ? true : false);
+}
+
+
+/**
+@brief  Get time-weighted average.
+@param  StampIn - date and time of the end of interval (msec since epoch).
+@return Average.
+*/
+double ArhAggr::getTwa(const qint64 StampIn) const
+{
+    double Area   = mArea;
+    double Weight = mWeight;
+
+    if(mHeld && StampIn > mLastStamp)
+    {
+        double Dt = static_cast<double>(StampIn-mLastStamp);
+        Area  += mLast*Dt;
+        Weight+= Dt;
+    }
+
+    return ((Weight > 0.0) ? (Area/Weight) : mLast);
+}
+
+
+/**
+@brief  Pack the aggregates into list of archive rows.
+@param  StampIn - date and time of the tick;
+@param  ProfileIn - name of profile;
+@param  DevIdIn - device ID;
+@param  RegIdIn - register ID;
+@param  FuncsIn - functions (bit mask);
+@param  ListRowsIn - link to list of rows.
+@return The number of packed rows.
+@details Profile of a row is "{ProfileIn}.{function}".
+*/
+int ArhAggr::toArhRows(const QDateTime &StampIn, const QString &ProfileIn, const quint16 DevIdIn, const quint16 RegIdIn, const quint8 FuncsIn, QList<ArhRow> &ListRowsIn) const
+{
+    if(this->isEmpty()) return (0);
+
+    int Size = ListRowsIn.size();
+    QString Profile = ProfileIn + QString(".");
+
+    if(FuncsIn & FUNC__MIN)   this->appendRow(StampIn, Profile + NAME__MIN, DevIdIn, RegIdIn, mMin, ListRowsIn);
+    if(FuncsIn & FUNC__MAX)   this->appendRow(StampIn, Profile + NAME__MAX, DevIdIn, RegIdIn, mMax, ListRowsIn);
+    if(FuncsIn & FUNC__AVG)   this->appendRow(StampIn, Profile + NAME__AVG, DevIdIn, RegIdIn, mSum/static_cast<double>(mCount), ListRowsIn);
+    if(FuncsIn & FUNC__TWA)   this->appendRow(StampIn, Profile + NAME__TWA, DevIdIn, RegIdIn, this->getTwa(StampIn.toMSecsSinceEpoch()), ListRowsIn);
+    if(FuncsIn & FUNC__FIRST) this->appendRow(StampIn, Profile + NAME__FIRST, DevIdIn, RegIdIn, mFirst, ListRowsIn);
+    if(FuncsIn & FUNC__LAST)  this->appendRow(StampIn, Profile + NAME__LAST, DevIdIn, RegIdIn, mLast, ListRowsIn);
+    if(FuncsIn & FUNC__COUNT) this->appendRow(StampIn, Profile + NAME__COUNT, DevIdIn, RegIdIn, static_cast<double>(mCount), ListRowsIn);
+
+    return (ListRowsIn.size()-Size);
+}
+
+
+/**
+@brief (static) Unpack functions from string.
+@param  StringIn - names of functions ("min,max,avg").
+@return Functions (bit mask), unknown names are skipped.
+*/
+quint8 ArhAggr::toFuncs(const QString &StringIn)
+{
+    quint8 Res = 0;
+    QStringList ListNames = StringIn.split(QChar(','), QString::SkipEmptyParts);
+    QString Name;
+
+    for(int i=0; i<ListNames.size(); i++)
+    {
+        Name = ListNames.at(i).trimmed().toLower();
+
+        if(Name == NAME__MIN)        Res|= FUNC__MIN;
+        else if(Name == NAME__MAX)   Res|= FUNC__MAX;
+        else if(Name == NAME__AVG)   Res|= FUNC__AVG;
+        else if(Name == NAME__TWA)   Res|= FUNC__TWA;
+        else if(Name == NAME__FIRST) Res|= FUNC__FIRST;
+        else if(Name == NAME__LAST)  Res|= FUNC__LAST;
+        else if(Name == NAME__COUNT) Res|= FUNC__COUNT;
+    }
+
+    return (Res);
+}
+
+
+/**
+@brief (static) Pack functions into string.
+@param  FuncsIn - functions (bit mask).
+@return Names of functions ("min,max,avg").
+*/
+QString ArhAggr::toString(const quint8 FuncsIn)
+{
+    QStringList ListNames;
+
+    if(FuncsIn & FUNC__MIN)   ListNames.append(NAME__MIN);
+    if(FuncsIn & FUNC__MAX)   ListNames.append(NAME__MAX);
+    if(FuncsIn & FUNC__AVG)   ListNames.append(NAME__AVG);
+    if(FuncsIn & FUNC__TWA)   ListNames.append(NAME__TWA);
+    if(FuncsIn & FUNC__FIRST) ListNames.append(NAME__FIRST);
+    if(FuncsIn & FUNC__LAST)  ListNames.append(NAME__LAST);
+    if(FuncsIn & FUNC__COUNT) ListNames.append(NAME__COUNT);
+
+    return (ListNames.join(QChar(',')));
+}
+
+
+/**
+@brief  Append a row.
+@param  StampIn - date and time of the tick;
+@param  ProfileIn - name of profile;
+@param  DevIdIn - device ID;
+@param  RegIdIn - register ID;
+@param  ValueIn - value;
+@param  ListRowsIn - link to list of rows.
+@return None.
+*/
+void ArhAggr::appendRow(const QDateTime &StampIn, const QString &ProfileIn, const quint16 DevIdIn, const quint16 RegIdIn, const double ValueIn, QList<ArhRow> &ListRowsIn) const
+{
+    ArhRow Row;
+    Row.mStamp   = StampIn;
+    Row.mProfile = ProfileIn;
+    Row.mDevID   = DevIdIn;
+    Row.mRegID   = RegIdIn;
+    Row.mValue   = ValueIn;
+    Row.mEx      = 0;
+    Row.mErr     = 0;
+    Row.mSign    = mSign;
+
+    ListRowsIn.append(Row);
+}
@@ -0,0 +1,207 @@
+/* Copyright (C) 2019 ATgroup09
+*  Contact: atgroup09@gmail.com
+*
+*  This file is part of the HMI server component.
+*
+*  The code in this page is free software: you can
+*  redistribute it and/or modify it under the terms of the GNU
+*  General Public License (GNU GPL) as published by the Free Software
+*  Foundation, either version 3 of the License, or (at your option)
+*  any later version.  The code is distributed WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS
+*  FOR A PARTICULAR PURPOSE.  See the GNU GPL for more details.
+*
+*  As additional permission under GNU GPL version 3 section 7, you
+*  may distribute non-source (e.g., minimized or compacted) forms of
+*  that code without the copy of the GNU GPL normally required by
+*  section 4, provided you include this license notice and a URL
+*  through which recipients can access the Corresponding Source.
+*/
+
+#ifndef ARH_AGGR_H
+#define ARH_AGGR_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QDateTime>
+
+#include "arh-row.h"
+
+
+/**
+@brief Running aggregates of one register between ticks of archive.
+@details Is updated by each survey cycle in O(1): count, min, max, mean, first, last
+         and time-weighted average (the value is held until the next sample).
+         Only valid samples are aggregated, a failed sample ends the holding of the last value.
+*/
+class ArhAggr
+{
+public:
+
+    /**
+    @brief  Constructor.
+    @param  None.
+    @return None.
+    */
+    ArhAggr();
+
+
+    /**
+    Public constants
+    */
+
+    /**
+    @brief Functions (bit mask)
+    */
+    static const quint8 FUNC__MIN   = 0x01;
+    static const quint8 FUNC__MAX   = 0x02;
+    static const quint8 FUNC__AVG   = 0x04;
+    static const quint8 FUNC__TWA   = 0x08;
+    static const quint8 FUNC__FIRST = 0x10;
+    static const quint8 FUNC__LAST  = 0x20;
+    static const quint8 FUNC__COUNT = 0x40;
+
+    /**
+    @brief Names of functions (suffix of profile: "5min.max")
+    */
+    static const QString NAME__MIN;
+    static const QString NAME__MAX;
+    static const QString NAME__AVG;
+    static const QString NAME__TWA;
+    static const QString NAME__FIRST;
+    static const QString NAME__LAST;
+    static const QString NAME__COUNT;
+
+
+    /**
+    Public methods
+    */
+
+    /**
+    @brief  Add a valid sample.
+    @param  StampIn - date and time of the sample (msec since epoch);
+    @param  ValueIn - value;
+    @param  SignIn - sign code.
+    @return None.
+    */
+    void add(const qint64 StampIn, const double ValueIn, const qint32 SignIn);
+
+    /**
+    @brief  Add a failed sample.
+    @param  StampIn - date and time of the sample (msec since epoch).
+    @return None.
+    @details The last value is weighted only up to StampIn.
+    */
+    void fail(const qint64 StampIn);
+
+    /**
+    @brief  Start a new interval.
+    @param  StampIn - date and time of the tick (msec since epoch).
+    @return None.
+    @details The last value is held into the new interval.
+    */
+    void restart(const qint64 StampIn);
+
+    /**
+    @brief  Check the interval has no samples.
+    @param  None.
+    @return True if empty, otherwise - False.
+    */
+    bool isEmpty() const;
+
+    /**
+    @brief  Get time-weighted average.
+    @param  StampIn - date and time of the end of interval (msec since epoch).
+    @return Average.
+    */
+    double getTwa(const qint64 StampIn) const;
+
+    /**
+    @brief  Pack the aggregates into list of archive rows.
+    @param  StampIn - date and time of the tick;
+    @param  ProfileIn - name of profile;
+    @param  DevIdIn - device ID;
+    @param  RegIdIn - register ID;
+    @param  FuncsIn - functions (bit mask);
+    @param  ListRowsIn - link to list of rows.
+    @return The number of packed rows.
+    @details Profile of a row is "{ProfileIn}.{function}".
+    */
+    int toArhRows(const QDateTime &StampIn, const QString &ProfileIn, const quint16 DevIdIn, const quint16 RegIdIn, const quint8 FuncsIn, QList<ArhRow> &ListRowsIn) const;
+
+    /**
+    @brief (static) Unpack functions from string.
+    @param  StringIn - names of functions ("min,max,avg").
+    @return Functions (bit mask), unknown names are skipped.
+    */
+    static quint8 toFuncs(const QString &StringIn);
+
+    /**
+    @brief (static) Pack functions into string.
+    @param  FuncsIn - functions (bit mask).
+    @return Names of functions ("min,max,avg").
+    */
+    static QString toString(const quint8 FuncsIn);
+
+
+private:
+
+    /**
+    Private options
+    */
+
+    /**
+    @brief The number of samples of the interval.
+    */
+    qint64 mCount;
+
+    /**
+    @brief Minimum, maximum, sum, first and last values of the interval.
+    */
+    double mMin;
+    double mMax;
+    double mSum;
+    double mFirst;
+    double mLast;
+
+    /**
+    @brief Sign code of the last sample.
+    */
+    qint32 mSign;
+
+    /**
+    @brief The last value is held (is weighted up to the next sample).
+    */
+    bool mHeld;
+
+    /**
+    @brief Date and time of the last sample or of the start of interval (msec since epoch).
+    */
+    qint64 mLastStamp;
+
+    /**
+    @brief Integral of the held value over time (value*msec) and its weight (msec).
+    */
+    double mArea;
+    double mWeight;
+
+
+    /**
+    Private methods
+    */
+
+    /**
+    @brief  Append a row.
+    @param  StampIn - date and time of the tick;
+    @param  ProfileIn - name of profile;
+    @param  DevIdIn - device ID;
+    @param  RegIdIn - register ID;
+    @param  ValueIn - value;
+    @param  ListRowsIn - link to list of rows.
+    @return None.
+    */
+    void appendRow(const QDateTime &StampIn, const QString &ProfileIn, const quint16 DevIdIn, const quint16 RegIdIn, const double ValueIn, QList<ArhRow> &ListRowsIn) const;
+};
+
+#endif // ARH_AGGR_H
@@ -0,0 +1,129 @@
+/* Copyright (C) 2019 ATgroup09
+*  Contact: atgroup09@gmail.com
+*
+*  This file is part of the HMI server component.
+*
+*  The code in this page is free software: you can
+*  redistribute it and/or modify it under the terms of the GNU
+*  General Public License (GNU GPL) as published by the Free Software
+*  Foundation, either version 3 of the License, or (at your option)
+*  any later version.  The code is distributed WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS
+*  FOR A PARTICULAR PURPOSE.  See the GNU GPL for more details.
+*
+*  As additional permission under GNU GPL version 3 section 7, you
+*  may distribute non-source (e.g., minimized or compacted) forms of
+*  that code without the copy of the GNU GPL normally required by
+*  section 4, provided you include this license notice and a URL
+*  through which recipients can access the Corresponding Source.
+*/
+
+#include "arh-checkpoint.h"
+
+
+/**
+@brief  Constructor.
+@param  None.
+@return None.
+*/
+ArhCheckpoint::ArhCheckpoint(QObject *parent) : QObject(parent)
+{
+    mFile     = QString("");
+    mInterval = 0;
+    mFileLog  = QString("");
+    mUseLog   = false;
+    mDbCli    = nullptr;
+    mTimer    = nullptr;
+}
+
+
+/**
+@brief  Destructor.
+@param  None.
+@return None.
+*/
+ArhCheckpoint::~ArhCheckpoint()
+{
+    if(mTimer) delete mTimer;
+    if(mDbCli) delete mDbCli;
+}
+
+
+/**
+@brief  Start.
+@param  None.
+@return None.
+@details Open the connection and start timer.
+*/
+void ArhCheckpoint::start()
+{
+    Log::log(QString("ArhCheckpoint::start(%1, %2 sec)").arg(mFile, QString::number(mInterval)), mFileLog, mUseLog);
+
+    //the objects are created by the thread of checkpoint
+    if(mDbCli == nullptr) mDbCli = new HelperSQLite(this);
+    if(mTimer == nullptr)
+    {
+        mTimer = new QTimer(this);
+        connect(mTimer, &QTimer::timeout, this, &ArhCheckpoint::checkpoint);
+    }
+
+    mDbCli->mFile           = mFile;
+    mDbCli->mAutoCheckpoint = false;
+
+    if(mInterval > 0)
+    {
+        mTimer->setInterval(mInterval*1000);
+        mTimer->start();
+    }
+}
+
+
+/**
+@brief  Stop.
+@param  None.
+@return None.
+@details Stop timer, close the connection and send signal sigStopped.
+*/
+void ArhCheckpoint::stop()
+{
+    Log::log(QString("ArhCheckpoint::stop()"), mFileLog, mUseLog);
+
+    if(mTimer && mTimer->isActive()) mTimer->stop();
+    if(mDbCli) mDbCli->disconnect();
+
+    emit sigStopped();
+}
+
+
+/**
+@brief  Checkpoint WAL.
+@param  None.
+@return None.
+*/
+void ArhCheckpoint::checkpoint()
+{
+    if(!mDbCli->isConnected() && !mDbCli->connect())
+    {
+        LOG_ERROR(QString("Error open SQLite DB for checkpoint (%1)! %2").arg(QString::number(mDbCli->getErrorNo()), mDbCli->getError()), mFileLog, mUseLog);
+        return;
+    }
+
+    int Frames = 0, Ckpt = 0;
+
+    if(!mDbCli->checkpoint(false, Frames, Ckpt))
+    {
+        LOG_WARN(QString("Error checkpoint of SQLite DB (%1)! %2").arg(QString::number(mDbCli->getErrorNo()), mDbCli->getError()), mFileLog, mUseLog);
+        return;
+    }
+
+    LOG_TRACE(QString("ArhCheckpoint::checkpoint(%1 of %2 frames)").arg(QString::number(Ckpt), QString::number(Frames)), mFileLog, mUseLog);
+
+    //the file of WAL is reused from the beginning, truncation only limits the disk space
+    if(Frames > WAL_PAGES__MAX && Ckpt == Frames)
+    {
+        if(mDbCli->checkpoint(true, Frames, Ckpt))
+        {
+            LOG_DEBUG(QString("WAL of SQLite DB is truncated."), mFileLog, mUseLog);
+        }
+    }
+}
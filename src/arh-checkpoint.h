@@ -0,0 +1,150 @@
+/* Copyright (C) 2019 ATgroup09
+*  Contact: atgroup09@gmail.com
+*
+*  This file is part of the HMI server component.
+*
+*  The code in this page is free software: you can
+*  redistribute it and/or modify it under the terms of the GNU
+*  General Public License (GNU GPL) as published by the Free Software
+*  Foundation, either version 3 of the License, or (at your option)
+*  any later version.  The code is distributed WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS
+*  FOR A PARTICULAR PURPOSE.  See the GNU GPL for more details.
+*
+*  As additional permission under GNU GPL version 3 section 7, you
+*  may distribute non-source (e.g., minimized or compacted) forms of
+*  that code without the copy of the GNU GPL normally required by
+*  section 4, provided you include this license notice and a URL
+*  through which recipients can access the Corresponding Source.
+*/
+
+#ifndef ARH_CHECKPOINT_H
+#define ARH_CHECKPOINT_H
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+#include "log.h"
+#include "sqlite-cli.h"
+
+
+/**
+@brief Background checkpoint of SQLite archive.
+@details Runs in its own thread with its own connection, so the archive (writer) never copies WAL into the database:
+         a passive checkpoint is run every interval (it does not wait for the writer),
+         WAL is truncated when it has been checkpointed completely and it is larger than WAL_PAGES__MAX.
+*/
+class ArhCheckpoint : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /**
+    @brief  Constructor.
+    @param  None.
+    @return None.
+    */
+    explicit ArhCheckpoint(QObject *parent = nullptr);
+
+    /**
+    @brief  Destructor.
+    @param  None.
+    @return None.
+    */
+    virtual ~ArhCheckpoint();
+
+
+    /**
+    Public constants
+    */
+
+    /**
+    @brief Size of WAL (pages) to truncate it
+    */
+    static const int WAL_PAGES__MAX = 4096;
+
+
+    /**
+    Public options
+    */
+
+    /**
+    @brief Path to the database file.
+    */
+    QString mFile;
+
+    /**
+    @brief Interval of checkpoint (sec).
+    */
+    int mInterval;
+
+    /**
+    @brief Log.
+    */
+    QString mFileLog;
+    bool mUseLog;
+
+
+public slots:
+
+    /**
+    @brief  Start.
+    @param  None.
+    @return None.
+    @details Open the connection and start timer.
+    */
+    void start();
+
+    /**
+    @brief  Stop.
+    @param  None.
+    @return None.
+    @details Stop timer, close the connection and send signal sigStopped.
+    */
+    void stop();
+
+
+private slots:
+
+    /**
+    @brief  Checkpoint WAL.
+    @param  None.
+    @return None.
+    */
+    void checkpoint();
+
+
+private:
+
+    /**
+    Private options
+    */
+
+    /**
+    @brief Connection of checkpoint.
+    */
+    HelperSQLite *mDbCli;
+
+    /**
+    @brief Timer of checkpoint.
+    */
+    QTimer *mTimer;
+
+
+signals:
+
+    /**
+    Signals
+    */
+
+    /**
+    @brief  Checkpoint is stopped.
+    @param  None.
+    @return None.
+    */
+    void sigStopped();
+};
+
+#endif // ARH_CHECKPOINT_H
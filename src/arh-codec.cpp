@@ -0,0 +1,530 @@
+/* Copyright (C) 2019 ATgroup09
+*  Contact: atgroup09@gmail.com
+*
+*  This file is part of the HMI server component.
+*
+*  The code in this page is free software: you can
+*  redistribute it and/or modify it under the terms of the GNU
+*  General Public License (GNU GPL) as published by the Free Software
+*  Foundation, either version 3 of the License, or (at your option)
+*  any later version.  The code is distributed WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS
+*  FOR A PARTICULAR PURPOSE.  See the GNU GPL for more details.
+*
+*  As additional permission under GNU GPL version 3 section 7, you
+*  may distribute non-source (e.g., minimized or compacted) forms of
+*  that code without the copy of the GNU GPL normally required by
+*  section 4, provided you include this license notice and a URL
+*  through which recipients can access the Corresponding Source.
+*/
+
+#include "arh-codec.h"
+
+
+/**
+@brief  Constructor.
+@param  None.
+@return None.
+*/
+ArhBitWriter::ArhBitWriter()
+{
+    mFree = 0;
+}
+
+
+/**
+@brief  Write one bit.
+@param  BitIn - bit.
+@return None.
+*/
+void ArhBitWriter::writeBit(const bool BitIn)
+{
+    if(mFree == 0)
+    {
+        mData.append(static_cast<char>(0));
+        mFree = 8;
+    }
+
+    mFree--;
+    if(BitIn) mData.data()[mData.size()-1]|= static_cast<char>(1 << mFree);
+}
+
+
+/**
+@brief  Write bits.
+@param  ValueIn - value (the lowest CountIn bits are written);
+@param  CountIn - the number of bits (0...64).
+@return None.
+*/
+void ArhBitWriter::writeBits(const quint64 ValueIn, int CountIn)
+{
+    int N;
+    quint8 Part;
+
+    while(CountIn > 0)
+    {
+        if(mFree == 0)
+        {
+            mData.append(static_cast<char>(0));
+            mFree = 8;
+        }
+
+        N    = ((CountIn < mFree) ? CountIn : mFree);
+        Part = static_cast<quint8>((ValueIn >> (CountIn-N)) & ((1u << N)-1));
+
+        mData.data()[mData.size()-1]|= static_cast<char>(Part << (mFree-N));
+
+        mFree  -= N;
+        CountIn-= N;
+    }
+}
+
+
+/**
+@brief  Clear the stream.
+@param  None.
+@return None.
+*/
+void ArhBitWriter::clear()
+{
+    mData.clear();
+    mFree = 0;
+}
+
+
+/**
+@brief  Get data of the stream.
+@param  None.
+@return Link to data (the last byte is padded by zeros).
+*/
+const QByteArray &ArhBitWriter::data() const
+{
+    return (mData);
+}
+
+
+/**
+@brief  Constructor.
+@param  DataIn - pointer to data;
+@param  SizeIn - size of data (bytes).
+@return None.
+*/
+ArhBitReader::ArhBitReader(const uchar *DataIn, const qint64 SizeIn)
+{
+    mData  = DataIn;
+    mSize  = ((DataIn != nullptr && SizeIn > 0) ? SizeIn*8 : 0);
+    mPos   = 0;
+    mError = false;
+}
+
+
+/**
+@brief  Read one bit.
+@param  None.
+@return Bit (false at the end of stream).
+*/
+bool ArhBitReader::readBit()
+{
+    if(mPos >= mSize)
+    {
+        mError = true;
+        return (false);
+    }
+
+    bool Res = (((mData[mPos >> 3] >> (7 - (mPos & 7))) & 1) ? true : false);
+    mPos++;
+
+    return (Res);
+}
+
+
+/**
+@brief  Read bits.
+@param  CountIn - the number of bits (0...64).
+@return Value.
+*/
+quint64 ArhBitReader::readBits(int CountIn)
+{
+    quint64 Res = 0;
+    int Free, N;
+
+    if(mPos + CountIn > mSize)
+    {
+        mError = true;
+        mPos   = mSize;
+        return (0);
+    }
+
+    while(CountIn > 0)
+    {
+        Free = 8 - static_cast<int>(mPos & 7);
+        N    = ((CountIn < Free) ? CountIn : Free);
+
+        Res = (Res << N) | ((mData[mPos >> 3] >> (Free-N)) & ((1u << N)-1));
+
+        mPos   += N;
+        CountIn-= N;
+    }
+
+    return (Res);
+}
+
+
+/**
+@brief  Check the end of stream has been passed.
+@param  None.
+@return True if error, otherwise - False.
+*/
+bool ArhBitReader::isError() const
+{
+    return (mError);
+}
+
+
+/**
+@brief  Constructor.
+@param  None.
+@return None.
+*/
+ArhEncoder::ArhEncoder()
+{
+    this->clear();
+}
+
+
+/**
+@brief  Append a sample.
+@param  StampIn - date and time (msec since epoch), a stamp before the last one is moved to the last;
+@param  ValueIn - value;
+@param  ExIn - exception code;
+@param  ErrIn - error code;
+@param  SignIn - sign code.
+@return None.
+*/
+void ArhEncoder::append(qint64 StampIn, const double ValueIn, const qint32 ExIn, const qint32 ErrIn, const qint32 SignIn)
+{
+    quint64 Value;
+    std::memcpy(&Value, &ValueIn, sizeof(Value));
+
+    if(mCount == 0)
+    {
+        mFirst = StampIn;
+        mLast  = StampIn;
+        mDelta = 0;
+        mValue = Value;
+
+        mValues.writeBits(Value, 64);
+
+        mStatus.writeBits(static_cast<quint32>(ExIn), 32);
+        mStatus.writeBits(static_cast<quint32>(ErrIn), 32);
+        mStatus.writeBits(static_cast<quint32>(SignIn), 32);
+        mEx   = ExIn;
+        mErr  = ErrIn;
+        mSign = SignIn;
+
+        mCount = 1;
+        return;
+    }
+
+    //stamps: delta-of-delta
+    if(StampIn < mLast) StampIn = mLast;
+
+    qint64 Delta = StampIn - mLast;
+    qint64 DoD   = Delta - mDelta;
+
+    if(DoD == 0)
+    {
+        mStamps.writeBit(false);
+    }
+    else if(DoD >= -63 && DoD <= 64)
+    {
+        mStamps.writeBits(0x2, 2);
+        mStamps.writeBits(static_cast<quint64>(DoD + 63), 7);
+    }
+    else if(DoD >= -255 && DoD <= 256)
+    {
+        mStamps.writeBits(0x6, 3);
+        mStamps.writeBits(static_cast<quint64>(DoD + 255), 9);
+    }
+    else if(DoD >= -2047 && DoD <= 2048)
+    {
+        mStamps.writeBits(0xE, 4);
+        mStamps.writeBits(static_cast<quint64>(DoD + 2047), 12);
+    }
+    else
+    {
+        mStamps.writeBits(0xF, 4);
+        mStamps.writeBits(static_cast<quint32>(static_cast<qint32>(DoD)), 32);
+    }
+
+    mLast  = StampIn;
+    mDelta = Delta;
+
+    //values: XOR with previous value
+    quint64 Xor = Value ^ mValue;
+
+    if(Xor == 0)
+    {
+        mValues.writeBit(false);
+    }
+    else
+    {
+        int Leading  = static_cast<int>(qCountLeadingZeroBits(Xor));
+        int Trailing = static_cast<int>(qCountTrailingZeroBits(Xor));
+        if(Leading > 31) Leading = 31;
+
+        mValues.writeBit(true);
+
+        if(mLeading >= 0 && Leading >= mLeading && Trailing >= mTrailing)
+        {
+            mValues.writeBit(false);
+            mValues.writeBits(Xor >> mTrailing, 64 - mLeading - mTrailing);
+        }
+        else
+        {
+            int Meaningful = 64 - Leading - Trailing;
+
+            mValues.writeBit(true);
+            mValues.writeBits(static_cast<quint64>(Leading), 5);
+            mValues.writeBits(static_cast<quint64>(Meaningful - 1), 6);
+            mValues.writeBits(Xor >> Trailing, Meaningful);
+
+            mLeading  = Leading;
+            mTrailing = Trailing;
+        }
+    }
+
+    mValue = Value;
+
+    //status
+    if(ExIn == mEx && ErrIn == mErr && SignIn == mSign)
+    {
+        mStatus.writeBit(false);
+    }
+    else
+    {
+        mStatus.writeBit(true);
+        mStatus.writeBits(static_cast<quint32>(ExIn), 32);
+        mStatus.writeBits(static_cast<quint32>(ErrIn), 32);
+        mStatus.writeBits(static_cast<quint32>(SignIn), 32);
+        mEx   = ExIn;
+        mErr  = ErrIn;
+        mSign = SignIn;
+    }
+
+    mCount++;
+}
+
+
+/**
+@brief  Clear the block.
+@param  None.
+@return None.
+*/
+void ArhEncoder::clear()
+{
+    mStamps.clear();
+    mValues.clear();
+    mStatus.clear();
+
+    mCount    = 0;
+    mFirst    = 0;
+    mLast     = 0;
+    mDelta    = 0;
+    mValue    = 0;
+    mLeading  = -1;
+    mTrailing = 0;
+    mEx       = 0;
+    mErr      = 0;
+    mSign     = 0;
+}
+
+
+/**
+@brief  Get the number of samples.
+@param  None.
+@return The number of samples.
+*/
+int ArhEncoder::size() const
+{
+    return (mCount);
+}
+
+
+/**
+@brief  Get the first stamp (msec since epoch).
+@param  None.
+@return Stamp.
+*/
+qint64 ArhEncoder::getFirst() const
+{
+    return (mFirst);
+}
+
+
+/**
+@brief  Get the last stamp (msec since epoch).
+@param  None.
+@return Stamp.
+*/
+qint64 ArhEncoder::getLast() const
+{
+    return (mLast);
+}
+
+
+/**
+@brief  Get the column of stamps.
+@param  None.
+@return Link to data of column.
+*/
+const QByteArray &ArhEncoder::getStamps() const
+{
+    return (mStamps.data());
+}
+
+
+/**
+@brief  Get the column of values.
+@param  None.
+@return Link to data of column.
+*/
+const QByteArray &ArhEncoder::getValues() const
+{
+    return (mValues.data());
+}
+
+
+/**
+@brief  Get the column of status.
+@param  None.
+@return Link to data of column.
+*/
+const QByteArray &ArhEncoder::getStatus() const
+{
+    return (mStatus.data());
+}
+
+
+/**
+@brief  Get size of encoded data (bytes).
+@param  None.
+@return Size.
+*/
+int ArhEncoder::getBytes() const
+{
+    return (mStamps.data().size() + mValues.data().size() + mStatus.data().size());
+}
+
+
+/**
+@brief  Constructor.
+@param  CountIn - the number of samples;
+@param  FirstIn - the first stamp (msec since epoch);
+@param  StampsIn, StampsSizeIn - column of stamps;
+@param  ValuesIn, ValuesSizeIn - column of values;
+@param  StatusIn, StatusSizeIn - column of status.
+@return None.
+*/
+ArhDecoder::ArhDecoder(const int CountIn, const qint64 FirstIn, const uchar *StampsIn, const qint64 StampsSizeIn, const uchar *ValuesIn, const qint64 ValuesSizeIn, const uchar *StatusIn, const qint64 StatusSizeIn) :
+    mStamps(StampsIn, StampsSizeIn),
+    mValues(ValuesIn, ValuesSizeIn),
+    mStatus(StatusIn, StatusSizeIn)
+{
+    mCount    = CountIn;
+    mPos      = 0;
+    mLast     = FirstIn;
+    mDelta    = 0;
+    mValue    = 0;
+    mLeading  = 0;
+    mTrailing = 0;
+    mEx       = 0;
+    mErr      = 0;
+    mSign     = 0;
+}
+
+
+/**
+@brief  Read the next sample.
+@param  StampIn - link to stamp (msec since epoch);
+@param  ValueIn - link to value;
+@param  ExIn - link to exception code;
+@param  ErrIn - link to error code;
+@param  SignIn - link to sign code.
+@return True if the sample is read, otherwise (the end of block or error) - False.
+*/
+bool ArhDecoder::next(qint64 &StampIn, double &ValueIn, qint32 &ExIn, qint32 &ErrIn, qint32 &SignIn)
+{
+    if(mPos >= mCount) return (false);
+
+    if(mPos == 0)
+    {
+        mValue = mValues.readBits(64);
+
+        mEx   = static_cast<qint32>(static_cast<quint32>(mStatus.readBits(32)));
+        mErr  = static_cast<qint32>(static_cast<quint32>(mStatus.readBits(32)));
+        mSign = static_cast<qint32>(static_cast<quint32>(mStatus.readBits(32)));
+    }
+    else
+    {
+        //stamps
+        qint64 DoD = 0;
+
+        if(mStamps.readBit())
+        {
+            if(!mStamps.readBit())
+            {
+                DoD = static_cast<qint64>(mStamps.readBits(7)) - 63;
+            }
+            else if(!mStamps.readBit())
+            {
+                DoD = static_cast<qint64>(mStamps.readBits(9)) - 255;
+            }
+            else if(!mStamps.readBit())
+            {
+                DoD = static_cast<qint64>(mStamps.readBits(12)) - 2047;
+            }
+            else
+            {
+                DoD = static_cast<qint64>(static_cast<qint32>(static_cast<quint32>(mStamps.readBits(32))));
+            }
+        }
+
+        mDelta+= DoD;
+        mLast += mDelta;
+
+        //values
+        if(mValues.readBit())
+        {
+            if(mValues.readBit())
+            {
+                mLeading  = static_cast<int>(mValues.readBits(5));
+                int Meaningful = static_cast<int>(mValues.readBits(6)) + 1;
+                mTrailing = 64 - mLeading - Meaningful;
+                if(mTrailing < 0) return (false);
+            }
+
+            mValue^= (mValues.readBits(64 - mLeading - mTrailing) << mTrailing);
+        }
+
+        //status
+        if(mStatus.readBit())
+        {
+            mEx   = static_cast<qint32>(static_cast<quint32>(mStatus.readBits(32)));
+            mErr  = static_cast<qint32>(static_cast<quint32>(mStatus.readBits(32)));
+            mSign = static_cast<qint32>(static_cast<quint32>(mStatus.readBits(32)));
+        }
+    }
+
+    if(mStamps.isError() || mValues.isError() || mStatus.isError()) return (false);
+
+    StampIn = mLast;
+    std::memcpy(&ValueIn, &mValue, sizeof(ValueIn));
+    ExIn    = mEx;
+    ErrIn   = mErr;
+    SignIn  = mSign;
+
+    mPos++;
+
+    return (true);
+}
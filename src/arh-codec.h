@@ -0,0 +1,296 @@
+/* Copyright (C) 2019 ATgroup09
+*  Contact: atgroup09@gmail.com
+*
+*  This file is part of the HMI server component.
+*
+*  The code in this page is free software: you can
+*  redistribute it and/or modify it under the terms of the GNU
+*  General Public License (GNU GPL) as published by the Free Software
+*  Foundation, either version 3 of the License, or (at your option)
+*  any later version.  The code is distributed WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS
+*  FOR A PARTICULAR PURPOSE.  See the GNU GPL for more details.
+*
+*  As additional permission under GNU GPL version 3 section 7, you
+*  may distribute non-source (e.g., minimized or compacted) forms of
+*  that code without the copy of the GNU GPL normally required by
+*  section 4, provided you include this license notice and a URL
+*  through which recipients can access the Corresponding Source.
+*/
+
+#ifndef ARH_CODEC_H
+#define ARH_CODEC_H
+
+#include <cstring>
+#include <QByteArray>
+#include <QtAlgorithms>
+
+
+/**
+@brief Writer of bit stream (MSB first).
+*/
+class ArhBitWriter
+{
+public:
+
+    /**
+    @brief  Constructor.
+    @param  None.
+    @return None.
+    */
+    ArhBitWriter();
+
+    /**
+    @brief  Write one bit.
+    @param  BitIn - bit.
+    @return None.
+    */
+    void writeBit(const bool BitIn);
+
+    /**
+    @brief  Write bits.
+    @param  ValueIn - value (the lowest CountIn bits are written);
+    @param  CountIn - the number of bits (0...64).
+    @return None.
+    */
+    void writeBits(const quint64 ValueIn, int CountIn);
+
+    /**
+    @brief  Clear the stream.
+    @param  None.
+    @return None.
+    */
+    void clear();
+
+    /**
+    @brief  Get data of the stream.
+    @param  None.
+    @return Link to data (the last byte is padded by zeros).
+    */
+    const QByteArray &data() const;
+
+
+private:
+
+    /**
+    @brief Data.
+    */
+    QByteArray mData;
+
+    /**
+    @brief The number of free bits of the last byte.
+    */
+    int mFree;
+};
+
+
+/**
+@brief Reader of bit stream (MSB first).
+*/
+class ArhBitReader
+{
+public:
+
+    /**
+    @brief  Constructor.
+    @param  DataIn - pointer to data;
+    @param  SizeIn - size of data (bytes).
+    @return None.
+    */
+    ArhBitReader(const uchar *DataIn, const qint64 SizeIn);
+
+    /**
+    @brief  Read one bit.
+    @param  None.
+    @return Bit (false at the end of stream).
+    */
+    bool readBit();
+
+    /**
+    @brief  Read bits.
+    @param  CountIn - the number of bits (0...64).
+    @return Value.
+    */
+    quint64 readBits(int CountIn);
+
+    /**
+    @brief  Check the end of stream has been passed.
+    @param  None.
+    @return True if error, otherwise - False.
+    */
+    bool isError() const;
+
+
+private:
+
+    /**
+    @brief Data.
+    */
+    const uchar *mData;
+
+    /**
+    @brief Size of data (bits).
+    */
+    qint64 mSize;
+
+    /**
+    @brief Position (bits).
+    */
+    qint64 mPos;
+
+    /**
+    @brief The end of stream has been passed.
+    */
+    bool mError;
+};
+
+
+/**
+@brief Encoder of one block of samples of a tag (columnar, Gorilla-like).
+@details Three columns are encoded separately:
+            stamps - delta-of-delta of msec: '0' | '10'+7 | '110'+9 | '1110'+12 | '1111'+32 bits;
+            values - XOR with previous value: '0' | '10'+meaningful bits | '11'+5+6+meaningful bits;
+            status - '0' if ex/err/sign are not changed, otherwise '1'+32+32+32 bits.
+         The first stamp is kept in the header of block, the first value and status are written as is.
+*/
+class ArhEncoder
+{
+public:
+
+    /**
+    @brief  Constructor.
+    @param  None.
+    @return None.
+    */
+    ArhEncoder();
+
+    /**
+    @brief  Append a sample.
+    @param  StampIn - date and time (msec since epoch), a stamp before the last one is moved to the last;
+    @param  ValueIn - value;
+    @param  ExIn - exception code;
+    @param  ErrIn - error code;
+    @param  SignIn - sign code.
+    @return None.
+    */
+    void append(qint64 StampIn, const double ValueIn, const qint32 ExIn, const qint32 ErrIn, const qint32 SignIn);
+
+    /**
+    @brief  Clear the block.
+    @param  None.
+    @return None.
+    */
+    void clear();
+
+    /**
+    @brief  Get the number of samples.
+    @param  None.
+    @return The number of samples.
+    */
+    int size() const;
+
+    /**
+    @brief  Get the first and the last stamps (msec since epoch).
+    @param  None.
+    @return Stamp.
+    */
+    qint64 getFirst() const;
+    qint64 getLast() const;
+
+    /**
+    @brief  Get the columns.
+    @param  None.
+    @return Link to data of column.
+    */
+    const QByteArray &getStamps() const;
+    const QByteArray &getValues() const;
+    const QByteArray &getStatus() const;
+
+    /**
+    @brief  Get size of encoded data (bytes).
+    @param  None.
+    @return Size.
+    */
+    int getBytes() const;
+
+
+private:
+
+    /**
+    @brief Columns.
+    */
+    ArhBitWriter mStamps;
+    ArhBitWriter mValues;
+    ArhBitWriter mStatus;
+
+    /**
+    @brief State of encoder.
+    */
+    int mCount;
+    qint64 mFirst;
+    qint64 mLast;
+    qint64 mDelta;
+    quint64 mValue;
+    int mLeading;
+    int mTrailing;
+    qint32 mEx;
+    qint32 mErr;
+    qint32 mSign;
+};
+
+
+/**
+@brief Decoder of one block of samples of a tag (see ArhEncoder).
+*/
+class ArhDecoder
+{
+public:
+
+    /**
+    @brief  Constructor.
+    @param  CountIn - the number of samples;
+    @param  FirstIn - the first stamp (msec since epoch);
+    @param  StampsIn, StampsSizeIn - column of stamps;
+    @param  ValuesIn, ValuesSizeIn - column of values;
+    @param  StatusIn, StatusSizeIn - column of status.
+    @return None.
+    */
+    ArhDecoder(const int CountIn, const qint64 FirstIn, const uchar *StampsIn, const qint64 StampsSizeIn, const uchar *ValuesIn, const qint64 ValuesSizeIn, const uchar *StatusIn, const qint64 StatusSizeIn);
+
+    /**
+    @brief  Read the next sample.
+    @param  StampIn - link to stamp (msec since epoch);
+    @param  ValueIn - link to value;
+    @param  ExIn - link to exception code;
+    @param  ErrIn - link to error code;
+    @param  SignIn - link to sign code.
+    @return True if the sample is read, otherwise (the end of block or error) - False.
+    */
+    bool next(qint64 &StampIn, double &ValueIn, qint32 &ExIn, qint32 &ErrIn, qint32 &SignIn);
+
+
+private:
+
+    /**
+    @brief Columns.
+    */
+    ArhBitReader mStamps;
+    ArhBitReader mValues;
+    ArhBitReader mStatus;
+
+    /**
+    @brief State of decoder.
+    */
+    int mCount;
+    int mPos;
+    qint64 mLast;
+    qint64 mDelta;
+    quint64 mValue;
+    int mLeading;
+    int mTrailing;
+    qint32 mEx;
+    qint32 mErr;
+    qint32 mSign;
+};
+
+#endif // ARH_CODEC_H
@@ -0,0 +1,222 @@
+/* Copyright (C) 2019 ATgroup09
+*  Contact: atgroup09@gmail.com
+*
+*  This file is part of the HMI server component.
+*
+*  The code in this page is free software: you can
+*  redistribute it and/or modify it under the terms of the GNU
+*  General Public License (GNU GPL) as published by the Free Software
+*  Foundation, either version 3 of the License, or (at your option)
+*  any later version.  The code is distributed WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS
+*  FOR A PARTICULAR PURPOSE.  See the GNU GPL for more details.
+*
+*  As additional permission under GNU GPL version 3 section 7, you
+*  may distribute non-source (e.g., minimized or compacted) forms of
+*  that code without the copy of the GNU GPL normally required by
+*  section 4, provided you include this license notice and a URL
+*  through which recipients can access the Corresponding Source.
+*/
+
+#include "arh-comp.h"
+
+
+/**
+@brief  Constructor.
+@param  None.
+@return None.
+*/
+ArhComp::ArhComp()
+{
+    mDeadband    = 0.0;
+    mDeadbandPct = 0.0;
+    mSwDoor      = 0.0;
+    mMaxInterval = 0;
+    mHasLast     = false;
+    mHasHeld     = false;
+    mSlopeMin    = 0.0;
+    mSlopeMax    = 0.0;
+}
+
+
+/**
+@brief  Check the compression is on.
+@param  None.
+@return True if one of the options is set, otherwise - False.
+*/
+bool ArhComp::isEnabled() const
+{
+    return ((mDeadband > 0.0 || mDeadbandPct > 0.0 || mSwDoor > 0.0) ? true : false);
+}
+
+
+/**
+@brief  Filter a row.
+@param  RowIn - row of the register;
+@param  ListRowsIn - link to list of rows to archive.
+@return The number of appended rows (0...2).
+*/
+int ArhComp::filter(const ArhRow &RowIn, QList<ArhRow> &ListRowsIn)
+{
+    if(!this->isEnabled())
+    {
+        ListRowsIn.append(RowIn);
+        return (1);
+    }
+
+    //the first row and a change of status are always archived
+    if(!mHasLast || !isSameStatus(RowIn, mLast) || !std::isfinite(RowIn.mValue) || !std::isfinite(mLast.mValue))
+    {
+        int Num = 0;
+
+        if(mHasHeld)
+        {
+            this->archive(mHeld, ListRowsIn);
+            Num++;
+        }
+
+        this->archive(RowIn, ListRowsIn);
+        return (Num + 1);
+    }
+
+    //values of a failed register are not compared
+    if(RowIn.mErr != 0)
+    {
+        if(mMaxInterval > 0 && mLast.mStamp.msecsTo(RowIn.mStamp) >= static_cast<qint64>(mMaxInterval)*1000)
+        {
+            this->archive(RowIn, ListRowsIn);
+            return (1);
+        }
+
+        return (0);
+    }
+
+    if(mSwDoor > 0.0) return (this->filterSwDoor(RowIn, ListRowsIn));
+
+    return (this->filterDeadband(RowIn, ListRowsIn));
+}
+
+
+/**
+@brief  Filter a row by deadband.
+@param  RowIn - row of the register;
+@param  ListRowsIn - link to list of rows to archive.
+@return The number of appended rows (0...1).
+*/
+int ArhComp::filterDeadband(const ArhRow &RowIn, QList<ArhRow> &ListRowsIn)
+{
+    double Deadband = -1.0;
+
+    if(mDeadband > 0.0) Deadband = mDeadband;
+    if(mDeadbandPct > 0.0)
+    {
+        double Pct = std::fabs(mLast.mValue) * mDeadbandPct / 100.0;
+        if(Deadband < 0.0 || Pct < Deadband) Deadband = Pct;
+    }
+
+    bool ToArh = (std::fabs(RowIn.mValue - mLast.mValue) > Deadband);
+
+    if(!ToArh && mMaxInterval > 0) ToArh = (mLast.mStamp.msecsTo(RowIn.mStamp) >= static_cast<qint64>(mMaxInterval)*1000);
+
+    if(ToArh)
+    {
+        this->archive(RowIn, ListRowsIn);
+        return (1);
+    }
+
+    return (0);
+}
+
+
+/**
+@brief  Filter a row by swinging door.
+@param  RowIn - row of the register;
+@param  ListRowsIn - link to list of rows to archive.
+@return The number of appended rows (0...2).
+*/
+int ArhComp::filterSwDoor(const ArhRow &RowIn, QList<ArhRow> &ListRowsIn)
+{
+    qint64 Dt = mLast.mStamp.msecsTo(RowIn.mStamp);
+    int Num = 0;
+
+    //a row of the same time is not a new point of the line
+    if(Dt <= 0) return (0);
+
+    if(!mHasHeld)
+    {
+        this->openDoor(RowIn);
+    }
+    else
+    {
+        //the line to the new row must pass within the door of all rows since the last archived row
+        double Slope = (RowIn.mValue - mLast.mValue) / static_cast<double>(Dt);
+
+        if(Slope >= mSlopeMin && Slope <= mSlopeMax)
+        {
+            mSlopeMin = std::max(mSlopeMin, (RowIn.mValue - mSwDoor - mLast.mValue) / static_cast<double>(Dt));
+            mSlopeMax = std::min(mSlopeMax, (RowIn.mValue + mSwDoor - mLast.mValue) / static_cast<double>(Dt));
+            mHeld     = RowIn;
+        }
+        else
+        {
+            this->archive(mHeld, ListRowsIn);
+            Num++;
+
+            if(mLast.mStamp.msecsTo(RowIn.mStamp) <= 0) return (Num);
+
+            this->openDoor(RowIn);
+        }
+    }
+
+    if(mMaxInterval > 0 && mLast.mStamp.msecsTo(RowIn.mStamp) >= static_cast<qint64>(mMaxInterval)*1000)
+    {
+        this->archive(RowIn, ListRowsIn);
+        Num++;
+    }
+
+    return (Num);
+}
+
+
+/**
+@brief  Archive a row.
+@param  RowIn - row;
+@param  ListRowsIn - link to list of rows to archive.
+@return None.
+@details The row becomes the last archived row, the door is closed.
+*/
+void ArhComp::archive(const ArhRow &RowIn, QList<ArhRow> &ListRowsIn)
+{
+    ListRowsIn.append(RowIn);
+
+    mLast    = RowIn;
+    mHasLast = true;
+    mHasHeld = false;
+}
+
+
+/**
+@brief  Open the door from the last archived row to a row.
+@param  RowIn - row.
+@return None.
+*/
+void ArhComp::openDoor(const ArhRow &RowIn)
+{
+    double Dt = static_cast<double>(mLast.mStamp.msecsTo(RowIn.mStamp));
+
+    mSlopeMin = (RowIn.mValue - mSwDoor - mLast.mValue) / Dt;
+    mSlopeMax = (RowIn.mValue + mSwDoor - mLast.mValue) / Dt;
+    mHeld     = RowIn;
+    mHasHeld  = true;
+}
+
+
+/**
+@brief (static) Compare status of rows.
+@param  Row1In, Row2In - rows.
+@return True if ex, err and sign are equal, otherwise - False.
+*/
+bool ArhComp::isSameStatus(const ArhRow &Row1In, const ArhRow &Row2In)
+{
+    return ((Row1In.mEx == Row2In.mEx && Row1In.mErr == Row2In.mErr && Row1In.mSign == Row2In.mSign) ? true : false);
+}
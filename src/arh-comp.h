@@ -0,0 +1,168 @@
+/* Copyright (C) 2019 ATgroup09
+*  Contact: atgroup09@gmail.com
+*
+*  This file is part of the HMI server component.
+*
+*  The code in this page is free software: you can
+*  redistribute it and/or modify it under the terms of the GNU
+*  General Public License (GNU GPL) as published by the Free Software
+*  Foundation, either version 3 of the License, or (at your option)
+*  any later version.  The code is distributed WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS
+*  FOR A PARTICULAR PURPOSE.  See the GNU GPL for more details.
+*
+*  As additional permission under GNU GPL version 3 section 7, you
+*  may distribute non-source (e.g., minimized or compacted) forms of
+*  that code without the copy of the GNU GPL normally required by
+*  section 4, provided you include this license notice and a URL
+*  through which recipients can access the Corresponding Source.
+*/
+
+#ifndef ARH_COMP_H
+#define ARH_COMP_H
+
+#include <cmath>
+#include <algorithm>
+#include <QList>
+#include <QDateTime>
+
+#include "arh-row.h"
+
+
+/**
+@brief Compression of archived values of one register.
+@details Rows of a register are filtered before they reach a file or DB, the error bound is kept:
+            deadband      - a value is archived if it differs from the last archived value by more than
+                            min(Deadband, DeadbandPct% of the last archived value), the step-hold error <= the deadband;
+            swinging door - a value is archived when a line from the last archived value cannot pass within
+                            SwDoor of all values since it, the linear interpolation error <= SwDoor
+                            (the archived value is the last one that fits, so rows are delayed by one tick).
+         A change of status (ex, err, sign) is always archived, MaxInterval (sec) forces a row.
+*/
+class ArhComp
+{
+public:
+
+    /**
+    @brief  Constructor.
+    @param  None.
+    @return None.
+    */
+    ArhComp();
+
+
+    /**
+    Public options
+    */
+
+    /**
+    @brief Absolute deadband (0 - off).
+    */
+    double mDeadband;
+
+    /**
+    @brief Deadband in percent of the last archived value (0 - off).
+    */
+    double mDeadbandPct;
+
+    /**
+    @brief Deviation of swinging door (0 - off).
+    */
+    double mSwDoor;
+
+    /**
+    @brief Maximal interval between archived rows (sec, 0 - off).
+    */
+    quint32 mMaxInterval;
+
+
+    /**
+    Public methods
+    */
+
+    /**
+    @brief  Check the compression is on.
+    @param  None.
+    @return True if one of the options is set, otherwise - False.
+    */
+    bool isEnabled() const;
+
+    /**
+    @brief  Filter a row.
+    @param  RowIn - row of the register;
+    @param  ListRowsIn - link to list of rows to archive.
+    @return The number of appended rows (0...2).
+    */
+    int filter(const ArhRow &RowIn, QList<ArhRow> &ListRowsIn);
+
+
+private:
+
+    /**
+    Private options
+    */
+
+    /**
+    @brief The last archived row.
+    */
+    bool mHasLast;
+    ArhRow mLast;
+
+    /**
+    @brief The last row that fits the door (is not archived yet).
+    */
+    bool mHasHeld;
+    ArhRow mHeld;
+
+    /**
+    @brief Slopes of the door (value per msec): all rows since mLast are within mSwDoor of a line with slope in [mSlopeMin, mSlopeMax].
+    */
+    double mSlopeMin;
+    double mSlopeMax;
+
+
+    /**
+    Private methods
+    */
+
+    /**
+    @brief  Filter a row by deadband.
+    @param  RowIn - row of the register;
+    @param  ListRowsIn - link to list of rows to archive.
+    @return The number of appended rows (0...1).
+    */
+    int filterDeadband(const ArhRow &RowIn, QList<ArhRow> &ListRowsIn);
+
+    /**
+    @brief  Filter a row by swinging door.
+    @param  RowIn - row of the register;
+    @param  ListRowsIn - link to list of rows to archive.
+    @return The number of appended rows (0...2).
+    */
+    int filterSwDoor(const ArhRow &RowIn, QList<ArhRow> &ListRowsIn);
+
+    /**
+    @brief  Archive a row.
+    @param  RowIn - row;
+    @param  ListRowsIn - link to list of rows to archive.
+    @return None.
+    @details The row becomes the last archived row, the door is closed.
+    */
+    void archive(const ArhRow &RowIn, QList<ArhRow> &ListRowsIn);
+
+    /**
+    @brief  Open the door from the last archived row to a row.
+    @param  RowIn - row.
+    @return None.
+    */
+    void openDoor(const ArhRow &RowIn);
+
+    /**
+    @brief (static) Compare status of rows.
+    @param  Row1In, Row2In - rows.
+    @return True if ex, err and sign are equal, otherwise - False.
+    */
+    static bool isSameStatus(const ArhRow &Row1In, const ArhRow &Row2In);
+};
+
+#endif // ARH_COMP_H
@@ -0,0 +1,396 @@
+/* Copyright (C) 2019 ATgroup09
+*  Contact: atgroup09@gmail.com
+*
+*  This file is part of the HMI server component.
+*
+*  The code in this page is free software: you can
+*  redistribute it and/or modify it under the terms of the GNU
+*  General Public License (GNU GPL) as published by the Free Software
+*  Foundation, either version 3 of the License, or (at your option)
+*  any later version.  The code is distributed WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS
+*  FOR A PARTICULAR PURPOSE.  See the GNU GPL for more details.
+*
+*  As additional permission under GNU GPL version 3 section 7, you
+*  may distribute non-source (e.g., minimized or compacted) forms of
+*  that code without the copy of the GNU GPL normally required by
+*  section 4, provided you include this license notice and a URL
+*  through which recipients can access the Corresponding Source.
+*/
+
+#include "arh-history.h"
+
+
+/**
+@brief Algorithms
+*/
+const QString ArhDownsampler::ALG__MINMAX_STR = "minmax";
+const QString ArhDownsampler::ALG__LTTB_STR   = "lttb";
+
+
+/**
+@brief  Constructor.
+@param  AlgIn - algorithm;
+@param  FromIn, ToIn - range (msec since epoch);
+@param  PointsIn - target number of points.
+@return None.
+*/
+ArhDownsampler::ArhDownsampler(const quint8 AlgIn, const qint64 FromIn, const qint64 ToIn, const int PointsIn)
+{
+    //MINMAX gives two points per bucket, LTTB keeps the first and the last points out of buckets
+    qint64 Buckets = ((AlgIn == ALG__LTTB) ? (PointsIn - 2) : (PointsIn / 2));
+    if(Buckets < 1) Buckets = 1;
+
+    mAlg        = AlgIn;
+    mFrom       = FromIn;
+    mWidth      = (ToIn - FromIn + Buckets) / Buckets;
+    mCount      = 0;
+    mCurBucket  = -1;
+    mNextBucket = -1;
+
+    if(mWidth < 1) mWidth = 1;
+
+    mLast.mStamp     = 0;
+    mLast.mValue     = 0.0;
+    mCurMin          = mLast;
+    mCurMax          = mLast;
+    mSelected        = mLast;
+}
+
+
+/**
+@brief  Add a sample.
+@param  StampIn - date and time (msec since epoch);
+@param  ValueIn - value.
+@return None.
+*/
+void ArhDownsampler::add(const qint64 StampIn, const double ValueIn)
+{
+    ArhPoint Point;
+    Point.mStamp = StampIn;
+    Point.mValue = ValueIn;
+
+    qint64 Bucket = (StampIn - mFrom) / mWidth;
+
+    if(mAlg == ALG__LTTB)
+    {
+        if(mCount == 0)
+        {
+            mListOut.append(Point);
+            mSelected = Point;
+        }
+        else if(mListCur.isEmpty())
+        {
+            mListCur.append(Point);
+            mCurBucket = Bucket;
+        }
+        else if(Bucket == mCurBucket && mListNext.isEmpty())
+        {
+            mListCur.append(Point);
+        }
+        else if(mListNext.isEmpty() || Bucket == mNextBucket)
+        {
+            mListNext.append(Point);
+            mNextBucket = Bucket;
+        }
+        else
+        {
+            //the next bucket is complete: the point of the current bucket can be selected
+            this->selectLttb(toAverage(mListNext));
+            mListCur = mListNext;
+            mCurBucket = mNextBucket;
+            mListNext.clear();
+            mListNext.append(Point);
+            mNextBucket = Bucket;
+        }
+    }
+    else
+    {
+        if(mCount == 0 || Bucket != mCurBucket)
+        {
+            if(mCount > 0) this->closeMinMax();
+
+            mCurBucket = Bucket;
+            mCurMin    = Point;
+            mCurMax    = Point;
+        }
+        else
+        {
+            if(ValueIn < mCurMin.mValue) mCurMin = Point;
+            if(ValueIn > mCurMax.mValue) mCurMax = Point;
+        }
+    }
+
+    mLast = Point;
+    mCount++;
+}
+
+
+/**
+@brief  Finish the range.
+@param  None.
+@return None.
+@details The rest of points is moved into the output.
+*/
+void ArhDownsampler::finish()
+{
+    if(mCount == 0) return;
+
+    if(mAlg == ALG__LTTB)
+    {
+        if(mCount == 1) return;
+
+        //the last sample is always the last point of output
+        if(!mListNext.isEmpty())
+        {
+            mListNext.removeLast();
+        }
+        else if(!mListCur.isEmpty())
+        {
+            mListCur.removeLast();
+        }
+
+        if(!mListNext.isEmpty())
+        {
+            this->selectLttb(toAverage(mListNext));
+            mListCur = mListNext;
+            mListNext.clear();
+        }
+
+        if(!mListCur.isEmpty()) this->selectLttb(mLast);
+
+        mListOut.append(mLast);
+    }
+    else
+    {
+        this->closeMinMax();
+    }
+
+    mCount = 0;
+}
+
+
+/**
+@brief  Get the number of output points.
+@param  None.
+@return The number of points.
+*/
+int ArhDownsampler::sizeOut() const
+{
+    return (mListOut.size());
+}
+
+
+/**
+@brief  Take the output points.
+@param  ListPointsIn - link to list of points.
+@return None.
+*/
+void ArhDownsampler::takeOut(QVector<ArhPoint> &ListPointsIn)
+{
+    ListPointsIn = mListOut;
+    mListOut.clear();
+}
+
+
+/**
+@brief (static) Get algorithm by name.
+@param  NameIn - name of algorithm.
+@return Algorithm (ALG__MINMAX by default).
+*/
+quint8 ArhDownsampler::toAlg(const QString &NameIn)
+{
+    if(NameIn.trimmed().toLower() == ALG__LTTB_STR) return (ALG__LTTB);
+
+    return (ALG__MINMAX);
+}
+
+
+/**
+@brief  Close the current bucket (MINMAX).
+@param  None.
+@return None.
+*/
+void ArhDownsampler::closeMinMax()
+{
+    if(mCurMin.mStamp == mCurMax.mStamp)
+    {
+        mListOut.append(mCurMin);
+    }
+    else if(mCurMin.mStamp < mCurMax.mStamp)
+    {
+        mListOut.append(mCurMin);
+        mListOut.append(mCurMax);
+    }
+    else
+    {
+        mListOut.append(mCurMax);
+        mListOut.append(mCurMin);
+    }
+}
+
+
+/**
+@brief  Select the point of the current bucket (LTTB).
+@param  NextIn - the third point of triangle.
+@return None.
+*/
+void ArhDownsampler::selectLttb(const ArhPoint &NextIn)
+{
+    if(mListCur.isEmpty()) return;
+
+    const double Ax = static_cast<double>(mSelected.mStamp);
+    const double Ay = mSelected.mValue;
+    const double Cx = static_cast<double>(NextIn.mStamp);
+    const double Cy = NextIn.mValue;
+    double Area, AreaMax = -1.0;
+    int Idx = 0;
+
+    for(int i=0; i<mListCur.size(); i++)
+    {
+        const ArhPoint &B = mListCur.at(i);
+
+        //doubled area of triangle (A, B, C)
+        Area = std::fabs((Ax - Cx) * (B.mValue - Ay) - (Ax - static_cast<double>(B.mStamp)) * (Cy - Ay));
+        if(Area > AreaMax)
+        {
+            AreaMax = Area;
+            Idx = i;
+        }
+    }
+
+    mSelected = mListCur.at(Idx);
+    mListOut.append(mSelected);
+    mListCur.clear();
+}
+
+
+/**
+@brief  Get average point of a bucket.
+@param  ListPointsIn - points of the bucket.
+@return Average point.
+*/
+ArhPoint ArhDownsampler::toAverage(const QVector<ArhPoint> &ListPointsIn)
+{
+    ArhPoint Res;
+    double Stamp = 0.0, Value = 0.0;
+
+    for(int i=0; i<ListPointsIn.size(); i++)
+    {
+        Stamp+= static_cast<double>(ListPointsIn.at(i).mStamp);
+        Value+= ListPointsIn.at(i).mValue;
+    }
+
+    Res.mStamp = ((ListPointsIn.isEmpty()) ? 0 : static_cast<qint64>(Stamp / ListPointsIn.size()));
+    Res.mValue = ((ListPointsIn.isEmpty()) ? 0.0 : (Value / ListPointsIn.size()));
+
+    return (Res);
+}
+
+
+/**
+@brief  Constructor.
+@param  StoreIn - store;
+@param  ReceiverIn - receiver of chunks (Server);
+@param  CliIdIn - ID of the client (see Client::mID);
+@param  HeadIn - common fields of reply;
+@param  DevIdIn - device ID;
+@param  RegIdIn - register ID;
+@param  FromIn, ToIn - range (msec since epoch);
+@param  PointsIn - target number of points;
+@param  AlgIn - algorithm.
+@return None.
+*/
+ArhHistoryTask::ArhHistoryTask(ArhStore *StoreIn, QObject *ReceiverIn, const quint64 CliIdIn, const QJsonObject &HeadIn, const quint16 DevIdIn, const quint16 RegIdIn, const qint64 FromIn, const qint64 ToIn, const int PointsIn, const quint8 AlgIn)
+{
+    mStore    = StoreIn;
+    mReceiver = ReceiverIn;
+    mCliID    = CliIdIn;
+    mHead     = HeadIn;
+    mDevID    = DevIdIn;
+    mRegID    = RegIdIn;
+    mFrom     = FromIn;
+    mTo       = ToIn;
+    mPoints   = PointsIn;
+    mAlg      = AlgIn;
+
+    this->setAutoDelete(true);
+}
+
+
+/**
+@brief  Run the task.
+@param  None.
+@return None.
+*/
+void ArhHistoryTask::run()
+{
+    ArhDownsampler Sampler(mAlg, mFrom, mTo, mPoints);
+    QVector<ArhPoint> ListPoints;
+    int Chunk = 0;
+
+    //samples are streamed through the downsampler, full chunks are sent while the range is read
+    mStore->scan(mDevID, mRegID, mFrom, mTo, [&](const qint64 StampIn, const double ValueIn, const qint32 ErrIn) -> bool
+    {
+        if(ErrIn != 0 || !std::isfinite(ValueIn)) return (true);
+
+        Sampler.add(StampIn, ValueIn);
+
+        if(Sampler.sizeOut() >= CHUNK__POINTS)
+        {
+            Sampler.takeOut(ListPoints);
+            this->send(toChunk(mHead, true, Chunk++, false, ListPoints));
+        }
+
+        return (true);
+    });
+
+    Sampler.finish();
+    Sampler.takeOut(ListPoints);
+    this->send(toChunk(mHead, true, Chunk, true, ListPoints));
+}
+
+
+/**
+@brief (static) Pack a chunk of reply.
+@param  HeadIn - common fields of reply;
+@param  ResIn - result;
+@param  ChunkIn - number of chunk (0...);
+@param  LastIn - the last chunk;
+@param  ListPointsIn - points.
+@return JSON-message.
+@detailed { ...HeadIn, Res:0|1, Chunk:n, Last:0|1, Data:[[msec, value], ...] }
+*/
+QString ArhHistoryTask::toChunk(const QJsonObject &HeadIn, const bool ResIn, const int ChunkIn, const bool LastIn, const QVector<ArhPoint> &ListPointsIn)
+{
+    QJsonObject Obj = HeadIn;
+    QJsonArray Data;
+
+    for(int i=0; i<ListPointsIn.size(); i++)
+    {
+        QJsonArray Point;
+        Point.append(QJsonValue(static_cast<double>(ListPointsIn.at(i).mStamp)));
+        Point.append(QJsonValue(ListPointsIn.at(i).mValue));
+        Data.append(Point);
+    }
+
+    Obj.insert(Config::FIELD__RES, QJsonValue(((ResIn) ? 1 : 0)));
+    Obj.insert(Config::FIELD__CHUNK, QJsonValue(ChunkIn));
+    Obj.insert(Config::FIELD__LAST, QJsonValue(((LastIn) ? 1 : 0)));
+    Obj.insert(Config::FIELD__DATA, QJsonValue(Data));
+
+    QJsonDocument Doc(Obj);
+    return (QString(Doc.toJson(QJsonDocument::Compact)));
+}
+
+
+/**
+@brief  Send a chunk to the receiver.
+@param  DataIn - JSON-message.
+@return None.
+*/
+void ArhHistoryTask::send(const QString &DataIn)
+{
+    //the client lives in the thread of Server: the chunk is passed by queued call
+    QMetaObject::invokeMethod(mReceiver, "sendHistory", Qt::QueuedConnection, Q_ARG(quint64, mCliID), Q_ARG(QString, DataIn));
+}
@@ -0,0 +1,311 @@
+/* Copyright (C) 2019 ATgroup09
+*  Contact: atgroup09@gmail.com
+*
+*  This file is part of the HMI server component.
+*
+*  The code in this page is free software: you can
+*  redistribute it and/or modify it under the terms of the GNU
+*  General Public License (GNU GPL) as published by the Free Software
+*  Foundation, either version 3 of the License, or (at your option)
+*  any later version.  The code is distributed WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS
+*  FOR A PARTICULAR PURPOSE.  See the GNU GPL for more details.
+*
+*  As additional permission under GNU GPL version 3 section 7, you
+*  may distribute non-source (e.g., minimized or compacted) forms of
+*  that code without the copy of the GNU GPL normally required by
+*  section 4, provided you include this license notice and a URL
+*  through which recipients can access the Corresponding Source.
+*/
+
+#ifndef ARH_HISTORY_H
+#define ARH_HISTORY_H
+
+#include <cmath>
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QRunnable>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+#include "arh-store.h"
+#include "config.h"
+
+
+/**
+@brief Point of history.
+*/
+class ArhPoint
+{
+public:
+
+    /**
+    @brief Date and time (msec since epoch).
+    */
+    qint64 mStamp;
+
+    /**
+    @brief Value.
+    */
+    double mValue;
+};
+
+
+/**
+@brief Streaming downsampler of history.
+@details The range is divided into buckets of equal time, samples are added in time order:
+            ALG__MINMAX - the minimum and the maximum of each bucket (Points/2 buckets);
+            ALG__LTTB   - Largest-Triangle-Three-Buckets (Points buckets), the point of a bucket is
+                          selected when the next bucket is complete (only two buckets are kept).
+         Selected points are collected in the output until they are taken.
+*/
+class ArhDownsampler
+{
+public:
+
+    /**
+    @brief  Constructor.
+    @param  AlgIn - algorithm;
+    @param  FromIn, ToIn - range (msec since epoch);
+    @param  PointsIn - target number of points.
+    @return None.
+    */
+    ArhDownsampler(const quint8 AlgIn, const qint64 FromIn, const qint64 ToIn, const int PointsIn);
+
+
+    /**
+    Public constants
+    */
+
+    /**
+    @brief Algorithms
+    */
+    static const quint8 ALG__MINMAX = 0;
+    static const quint8 ALG__LTTB   = 1;
+    static const QString ALG__MINMAX_STR;
+    static const QString ALG__LTTB_STR;
+
+
+    /**
+    Public methods
+    */
+
+    /**
+    @brief  Add a sample.
+    @param  StampIn - date and time (msec since epoch);
+    @param  ValueIn - value.
+    @return None.
+    */
+    void add(const qint64 StampIn, const double ValueIn);
+
+    /**
+    @brief  Finish the range.
+    @param  None.
+    @return None.
+    @details The rest of points is moved into the output.
+    */
+    void finish();
+
+    /**
+    @brief  Get the number of output points.
+    @param  None.
+    @return The number of points.
+    */
+    int sizeOut() const;
+
+    /**
+    @brief  Take the output points.
+    @param  ListPointsIn - link to list of points.
+    @return None.
+    */
+    void takeOut(QVector<ArhPoint> &ListPointsIn);
+
+    /**
+    @brief (static) Get algorithm by name.
+    @param  NameIn - name of algorithm.
+    @return Algorithm (ALG__MINMAX by default).
+    */
+    static quint8 toAlg(const QString &NameIn);
+
+
+private:
+
+    /**
+    Private options
+    */
+
+    /**
+    @brief Algorithm.
+    */
+    quint8 mAlg;
+
+    /**
+    @brief Start of the range (msec since epoch).
+    */
+    qint64 mFrom;
+
+    /**
+    @brief Width of bucket (msec).
+    */
+    qint64 mWidth;
+
+    /**
+    @brief The number of added samples.
+    */
+    qint64 mCount;
+
+    /**
+    @brief The last added sample.
+    */
+    ArhPoint mLast;
+
+    /**
+    @brief Output points.
+    */
+    QVector<ArhPoint> mListOut;
+
+    /**
+    @brief Current bucket (index, min and max points, points for LTTB).
+    */
+    qint64 mCurBucket;
+    ArhPoint mCurMin;
+    ArhPoint mCurMax;
+    QVector<ArhPoint> mListCur;
+
+    /**
+    @brief Next bucket for LTTB (index, points).
+    */
+    qint64 mNextBucket;
+    QVector<ArhPoint> mListNext;
+
+    /**
+    @brief The last selected point (LTTB).
+    */
+    ArhPoint mSelected;
+
+
+    /**
+    Private methods
+    */
+
+    /**
+    @brief  Close the current bucket (MINMAX).
+    @param  None.
+    @return None.
+    */
+    void closeMinMax();
+
+    /**
+    @brief  Select the point of the current bucket (LTTB).
+    @param  NextIn - the third point of triangle.
+    @return None.
+    */
+    void selectLttb(const ArhPoint &NextIn);
+
+    /**
+    @brief  Get average point of a bucket.
+    @param  ListPointsIn - points of the bucket.
+    @return Average point.
+    */
+    static ArhPoint toAverage(const QVector<ArhPoint> &ListPointsIn);
+};
+
+
+/**
+@brief Task of history query.
+@details Is run in thread pool of Server: reads samples of a register from the store,
+         downsamples them and sends the reply by chunks (Server::sendHistory()).
+*/
+class ArhHistoryTask : public QRunnable
+{
+public:
+
+    /**
+    @brief  Constructor.
+    @param  StoreIn - store;
+    @param  ReceiverIn - receiver of chunks (Server);
+    @param  CliIdIn - ID of the client (see Client::mID);
+    @param  HeadIn - common fields of reply;
+    @param  DevIdIn - device ID;
+    @param  RegIdIn - register ID;
+    @param  FromIn, ToIn - range (msec since epoch);
+    @param  PointsIn - target number of points;
+    @param  AlgIn - algorithm.
+    @return None.
+    */
+    ArhHistoryTask(ArhStore *StoreIn, QObject *ReceiverIn, const quint64 CliIdIn, const QJsonObject &HeadIn, const quint16 DevIdIn, const quint16 RegIdIn, const qint64 FromIn, const qint64 ToIn, const int PointsIn, const quint8 AlgIn);
+
+
+    /**
+    Public constants
+    */
+
+    /**
+    @brief Maximal number of points of one chunk
+    */
+    static const int CHUNK__POINTS = 1000;
+
+    /**
+    @brief Target number of points
+    */
+    static const int POINTS__DEF = 1000;
+    static const int POINTS__MAX = 100000;
+
+
+    /**
+    Public methods
+    */
+
+    /**
+    @brief  Run the task.
+    @param  None.
+    @return None.
+    */
+    void run();
+
+    /**
+    @brief (static) Pack a chunk of reply.
+    @param  HeadIn - common fields of reply;
+    @param  ResIn - result;
+    @param  ChunkIn - number of chunk (0...);
+    @param  LastIn - the last chunk;
+    @param  ListPointsIn - points.
+    @return JSON-message.
+    @detailed { ...HeadIn, Res:0|1, Chunk:n, Last:0|1, Data:[[msec, value], ...] }
+    */
+    static QString toChunk(const QJsonObject &HeadIn, const bool ResIn, const int ChunkIn, const bool LastIn, const QVector<ArhPoint> &ListPointsIn);
+
+
+private:
+
+    /**
+    Private options
+    */
+
+    ArhStore *mStore;
+    QObject *mReceiver;
+    quint64 mCliID;
+    QJsonObject mHead;
+    quint16 mDevID;
+    quint16 mRegID;
+    qint64 mFrom;
+    qint64 mTo;
+    int mPoints;
+    quint8 mAlg;
+
+
+    /**
+    Private methods
+    */
+
+    /**
+    @brief  Send a chunk to the receiver.
+    @param  DataIn - JSON-message.
+    @return None.
+    */
+    void send(const QString &DataIn);
+};
+
+#endif // ARH_HISTORY_H
@@ -0,0 +1,81 @@
+/* Copyright (C) 2019 ATgroup09
+*  Contact: atgroup09@gmail.com
+*
+*  This file is part of the HMI server component.
+*
+*  The code in this page is free software: you can
+*  redistribute it and/or modify it under the terms of the GNU
+*  General Public License (GNU GPL) as published by the Free Software
+*  Foundation, either version 3 of the License, or (at your option)
+*  any later version.  The code is distributed WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS
+*  FOR A PARTICULAR PURPOSE.  See the GNU GPL for more details.
+*
+*  As additional permission under GNU GPL version 3 section 7, you
+*  may distribute non-source (e.g., minimized or compacted) forms of
+*  that code without the copy of the GNU GPL normally required by
+*  section 4, provided you include this license notice and a URL
+*  through which recipients can access the Corresponding Source.
+*/
+
+#ifndef ARH_ROW_H
+#define ARH_ROW_H
+
+#include <QString>
+#include <QDateTime>
+
+
+/**
+@brief Row of archive.
+@details Binary form of one archived value (see Register::toSqlValue()).
+         Is used to send the values by prepared statements without SQL-text.
+*/
+class ArhRow
+{
+public:
+
+    /**
+    @brief Date and time stamp.
+    */
+    QDateTime mStamp;
+
+    /**
+    @brief Name of profile.
+    @details Empty for NULL.
+    */
+    QString mProfile;
+
+    /**
+    @brief Device ID.
+    @details 0 for NULL.
+    */
+    quint16 mDevID;
+
+    /**
+    @brief Register ID.
+    @details 0 for NULL.
+    */
+    quint16 mRegID;
+
+    /**
+    @brief Formatted value.
+    */
+    double mValue;
+
+    /**
+    @brief Exception code.
+    */
+    qint32 mEx;
+
+    /**
+    @brief Error code.
+    */
+    qint32 mErr;
+
+    /**
+    @brief Sign code.
+    */
+    qint32 mSign;
+};
+
+#endif // ARH_ROW_H
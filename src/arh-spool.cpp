@@ -0,0 +1,569 @@
+/* Copyright (C) 2019 ATgroup09
+*  Contact: atgroup09@gmail.com
+*
+*  This file is part of the HMI server component.
+*
+*  The code in this page is free software: you can
+*  redistribute it and/or modify it under the terms of the GNU
+*  General Public License (GNU GPL) as published by the Free Software
+*  Foundation, either version 3 of the License, or (at your option)
+*  any later version.  The code is distributed WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS
+*  FOR A PARTICULAR PURPOSE.  See the GNU GPL for more details.
+*
+*  As additional permission under GNU GPL version 3 section 7, you
+*  may distribute non-source (e.g., minimized or compacted) forms of
+*  that code without the copy of the GNU GPL normally required by
+*  section 4, provided you include this license notice and a URL
+*  through which recipients can access the Corresponding Source.
+*/
+
+#include "arh-spool.h"
+
+
+/**
+@brief  Constructor.
+@param  None.
+@return None.
+*/
+ArhSpool::ArhSpool(QObject *parent) : QObject(parent)
+{
+    mDir     = QString("");
+    mMaxSize = 0;
+    mSegment = 0;
+    mSize    = 0;
+    mWrite   = nullptr;
+    mRead    = nullptr;
+    mReadPos = HEADER_SIZE;
+    mNextPos = HEADER_SIZE;
+    mDropped = 0;
+}
+
+
+/**
+@brief  Destructor.
+@param  None.
+@return None.
+*/
+ArhSpool::~ArhSpool()
+{
+    this->close();
+}
+
+
+/**
+@brief  Open the spool.
+@param  DirIn - path to directory of spool;
+@param  MaxSizeIn - maximal size of the spool (bytes);
+@param  SegmentIn - size of one segment (bytes).
+@return True if opened, otherwise - False.
+*/
+bool ArhSpool::open(const QString &DirIn, qint64 MaxSizeIn, qint64 SegmentIn)
+{
+    this->close();
+
+    if(DirIn.isEmpty()) return (false);
+
+    QDir Dir(DirIn);
+    if(!Dir.mkpath(QString("."))) return (false);
+
+    mDir     = Dir.absolutePath();
+    mMaxSize = MaxSizeIn;
+    mSegment = SegmentIn;
+    mSize    = 0;
+
+    //existing segments
+    QFileInfoList ListFiles = Dir.entryInfoList(QStringList() << QString("*.spl"), QDir::Files, QDir::Name);
+    bool Ok;
+    quint32 Seq;
+
+    for(int i=0; i<ListFiles.size(); i++)
+    {
+        Seq = ListFiles.at(i).completeBaseName().toUInt(&Ok);
+
+        if(Ok && Seq > 0)
+        {
+            mListSegs.append(Seq);
+            mSize+= ListFiles.at(i).size();
+        }
+    }
+
+    std::sort(mListSegs.begin(), mListSegs.end());
+
+    //segments before the saved position are sent already
+    quint32 PosSeq = 0;
+    qint64 Pos     = HEADER_SIZE;
+
+    if(this->loadPos(PosSeq, Pos))
+    {
+        while(!mListSegs.isEmpty() && mListSegs.first() < PosSeq)
+        {
+            this->removeHead();
+        }
+    }
+
+    mReadPos = (((!mListSegs.isEmpty() && mListSegs.first() == PosSeq) && Pos > HEADER_SIZE) ? Pos : HEADER_SIZE);
+    mNextPos = mReadPos;
+
+    Seq = ((mListSegs.isEmpty()) ? 1 : (mListSegs.last() + 1));
+
+    return (this->openWrite(Seq));
+}
+
+
+/**
+@brief  Close the spool.
+@param  None.
+@return None.
+*/
+void ArhSpool::close()
+{
+    if(mRead != nullptr)
+    {
+        mRead->close();
+        delete mRead;
+        mRead = nullptr;
+    }
+
+    if(mWrite != nullptr)
+    {
+        mWrite->close();
+        delete mWrite;
+        mWrite = nullptr;
+
+        //an empty segment is not kept
+        if(!mListSegs.isEmpty())
+        {
+            QFileInfo Info(this->toPath(mListSegs.last()));
+
+            if(Info.size() <= HEADER_SIZE)
+            {
+                QFile::remove(Info.filePath());
+                mListSegs.removeLast();
+            }
+        }
+    }
+
+    mListSegs.clear();
+    mSize    = 0;
+    mReadPos = HEADER_SIZE;
+    mNextPos = HEADER_SIZE;
+}
+
+
+/**
+@brief  Check the spool is opened.
+@param  None.
+@return True if opened, otherwise - False.
+*/
+bool ArhSpool::isOpened()
+{
+    return ((mWrite != nullptr) ? true : false);
+}
+
+
+/**
+@brief  Check the spool has no records to read.
+@param  None.
+@return True if empty, otherwise - False.
+*/
+bool ArhSpool::isEmpty()
+{
+    if(!this->isOpened() || mListSegs.isEmpty()) return (true);
+
+    return ((mListSegs.size() == 1 && (mReadPos + FRAME_SIZE) > mWrite->size()) ? true : false);
+}
+
+
+/**
+@brief  Get size of the spool on disk.
+@param  None.
+@return Size (bytes).
+*/
+qint64 ArhSpool::size()
+{
+    return (mSize);
+}
+
+
+/**
+@brief  Append a record.
+@param  RecordIn - record.
+@return True if appended, otherwise - False.
+*/
+bool ArhSpool::push(const QByteArray &RecordIn)
+{
+    if(!this->isOpened() || RecordIn.isEmpty() || static_cast<quint32>(RecordIn.size()) > RECORD_SIZE__MAX) return (false);
+
+    //the next segment
+    if(mWrite->size() > HEADER_SIZE && (mWrite->size() + FRAME_SIZE + RecordIn.size()) > mSegment)
+    {
+        if(!this->openWrite(mListSegs.last() + 1)) return (false);
+    }
+
+    uchar Frame[FRAME_SIZE];
+    qToBigEndian<quint32>(static_cast<quint32>(RecordIn.size()), Frame);
+    qToBigEndian<quint32>(crc32(RecordIn), Frame + 4);
+
+    if(mWrite->write(reinterpret_cast<const char *>(Frame), FRAME_SIZE) != FRAME_SIZE) return (false);
+    if(mWrite->write(RecordIn) != RecordIn.size()) return (false);
+    mWrite->flush();
+
+    mSize+= FRAME_SIZE + RecordIn.size();
+
+    //bounded: the oldest data is dropped
+    while(mSize > mMaxSize && mListSegs.size() > 1)
+    {
+        this->removeHead();
+        mDropped++;
+    }
+
+    return (true);
+}
+
+
+/**
+@brief  Read the oldest record (the record stays in the spool).
+@param  RecordIn - link to record.
+@return True if read, otherwise - False (the spool is empty).
+@detailed The rest of a segment is skipped if a record is broken (CRC or size).
+*/
+bool ArhSpool::peek(QByteArray &RecordIn)
+{
+    while(this->isOpened() && !mListSegs.isEmpty())
+    {
+        bool Last = ((mListSegs.size() == 1) ? true : false);
+
+        if(!this->openRead())
+        {
+            if(Last) return (false);
+            this->removeHead();
+            continue;
+        }
+
+        qint64 Size = mRead->size();
+
+        if((mReadPos + FRAME_SIZE) <= Size && mRead->seek(mReadPos))
+        {
+            QByteArray Frame = mRead->read(FRAME_SIZE);
+
+            if(Frame.size() == FRAME_SIZE)
+            {
+                quint32 RecSize = qFromBigEndian<quint32>(reinterpret_cast<const uchar *>(Frame.constData()));
+                quint32 RecCrc  = qFromBigEndian<quint32>(reinterpret_cast<const uchar *>(Frame.constData()) + 4);
+
+                if(RecSize > 0 && RecSize <= RECORD_SIZE__MAX && (mReadPos + FRAME_SIZE + RecSize) <= Size)
+                {
+                    RecordIn = mRead->read(RecSize);
+
+                    if(static_cast<quint32>(RecordIn.size()) == RecSize && crc32(RecordIn) == RecCrc)
+                    {
+                        mNextPos = mReadPos + FRAME_SIZE + RecSize;
+                        return (true);
+                    }
+                }
+            }
+        }
+        else if(Last)
+        {
+            //all records are read
+            return (false);
+        }
+
+        //the end of an old segment or a broken record
+        if(Last)
+        {
+            //a new segment is started, so the broken tail is never appended
+            if(!this->openWrite(mListSegs.last() + 1)) return (false);
+        }
+
+        this->removeHead();
+    }
+
+    return (false);
+}
+
+
+/**
+@brief  Remove the record read by peek().
+@param  None.
+@return None.
+*/
+void ArhSpool::pop()
+{
+    if(mNextPos > mReadPos)
+    {
+        mReadPos = mNextPos;
+        this->savePos();
+    }
+}
+
+
+/**
+@brief  Get and reset the number of dropped segments.
+@param  None.
+@return The number of segments.
+*/
+quint32 ArhSpool::takeDropped()
+{
+    quint32 Res = mDropped;
+    mDropped = 0;
+    return (Res);
+}
+
+
+/**
+@brief  Pack SQL-query into a record.
+@param  QueryIn - SQL-query;
+@param  RowsIn - the number of rows of the query.
+@return Record.
+*/
+QByteArray ArhSpool::packQuery(const QString &QueryIn, int RowsIn)
+{
+    QByteArray Res;
+    QDataStream Stream(&Res, QIODevice::WriteOnly);
+    Stream.setVersion(QDataStream::Qt_5_0);
+
+    Stream << RECORD__QUERY << static_cast<qint32>(RowsIn) << QueryIn;
+
+    return (Res);
+}
+
+
+/**
+@brief  Pack rows of a table into a record.
+@param  TableIn - name of table;
+@param  ListRowsIn - list of rows;
+@param  FromIn - index of the first row;
+@param  CountIn - the number of rows.
+@return Record.
+*/
+QByteArray ArhSpool::packRows(const QString &TableIn, const QList<ArhRow> &ListRowsIn, int FromIn, int CountIn)
+{
+    QByteArray Res;
+    QDataStream Stream(&Res, QIODevice::WriteOnly);
+    Stream.setVersion(QDataStream::Qt_5_0);
+
+    int To = qMin(FromIn + CountIn, ListRowsIn.size());
+
+    Stream << RECORD__ROWS << static_cast<qint32>(To - FromIn) << TableIn;
+
+    for(int i=FromIn; i<To; i++)
+    {
+        const ArhRow &Row = ListRowsIn.at(i);
+        Stream << Row.mStamp.toMSecsSinceEpoch() << Row.mProfile << Row.mDevID << Row.mRegID << Row.mValue << Row.mEx << Row.mErr << Row.mSign;
+    }
+
+    return (Res);
+}
+
+
+/**
+@brief  Unpack a record.
+@param  RecordIn - record;
+@param  QueryIn - link to SQL-query (RECORD__QUERY);
+@param  RowsIn - link to the number of rows;
+@param  TableIn - link to name of table (RECORD__ROWS);
+@param  ListRowsIn - link to list of rows (RECORD__ROWS).
+@return True if unpacked, otherwise - False.
+*/
+bool ArhSpool::unpack(const QByteArray &RecordIn, QString &QueryIn, int &RowsIn, QString &TableIn, QList<ArhRow> &ListRowsIn)
+{
+    QDataStream Stream(RecordIn);
+    Stream.setVersion(QDataStream::Qt_5_0);
+
+    quint8 Type = 0;
+    qint32 Rows = 0;
+
+    Stream >> Type >> Rows;
+
+    QueryIn.clear();
+    TableIn.clear();
+    ListRowsIn.clear();
+    RowsIn = static_cast<int>(Rows);
+
+    if(Type == RECORD__QUERY)
+    {
+        Stream >> QueryIn;
+    }
+    else if(Type == RECORD__ROWS)
+    {
+        Stream >> TableIn;
+
+        ArhRow Row;
+        qint64 Stamp;
+
+        for(qint32 i=0; i<Rows && Stream.status() == QDataStream::Ok; i++)
+        {
+            Stream >> Stamp >> Row.mProfile >> Row.mDevID >> Row.mRegID >> Row.mValue >> Row.mEx >> Row.mErr >> Row.mSign;
+            Row.mStamp = QDateTime::fromMSecsSinceEpoch(Stamp);
+            ListRowsIn.append(Row);
+        }
+    }
+
+    return ((Stream.status() == QDataStream::Ok && (!QueryIn.isEmpty() || !ListRowsIn.isEmpty())) ? true : false);
+}
+
+
+/**
+@brief  Get path to a segment.
+@param  SeqIn - sequence number.
+@return Path.
+*/
+QString ArhSpool::toPath(quint32 SeqIn)
+{
+    return (QString("%1/%2.spl").arg(mDir).arg(SeqIn, 10, 10, QChar('0')));
+}
+
+
+/**
+@brief  Start a new segment to write.
+@param  SeqIn - sequence number.
+@return True if started, otherwise - False.
+*/
+bool ArhSpool::openWrite(quint32 SeqIn)
+{
+    QFile *File = new QFile(this->toPath(SeqIn));
+
+    if(!File->open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        delete File;
+        return (false);
+    }
+
+    uchar Header[HEADER_SIZE];
+    qToBigEndian<quint32>(MAGIC, Header);
+    qToBigEndian<quint16>(VERSION, Header + 4);
+    File->write(reinterpret_cast<const char *>(Header), HEADER_SIZE);
+    File->flush();
+
+    if(mWrite != nullptr)
+    {
+        mWrite->close();
+        delete mWrite;
+    }
+
+    mWrite = File;
+    mListSegs.append(SeqIn);
+    mSize+= HEADER_SIZE;
+
+    return (true);
+}
+
+
+/**
+@brief  Open the first segment to read.
+@param  None.
+@return True if opened, otherwise - False.
+*/
+bool ArhSpool::openRead()
+{
+    if(mListSegs.isEmpty()) return (false);
+
+    QString Path = this->toPath(mListSegs.first());
+
+    if(mRead != nullptr)
+    {
+        if(mRead->fileName() == Path) return (true);
+
+        mRead->close();
+        delete mRead;
+        mRead = nullptr;
+    }
+
+    QFile *File = new QFile(Path);
+
+    //unbuffered: the segment may be appended at the same time
+    if(File->open(QIODevice::ReadOnly | QIODevice::Unbuffered))
+    {
+        QByteArray Header = File->read(HEADER_SIZE);
+
+        if(Header.size() == HEADER_SIZE)
+        {
+            const uchar *Data = reinterpret_cast<const uchar *>(Header.constData());
+
+            if(qFromBigEndian<quint32>(Data) == MAGIC && qFromBigEndian<quint16>(Data + 4) == VERSION)
+            {
+                mRead = File;
+                return (true);
+            }
+        }
+    }
+
+    delete File;
+    return (false);
+}
+
+
+/**
+@brief  Remove the first segment.
+@param  None.
+@return None.
+*/
+void ArhSpool::removeHead()
+{
+    if(mListSegs.isEmpty()) return;
+
+    QString Path = this->toPath(mListSegs.takeFirst());
+
+    if(mRead != nullptr && mRead->fileName() == Path)
+    {
+        mRead->close();
+        delete mRead;
+        mRead = nullptr;
+    }
+
+    mSize-= QFileInfo(Path).size();
+    if(mSize < 0) mSize = 0;
+    QFile::remove(Path);
+
+    mReadPos = HEADER_SIZE;
+    mNextPos = HEADER_SIZE;
+    this->savePos();
+}
+
+
+/**
+@brief  Save read position.
+@param  None.
+@return None.
+*/
+void ArhSpool::savePos()
+{
+    QSaveFile File(QString("%1/spool.pos").arg(mDir));
+
+    if(File.open(QIODevice::WriteOnly))
+    {
+        quint32 Seq = ((mListSegs.isEmpty()) ? 0 : mListSegs.first());
+        File.write(QString("%1 %2\n").arg(QString::number(Seq), QString::number(mReadPos)).toLatin1());
+        File.commit();
+    }
+}
+
+
+/**
+@brief  Load read position.
+@param  SeqIn - link to sequence number;
+@param  PosIn - link to position.
+@return True if loaded, otherwise - False.
+*/
+bool ArhSpool::loadPos(quint32 &SeqIn, qint64 &PosIn)
+{
+    QFile File(QString("%1/spool.pos").arg(mDir));
+
+    if(File.open(QIODevice::ReadOnly))
+    {
+        QStringList ListValues = QString::fromLatin1(File.readAll()).simplified().split(QChar(' '));
+
+        if(ListValues.size() == 2)
+        {
+            bool OkSeq, OkPos;
+            SeqIn = ListValues.at(0).toUInt(&OkSeq);
+            PosIn = ListValues.at(1).toLongLong(&OkPos);
+
+            return ((OkSeq && OkPos) ? true : false);
+        }
+    }
+
+    return (false);
+}
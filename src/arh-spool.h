@@ -0,0 +1,299 @@
+/* Copyright (C) 2019 ATgroup09
+*  Contact: atgroup09@gmail.com
+*
+*  This file is part of the HMI server component.
+*
+*  The code in this page is free software: you can
+*  redistribute it and/or modify it under the terms of the GNU
+*  General Public License (GNU GPL) as published by the Free Software
+*  Foundation, either version 3 of the License, or (at your option)
+*  any later version.  The code is distributed WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS
+*  FOR A PARTICULAR PURPOSE.  See the GNU GPL for more details.
+*
+*  As additional permission under GNU GPL version 3 section 7, you
+*  may distribute non-source (e.g., minimized or compacted) forms of
+*  that code without the copy of the GNU GPL normally required by
+*  section 4, provided you include this license notice and a URL
+*  through which recipients can access the Corresponding Source.
+*/
+
+#ifndef ARH_SPOOL_H
+#define ARH_SPOOL_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QStringList>
+#include <QFile>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QtEndian>
+#include <algorithm>
+
+#include "arh-row.h"
+#include "bit.h"
+
+
+/**
+@brief Store-and-forward spool of archive.
+@details Append-only segment files (Dir/NNNNNNNNNN.spl) that keep the data while DB is unavailable:
+            segment = [MAGIC:4][VERSION:2] { [Size:4][CRC-32:4][Record:Size] } ...
+         The read position is saved into Dir/spool.pos, so the spool survives restarts
+         (a record is sent at least once).
+         A new segment is always started on open, the old segments are only read.
+         The oldest segments are dropped if the spool is larger than its limit.
+*/
+class ArhSpool : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /**
+    @brief  Constructor.
+    @param  None.
+    @return None.
+    */
+    explicit ArhSpool(QObject *parent = nullptr);
+
+    /**
+    @brief  Destructor.
+    @param  None.
+    @return None.
+    */
+    virtual ~ArhSpool();
+
+
+    /**
+    Public constants
+    */
+
+    /**
+    @brief Format of segment
+    */
+    static const quint32 MAGIC       = 0x57535350;
+    static const quint16 VERSION     = 1;
+    static const qint64  HEADER_SIZE = 6;
+    static const qint64  FRAME_SIZE  = 8;
+
+    /**
+    @brief Maximal size of one record (bytes)
+    */
+    static const quint32 RECORD_SIZE__MAX = 67108864;
+
+    /**
+    @brief Types of record
+    */
+    static const quint8 RECORD__QUERY = 1;
+    static const quint8 RECORD__ROWS  = 2;
+
+
+    /**
+    Public methods
+    */
+
+    /**
+    @brief  Open the spool.
+    @param  DirIn - path to directory of spool;
+    @param  MaxSizeIn - maximal size of the spool (bytes);
+    @param  SegmentIn - size of one segment (bytes).
+    @return True if opened, otherwise - False.
+    */
+    bool open(const QString &DirIn, qint64 MaxSizeIn, qint64 SegmentIn);
+
+    /**
+    @brief  Close the spool.
+    @param  None.
+    @return None.
+    */
+    void close();
+
+    /**
+    @brief  Check the spool is opened.
+    @param  None.
+    @return True if opened, otherwise - False.
+    */
+    bool isOpened();
+
+    /**
+    @brief  Check the spool has no records to read.
+    @param  None.
+    @return True if empty, otherwise - False.
+    */
+    bool isEmpty();
+
+    /**
+    @brief  Get size of the spool on disk.
+    @param  None.
+    @return Size (bytes).
+    */
+    qint64 size();
+
+    /**
+    @brief  Append a record.
+    @param  RecordIn - record.
+    @return True if appended, otherwise - False.
+    */
+    bool push(const QByteArray &RecordIn);
+
+    /**
+    @brief  Read the oldest record (the record stays in the spool).
+    @param  RecordIn - link to record.
+    @return True if read, otherwise - False (the spool is empty).
+    @detailed The rest of a segment is skipped if a record is broken (CRC or size).
+    */
+    bool peek(QByteArray &RecordIn);
+
+    /**
+    @brief  Remove the record read by peek().
+    @param  None.
+    @return None.
+    */
+    void pop();
+
+    /**
+    @brief  Get and reset the number of dropped segments.
+    @param  None.
+    @return The number of segments.
+    */
+    quint32 takeDropped();
+
+    /**
+    @brief  Pack SQL-query into a record.
+    @param  QueryIn - SQL-query;
+    @param  RowsIn - the number of rows of the query.
+    @return Record.
+    */
+    static QByteArray packQuery(const QString &QueryIn, int RowsIn);
+
+    /**
+    @brief  Pack rows of a table into a record.
+    @param  TableIn - name of table;
+    @param  ListRowsIn - list of rows;
+    @param  FromIn - index of the first row;
+    @param  CountIn - the number of rows.
+    @return Record.
+    */
+    static QByteArray packRows(const QString &TableIn, const QList<ArhRow> &ListRowsIn, int FromIn, int CountIn);
+
+    /**
+    @brief  Unpack a record.
+    @param  RecordIn - record;
+    @param  QueryIn - link to SQL-query (RECORD__QUERY);
+    @param  RowsIn - link to the number of rows;
+    @param  TableIn - link to name of table (RECORD__ROWS);
+    @param  ListRowsIn - link to list of rows (RECORD__ROWS).
+    @return True if unpacked, otherwise - False.
+    */
+    static bool unpack(const QByteArray &RecordIn, QString &QueryIn, int &RowsIn, QString &TableIn, QList<ArhRow> &ListRowsIn);
+
+
+private:
+
+    /**
+    Private options
+    */
+
+    /**
+    @brief Path to directory.
+    */
+    QString mDir;
+
+    /**
+    @brief Maximal size of the spool (bytes).
+    */
+    qint64 mMaxSize;
+
+    /**
+    @brief Size of one segment (bytes).
+    */
+    qint64 mSegment;
+
+    /**
+    @brief Size of the spool (bytes).
+    */
+    qint64 mSize;
+
+    /**
+    @brief Sequence numbers of segments (the first is read, the last is written).
+    */
+    QList<quint32> mListSegs;
+
+    /**
+    @brief Segment to write.
+    */
+    QFile *mWrite;
+
+    /**
+    @brief Segment to read.
+    */
+    QFile *mRead;
+
+    /**
+    @brief Read position in the first segment.
+    */
+    qint64 mReadPos;
+
+    /**
+    @brief Position after the record read by peek().
+    */
+    qint64 mNextPos;
+
+    /**
+    @brief The number of dropped segments.
+    */
+    quint32 mDropped;
+
+
+    /**
+    Private methods
+    */
+
+    /**
+    @brief  Get path to a segment.
+    @param  SeqIn - sequence number.
+    @return Path.
+    */
+    QString toPath(quint32 SeqIn);
+
+    /**
+    @brief  Start a new segment to write.
+    @param  SeqIn - sequence number.
+    @return True if started, otherwise - False.
+    */
+    bool openWrite(quint32 SeqIn);
+
+    /**
+    @brief  Open the first segment to read.
+    @param  None.
+    @return True if opened, otherwise - False.
+    */
+    bool openRead();
+
+    /**
+    @brief  Remove the first segment.
+    @param  None.
+    @return None.
+    */
+    void removeHead();
+
+    /**
+    @brief  Save read position.
+    @param  None.
+    @return None.
+    */
+    void savePos();
+
+    /**
+    @brief  Load read position.
+    @param  SeqIn - link to sequence number;
+    @param  PosIn - link to position.
+    @return True if loaded, otherwise - False.
+    */
+    bool loadPos(quint32 &SeqIn, qint64 &PosIn);
+};
+
+#endif // ARH_SPOOL_H
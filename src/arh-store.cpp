@@ -0,0 +1,798 @@
+/* Copyright (C) 2019 ATgroup09
+*  Contact: atgroup09@gmail.com
+*
+*  This file is part of the HMI server component.
+*
+*  The code in this page is free software: you can
+*  redistribute it and/or modify it under the terms of the GNU
+*  General Public License (GNU GPL) as published by the Free Software
+*  Foundation, either version 3 of the License, or (at your option)
+*  any later version.  The code is distributed WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS
+*  FOR A PARTICULAR PURPOSE.  See the GNU GPL for more details.
+*
+*  As additional permission under GNU GPL version 3 section 7, you
+*  may distribute non-source (e.g., minimized or compacted) forms of
+*  that code without the copy of the GNU GPL normally required by
+*  section 4, provided you include this license notice and a URL
+*  through which recipients can access the Corresponding Source.
+*/
+
+#include "arh-store.h"
+
+
+/**
+@brief Suffixes of files
+*/
+const QString ArhStore::SUFFIX__DATA  = ".tsd";
+const QString ArhStore::SUFFIX__INDEX = ".tsi";
+
+
+/**
+@brief  Constructor.
+@param  None.
+@return None.
+*/
+ArhStore::ArhStore(QObject *parent) : QObject(parent)
+{
+    mDir       = QString("");
+    mPartition = 24;
+    mBlock     = 256;
+    mOpened    = false;
+    mPartStart = -1;
+    mMap       = nullptr;
+    mCapacity  = 0;
+    mUsed      = 0;
+}
+
+
+/**
+@brief  Destructor.
+@param  None.
+@return None.
+*/
+ArhStore::~ArhStore()
+{
+    this->close();
+}
+
+
+/**
+@brief  Open the store.
+@param  DirIn - path to directory of the store;
+@param  PartitionIn - length of time partition (hours);
+@param  BlockIn - the number of samples of one block.
+@return True if opened, otherwise - False.
+*/
+bool ArhStore::open(const QString &DirIn, int PartitionIn, int BlockIn)
+{
+    this->close();
+
+    if(DirIn.isEmpty() || PartitionIn < 1 || BlockIn < 1) return (false);
+
+    QDir Dir(DirIn);
+    if(!Dir.mkpath(QString("."))) return (false);
+
+//MUTEX LOCK
+    QMutexLocker MutexLk(&mMutex);
+
+    mDir       = Dir.absolutePath();
+    mPartition = PartitionIn;
+    mBlock     = BlockIn;
+    mOpened    = true;
+
+    return (true);
+//MUTEX UNLOCK
+}
+
+
+/**
+@brief  Close the store.
+@param  None.
+@return None.
+@details Open blocks are written.
+*/
+void ArhStore::close()
+{
+//MUTEX LOCK
+    QMutexLocker MutexLk(&mMutex);
+
+    if(mOpened)
+    {
+        this->flushBlocks();
+        this->closeSegment();
+        mMapOpen.clear();
+        mOpened = false;
+    }
+//MUTEX UNLOCK
+}
+
+
+/**
+@brief  Check the store is opened.
+@param  None.
+@return True if opened, otherwise - False.
+*/
+bool ArhStore::isOpened()
+{
+//MUTEX LOCK
+    QMutexLocker MutexLk(&mMutex);
+    return (mOpened);
+//MUTEX UNLOCK
+}
+
+
+/**
+@brief  Append a sample.
+@param  DevIdIn - device ID;
+@param  RegIdIn - register ID;
+@param  StampIn - date and time (msec since epoch);
+@param  ValueIn - value;
+@param  ExIn - exception code;
+@param  ErrIn - error code;
+@param  SignIn - sign code.
+@return True if appended, otherwise - False.
+*/
+bool ArhStore::append(const quint16 DevIdIn, const quint16 RegIdIn, const qint64 StampIn, const double ValueIn, const qint32 ExIn, const qint32 ErrIn, const qint32 SignIn)
+{
+//MUTEX LOCK
+    QMutexLocker MutexLk(&mMutex);
+
+    if(!mOpened) return (false);
+
+    //a new partition: the open blocks are written into the previous one
+    qint64 Start = this->toPartStart(StampIn);
+
+    if(mPartStart < 0 || Start > mPartStart)
+    {
+        if(mPartStart >= 0)
+        {
+            this->flushBlocks();
+            this->closeSegment();
+        }
+
+        if(!this->openSegment(Start)) return (false);
+    }
+
+    quint32 Key = ((static_cast<quint32>(DevIdIn) << 16) | RegIdIn);
+    ArhEncoder &Enc = mMapOpen[Key];
+
+    Enc.append(StampIn, ValueIn, ExIn, ErrIn, SignIn);
+
+    if(Enc.size() >= mBlock)
+    {
+        this->writeBlock(Key, Enc);
+        Enc.clear();
+    }
+
+    return (true);
+//MUTEX UNLOCK
+}
+
+
+/**
+@brief  Write all open blocks.
+@param  None.
+@return The number of written blocks.
+*/
+int ArhStore::flush()
+{
+//MUTEX LOCK
+    QMutexLocker MutexLk(&mMutex);
+    return (this->flushBlocks());
+//MUTEX UNLOCK
+}
+
+
+/**
+@brief  Read samples of a tag.
+@param  DevIdIn - device ID;
+@param  RegIdIn - register ID;
+@param  FromIn - start of the range (msec since epoch);
+@param  ToIn - end of the range (msec since epoch, inclusive);
+@param  VisitorIn - visitor of samples.
+@return The number of visited samples.
+@details Samples are visited in time order, block by block (the range is never loaded at once).
+         Open blocks are visited too.
+*/
+qint64 ArhStore::scan(const quint16 DevIdIn, const quint16 RegIdIn, const qint64 FromIn, const qint64 ToIn, const ArhStoreVisitor &VisitorIn)
+{
+    quint32 Key = ((static_cast<quint32>(DevIdIn) << 16) | RegIdIn);
+    QList<QString> ListPaths;
+    QList<QVector<ArhStoreIndex> > ListParts;
+    QVector<ArhStoreIndex> OpenIndex;
+    ArhEncoder Open;
+    QString Path;
+    qint64 PartStart;
+    qint64 Count = 0;
+    int i, j;
+
+    //only the state in memory is copied under lock (the open partition), so append() is not blocked by the disk:
+    //the partitions are listed, the closed indexes and the blocks are read without lock
+    {
+//MUTEX LOCK
+        QMutexLocker MutexLk(&mMutex);
+
+        if(!mOpened || FromIn > ToIn) return (0);
+
+        Path      = mDir;
+        PartStart = mPartStart;
+        OpenIndex = mMapIndex.value(Key);
+        if(mMapOpen.contains(Key)) Open = mMapOpen.value(Key);
+//MUTEX UNLOCK
+    }
+
+    QDir Dir(Path);
+    QFileInfoList ListFiles = Dir.entryInfoList(QStringList() << (QString("*") + SUFFIX__DATA), QDir::Files, QDir::Name);
+    QList<qint64> ListStarts;
+    QDateTime Stamp;
+
+    for(i=0; i<ListFiles.size(); i++)
+    {
+        Stamp = QDateTime::fromString(ListFiles.at(i).completeBaseName(), QString("yyyyMMddHH"));
+        Stamp.setTimeSpec(Qt::UTC);
+        ListStarts.append(((Stamp.isValid()) ? Stamp.toMSecsSinceEpoch() : -1));
+    }
+
+    for(i=0; i<ListFiles.size(); i++)
+    {
+        qint64 Start = ListStarts.at(i);
+        qint64 End   = ((i+1 < ListStarts.size()) ? ListStarts.at(i+1) : ToIn+1);
+
+        if(Start < 0 || Start > ToIn || End <= FromIn) continue;
+
+        //a partition opened after the copy has only samples newer than the copy
+        if(PartStart >= 0 && Start > PartStart) continue;
+
+        QVector<ArhStoreIndex> ListIndex;
+
+        if(Start == PartStart)
+        {
+            ListIndex = OpenIndex;
+        }
+        else
+        {
+            QString PathIndex = ListFiles.at(i).absolutePath() + QString("/") + ListFiles.at(i).completeBaseName() + SUFFIX__INDEX;
+            readIndex(PathIndex, Key, ListIndex);
+        }
+
+        QVector<ArhStoreIndex> ListSelected;
+
+        for(j=0; j<ListIndex.size(); j++)
+        {
+            if(ListIndex.at(j).mLast >= FromIn && ListIndex.at(j).mFirst <= ToIn) ListSelected.append(ListIndex.at(j));
+        }
+
+        if(!ListSelected.isEmpty())
+        {
+            ListPaths.append(ListFiles.at(i).absoluteFilePath());
+            ListParts.append(ListSelected);
+        }
+    }
+
+    for(i=0; i<ListPaths.size(); i++)
+    {
+        QFile File(ListPaths.at(i));
+        if(!File.open(QIODevice::ReadOnly)) continue;
+
+        for(j=0; j<ListParts.at(i).size(); j++)
+        {
+            if(!scanBlock(File, ListParts.at(i).at(j), FromIn, ToIn, VisitorIn, Count)) return (Count);
+        }
+    }
+
+    if(Open.size() > 0 && Open.getLast() >= FromIn && Open.getFirst() <= ToIn)
+    {
+        scanEncoder(Open, FromIn, ToIn, VisitorIn, Count);
+    }
+
+    return (Count);
+}
+
+
+/**
+@brief  Get size of the store on disk.
+@param  None.
+@return Size (bytes).
+*/
+qint64 ArhStore::size()
+{
+    qint64 Res = 0;
+    QString Path;
+
+    {
+//MUTEX LOCK
+        QMutexLocker MutexLk(&mMutex);
+        Path = mDir;
+//MUTEX UNLOCK
+    }
+
+    if(Path.isEmpty()) return (0);
+
+    QDir Dir(Path);
+    QFileInfoList ListFiles = Dir.entryInfoList(QStringList() << (QString("*") + SUFFIX__DATA) << (QString("*") + SUFFIX__INDEX), QDir::Files);
+
+    for(int i=0; i<ListFiles.size(); i++) Res+= ListFiles.at(i).size();
+
+    return (Res);
+}
+
+
+/**
+@brief (static) Benchmark of the store.
+@param  DirIn - path to an empty directory;
+@param  TagsIn - the number of tags;
+@param  SamplesIn - the number of samples of each tag (1 sec step).
+@return None.
+@details Write throughput and bytes per sample are printed into stdout.
+*/
+void ArhStore::bench(const QString &DirIn, int TagsIn, int SamplesIn)
+{
+    if(TagsIn < 1) TagsIn = 1;
+    if(TagsIn > 65535) TagsIn = 65535;
+    if(SamplesIn < 1) SamplesIn = 1;
+
+    ArhStore Store;
+
+    if(!Store.open(DirIn, 24, 256))
+    {
+        std::cout << "Error open store: " << DirIn.toStdString() << std::endl;
+        return;
+    }
+
+    //values like of registers: random walk rounded to 0.1, a value is changed in 1/4 of cycles
+    QVector<qint32> ListValues(TagsIn, 200);
+    qint64 Start  = (QDateTime::currentMSecsSinceEpoch()/1000)*1000;
+    quint32 Seed  = 1;
+    qint64 Stamp;
+    int s, t;
+
+    QElapsedTimer Timer;
+    Timer.start();
+
+    for(s=0; s<SamplesIn; s++)
+    {
+        for(t=0; t<TagsIn; t++)
+        {
+            Seed = Seed*1103515245u + 12345u;
+            if(((Seed >> 16) & 3) == 0) ListValues[t]+= static_cast<qint32>((Seed >> 20) % 3) - 1;
+
+            Stamp = Start + static_cast<qint64>(s)*1000 + static_cast<qint64>((Seed >> 24) % 3);
+            Store.append(static_cast<quint16>(1 + t/256), static_cast<quint16>(1 + t%256), Stamp, static_cast<double>(ListValues.at(t))/10.0, -1, 0, 0);
+        }
+    }
+
+    Store.close();
+
+    qint64 Nsec    = Timer.nsecsElapsed();
+    qint64 Samples = static_cast<qint64>(TagsIn)*static_cast<qint64>(SamplesIn);
+    qint64 Bytes   = Store.size();
+
+    //read one tag back
+    Store.open(DirIn, 24, 256);
+    Timer.restart();
+    qint64 Read = Store.scan(1, 1, Start, Start + static_cast<qint64>(SamplesIn)*1000, [](const qint64, const double, const qint32) { return (true); });
+    qint64 NsecRead = Timer.nsecsElapsed();
+    Store.close();
+
+    std::cout << "ArhStore::bench()" << std::endl;
+    std::cout << " - Tags = " << TagsIn << std::endl;
+    std::cout << " - Samples = " << Samples << std::endl;
+    std::cout << " - Write = " << (Nsec/1000000) << " msec" << std::endl;
+    std::cout << " - Write throughput = " << static_cast<qint64>((Nsec > 0) ? (static_cast<double>(Samples)*1e9/static_cast<double>(Nsec)) : 0) << " samples/sec" << std::endl;
+    std::cout << " - Size = " << Bytes << " bytes" << std::endl;
+    std::cout << " - Bytes per sample = " << ((Samples > 0) ? (static_cast<double>(Bytes)/static_cast<double>(Samples)) : 0.0) << std::endl;
+    std::cout << " - Scan of one tag = " << Read << " samples, " << (NsecRead/1000) << " usec" << std::endl;
+}
+
+
+/**
+@brief  Get path to a file of partition.
+@param  StartIn - start of partition (msec since epoch);
+@param  SuffixIn - suffix of file.
+@return Path.
+*/
+QString ArhStore::toPath(const qint64 StartIn, const QString &SuffixIn)
+{
+    return (QString("%1/%2%3").arg(mDir, QDateTime::fromMSecsSinceEpoch(StartIn, Qt::UTC).toString(QString("yyyyMMddHH")), SuffixIn));
+}
+
+
+/**
+@brief  Get start of partition of a stamp.
+@param  StampIn - date and time (msec since epoch).
+@return Start of partition (msec since epoch).
+*/
+qint64 ArhStore::toPartStart(const qint64 StampIn)
+{
+    qint64 Length = static_cast<qint64>(mPartition)*3600000;
+    return ((StampIn/Length)*Length);
+}
+
+
+/**
+@brief  Open the segment of partition to write.
+@param  StartIn - start of partition (msec since epoch).
+@return True if opened, otherwise - False.
+*/
+bool ArhStore::openSegment(const qint64 StartIn)
+{
+    QString Path = this->toPath(StartIn, SUFFIX__DATA);
+
+    mFile.setFileName(Path);
+    if(!mFile.open(QIODevice::ReadWrite)) return (false);
+
+    mCapacity = mFile.size();
+
+    if(mCapacity < HEADER_SIZE)
+    {
+        //new segment
+        if(!mFile.resize(GROW_SIZE))
+        {
+            mFile.close();
+            return (false);
+        }
+
+        mCapacity = GROW_SIZE;
+        mMap      = mFile.map(0, mCapacity);
+
+        if(mMap == nullptr)
+        {
+            mFile.close();
+            return (false);
+        }
+
+        qToBigEndian<quint32>(MAGIC, mMap);
+        qToBigEndian<quint16>(VERSION, mMap + 4);
+        qToBigEndian<quint16>(static_cast<quint16>(mPartition), mMap + 6);
+        qToBigEndian<quint64>(static_cast<quint64>(HEADER_SIZE), mMap + 8);
+
+        mUsed = HEADER_SIZE;
+    }
+    else
+    {
+        //existing segment: the index is rebuilt from the blocks up to the used size
+        mMap = mFile.map(0, mCapacity);
+
+        if(mMap == nullptr || qFromBigEndian<quint32>(mMap) != MAGIC || qFromBigEndian<quint16>(mMap + 4) != VERSION)
+        {
+            if(mMap != nullptr) mFile.unmap(mMap);
+            mMap = nullptr;
+            mFile.close();
+            return (false);
+        }
+
+        qint64 Used = static_cast<qint64>(qFromBigEndian<quint64>(mMap + 8));
+        if(Used < HEADER_SIZE || Used > mCapacity) Used = mCapacity;
+
+        ArhStoreIndex Index;
+        qint64 Pos = HEADER_SIZE;
+        qint64 Size;
+        const uchar *Block;
+
+        while(Pos + BLOCK_HEADER_SIZE <= Used)
+        {
+            Block = mMap + Pos;
+
+            Index.mKey    = qFromBigEndian<quint32>(Block);
+            Index.mCount  = qFromBigEndian<quint32>(Block + 4);
+            Index.mFirst  = static_cast<qint64>(qFromBigEndian<quint64>(Block + 8));
+            Index.mLast   = static_cast<qint64>(qFromBigEndian<quint64>(Block + 16));
+            Index.mOffset = Pos;
+
+            Size = BLOCK_HEADER_SIZE + static_cast<qint64>(qFromBigEndian<quint32>(Block + 24)) + static_cast<qint64>(qFromBigEndian<quint32>(Block + 28)) + static_cast<qint64>(qFromBigEndian<quint32>(Block + 32));
+
+            if(Index.mCount == 0 || Index.mFirst > Index.mLast || Pos + Size > Used) break;
+
+            mMapIndex[Index.mKey].append(Index);
+            Pos+= Size;
+        }
+
+        mUsed = Pos;
+        qToBigEndian<quint64>(static_cast<quint64>(mUsed), mMap + 8);
+    }
+
+    //index of the segment
+    QSaveFile IndexFile(this->toPath(StartIn, SUFFIX__INDEX));
+
+    if(IndexFile.open(QIODevice::WriteOnly))
+    {
+        uchar Buff[INDEX_SIZE];
+        QHash<quint32, QVector<ArhStoreIndex> >::const_iterator It;
+
+        for(It = mMapIndex.constBegin(); It != mMapIndex.constEnd(); ++It)
+        {
+            for(int i=0; i<It.value().size(); i++)
+            {
+                packIndex(It.value().at(i), Buff);
+                IndexFile.write(reinterpret_cast<const char *>(Buff), INDEX_SIZE);
+            }
+        }
+
+        IndexFile.commit();
+    }
+
+    mIndexFile.setFileName(this->toPath(StartIn, SUFFIX__INDEX));
+    mIndexFile.open(QIODevice::WriteOnly | QIODevice::Append);
+
+    mPartStart = StartIn;
+
+    return (true);
+}
+
+
+/**
+@brief  Close the segment being written.
+@param  None.
+@return None.
+*/
+void ArhStore::closeSegment()
+{
+    if(mMap != nullptr)
+    {
+        qToBigEndian<quint64>(static_cast<quint64>(mUsed), mMap + 8);
+        mFile.unmap(mMap);
+        mMap = nullptr;
+    }
+
+    if(mFile.isOpen())
+    {
+        if(mUsed >= HEADER_SIZE) mFile.resize(mUsed);
+        mFile.close();
+    }
+
+    if(mIndexFile.isOpen()) mIndexFile.close();
+
+    mMapIndex.clear();
+    mPartStart = -1;
+    mCapacity  = 0;
+    mUsed      = 0;
+}
+
+
+/**
+@brief  Grow the segment being written.
+@param  NeedIn - required free space (bytes).
+@return True if OK, otherwise - False.
+*/
+bool ArhStore::growSegment(const qint64 NeedIn)
+{
+    if(mCapacity - mUsed >= NeedIn) return (mMap != nullptr);
+
+    qint64 Capacity = mCapacity;
+    while(Capacity - mUsed < NeedIn) Capacity+= GROW_SIZE;
+
+    if(mMap != nullptr) mFile.unmap(mMap);
+    mMap = nullptr;
+
+    if(mFile.resize(Capacity)) mCapacity = Capacity;
+
+    mMap = mFile.map(0, mCapacity);
+
+    return ((mMap != nullptr && mCapacity - mUsed >= NeedIn) ? true : false);
+}
+
+
+/**
+@brief  Write a block into the segment.
+@param  KeyIn - key of tag;
+@param  EncIn - encoded block.
+@return True if written, otherwise - False.
+*/
+bool ArhStore::writeBlock(const quint32 KeyIn, const ArhEncoder &EncIn)
+{
+    if(EncIn.size() == 0) return (false);
+
+    const QByteArray &Stamps = EncIn.getStamps();
+    const QByteArray &Values = EncIn.getValues();
+    const QByteArray &Status = EncIn.getStatus();
+
+    qint64 Size = BLOCK_HEADER_SIZE + EncIn.getBytes();
+    if(!this->growSegment(Size)) return (false);
+
+    QByteArray Payload;
+    Payload.reserve(EncIn.getBytes());
+    Payload.append(Stamps);
+    Payload.append(Values);
+    Payload.append(Status);
+
+    ArhStoreIndex Index;
+    Index.mKey    = KeyIn;
+    Index.mCount  = static_cast<quint32>(EncIn.size());
+    Index.mFirst  = EncIn.getFirst();
+    Index.mLast   = EncIn.getLast();
+    Index.mOffset = mUsed;
+
+    uchar *Block = mMap + mUsed;
+    qToBigEndian<quint32>(Index.mKey, Block);
+    qToBigEndian<quint32>(Index.mCount, Block + 4);
+    qToBigEndian<quint64>(static_cast<quint64>(Index.mFirst), Block + 8);
+    qToBigEndian<quint64>(static_cast<quint64>(Index.mLast), Block + 16);
+    qToBigEndian<quint32>(static_cast<quint32>(Stamps.size()), Block + 24);
+    qToBigEndian<quint32>(static_cast<quint32>(Values.size()), Block + 28);
+    qToBigEndian<quint32>(static_cast<quint32>(Status.size()), Block + 32);
+    qToBigEndian<quint32>(crc32(Payload), Block + 36);
+    std::memcpy(Block + BLOCK_HEADER_SIZE, Payload.constData(), static_cast<size_t>(Payload.size()));
+
+    //the used size is moved after the block is complete
+    mUsed+= Size;
+    qToBigEndian<quint64>(static_cast<quint64>(mUsed), mMap + 8);
+
+    uchar Buff[INDEX_SIZE];
+    packIndex(Index, Buff);
+    mIndexFile.write(reinterpret_cast<const char *>(Buff), INDEX_SIZE);
+
+    mMapIndex[KeyIn].append(Index);
+
+    return (true);
+}
+
+
+/**
+@brief  Write all open blocks (without lock).
+@param  None.
+@return The number of written blocks.
+*/
+int ArhStore::flushBlocks()
+{
+    int Res = 0;
+    QHash<quint32, ArhEncoder>::iterator It;
+
+    for(It = mMapOpen.begin(); It != mMapOpen.end(); ++It)
+    {
+        if(It.value().size() > 0)
+        {
+            if(this->writeBlock(It.key(), It.value())) Res++;
+            It.value().clear();
+        }
+    }
+
+    if(mIndexFile.isOpen()) mIndexFile.flush();
+
+    return (Res);
+}
+
+
+/**
+@brief  Read a block from a segment and visit its samples.
+@param  FileIn - opened segment;
+@param  IndexIn - entry of index;
+@param  FromIn, ToIn - range (msec since epoch);
+@param  VisitorIn - visitor;
+@param  CountIn - link to the number of visited samples.
+@return False if the visitor has stopped reading, otherwise - True.
+*/
+bool ArhStore::scanBlock(QFile &FileIn, const ArhStoreIndex &IndexIn, const qint64 FromIn, const qint64 ToIn, const ArhStoreVisitor &VisitorIn, qint64 &CountIn)
+{
+    if(!FileIn.seek(IndexIn.mOffset)) return (true);
+
+    QByteArray Header = FileIn.read(BLOCK_HEADER_SIZE);
+    if(Header.size() != BLOCK_HEADER_SIZE) return (true);
+
+    const uchar *Head = reinterpret_cast<const uchar *>(Header.constData());
+    if(qFromBigEndian<quint32>(Head) != IndexIn.mKey) return (true);
+
+    quint32 SizeStamps = qFromBigEndian<quint32>(Head + 24);
+    quint32 SizeValues = qFromBigEndian<quint32>(Head + 28);
+    quint32 SizeStatus = qFromBigEndian<quint32>(Head + 32);
+    qint64 Size        = static_cast<qint64>(SizeStamps) + static_cast<qint64>(SizeValues) + static_cast<qint64>(SizeStatus);
+
+    QByteArray Payload = FileIn.read(Size);
+    if(Payload.size() != Size || crc32(Payload) != qFromBigEndian<quint32>(Head + 36)) return (true);
+
+    const uchar *Data = reinterpret_cast<const uchar *>(Payload.constData());
+    ArhDecoder Dec(static_cast<int>(IndexIn.mCount), IndexIn.mFirst, Data, SizeStamps, Data + SizeStamps, SizeValues, Data + SizeStamps + SizeValues, SizeStatus);
+
+    qint64 Stamp;
+    double Value;
+    qint32 Ex, Err, Sign;
+
+    while(Dec.next(Stamp, Value, Ex, Err, Sign))
+    {
+        if(Stamp > ToIn) break;
+
+        if(Stamp >= FromIn)
+        {
+            CountIn++;
+            if(!VisitorIn(Stamp, Value, Err)) return (false);
+        }
+    }
+
+    return (true);
+}
+
+
+/**
+@brief  Visit samples of an encoded block.
+@param  EncIn - encoded block;
+@param  FromIn, ToIn - range (msec since epoch);
+@param  VisitorIn - visitor;
+@param  CountIn - link to the number of visited samples.
+@return False if the visitor has stopped reading, otherwise - True.
+*/
+bool ArhStore::scanEncoder(const ArhEncoder &EncIn, const qint64 FromIn, const qint64 ToIn, const ArhStoreVisitor &VisitorIn, qint64 &CountIn)
+{
+    const QByteArray &Stamps = EncIn.getStamps();
+    const QByteArray &Values = EncIn.getValues();
+    const QByteArray &Status = EncIn.getStatus();
+
+    ArhDecoder Dec(EncIn.size(), EncIn.getFirst(),
+                   reinterpret_cast<const uchar *>(Stamps.constData()), Stamps.size(),
+                   reinterpret_cast<const uchar *>(Values.constData()), Values.size(),
+                   reinterpret_cast<const uchar *>(Status.constData()), Status.size());
+
+    qint64 Stamp;
+    double Value;
+    qint32 Ex, Err, Sign;
+
+    while(Dec.next(Stamp, Value, Ex, Err, Sign))
+    {
+        if(Stamp > ToIn) break;
+
+        if(Stamp >= FromIn)
+        {
+            CountIn++;
+            if(!VisitorIn(Stamp, Value, Err)) return (false);
+        }
+    }
+
+    return (true);
+}
+
+
+/**
+@brief  Read index of a partition.
+@param  PathIn - path to file of index;
+@param  KeyIn - key of tag;
+@param  ListIndexIn - link to list of entries.
+@return The number of read entries.
+*/
+int ArhStore::readIndex(const QString &PathIn, const quint32 KeyIn, QVector<ArhStoreIndex> &ListIndexIn)
+{
+    QFile File(PathIn);
+    if(!File.open(QIODevice::ReadOnly)) return (0);
+
+    int Res = 0;
+    ArhStoreIndex Index;
+    QByteArray Data;
+    const uchar *Entry;
+
+    //the index is read by chunks, the index of a large partition is never loaded at once
+    while(!(Data = File.read(INDEX_SIZE*4096)).isEmpty())
+    {
+        for(int Pos=0; Pos + INDEX_SIZE <= Data.size(); Pos+= INDEX_SIZE)
+        {
+            Entry = reinterpret_cast<const uchar *>(Data.constData()) + Pos;
+
+            if(qFromBigEndian<quint32>(Entry) == KeyIn)
+            {
+                Index.mKey    = KeyIn;
+                Index.mCount  = qFromBigEndian<quint32>(Entry + 4);
+                Index.mFirst  = static_cast<qint64>(qFromBigEndian<quint64>(Entry + 8));
+                Index.mLast   = static_cast<qint64>(qFromBigEndian<quint64>(Entry + 16));
+                Index.mOffset = static_cast<qint64>(qFromBigEndian<quint64>(Entry + 24));
+
+                ListIndexIn.append(Index);
+                Res++;
+            }
+        }
+    }
+
+    return (Res);
+}
+
+
+/**
+@brief  Pack an entry of index.
+@param  IndexIn - entry;
+@param  BuffIn - buffer (INDEX_SIZE bytes).
+@return None.
+*/
+void ArhStore::packIndex(const ArhStoreIndex &IndexIn, uchar *BuffIn)
+{
+    qToBigEndian<quint32>(IndexIn.mKey, BuffIn);
+    qToBigEndian<quint32>(IndexIn.mCount, BuffIn + 4);
+    qToBigEndian<quint64>(static_cast<quint64>(IndexIn.mFirst), BuffIn + 8);
+    qToBigEndian<quint64>(static_cast<quint64>(IndexIn.mLast), BuffIn + 16);
+    qToBigEndian<quint64>(static_cast<quint64>(IndexIn.mOffset), BuffIn + 24);
+}
@@ -0,0 +1,386 @@
+/* Copyright (C) 2019 ATgroup09
+*  Contact: atgroup09@gmail.com
+*
+*  This file is part of the HMI server component.
+*
+*  The code in this page is free software: you can
+*  redistribute it and/or modify it under the terms of the GNU
+*  General Public License (GNU GPL) as published by the Free Software
+*  Foundation, either version 3 of the License, or (at your option)
+*  any later version.  The code is distributed WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS
+*  FOR A PARTICULAR PURPOSE.  See the GNU GPL for more details.
+*
+*  As additional permission under GNU GPL version 3 section 7, you
+*  may distribute non-source (e.g., minimized or compacted) forms of
+*  that code without the copy of the GNU GPL normally required by
+*  section 4, provided you include this license notice and a URL
+*  through which recipients can access the Corresponding Source.
+*/
+
+#ifndef ARH_STORE_H
+#define ARH_STORE_H
+
+#include <iostream>
+#include <functional>
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QVector>
+#include <QHash>
+#include <QFile>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QtEndian>
+
+#include "arh-codec.h"
+#include "bit.h"
+
+
+/**
+@brief Entry of sparse time index (one entry per block).
+*/
+class ArhStoreIndex
+{
+public:
+
+    /**
+    @brief Key of tag (DevID << 16 | RegID).
+    */
+    quint32 mKey;
+
+    /**
+    @brief The number of samples of the block.
+    */
+    quint32 mCount;
+
+    /**
+    @brief The first and the last stamps of the block (msec since epoch).
+    */
+    qint64 mFirst;
+    qint64 mLast;
+
+    /**
+    @brief Offset of the block in the segment.
+    */
+    qint64 mOffset;
+};
+
+
+/**
+@brief Visitor of samples read from the store.
+@details Arguments: stamp (msec since epoch), value, error code; return false to stop reading.
+*/
+typedef std::function<bool (const qint64, const double, const qint32)> ArhStoreVisitor;
+
+
+/**
+@brief Embedded append-only columnar time-series store of archive.
+@details One segment per time partition (Dir/yyyyMMddHH.tsd, UTC start of the partition):
+            segment = [MAGIC:4][VERSION:2][Hours:2][Used:8] { block } ...
+            block   = [Key:4][Count:4][First:8][Last:8][SizeStamps:4][SizeValues:4][SizeStatus:4][CRC-32:4]
+                      [stamps][values][status]
+         The columns of a block are compressed by ArhEncoder (delta-of-delta stamps, XOR values).
+         The segment being written is memory-mapped and grown by GROW_SIZE, it is truncated on close.
+         Sparse time index (one ArhStoreIndex per block) is kept in Dir/yyyyMMddHH.tsi,
+         the index of the current segment is rebuilt from the blocks on open.
+         Samples of a tag are collected in an open block until it has mBlock samples.
+         Is written by the thread of Archive, read (scan) from any thread.
+*/
+class ArhStore : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /**
+    @brief  Constructor.
+    @param  None.
+    @return None.
+    */
+    explicit ArhStore(QObject *parent = nullptr);
+
+    /**
+    @brief  Destructor.
+    @param  None.
+    @return None.
+    */
+    virtual ~ArhStore();
+
+
+    /**
+    Public constants
+    */
+
+    /**
+    @brief Format of segment
+    */
+    static const quint32 MAGIC             = 0x57535453;
+    static const quint16 VERSION           = 1;
+    static const qint64  HEADER_SIZE       = 16;
+    static const qint64  BLOCK_HEADER_SIZE = 40;
+    static const qint64  INDEX_SIZE        = 32;
+
+    /**
+    @brief Step of growth of the segment being written (bytes)
+    */
+    static const qint64 GROW_SIZE = 16777216;
+
+    /**
+    @brief Suffixes of files
+    */
+    static const QString SUFFIX__DATA;
+    static const QString SUFFIX__INDEX;
+
+
+    /**
+    Public methods
+    */
+
+    /**
+    @brief  Open the store.
+    @param  DirIn - path to directory of the store;
+    @param  PartitionIn - length of time partition (hours);
+    @param  BlockIn - the number of samples of one block.
+    @return True if opened, otherwise - False.
+    */
+    bool open(const QString &DirIn, int PartitionIn, int BlockIn);
+
+    /**
+    @brief  Close the store.
+    @param  None.
+    @return None.
+    @details Open blocks are written.
+    */
+    void close();
+
+    /**
+    @brief  Check the store is opened.
+    @param  None.
+    @return True if opened, otherwise - False.
+    */
+    bool isOpened();
+
+    /**
+    @brief  Append a sample.
+    @param  DevIdIn - device ID;
+    @param  RegIdIn - register ID;
+    @param  StampIn - date and time (msec since epoch);
+    @param  ValueIn - value;
+    @param  ExIn - exception code;
+    @param  ErrIn - error code;
+    @param  SignIn - sign code.
+    @return True if appended, otherwise - False.
+    */
+    bool append(const quint16 DevIdIn, const quint16 RegIdIn, const qint64 StampIn, const double ValueIn, const qint32 ExIn, const qint32 ErrIn, const qint32 SignIn);
+
+    /**
+    @brief  Write all open blocks.
+    @param  None.
+    @return The number of written blocks.
+    */
+    int flush();
+
+    /**
+    @brief  Read samples of a tag.
+    @param  DevIdIn - device ID;
+    @param  RegIdIn - register ID;
+    @param  FromIn - start of the range (msec since epoch);
+    @param  ToIn - end of the range (msec since epoch, inclusive);
+    @param  VisitorIn - visitor of samples.
+    @return The number of visited samples.
+    @details Samples are visited in time order, block by block (the range is never loaded at once).
+             Open blocks are visited too.
+    */
+    qint64 scan(const quint16 DevIdIn, const quint16 RegIdIn, const qint64 FromIn, const qint64 ToIn, const ArhStoreVisitor &VisitorIn);
+
+    /**
+    @brief  Get size of the store on disk.
+    @param  None.
+    @return Size (bytes).
+    */
+    qint64 size();
+
+    /**
+    @brief (static) Benchmark of the store.
+    @param  DirIn - path to an empty directory;
+    @param  TagsIn - the number of tags;
+    @param  SamplesIn - the number of samples of each tag (1 sec step).
+    @return None.
+    @details Write throughput and bytes per sample are printed into stdout.
+    */
+    static void bench(const QString &DirIn, int TagsIn, int SamplesIn);
+
+
+private:
+
+    /**
+    Private options
+    */
+
+    /**
+    @brief Mutex.
+    */
+    QMutex mMutex;
+
+    /**
+    @brief Path to directory.
+    */
+    QString mDir;
+
+    /**
+    @brief Length of time partition (hours).
+    */
+    int mPartition;
+
+    /**
+    @brief The number of samples of one block.
+    */
+    int mBlock;
+
+    /**
+    @brief The store is opened.
+    */
+    bool mOpened;
+
+    /**
+    @brief Start of the current partition (msec since epoch, -1 if no segment is opened).
+    */
+    qint64 mPartStart;
+
+    /**
+    @brief Segment being written.
+    */
+    QFile mFile;
+
+    /**
+    @brief Mapping of the segment being written.
+    */
+    uchar *mMap;
+
+    /**
+    @brief Size of the file of the segment (bytes).
+    */
+    qint64 mCapacity;
+
+    /**
+    @brief Used size of the segment (bytes).
+    */
+    qint64 mUsed;
+
+    /**
+    @brief Index of the segment being written.
+    */
+    QFile mIndexFile;
+
+    /**
+    @brief Index of the segment being written (by keys).
+    */
+    QHash<quint32, QVector<ArhStoreIndex> > mMapIndex;
+
+    /**
+    @brief Open blocks (by keys).
+    */
+    QHash<quint32, ArhEncoder> mMapOpen;
+
+
+    /**
+    Private methods
+    */
+
+    /**
+    @brief  Get path to a file of partition.
+    @param  StartIn - start of partition (msec since epoch);
+    @param  SuffixIn - suffix of file.
+    @return Path.
+    */
+    QString toPath(const qint64 StartIn, const QString &SuffixIn);
+
+    /**
+    @brief  Get start of partition of a stamp.
+    @param  StampIn - date and time (msec since epoch).
+    @return Start of partition (msec since epoch).
+    */
+    qint64 toPartStart(const qint64 StampIn);
+
+    /**
+    @brief  Open the segment of partition to write.
+    @param  StartIn - start of partition (msec since epoch).
+    @return True if opened, otherwise - False.
+    */
+    bool openSegment(const qint64 StartIn);
+
+    /**
+    @brief  Close the segment being written.
+    @param  None.
+    @return None.
+    */
+    void closeSegment();
+
+    /**
+    @brief  Grow the segment being written.
+    @param  NeedIn - required free space (bytes).
+    @return True if OK, otherwise - False.
+    */
+    bool growSegment(const qint64 NeedIn);
+
+    /**
+    @brief  Write a block into the segment.
+    @param  KeyIn - key of tag;
+    @param  EncIn - encoded block.
+    @return True if written, otherwise - False.
+    */
+    bool writeBlock(const quint32 KeyIn, const ArhEncoder &EncIn);
+
+    /**
+    @brief  Write all open blocks (without lock).
+    @param  None.
+    @return The number of written blocks.
+    */
+    int flushBlocks();
+
+    /**
+    @brief  Read a block from a segment and visit its samples.
+    @param  FileIn - opened segment;
+    @param  IndexIn - entry of index;
+    @param  FromIn, ToIn - range (msec since epoch);
+    @param  VisitorIn - visitor;
+    @param  CountIn - link to the number of visited samples.
+    @return False if the visitor has stopped reading, otherwise - True.
+    */
+    static bool scanBlock(QFile &FileIn, const ArhStoreIndex &IndexIn, const qint64 FromIn, const qint64 ToIn, const ArhStoreVisitor &VisitorIn, qint64 &CountIn);
+
+    /**
+    @brief  Visit samples of an encoded block.
+    @param  EncIn - encoded block;
+    @param  FromIn, ToIn - range (msec since epoch);
+    @param  VisitorIn - visitor;
+    @param  CountIn - link to the number of visited samples.
+    @return False if the visitor has stopped reading, otherwise - True.
+    */
+    static bool scanEncoder(const ArhEncoder &EncIn, const qint64 FromIn, const qint64 ToIn, const ArhStoreVisitor &VisitorIn, qint64 &CountIn);
+
+    /**
+    @brief  Read index of a partition.
+    @param  PathIn - path to file of index;
+    @param  KeyIn - key of tag;
+    @param  ListIndexIn - link to list of entries.
+    @return The number of read entries.
+    */
+    static int readIndex(const QString &PathIn, const quint32 KeyIn, QVector<ArhStoreIndex> &ListIndexIn);
+
+    /**
+    @brief  Pack an entry of index.
+    @param  IndexIn - entry;
+    @param  BuffIn - buffer (INDEX_SIZE bytes).
+    @return None.
+    */
+    static void packIndex(const ArhStoreIndex &IndexIn, uchar *BuffIn);
+};
+
+#endif // ARH_STORE_H
@@ -35,10 +35,37 @@ const QString Archive::FIELD__USE_LOG_EVENT  = "UseLogEvent";
 const QString Archive::FIELD__FILE_LOG       = "Log";
 const QString Archive::FIELD__FILE_LOG_EVENT = "LogEvent";
 const QString Archive::FIELD__MODE           = "Mode";
+const QString Archive::FIELD__KEEPALIVE      = "Keepalive";
+const QString Archive::FIELD__RECONNECT_MIN  = "ReconnectMin";
+const QString Archive::FIELD__RECONNECT_MAX  = "ReconnectMax";
+const QString Archive::FIELD__USE_STMT       = "UseStmt";
+const QString Archive::FIELD__USE_TRANS      = "UseTrans";
+const QString Archive::FIELD__USE_INFILE     = "UseInfile";
+const QString Archive::FIELD__TRANS_ROWS     = "TransRows";
+const QString Archive::FIELD__TRANS_RETRY    = "TransRetry";
+const QString Archive::FIELD__SPOOL          = "Spool";
+const QString Archive::FIELD__SPOOL_MAX_SIZE = "SpoolMaxSize";
+const QString Archive::FIELD__SPOOL_SEGMENT  = "SpoolSegment";
+const QString Archive::FIELD__SPOOL_RATE     = "SpoolRate";
+const QString Archive::FIELD__SPOOL_TIMEOUT  = "SpoolTimeout";
+const QString Archive::FIELD__AGGREGATE      = "Aggregate";
+const QString Archive::FIELD__STORE          = "Store";
+const QString Archive::FIELD__STORE_PART     = "StorePartition";
+const QString Archive::FIELD__STORE_BLOCK    = "StoreBlock";
+const QString Archive::FIELD__STORE_FLUSH    = "StoreFlush";
+const QString Archive::FIELD__DRIVER         = "Driver";
+const QString Archive::FIELD__CHECKPOINT     = "Checkpoint";
+const QString Archive::FIELD__PROFILES       = "Profiles";
+const QString Archive::FIELD__RETENTION      = "Retention";
+const QString Archive::FIELD__RETENTION_CHUNK = "RetentionChunk";
+const QString Archive::FIELD__RETENTION_PARTS = "RetentionPartitions";
+const QString Archive::FIELD__ROLLUP         = "Rollup";
+const QString Archive::FIELD__ROLLUP_RETENTION = "RollupRetention";
 
 /**
 @brief Named profiles
 */
+const QString Archive::PROFILE__1SEC         = "1sec";
 const QString Archive::PROFILE__1MIN         = "1min";
 const QString Archive::PROFILE__5MIN         = "5min";
 const QString Archive::PROFILE__15MIN        = "15min";
@@ -51,6 +78,21 @@ const QString Archive::PROFILE__EVENT        = "event";
 */
 const QString Archive::DEFAUL__HOST          = "localhost";
 
+/**
+@brief Drivers of DB
+*/
+const QString Archive::DRIVER__MYSQL         = "mysql";
+const QString Archive::DRIVER__SQLITE        = "sqlite";
+
+
+#ifdef WITH_SQLITE
+/**
+@brief SQLite DB files that have the background checkpoint.
+*/
+QSet<QString> Archive::mCkptFiles;
+QMutex Archive::mCkptMutex;
+#endif
+
 
 /**
 @brief  Constructor.
@@ -64,15 +106,72 @@ Archive::Archive(QList<Network *> *ListNetworksIn, quint8 ModeIn, QObject *paren
     mUser         = QString("");
     mPasswd       = QString("");
     mDb           = QString("");
+    mDriver       = DRIVER__MYSQL;
+    mCheckpoint   = DEFAUL__CHECKPOINT;
     mProfile      = QString("");
     mUseLog       = false;
     mFileLog      = QString("");
     mMode         = ((ModeIn == MODE__EVENT) ? MODE__EVENT : MODE__PERIODIC);
+    mIndex        = 0;
     mListNetworks = ListNetworksIn;
+    mKeepalive    = DEFAUL__KEEPALIVE;
+    mReconnectMin = DEFAUL__RECONNECT_MIN;
+    mReconnectMax = DEFAUL__RECONNECT_MAX;
+    mUseStmt      = true;
+    mUseTrans     = false;
+    mUseInfile    = false;
+    mInfileRefused = false;
+    mTransRows    = DEFAUL__TRANS_ROWS;
+    mTransRetry   = DEFAUL__TRANS_RETRY;
+    mSpoolDir     = QString("");
+    mSpoolMaxSize = DEFAUL__SPOOL_MAX_SIZE;
+    mSpoolSegment = DEFAUL__SPOOL_SEGMENT;
+    mSpoolRate    = DEFAUL__SPOOL_RATE;
+    mSpoolTimeout = DEFAUL__SPOOL_TIMEOUT;
+    mAggregate    = 0;
+
+    mStoreDir       = QString("");
+    mStorePartition = DEFAUL__STORE_PARTITION;
+    mStoreBlock     = DEFAUL__STORE_BLOCK;
+    mStoreFlush     = DEFAUL__STORE_FLUSH;
+
+    mReconnectDelay = 0;
+    mReconnectAt    = 0;
+    mAggrVersion    = 0;
+    mStoreFlushAt   = 0;
+    mCompInited     = false;
+
+    mDbCli = new HelperMySQL(this);
+
+#ifdef WITH_SQLITE
+    mLiteCli    = new HelperSQLite(this);
+    mCkpt       = nullptr;
+    mCkptThread = nullptr;
+#endif
 
     mTimer = new QTimer(this);
     connect(mTimer, &QTimer::timeout, this, &Archive::save);
     connect(this, &Archive::sigCompleted, this, &Archive::start);
+
+    mKeepTimer = new QTimer(this);
+    connect(mKeepTimer, &QTimer::timeout, this, &Archive::keepalive);
+
+    mSpool = new ArhSpool(this);
+
+    mStore = new ArhStore(this);
+
+    mSpoolTimer = new QTimer(this);
+    connect(mSpoolTimer, &QTimer::timeout, this, &Archive::drainSpool);
+
+    mRetention       = 0;
+    mRetentionChunk  = DEFAUL__RETENTION_CHUNK;
+    mRetentionParts  = false;
+    mRollup          = QString("");
+    mRollupProfile   = QString("");
+    mRollupRetention = 0;
+
+    mMaintTimer = new QTimer(this);
+    connect(mMaintTimer, &QTimer::timeout, this, &Archive::maintain);
 }
 
 
@@ -84,7 +183,24 @@ Archive::Archive(QList<Network *> *ListNetworksIn, quint8 ModeIn, QObject *paren
 Archive::~Archive()
 {
     this->stopTimer();
+    if(mKeepTimer->isActive()) mKeepTimer->stop();
+    if(mSpoolTimer->isActive()) mSpoolTimer->stop();
+    if(mMaintTimer->isActive()) mMaintTimer->stop();
+    this->disconnectDb();
+#ifdef WITH_SQLITE
+    this->stopCheckpoint();
+#endif
+
     delete mTimer;
+    delete mKeepTimer;
+    delete mSpoolTimer;
+    delete mMaintTimer;
+    delete mSpool;
+    delete mStore;
+    delete mDbCli;
+#ifdef WITH_SQLITE
+    delete mLiteCli;
+#endif
 }
 
 
@@ -106,6 +222,12 @@ void Archive::toString(QString &StringIn)
     StringIn+= ((mMode == MODE__EVENT) ? QString("event") : QString("periodic"));
     StringIn+= QString("\r\n");
 
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__DRIVER;
+    StringIn+= QString(" = ");
+    StringIn+= mDriver;
+    StringIn+= QString("\r\n");
+
     StringIn+= QString(" - ");
     StringIn+= FIELD__HOST;
     StringIn+= QString(" = ");
@@ -136,6 +258,12 @@ void Archive::toString(QString &StringIn)
     StringIn+= mDb;
     StringIn+= QString("\r\n");
 
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__CHECKPOINT;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(mCheckpoint);
+    StringIn+= QString("\r\n");
+
     StringIn+= QString(" - ");
     StringIn+= FIELD__PROFILE;
     StringIn+= QString(" = ");
@@ -154,21 +282,241 @@ void Archive::toString(QString &StringIn)
     StringIn+= QString(" = ");
     StringIn+= mFileLog;
     StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__KEEPALIVE;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(mKeepalive);
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__RECONNECT_MIN;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(mReconnectMin);
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__RECONNECT_MAX;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(mReconnectMax);
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__USE_STMT;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(((mUseStmt) ? 1 : 0));
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__USE_TRANS;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(((mUseTrans) ? 1 : 0));
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__USE_INFILE;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(((mUseInfile) ? 1 : 0));
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__TRANS_ROWS;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(mTransRows);
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__TRANS_RETRY;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(mTransRetry);
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__SPOOL;
+    StringIn+= QString(" = ");
+    StringIn+= mSpoolDir;
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__SPOOL_MAX_SIZE;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(mSpoolMaxSize);
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__SPOOL_SEGMENT;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(mSpoolSegment);
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__SPOOL_RATE;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(mSpoolRate);
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__SPOOL_TIMEOUT;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(mSpoolTimeout);
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__AGGREGATE;
+    StringIn+= QString(" = ");
+    StringIn+= ArhAggr::toString(mAggregate);
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__STORE;
+    StringIn+= QString(" = ");
+    StringIn+= mStoreDir;
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__STORE_PART;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(mStorePartition);
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__STORE_BLOCK;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(mStoreBlock);
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__STORE_FLUSH;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(mStoreFlush);
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__RETENTION;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(mRetention);
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__RETENTION_CHUNK;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(mRetentionChunk);
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__RETENTION_PARTS;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(((mRetentionParts) ? 1 : 0));
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__ROLLUP;
+    StringIn+= QString(" = ");
+    StringIn+= mRollup;
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__ROLLUP_RETENTION;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(mRollupRetention);
+    StringIn+= QString("\r\n");
 }
 
 
 /**
 @brief  Read configuration from a file.
-@param  FileIn - path to a file.
+@param  FileIn - path to a file;
+@param  IdxIn - index of profile (see toProfiles());
+@param  UseEventIn - the event archive is used (it writes to the DB of the common options).
 @return true if success, otherwise - false.
+@details The event archive reads the common options (Profiles are not used).
 */
-bool Archive::readFileConfig(const QString &FileIn)
+bool Archive::readFileConfig(const QString &FileIn, const int IdxIn, const bool UseEventIn)
 {
     QString Err;
     QJsonDocument Doc = Json::readFile(FileIn, Err);
     if(!Err.isEmpty()) Log::log(Err, mFileLog, mUseLog);
 
-    return (this->parseDataConfig(Doc));
+    mIndex = 0;
+
+    QList<QJsonObject> ListProfiles;
+    QJsonObject Common = Doc.object();
+
+    if(mMode == MODE__PERIODIC)
+    {
+        if(IdxIn >= 0 && IdxIn < toProfiles(Doc, ListProfiles))
+        {
+            mIndex = IdxIn;
+            Doc    = QJsonDocument(ListProfiles.at(IdxIn));
+        }
+    }
+
+    bool Res = this->parseDataConfig(Doc);
+
+    //a partition keeps the rows of all archives of the DB
+    if(mRetentionParts && !this->isPartsAllowed(Common, ListProfiles, UseEventIn))
+    {
+        LOG_WARN(QString("Partitions of %1 keep rows of other archives with a longer retention! RetentionPartitions is disabled.").arg(mDb), mFileLog, mUseLog);
+        mRetentionParts = false;
+    }
+
+    return (Res);
+}
+
+
+/**
+@brief  Get options of profiles.
+@param  DocIn - link to JsonDocument;
+@param  ListProfilesIn - link to list of options of profiles.
+@return The number of profiles.
+@details Each item of "Profiles" is merged over the common options: { ...common options..., Profiles:[ { Profile:"1min", ... }, ... ] }
+         The common options are one profile if "Profiles" is not set.
+*/
+int Archive::toProfiles(const QJsonDocument &DocIn, QList<QJsonObject> &ListProfilesIn)
+{
+    if(!DocIn.isObject()) return (0);
+
+    QJsonObject Common = DocIn.object();
+    QJsonArray Profiles = Common.value(FIELD__PROFILES).toArray();
+    Common.remove(FIELD__PROFILES);
+
+    if(Profiles.isEmpty())
+    {
+        ListProfilesIn.append(Common);
+    }
+    else
+    {
+        QJsonObject Obj, Item;
+        QJsonObject::const_iterator It;
+
+        for(int i=0; i<Profiles.size(); i++)
+        {
+            if(!Profiles.at(i).isObject()) continue;
+
+            Obj  = Common;
+            Item = Profiles.at(i).toObject();
+
+            for(It = Item.constBegin(); It != Item.constEnd(); ++It) Obj.insert(It.key(), It.value());
+
+            ListProfilesIn.append(Obj);
+        }
+    }
+
+    return (ListProfilesIn.size());
+}
+
+
+/**
+@brief  Get the number of profiles of a configuration file.
+@param  FileIn - path to a file.
+@return The number of profiles.
+*/
+int Archive::sizeProfiles(const QString &FileIn)
+{
+    QString Err;
+    QList<QJsonObject> ListProfiles;
+
+    return (toProfiles(Json::readFile(FileIn, Err), ListProfiles));
 }
 
 
@@ -190,12 +538,125 @@ bool Archive::parseDataConfig(const QJsonDocument &DocIn)
             mUser      = Obj.value(FIELD__USER).toString(QString(""));
             mPasswd    = Obj.value(FIELD__PASSWD).toString(QString(""));
             mDb        = Obj.value(FIELD__DB).toString(QString(""));
-            mProfile   = Obj.value(FIELD__PROFILE).toString(QString(""));
+            mDriver    = ((Obj.value(FIELD__DRIVER).toString(DRIVER__MYSQL) == DRIVER__SQLITE) ? DRIVER__SQLITE : DRIVER__MYSQL);
+            mCheckpoint = Obj.value(FIELD__CHECKPOINT).toInt(DEFAUL__CHECKPOINT);
+
+            if(mCheckpoint < 0) mCheckpoint = 0;
+            if(mCheckpoint > CHECKPOINT__MAX) mCheckpoint = CHECKPOINT__MAX;
+            mProfile   = ((mMode == MODE__EVENT) ? PROFILE__EVENT : Obj.value(FIELD__PROFILE).toString(QString("")));
             mFileLog   = ((mMode == MODE__EVENT) ? Obj.value(FIELD__FILE_LOG_EVENT).toString(QString("")) : Obj.value(FIELD__FILE_LOG).toString(QString("")));
 
             int Boo = ((mMode == MODE__EVENT) ? Obj.value(FIELD__USE_LOG_EVENT).toInt(0) : Obj.value(FIELD__USE_LOG).toInt(0));
             mUseLog = ((Boo) ? true : false);
 
+#ifndef WITH_SQLITE
+            //the DB is not used (see isDbAllowed)
+            if(mDriver == DRIVER__SQLITE) LOG_ERROR(QString("SQLite driver is not supported by this build (qmake CONFIG+=sqlite)! Archive to DB is disabled: %1").arg(mDb), mFileLog, mUseLog);
+#endif
+
+            mKeepalive    = Obj.value(FIELD__KEEPALIVE).toInt(DEFAUL__KEEPALIVE);
+            mReconnectMin = Obj.value(FIELD__RECONNECT_MIN).toInt(DEFAUL__RECONNECT_MIN);
+            mReconnectMax = Obj.value(FIELD__RECONNECT_MAX).toInt(DEFAUL__RECONNECT_MAX);
+
+            if(mKeepalive < 0) mKeepalive = 0;
+            if(mKeepalive > KEEPALIVE__MAX) mKeepalive = KEEPALIVE__MAX;
+            if(mReconnectMin < 1) mReconnectMin = 1;
+            if(mReconnectMax > RECONNECT__MAX_MAX) mReconnectMax = RECONNECT__MAX_MAX;
+            if(mReconnectMax < mReconnectMin) mReconnectMax = mReconnectMin;
+
+            Boo = Obj.value(FIELD__USE_STMT).toInt(1);
+            //rows of SQLite are always bound (the tables are created by the archive)
+            if(mDriver == DRIVER__SQLITE) Boo = 1;
+#ifdef SQL_PROC_TRM
+            Boo = 0;
+#endif
+            mUseStmt = ((Boo) ? true : false);
+
+            Boo = Obj.value(FIELD__USE_TRANS).toInt(0);
+            mUseTrans = ((Boo) ? true : false);
+
+            Boo = Obj.value(FIELD__USE_INFILE).toInt(0);
+            if(mDriver == DRIVER__SQLITE) Boo = 0;
+#ifdef SQL_PROC_TRM
+            Boo = 0;
+#endif
+            mUseInfile = ((Boo) ? true : false);
+            //LOAD DATA reads bound rows (not SQL-queries)
+            if(mUseInfile) mUseStmt = true;
+
+            mTransRows  = Obj.value(FIELD__TRANS_ROWS).toInt(DEFAUL__TRANS_ROWS);
+            mTransRetry = Obj.value(FIELD__TRANS_RETRY).toInt(DEFAUL__TRANS_RETRY);
+
+            if(mTransRows < 1) mTransRows = 1;
+            if(mTransRows > TRANS_ROWS__MAX) mTransRows = TRANS_ROWS__MAX;
+            if(mTransRetry < 0) mTransRetry = 0;
+            if(mTransRetry > TRANS_RETRY__MAX) mTransRetry = TRANS_RETRY__MAX;
+
+            mSpoolDir     = Obj.value(FIELD__SPOOL).toString(QString(""));
+            mSpoolMaxSize = Obj.value(FIELD__SPOOL_MAX_SIZE).toInt(DEFAUL__SPOOL_MAX_SIZE);
+            mSpoolSegment = Obj.value(FIELD__SPOOL_SEGMENT).toInt(DEFAUL__SPOOL_SEGMENT);
+            mSpoolRate    = Obj.value(FIELD__SPOOL_RATE).toInt(DEFAUL__SPOOL_RATE);
+            mSpoolTimeout = Obj.value(FIELD__SPOOL_TIMEOUT).toInt(DEFAUL__SPOOL_TIMEOUT);
+
+            if(mSpoolSegment < SPOOL_SEGMENT__MIN) mSpoolSegment = SPOOL_SEGMENT__MIN;
+            if(mSpoolMaxSize < mSpoolSegment) mSpoolMaxSize = mSpoolSegment;
+            if(mSpoolRate < SPOOL_RATE__MIN) mSpoolRate = SPOOL_RATE__MIN;
+            if(mSpoolTimeout < 0) mSpoolTimeout = 0;
+
+            //the event archive and other profiles have their own spools
+            if(!mSpoolDir.isEmpty() && mMode == MODE__EVENT) mSpoolDir+= QString("/event");
+            if(!mSpoolDir.isEmpty() && mMode == MODE__PERIODIC && mIndex > 0) mSpoolDir+= QString("/%1").arg(mProfile);
+
+            //aggregates are accumulated from snapshots (periodic mode only)
+            mAggregate = ArhAggr::toFuncs(Obj.value(FIELD__AGGREGATE).toString(QString("")));
+#ifdef SQL_PROC_TRM
+            mAggregate = 0;
+#endif
+            if(mMode == MODE__EVENT) mAggregate = 0;
+
+            //the store is written by the periodic archive of the first profile only
+            mStoreDir       = ((mMode == MODE__EVENT || mIndex > 0) ? QString("") : Obj.value(FIELD__STORE).toString(QString("")));
+            mStorePartition = Obj.value(FIELD__STORE_PART).toInt(DEFAUL__STORE_PARTITION);
+            mStoreBlock     = Obj.value(FIELD__STORE_BLOCK).toInt(DEFAUL__STORE_BLOCK);
+            mStoreFlush     = Obj.value(FIELD__STORE_FLUSH).toInt(DEFAUL__STORE_FLUSH);
+
+            if(mStorePartition < 1) mStorePartition = 1;
+            if(mStorePartition > STORE_PARTITION__MAX) mStorePartition = STORE_PARTITION__MAX;
+            if(mStoreBlock < STORE_BLOCK__MIN) mStoreBlock = STORE_BLOCK__MIN;
+            if(mStoreBlock > STORE_BLOCK__MAX) mStoreBlock = STORE_BLOCK__MAX;
+            if(mStoreFlush < 0) mStoreFlush = 0;
+
+            //the tables are maintained by the periodic archive only
+            mRetention       = ((mMode == MODE__EVENT) ? 0 : Obj.value(FIELD__RETENTION).toInt(0));
+            mRetentionChunk  = Obj.value(FIELD__RETENTION_CHUNK).toInt(DEFAUL__RETENTION_CHUNK);
+            mRollup          = Obj.value(FIELD__ROLLUP).toString(QString(""));
+            mRollupRetention = Obj.value(FIELD__ROLLUP_RETENTION).toInt(0);
+
+            Boo = Obj.value(FIELD__RETENTION_PARTS).toInt(0);
+            if(mDriver == DRIVER__SQLITE) Boo = 0;
+            mRetentionParts = ((Boo) ? true : false);
+
+            if(mRetention < 0) mRetention = 0;
+            if(mRetention > RETENTION__MAX) mRetention = RETENTION__MAX;
+            if(mRetentionChunk < RETENTION_CHUNK__MIN) mRetentionChunk = RETENTION_CHUNK__MIN;
+            if(mRetentionChunk > RETENTION_CHUNK__MAX) mRetentionChunk = RETENTION_CHUNK__MAX;
+            if(mRollupRetention < 0) mRollupRetention = 0;
+            if(mRollupRetention > RETENTION__MAX) mRollupRetention = RETENTION__MAX;
+
+            //rollup rows are averaged from the columns of the archive (are not used for SQL_PROC_TRM)
+#ifdef SQL_PROC_TRM
+            mRollup = QString("");
+#endif
+            if(!mRollup.isEmpty() && (!isCorrectProfile(mRollup) || getTimedProfile(mRollup) <= getTimedProfile(mProfile)))
+            {
+                LOG_ERROR(QString("Rollup profile (%1) must be coarser than %2! Rollup is disabled.").arg(mRollup, mProfile), mFileLog, mUseLog);
+                mRollup = QString("");
+            }
+
+            if(mRetention == 0 || mRollup.isEmpty()) mRollupRetention = 0;
+            mRollupProfile = ((mRollup.isEmpty()) ? QString("") : QString("%1.%2").arg(mProfile, mRollup));
+            if(!mRollup.isEmpty()) mRetentionParts = false;
+
             if(mUseLog)
             {
                 QString LogBuff = QString();
@@ -203,6 +664,30 @@ bool Archive::parseDataConfig(const QJsonDocument &DocIn)
                 Log::log(LogBuff, mFileLog, mUseLog);
             }
 
+            if(!mSpoolDir.isEmpty())
+            {
+                if(mSpool->open(mSpoolDir, static_cast<qint64>(mSpoolMaxSize)*1024, static_cast<qint64>(mSpoolSegment)*1024))
+                {
+                    Log::log(QString("Spool is opened: %1 (%2 bytes)").arg(mSpoolDir, QString::number(mSpool->size())), mFileLog, mUseLog);
+                }
+                else
+                {
+                    LOG_ERROR(QString("Error open spool: %1").arg(mSpoolDir), mFileLog, mUseLog);
+                }
+            }
+
+            if(!mStoreDir.isEmpty())
+            {
+                if(mStore->open(mStoreDir, mStorePartition, mStoreBlock))
+                {
+                    Log::log(QString("Store is opened: %1 (%2 bytes)").arg(mStoreDir, QString::number(mStore->size())), mFileLog, mUseLog);
+                }
+                else
+                {
+                    LOG_ERROR(QString("Error open store: %1").arg(mStoreDir), mFileLog, mUseLog);
+                }
+            }
+
             return (true);
         }
     }
@@ -218,7 +703,7 @@ bool Archive::parseDataConfig(const QJsonDocument &DocIn)
 */
 bool Archive::isCorrectProfile(const QString &ProfileIn)
 {
-    return ((ProfileIn == PROFILE__1MIN || ProfileIn == PROFILE__5MIN || ProfileIn == PROFILE__15MIN || ProfileIn == PROFILE__30MIN || ProfileIn == PROFILE__HOUR) ? true : false);
+    return ((ProfileIn == PROFILE__1SEC || ProfileIn == PROFILE__1MIN || ProfileIn == PROFILE__5MIN || ProfileIn == PROFILE__15MIN || ProfileIn == PROFILE__30MIN || ProfileIn == PROFILE__HOUR) ? true : false);
 }
 
 
@@ -229,6 +714,9 @@ bool Archive::isCorrectProfile(const QString &ProfileIn)
 */
 bool Archive::isCorrectProfile()
 {
+    //rows of events are pushed by the survey (see addEvents())
+    if(mMode == MODE__EVENT) return ((mProfile == PROFILE__EVENT) ? true : false);
+
     return (isCorrectProfile(mProfile));
 }
 
@@ -251,7 +739,11 @@ bool Archive::isCorrect()
 */
 int Archive::getTimedProfile(const QString &ProfileIn)
 {
-    if(ProfileIn == PROFILE__1MIN)
+    if(ProfileIn == PROFILE__1SEC)
+    {
+        return (PROFILE__1SEC_MSEC);
+    }
+    else if(ProfileIn == PROFILE__1MIN)
     {
         return (PROFILE__1MIN_MSEC);
     }
@@ -280,6 +772,18 @@ int Archive::getTimedProfile(const QString &ProfileIn)
 }
 
 
+/**
+@brief  Get the store.
+@param  None.
+@return Pointer to the store or nullptr if the store is not opened.
+@details The store is thread-safe: it is read by queries of history from other threads.
+*/
+ArhStore *Archive::getStore()
+{
+    return ((mStore && mStore->isOpened()) ? mStore : nullptr);
+}
+
+
 /**
 @brief  Start.
 @param  None.
@@ -296,10 +800,39 @@ void Archive::start()
     {
         Log::log(QString("Archive::start(%1 msec)").arg(QString::number(Msec)), mFileLog, mUseLog);
 
+        //settings of compression are static: they are taken once (periodic values only),
+        //start() is called again after each tick, so the state of compression is kept
+        if(!mCompInited && mMode == MODE__PERIODIC && mListNetworks != nullptr)
+        {
+            mCompInited = true;
+            for(int i=0; i<mListNetworks->size(); i++)
+            {
+                if(mListNetworks->at(i)) mListNetworks->at(i)->getArhComp(mMapComp);
+            }
+        }
+
         mTimer->setInterval(Msec);
         mTimer->setSingleShot(true);
         mTimer->start();
 
+        if(mKeepalive > 0 && !mKeepTimer->isActive() && this->isDbAllowed())
+        {
+            mKeepTimer->setInterval(mKeepalive*1000);
+            mKeepTimer->start();
+        }
+
+        if(mSpool->isOpened() && !mSpoolTimer->isActive() && this->isDbAllowed())
+        {
+            mSpoolTimer->setInterval(SPOOL__DRAIN_MSEC);
+            mSpoolTimer->start();
+        }
+
+        if(mRetention > 0 && !mMaintTimer->isActive() && this->isDbAllowed())
+        {
+            mMaintTimer->setInterval(MAINT__BUSY_MSEC);
+            mMaintTimer->start();
+        }
+
         emit sigStarted();
     }
     else
@@ -320,6 +853,16 @@ void Archive::stop()
     Log::log(QString("Archive::stop()"), mFileLog, mUseLog);
 
     this->stopTimer();
+    if(mKeepTimer->isActive()) mKeepTimer->stop();
+    if(mSpoolTimer->isActive()) mSpoolTimer->stop();
+    if(mMaintTimer->isActive()) mMaintTimer->stop();
+    this->disconnectDb();
+#ifdef WITH_SQLITE
+    this->stopCheckpoint();
+#endif
+    mSpool->close();
+    mStore->close();
+
     emit sigStopped();
 }
 
@@ -339,13 +882,16 @@ void Archive::stopTimer()
 @brief  Pack device data into SQL.
 @param  NetIn - pointer to Network;
 @param  DevIdxIn - index of device in the list of devices (0...NetIn->sizeListDevices()-1);
-@param  StringIn - link to string buffer
+@param  StringIn - link to string buffer;
+@param  RowsIn - link to the number of packed rows.
 @return true if OK, otherwise - false.
 */
-bool Archive::toSql(Network *NetIn, const int DevIdxIn, QString &StringIn)
+bool Archive::toSql(Network *NetIn, const int DevIdxIn, QString &StringIn, int &RowsIn)
 {
     bool Res = false;
 
+    RowsIn = 0;
+
     if(this->isCorrectProfile() && NetIn != nullptr)
     {
         //* list of strings of one query
@@ -356,8 +902,8 @@ bool Archive::toSql(Network *NetIn, const int DevIdxIn, QString &StringIn)
         if(!ListStrings.isEmpty())
         {
             //merge strings to one SQL and append to input string buffer
-            Device::mergeSql(ListStrings, StringIn);
-            Res = true;
+            RowsIn = Device::mergeSql(ListStrings, StringIn) - Device::SQL__HEAD_ITEMS;
+            Res    = true;
         }
     }
 
@@ -365,6 +911,86 @@ bool Archive::toSql(Network *NetIn, const int DevIdxIn, QString &StringIn)
 }
 
 
+/**
+@brief  Pack archive rows into SQL.
+@param  TableIn - name of table;
+@param  ListRowsIn - list of rows;
+@param  FromIn - index of the first row;
+@param  CountIn - the number of rows;
+@param  StringIn - link to string buffer
+@return true if OK, otherwise - false.
+*/
+bool Archive::toSql(const QString &TableIn, const QList<ArhRow> &ListRowsIn, const int FromIn, const int CountIn, QString &StringIn)
+{
+    QList<QString> ListStrings;
+    QString Str;
+
+    for(int i=FromIn; i<(FromIn+CountIn) && i<ListRowsIn.size(); i++)
+    {
+        const ArhRow &Row = ListRowsIn.at(i);
+
+        Str = QString("");
+        Register::toSqlValue(Row.mStamp, Row.mProfile, Row.mDevID, Row.mRegID, Register::toSqlNumber(Row.mValue), Row.mEx, Row.mErr, Row.mSign, Str);
+        ListStrings.append(Str);
+    }
+
+    if(!ListStrings.isEmpty())
+    {
+        ListStrings.prepend(QString(" VALUES "));
+        ListStrings.prepend(QString("(`stamp`,`profile`,`device_id`,`register_id`,`value`,`ex`,`err`,`sign`)"));
+        ListStrings.prepend(QString("INSERT INTO `%1`").arg(TableIn));
+
+        Device::mergeSql(ListStrings, StringIn);
+        return (true);
+    }
+
+    return (false);
+}
+
+
+/**
+@brief  Pack archive rows into tab-separated format of LOAD DATA.
+@param  ListRowsIn - list of rows;
+@param  FromIn - index of the first row;
+@param  CountIn - the number of rows;
+@param  DataIn - link to data buffer
+@return true if OK, otherwise - false.
+*/
+bool Archive::toInfile(const QList<ArhRow> &ListRowsIn, const int FromIn, const int CountIn, QByteArray &DataIn)
+{
+    QString Stamp, Value, Str, Profile;
+    int i;
+
+    for(i=FromIn; i<(FromIn+CountIn) && i<ListRowsIn.size(); i++)
+    {
+        const ArhRow &Row = ListRowsIn.at(i);
+
+        Stamp = QString("");
+        Register::packStampISO(Row.mStamp, Stamp);
+        Value = ((std::isnan(Row.mValue)) ? QString("") : Register::toSqlNumber(Row.mValue));
+
+        Profile = Row.mProfile;
+        Profile.replace(QString("\\"), QString("\\\\")).replace(QString("\t"), QString("\\t")).replace(QString("\n"), QString("\\n"));
+
+        //`stamp`,`profile`,`device_id`,`register_id`,`value`,`ex`,`err`,`sign` (\N is NULL)
+        Str = Stamp;
+        Str+= QString("\t");
+        Str+= ((Profile.isEmpty()) ? QString("\\N") : Profile);
+        Str+= QString("\t");
+        Str+= ((Row.mDevID) ? QString::number(Row.mDevID) : QString("\\N"));
+        Str+= QString("\t");
+        Str+= ((Row.mRegID) ? QString::number(Row.mRegID) : QString("\\N"));
+        Str+= QString("\t");
+        Str+= ((Value.isEmpty()) ? QString("\\N") : Value);
+        Str+= QString("\t%1\t%2\t%3\n").arg(QString::number(Row.mEx), QString::number(Row.mErr), QString::number(Row.mSign));
+
+        DataIn.append(Str.toUtf8());
+    }
+
+    return ((i > FromIn) ? true : false);
+}
+
+
 /**
 @brief  Save data into a storage.
 @param  None.
@@ -373,17 +999,32 @@ bool Archive::toSql(Network *NetIn, const int DevIdxIn, QString &StringIn)
 */
 void Archive::save()
 {
-    if(mListNetworks != nullptr)
+    std::shared_ptr<const Snapshot> Snap = Snapshot::get();
+#ifdef SQL_PROC_TRM
+    //the extra columns of SQL_PROC_TRM are packed only by registers
+    Snap.reset();
+#endif
+
+    if(Snap && mMode == MODE__PERIODIC)
     {
-        Log::log(QString("Archive::save()"), mFileLog, mUseLog);
+        LOG_DEBUG(QString("Archive::save(snapshot %1)").arg(QString::number(Snap->mVersion)), mFileLog, mUseLog);
+        this->saveSnapshot(*Snap);
+    }
+    else if(mMode == MODE__PERIODIC && mListNetworks != nullptr)
+    {
+        LOG_DEBUG(QString("Archive::save()"), mFileLog, mUseLog);
 
         if(!mListNetworks->isEmpty())
         {
             Network *Net = nullptr;
             QString StoreFile(""), StoreTable(""), Query("");
             QList<QString> ListDbData;
+            QList<int> ListDbRows;
+            QMap<QString, QList<ArhRow> > MapDbRows;
+            bool EventMode = ((mMode == MODE__EVENT) ? true : false);
             int nNets = mListNetworks->size();
             int nDevs = 0;
+            int nRows = 0;
             int i, j;
 
             for(i=0; i<nNets; i++)
@@ -398,13 +1039,17 @@ void Archive::save()
                         StoreFile  = Net->getDeviceArhFile(j);
                         StoreTable = Net->getDeviceArhTable(j);
 
-                        if(!StoreFile.isEmpty() || !StoreTable.isEmpty())
+                        if(StoreFile.isEmpty() && !StoreTable.isEmpty() && mUseStmt && this->isCorrectProfile())
+                        {
+                            Net->getDeviceArh(mProfile, EventMode, j, MapDbRows[StoreTable]);
+                        }
+                        else if(!StoreFile.isEmpty() || !StoreTable.isEmpty())
                         {
                             Query = QString("");
-                            this->toSql(Net, j, Query);
+                            this->toSql(Net, j, Query, nRows);
 
-                            Log::log(Query, mFileLog, mUseLog, false, false);
-                            Log::log(QString("\r\n"), mFileLog, mUseLog, false, false);
+                            LOG_TRACE(Query, mFileLog, mUseLog, false, false);
+                            LOG_TRACE(QString("\r\n"), mFileLog, mUseLog, false, false);
 
                             if(!StoreFile.isEmpty())
                             {
@@ -413,17 +1058,18 @@ void Archive::save()
                             else
                             {
                                 ListDbData.append(Query);
+                                ListDbRows.append(nRows);
                             }
                         }
                     }
                 }
             }
 
-            if(!ListDbData.isEmpty()) this->saveToDb(ListDbData);
+            this->saveData(ListDbData, ListDbRows, MapDbRows);
         }
         else
         {
-            Log::log(QString("ListNetworks is empty!"), mFileLog, mUseLog, false);
+            LOG_WARN(QString("ListNetworks is empty!"), mFileLog, mUseLog, false);
         }
     }
 
@@ -432,78 +1078,1540 @@ void Archive::save()
 
 
 /**
-@brief  Save data into a File.
-@param  FileIn - path to file;
-@param  DataIn - data.
-@return true if OK, otherwise - false.
+@brief  Accumulate the current snapshot.
+@param  None.
+@return None.
+@details Update running aggregates of registers (O(1) per register) and append samples into the store.
+         Is called after each survey cycle, a snapshot is accumulated once.
 */
-bool Archive::saveToFile(const QString &FileIn, const QString &DataIn)
+void Archive::accumulate()
 {
-    bool Res = false;
+    bool UseStore = mStore->isOpened();
+    if(!mAggregate && !UseStore) return;
 
-    if(!FileIn.isEmpty() && !DataIn.isEmpty())
+    std::shared_ptr<const Snapshot> Snap = Snapshot::get();
+    if(!Snap || Snap->mVersion == mAggrVersion) return;
+
+    mAggrVersion = Snap->mVersion;
+
+    bool ToAggr, ToStore;
+    int i, j;
+
+    for(i=0; i<Snap->mListDevices.size(); i++)
     {
-        Log::log(QString("Archive::saveToFile(%1)").arg(FileIn), mFileLog, mUseLog);
-        Log::log(DataIn, FileIn, true, false, false);
-        Res = true;
-    }
+        const SnapshotDevice &Dev = Snap->mListDevices.at(i);
 
-    return (Res);
-}
+        ToAggr  = (mAggregate && (!Dev.mArhFile.isEmpty() || !Dev.mArhTable.isEmpty()));
+        ToStore = (UseStore && Dev.mArhStore);
 
+        if(!ToAggr && !ToStore) continue;
 
-/**
-@brief  Save data into a DB.
-@param  ListDataIn - list of data (queries).
-@return true if OK, otherwise - false.
+        for(j=0; j<Dev.mListRows.size(); j++)
+        {
+            const ArhRow &Row = Dev.mListRows.at(j);
+
+            if(ToAggr)
+            {
+                ArhAggr &Aggr = mMapAggr[((static_cast<quint32>(Row.mDevID) << 16) | Row.mRegID)];
+
+                if(Row.mErr == 0)
+                {
+                    Aggr.add(Snap->mStamp, Row.mValue, Row.mSign);
+                }
+                else
+                {
+                    Aggr.fail(Snap->mStamp);
+                }
+            }
+
+            //samples of a cycle have the stamp of the snapshot (regular stamps are compressed better)
+            if(ToStore) mStore->append(Row.mDevID, Row.mRegID, Snap->mStamp, Row.mValue, Row.mEx, Row.mErr, Row.mSign);
+        }
+    }
+
+    //open blocks are written periodically (a crash loses at most mStoreFlush sec)
+    if(UseStore && mStoreFlush > 0 && Snap->mStamp >= mStoreFlushAt)
+    {
+        if(mStoreFlushAt > 0) mStore->flush();
+        mStoreFlushAt = Snap->mStamp + static_cast<qint64>(mStoreFlush)*1000;
+    }
+}
+
+
+/**
+@brief  Save data of snapshot into a storage.
+@param  SnapIn - snapshot.
+@return None.
+@details Device locks are not taken, all devices are archived from the same survey cycle.
+         Aggregates of registers are archived with profiles "{mProfile}.{function}".
+         Values of registers with compression settings are filtered by ArhComp.
 */
-bool Archive::saveToDb(const QList<QString> &ListDataIn)
+void Archive::saveSnapshot(const Snapshot &SnapIn)
 {
-    bool Res = false;
+    if(!this->isCorrectProfile()) return;
 
-    if(!mHost.isEmpty() && mPort > 0 && !mUser.isEmpty() && !mDb.isEmpty())
+    QList<QString> ListDbData;
+    QList<int> ListDbRows;
+    QMap<QString, QList<ArhRow> > MapDbRows;
+    QList<ArhRow> ListRows;
+    QDateTime Tick = QDateTime::currentDateTime();
+    qint64 TickMsec = Tick.toMSecsSinceEpoch();
+    int i, j;
+
+    for(i=0; i<SnapIn.mListDevices.size(); i++)
     {
-        Log::log(QString("Archive::saveToDb()"), mFileLog, mUseLog);
+        const SnapshotDevice &Dev = SnapIn.mListDevices.at(i);
 
-        if(!ListDataIn.isEmpty())
+        if(Dev.mListRows.isEmpty() || (Dev.mArhFile.isEmpty() && Dev.mArhTable.isEmpty())) continue;
+
+        ListRows.clear();
+        for(j=0; j<Dev.mListRows.size(); j++)
         {
-            HelperMySQL *MySqlCli = new HelperMySQL();
+            ArhRow Row = Dev.mListRows.at(j);
+            Row.mProfile = mProfile;
 
-            MySqlCli->mHost   = mHost;
-            MySqlCli->mPort   = mPort;
-            MySqlCli->mUser   = mUser;
-            MySqlCli->mPasswd = mPasswd;
-            MySqlCli->mDB     = mDb;
+            //a compressed register gives 0...2 rows (the row held by swinging door is archived later)
+            QHash<quint32, ArhComp>::iterator It = mMapComp.find(((static_cast<quint32>(Row.mDevID) << 16) | Row.mRegID));
+            if(It != mMapComp.end())
+            {
+                It.value().filter(Row, ListRows);
+            }
+            else
+            {
+                ListRows.append(Row);
+            }
+        }
 
-            if(MySqlCli->connect())
+        if(mAggregate)
+        {
+            for(j=0; j<Dev.mListRows.size(); j++)
             {
-                Log::log(QString("Connection with MySQL DB is established: %1@%2:%3/%4").arg(MySqlCli->mUser, MySqlCli->mHost, QString::number(MySqlCli->mPort), MySqlCli->mDB), mFileLog, mUseLog);
+                const ArhRow &Row = Dev.mListRows.at(j);
+                quint32 Key = ((static_cast<quint32>(Row.mDevID) << 16) | Row.mRegID);
+
+                QHash<quint32, ArhAggr>::iterator It = mMapAggr.find(Key);
+                if(It != mMapAggr.end())
+                {
+                    It.value().toArhRows(Tick, mProfile, Row.mDevID, Row.mRegID, mAggregate, ListRows);
+                    It.value().restart(TickMsec);
+                }
+            }
+        }
+
+        if(ListRows.isEmpty()) continue;
+
+        this->toData(Dev, ListRows, ListDbData, ListDbRows, MapDbRows);
+    }
+
+    this->saveData(ListDbData, ListDbRows, MapDbRows);
+}
+
+
+/**
+@brief  Save rows of events into a storage.
+@param  ListDevicesIn - list of devices with rows of events.
+@return None.
+@details Is called by the survey (queued) when events of registers have been raised or cleared (event mode only).
+*/
+void Archive::addEvents(const QList<SnapshotDevice> &ListDevicesIn)
+{
+    if(mMode != MODE__EVENT || !this->isCorrectProfile()) return;
+
+    LOG_DEBUG(QString("Archive::addEvents(%1)").arg(QString::number(ListDevicesIn.size())), mFileLog, mUseLog);
+
+    QList<QString> ListDbData;
+    QList<int> ListDbRows;
+    QMap<QString, QList<ArhRow> > MapDbRows;
+    QList<ArhRow> ListRows;
+    int i, j;
+
+    for(i=0; i<ListDevicesIn.size(); i++)
+    {
+        const SnapshotDevice &Dev = ListDevicesIn.at(i);
+
+        if(Dev.mListRows.isEmpty() || (Dev.mArhFile.isEmpty() && Dev.mArhTable.isEmpty())) continue;
+
+        ListRows = Dev.mListRows;
+        for(j=0; j<ListRows.size(); j++) ListRows[j].mProfile = mProfile;
+
+        this->toData(Dev, ListRows, ListDbData, ListDbRows, MapDbRows);
+    }
+
+    this->saveData(ListDbData, ListDbRows, MapDbRows);
+}
+
+
+/**
+@brief  Route rows of a device to its storage.
+@param  DevIn - device;
+@param  ListRowsIn - rows of the device;
+@param  ListDbDataIn - link to list of data (queries);
+@param  ListDbRowsIn - link to the number of rows of each query;
+@param  MapDbRowsIn - link to rows by tables (for prepared statements).
+@return None.
+@details Rows of a file are saved at once, rows of a table are collected for saveData().
+*/
+void Archive::toData(const SnapshotDevice &DevIn, const QList<ArhRow> &ListRowsIn, QList<QString> &ListDbDataIn, QList<int> &ListDbRowsIn, QMap<QString, QList<ArhRow> > &MapDbRowsIn)
+{
+    if(mRetention > 0 && DevIn.mArhFile.isEmpty() && !DevIn.mArhTable.isEmpty()) mMaintTables.insert(DevIn.mArhTable);
 
+    if(DevIn.mArhFile.isEmpty() && mUseStmt)
+    {
+        MapDbRowsIn[DevIn.mArhTable].append(ListRowsIn);
+    }
+    else
+    {
+        QString Store = ((!DevIn.mArhFile.isEmpty()) ? DevIn.mArhFile : DevIn.mArhTable);
+        QString Query("");
+        this->toSql(Store, ListRowsIn, 0, ListRowsIn.size(), Query);
+
+        LOG_TRACE(Query, mFileLog, mUseLog, false, false);
+        LOG_TRACE(QString("\r\n"), mFileLog, mUseLog, false, false);
+
+        if(!DevIn.mArhFile.isEmpty())
+        {
+            this->saveToFile(DevIn.mArhFile, Query);
+        }
+        else
+        {
+            ListDbDataIn.append(Query);
+            ListDbRowsIn.append(ListRowsIn.size());
+        }
+    }
+}
+
+
+/**
+@brief  Save data of a tick into DB.
+@param  ListDataIn - list of data (queries);
+@param  ListRowsIn - the number of rows of each query;
+@param  MapRowsIn - rows by tables (for prepared statements).
+@return None.
+*/
+void Archive::saveData(const QList<QString> &ListDataIn, const QList<int> &ListRowsIn, const QMap<QString, QList<ArhRow> > &MapRowsIn)
+{
+    QList<ArhPart> ListParts;
+
+    if(this->toParts(ListDataIn, ListRowsIn, MapRowsIn, ListParts) > 0)
+    {
+        if(mDriver == DRIVER__SQLITE)
+        {
+#ifdef WITH_SQLITE
+            this->saveToLite(ListParts);
+#endif
+        }
+        else if(mUseTrans)
+        {
+            this->saveToDbTrans(ListParts);
+        }
+        else
+        {
+            this->saveToDbParts(ListParts);
+        }
+    }
+}
+
+
+/**
+@brief  Save data into a File.
+@param  FileIn - path to file;
+@param  DataIn - data.
+@return true if OK, otherwise - false.
+*/
+bool Archive::saveToFile(const QString &FileIn, const QString &DataIn)
+{
+    bool Res = false;
+
+    if(!FileIn.isEmpty() && !DataIn.isEmpty())
+    {
+        LOG_DEBUG(QString("Archive::saveToFile(%1)").arg(FileIn), mFileLog, mUseLog);
+        Log::write(FileIn, DataIn.toUtf8());
+        Res = true;
+    }
+
+    return (Res);
+}
+
+
+/**
+@brief  Save data into a DB.
+@param  ListDataIn - list of data (queries).
+@return true if OK, otherwise - false.
+*/
+bool Archive::saveToDb(const QList<QString> &ListDataIn)
+{
+    bool Res = false;
+
+    if(this->isDbAllowed())
+    {
+        LOG_DEBUG(QString("Archive::saveToDb()"), mFileLog, mUseLog);
+
+        if(!ListDataIn.isEmpty())
+        {
+            if(this->connectDb())
+            {
                 for(int i=0; i<ListDataIn.size(); i++)
                 {
-                    Res = MySqlCli->sendQuery(ListDataIn.at(i));
+                    Res = mDbCli->sendQuery(ListDataIn.at(i));
 
                     if(Res)
                     {
-                        Log::log(QString("The query sent successfully!"), mFileLog, mUseLog);
+                        LOG_DEBUG(QString("The query sent successfully!"), mFileLog, mUseLog);
                     }
                     else
                     {
-                        Log::log(QString("Error send query (%1)! %2)").arg(QString::number(MySqlCli->getErrorNo()), MySqlCli->getError()), mFileLog, mUseLog);
+                        LOG_ERROR(QString("Error send query (%1)! %2)").arg(QString::number(mDbCli->getErrorNo()), mDbCli->getError()), mFileLog, mUseLog);
+
+                        //the connection may be lost in the middle of the tick
+                        if(!mDbCli->ping())
+                        {
+                            this->disconnectDb();
+                            break;
+                        }
                     }
                 }
+            }
+        }
+    }
+
+    return (Res);
+}
+
+
+/**
+@brief  Split data of a tick into parts.
+@param  ListDataIn - list of data (queries);
+@param  ListRowsIn - the number of rows of each query;
+@param  MapRowsIn - rows by tables (for prepared statements);
+@param  ListPartsIn - link to list of parts.
+@return The number of parts.
+@details Rows of a table are split by STMT__ROWS_MAX or INFILE__ROWS_MAX (mTransRows if it is less).
+*/
+int Archive::toParts(const QList<QString> &ListDataIn, const QList<int> &ListRowsIn, const QMap<QString, QList<ArhRow> > &MapRowsIn, QList<ArhPart> &ListPartsIn)
+{
+    ArhPart Part;
+    int i, Size;
+
+    Part.mRows = nullptr;
+    Part.mFrom = 0;
+
+    for(i=0; i<ListDataIn.size(); i++)
+    {
+        if(!ListDataIn.at(i).isEmpty())
+        {
+            Part.mQuery = ListDataIn.at(i);
+            Part.mCount = ((i < ListRowsIn.size()) ? ListRowsIn.at(i) : 1);
+            ListPartsIn.append(Part);
+        }
+    }
+
+    QMap<QString, QList<ArhRow> >::const_iterator It;
+    int Chunk = ((mUseInfile && !mInfileRefused) ? INFILE__ROWS_MAX : STMT__ROWS_MAX);
+    if(mUseTrans) Chunk = qMin(Chunk, mTransRows);
+
+    Part.mQuery = QString("");
+
+    for(It = MapRowsIn.constBegin(); It != MapRowsIn.constEnd(); ++It)
+    {
+        Size = It.value().size();
+
+        for(i=0; i<Size; i+=Chunk)
+        {
+            Part.mTable = It.key();
+            Part.mRows  = &It.value();
+            Part.mFrom  = i;
+            Part.mCount = qMin(Chunk, Size-i);
+            ListPartsIn.append(Part);
+        }
+    }
+
+    return (ListPartsIn.size());
+}
+
+
+/**
+@brief  Save data into a DB part by part (autocommit).
+@param  ListPartsIn - list of parts.
+@return true if OK, otherwise - false.
+@details The parts are spooled if DB is unavailable or slow.
+*/
+bool Archive::saveToDbParts(const QList<ArhPart> &ListPartsIn)
+{
+    bool Res = false;
+
+    if(this->isDbAllowed() && !ListPartsIn.isEmpty())
+    {
+        LOG_DEBUG(QString("Archive::saveToDbParts()"), mFileLog, mUseLog);
+
+        QElapsedTimer Timer;
+        Timer.start();
+
+        bool Conn = this->connectDb();
+        Res = Conn;
+
+        for(int i=0; i<ListPartsIn.size(); i++)
+        {
+            if(Conn && this->isSlow(Timer))
+            {
+                LOG_WARN(QString("DB is slow (%1 msec)! The rest of data is spooled.").arg(QString::number(Timer.elapsed())), mFileLog, mUseLog);
+                Conn = false;
+                Res  = false;
+            }
+
+            if(Conn)
+            {
+                if(this->sendPart(ListPartsIn.at(i))) continue;
+
+                Res = false;
+
+                //the error of query, the data is lost
+                if(mDbCli->isConnected()) continue;
+
+                Conn = false;
+            }
+
+            this->toSpool(ListPartsIn.at(i));
+        }
+    }
+
+    return (Res);
+}
+
+
+/**
+@brief  Save data into a DB by transactions.
+@param  ListPartsIn - list of parts.
+@return true if OK, otherwise - false.
+@details The parts are grouped into transactions of up to mTransRows rows.
+         A failed transaction is rolled back and sent again up to mTransRetry times.
+         The parts are spooled if DB is unavailable or slow.
+*/
+bool Archive::saveToDbTrans(const QList<ArhPart> &ListPartsIn)
+{
+    bool Res = false;
+
+    if(this->isDbAllowed() && !ListPartsIn.isEmpty())
+    {
+        LOG_DEBUG(QString("Archive::saveToDbTrans()"), mFileLog, mUseLog);
+
+        QElapsedTimer Timer;
+        Timer.start();
+
+        int From = 0, To, Rows, Retry, j;
+        bool Done;
+
+        Res = this->connectDb();
+
+        while(Res && From < ListPartsIn.size())
+        {
+            if(this->isSlow(Timer))
+            {
+                LOG_WARN(QString("DB is slow (%1 msec)! The rest of data is spooled.").arg(QString::number(Timer.elapsed())), mFileLog, mUseLog);
+                Res = false;
+                break;
+            }
+
+            //parts of one transaction [From, To)
+            Rows = 0;
+            To   = From;
+
+            while(To < ListPartsIn.size() && (To == From || (Rows + ListPartsIn.at(To).mCount) <= mTransRows))
+            {
+                Rows+= ListPartsIn.at(To).mCount;
+                To++;
+            }
+
+            for(Retry=0; ; Retry++)
+            {
+                Done = mDbCli->begin();
+
+                for(j=From; j<To && Done; j++)
+                {
+                    Done = this->sendPart(ListPartsIn.at(j));
+                }
+
+                if(Done) Done = mDbCli->commit();
+                if(Done) break;
+
+                LOG_WARN(QString("Transaction (%1 rows) is failed (%2)! %3").arg(QString::number(Rows), QString::number(mDbCli->getErrorNo()), mDbCli->getError()), mFileLog, mUseLog);
+
+                //the server rolls back an open transaction itself if the connection is lost
+                if(mDbCli->isConnected() && mDbCli->ping())
+                {
+                    mDbCli->rollback();
+                }
+                else
+                {
+                    this->disconnectDb();
+                }
+
+                if(Retry >= mTransRetry || !this->connectDb()) break;
+
+                LOG_INFO(QString("Transaction is retried (%1 of %2).").arg(QString::number(Retry+1), QString::number(mTransRetry)), mFileLog, mUseLog);
+            }
 
-                MySqlCli->disconnect();
-                Log::log(QString("Connection with MySQL DB is closed."), mFileLog, mUseLog);
+            if(Done)
+            {
+                LOG_DEBUG(QString("The transaction committed successfully (%1 rows)!").arg(QString::number(Rows)), mFileLog, mUseLog);
+            }
+            else if(mDbCli->isConnected())
+            {
+                //the error of query, the data is lost
+                LOG_ERROR(QString("Transaction (%1 rows) is lost!").arg(QString::number(Rows)), mFileLog, mUseLog);
             }
             else
             {
-                Log::log(QString("Error connecting to DB (%1)! %2)").arg(QString::number(MySqlCli->getErrorNo()), MySqlCli->getError()), mFileLog, mUseLog);
+                Res = false;
+                break;
             }
 
-            delete MySqlCli;
+            From = To;
+        }
+
+        //DB is unavailable or slow
+        for(j=From; j<ListPartsIn.size(); j++)
+        {
+            this->toSpool(ListPartsIn.at(j));
         }
     }
 
     return (Res);
 }
+
+
+/**
+@brief  Send part of data.
+@param  PartIn - part.
+@return true if OK, otherwise - false.
+@details The connection is closed if it is lost.
+*/
+bool Archive::sendPart(const ArhPart &PartIn)
+{
+    if(mDriver == DRIVER__SQLITE)
+    {
+#ifdef WITH_SQLITE
+        if(!PartIn.mQuery.isEmpty())
+        {
+            if(mLiteCli->sendQuery(PartIn.mQuery)) return (true);
+
+            LOG_ERROR(QString("Error send query (%1)! %2)").arg(QString::number(mLiteCli->getErrorNo()), mLiteCli->getError()), mFileLog, mUseLog);
+            return (false);
+        }
+
+        return ((PartIn.mRows != nullptr) ? this->sendLiteStmt(PartIn.mTable, *PartIn.mRows, PartIn.mFrom, PartIn.mCount) : false);
+#else
+        return (false);
+#endif
+    }
+
+    if(!PartIn.mQuery.isEmpty())
+    {
+        bool Res = mDbCli->sendQuery(PartIn.mQuery);
+
+        if(!Res)
+        {
+            LOG_ERROR(QString("Error send query (%1)! %2)").arg(QString::number(mDbCli->getErrorNo()), mDbCli->getError()), mFileLog, mUseLog);
+
+            if(!mDbCli->ping()) this->disconnectDb();
+        }
+
+        return (Res);
+    }
+    else if(PartIn.mRows != nullptr)
+    {
+        return (this->sendInfile(PartIn.mTable, *PartIn.mRows, PartIn.mFrom, PartIn.mCount));
+    }
+
+    return (false);
+}
+
+
+/**
+@brief  Send part of data by one transaction.
+@param  PartIn - part.
+@return true if OK, otherwise - false.
+@details Is used for a spooled record of several statements, so the record is either committed or rolled back
+         at once (it is not sent twice by the next drain).
+*/
+bool Archive::sendPartTrans(const ArhPart &PartIn)
+{
+#ifdef WITH_SQLITE
+    if(mDriver == DRIVER__SQLITE)
+    {
+        if(!mLiteCli->begin()) return (false);
+        if(this->sendPart(PartIn) && mLiteCli->commit()) return (true);
+
+        if(mLiteCli->isConnected()) mLiteCli->rollback();
+        return (false);
+    }
+#endif
+
+    if(!mDbCli->begin())
+    {
+        if(!mDbCli->ping()) this->disconnectDb();
+        return (false);
+    }
+
+    if(this->sendPart(PartIn) && mDbCli->commit()) return (true);
+
+    //the server rolls back an open transaction itself if the connection is lost
+    if(mDbCli->isConnected() && mDbCli->ping())
+    {
+        mDbCli->rollback();
+    }
+    else
+    {
+        this->disconnectDb();
+    }
+
+    return (false);
+}
+
+
+/**
+@brief  Save part of data into the spool.
+@param  PartIn - part.
+@return true if OK, otherwise - false.
+*/
+bool Archive::toSpool(const ArhPart &PartIn)
+{
+    bool Res = false;
+
+    if(mSpool->isOpened())
+    {
+        QByteArray Record = ((PartIn.mQuery.isEmpty() && PartIn.mRows != nullptr) ? ArhSpool::packRows(PartIn.mTable, *PartIn.mRows, PartIn.mFrom, PartIn.mCount) : ArhSpool::packQuery(PartIn.mQuery, PartIn.mCount));
+
+        Res = mSpool->push(Record);
+
+        quint32 Dropped = mSpool->takeDropped();
+        if(Dropped) LOG_WARN(QString("Spool is full! The oldest segments are dropped (%1).").arg(QString::number(Dropped)), mFileLog, mUseLog);
+    }
+
+    if(Res)
+    {
+        LOG_DEBUG(QString("The data is spooled (%1 rows)!").arg(QString::number(PartIn.mCount)), mFileLog, mUseLog);
+    }
+    else
+    {
+        LOG_ERROR(QString("The data is lost (%1 rows)!").arg(QString::number(PartIn.mCount)), mFileLog, mUseLog);
+    }
+
+    return (Res);
+}
+
+
+/**
+@brief  Check the time of saving data into DB.
+@param  TimerIn - timer started with the saving.
+@return true if DB is slow, otherwise - false.
+@details Is used only with the spool.
+*/
+bool Archive::isSlow(const QElapsedTimer &TimerIn)
+{
+    return ((mSpool->isOpened() && mSpoolTimeout > 0 && TimerIn.elapsed() > static_cast<qint64>(mSpoolTimeout)*1000) ? true : false);
+}
+
+
+/**
+@brief  Send rows of a table by prepared statement.
+@param  TableIn - name of table;
+@param  ListRowsIn - list of rows;
+@param  FromIn - index of the first row;
+@param  CountIn - the number of rows (1...STMT__ROWS_MAX).
+@return true if OK, otherwise - false.
+@details SQL-query is used if the statement can not be prepared.
+*/
+bool Archive::sendStmt(const QString &TableIn, const QList<ArhRow> &ListRowsIn, const int FromIn, const int CountIn)
+{
+    if(CountIn <= 0 || CountIn > STMT__ROWS_MAX || (FromIn+CountIn) > ListRowsIn.size()) return (false);
+
+    //the statements are cached by text, so a table with a varying number of rows may fill the cache
+    if(mDbCli->sizeStmts() >= STMT__CACHE_MAX) mDbCli->closeStmts();
+
+    QString Query = QString("INSERT INTO `%1`(`stamp`,`profile`,`device_id`,`register_id`,`value`,`ex`,`err`,`sign`) VALUES ").arg(TableIn);
+    int i;
+
+    for(i=0; i<CountIn; i++)
+    {
+        if(i) Query+= QString(",");
+        Query+= QString("(?,?,?,?,?,?,?,?)");
+    }
+
+    MYSQL_STMT *Stmt = mDbCli->getStmt(Query);
+
+    if(Stmt == nullptr)
+    {
+        LOG_WARN(QString("Error prepare statement (%1)! %2) SQL-query is used.").arg(QString::number(mDbCli->getStmtErrorNo()), mDbCli->getStmtError()), mFileLog, mUseLog);
+
+        Query = QString("");
+        this->toSql(TableIn, ListRowsIn, FromIn, CountIn, Query);
+
+        QList<QString> ListData;
+        ListData.append(Query);
+        return (this->saveToDb(ListData));
+    }
+
+    QVector<MYSQL_BIND> Bind(CountIn*STMT__COLUMNS);
+    QVector<MYSQL_TIME> Stamp(CountIn);
+    QVector<QByteArray> Profile(CountIn);
+    QVector<unsigned long> ProfileLen(CountIn);
+    QVector<my_bool> ProfileNull(CountIn), DevNull(CountIn), RegNull(CountIn);
+
+    std::memset(Bind.data(), 0, sizeof(MYSQL_BIND)*static_cast<size_t>(Bind.size()));
+    std::memset(Stamp.data(), 0, sizeof(MYSQL_TIME)*static_cast<size_t>(Stamp.size()));
+
+    MYSQL_BIND *Col = nullptr;
+
+    for(i=0; i<CountIn; i++)
+    {
+        const ArhRow &Row = ListRowsIn.at(FromIn+i);
+        QDate Date = Row.mStamp.date();
+        QTime Time = Row.mStamp.time();
+
+        Stamp[i].year      = static_cast<unsigned int>(Date.year());
+        Stamp[i].month     = static_cast<unsigned int>(Date.month());
+        Stamp[i].day       = static_cast<unsigned int>(Date.day());
+        Stamp[i].hour      = static_cast<unsigned int>(Time.hour());
+        Stamp[i].minute    = static_cast<unsigned int>(Time.minute());
+        Stamp[i].second    = static_cast<unsigned int>(Time.second());
+        Stamp[i].time_type = MYSQL_TIMESTAMP_DATETIME;
+
+        Profile[i]     = Row.mProfile.toUtf8();
+        ProfileLen[i]  = static_cast<unsigned long>(Profile[i].size());
+        ProfileNull[i] = ((Row.mProfile.isEmpty()) ? 1 : 0);
+        DevNull[i]     = ((Row.mDevID) ? 0 : 1);
+        RegNull[i]     = ((Row.mRegID) ? 0 : 1);
+
+        Col = &Bind[i*STMT__COLUMNS];
+
+        //`stamp`
+        Col[0].buffer_type   = MYSQL_TYPE_DATETIME;
+        Col[0].buffer        = &Stamp[i];
+        //`profile`
+        Col[1].buffer_type   = MYSQL_TYPE_STRING;
+        Col[1].buffer        = Profile[i].data();
+        Col[1].buffer_length = ProfileLen[i];
+        Col[1].length        = &ProfileLen[i];
+        Col[1].is_null       = &ProfileNull[i];
+        //`device_id`
+        Col[2].buffer_type   = MYSQL_TYPE_SHORT;
+        Col[2].buffer        = const_cast<quint16 *>(&Row.mDevID);
+        Col[2].is_unsigned   = 1;
+        Col[2].is_null       = &DevNull[i];
+        //`register_id`
+        Col[3].buffer_type   = MYSQL_TYPE_SHORT;
+        Col[3].buffer        = const_cast<quint16 *>(&Row.mRegID);
+        Col[3].is_unsigned   = 1;
+        Col[3].is_null       = &RegNull[i];
+        //`value`
+        Col[4].buffer_type   = MYSQL_TYPE_DOUBLE;
+        Col[4].buffer        = const_cast<double *>(&Row.mValue);
+        //`ex`
+        Col[5].buffer_type   = MYSQL_TYPE_LONG;
+        Col[5].buffer        = const_cast<qint32 *>(&Row.mEx);
+        //`err`
+        Col[6].buffer_type   = MYSQL_TYPE_LONG;
+        Col[6].buffer        = const_cast<qint32 *>(&Row.mErr);
+        //`sign`
+        Col[7].buffer_type   = MYSQL_TYPE_LONG;
+        Col[7].buffer        = const_cast<qint32 *>(&Row.mSign);
+    }
+
+    bool Res = mDbCli->sendStmt(Stmt, Bind.data());
+
+    if(Res)
+    {
+        LOG_DEBUG(QString("The statement sent successfully (%1: %2 rows)!").arg(TableIn, QString::number(CountIn)), mFileLog, mUseLog);
+    }
+    else
+    {
+        LOG_ERROR(QString("Error send statement (%1)! %2)").arg(QString::number(mDbCli->getStmtErrorNo()), mDbCli->getStmtError()), mFileLog, mUseLog);
+
+        if(!mDbCli->ping()) this->disconnectDb();
+    }
+
+    return (Res);
+}
+
+
+/**
+@brief  Send rows of a table by LOAD DATA LOCAL INFILE.
+@param  TableIn - name of table;
+@param  ListRowsIn - list of rows;
+@param  FromIn - index of the first row;
+@param  CountIn - the number of rows.
+@return true if OK, otherwise - false.
+@details The rows are sent by prepared statements (by STMT__ROWS_MAX) if local infile is disabled or refused by the server.
+*/
+bool Archive::sendInfile(const QString &TableIn, const QList<ArhRow> &ListRowsIn, const int FromIn, const int CountIn)
+{
+    if(CountIn <= 0 || (FromIn+CountIn) > ListRowsIn.size()) return (false);
+
+    if(mUseInfile && !mInfileRefused)
+    {
+        QByteArray Data;
+        this->toInfile(ListRowsIn, FromIn, CountIn, Data);
+
+        QString Query = QString("LOAD DATA LOCAL INFILE 'arh' INTO TABLE `%1` CHARACTER SET utf8 FIELDS TERMINATED BY '\\t' ESCAPED BY '\\\\' LINES TERMINATED BY '\\n' (`stamp`,`profile`,`device_id`,`register_id`,`value`,`ex`,`err`,`sign`)").arg(TableIn);
+
+        if(mDbCli->sendInfile(Query, Data))
+        {
+            LOG_DEBUG(QString("LOAD DATA sent successfully (%1: %2 rows)!").arg(TableIn, QString::number(CountIn)), mFileLog, mUseLog);
+            return (true);
+        }
+
+        if(!mDbCli->isInfileRefused())
+        {
+            LOG_ERROR(QString("Error send LOAD DATA (%1)! %2)").arg(QString::number(mDbCli->getErrorNo()), mDbCli->getError()), mFileLog, mUseLog);
+
+            if(!mDbCli->ping()) this->disconnectDb();
+            return (false);
+        }
+
+        //the rows are sent by prepared statements until reconnect
+        mInfileRefused = true;
+        LOG_WARN(QString("LOAD DATA LOCAL INFILE is refused (%1)! %2) Prepared statements are used.").arg(QString::number(mDbCli->getErrorNo()), mDbCli->getError()), mFileLog, mUseLog);
+    }
+
+    bool Res = true;
+
+    for(int i=0; i<CountIn && Res; i+=STMT__ROWS_MAX)
+    {
+        Res = this->sendStmt(TableIn, ListRowsIn, FromIn+i, qMin(STMT__ROWS_MAX, CountIn-i));
+    }
+
+    return (Res);
+}
+
+
+#ifdef WITH_SQLITE
+/**
+@brief  Save data into SQLite DB.
+@param  ListPartsIn - list of parts.
+@return true if OK, otherwise - false.
+@details All parts of a tick are saved by one transaction, the parts are spooled if the transaction is failed.
+*/
+bool Archive::saveToLite(const QList<ArhPart> &ListPartsIn)
+{
+    bool Res = false;
+    int i;
+
+    if(this->isDbAllowed() && !ListPartsIn.isEmpty())
+    {
+        LOG_DEBUG(QString("Archive::saveToLite()"), mFileLog, mUseLog);
+
+        Res = this->connectDb();
+
+        //one commit per tick: SQLite syncs on commit, so a transaction per row is very slow on flash
+        if(Res) Res = mLiteCli->begin();
+
+        for(i=0; i<ListPartsIn.size() && Res; i++)
+        {
+            Res = this->sendPart(ListPartsIn.at(i));
+        }
+
+        if(Res) Res = mLiteCli->commit();
+
+        if(Res)
+        {
+            LOG_DEBUG(QString("The transaction committed successfully (%1 parts)!").arg(QString::number(ListPartsIn.size())), mFileLog, mUseLog);
+        }
+        else
+        {
+            LOG_WARN(QString("Transaction is failed (%1)! %2").arg(QString::number(mLiteCli->getErrorNo()), mLiteCli->getError()), mFileLog, mUseLog);
+
+            if(mLiteCli->isConnected()) mLiteCli->rollback();
+
+            for(i=0; i<ListPartsIn.size(); i++)
+            {
+                this->toSpool(ListPartsIn.at(i));
+            }
+        }
+    }
+
+    return (Res);
+}
+
+
+/**
+@brief  Send rows of a table into SQLite DB by prepared statement.
+@param  TableIn - name of table;
+@param  ListRowsIn - list of rows;
+@param  FromIn - index of the first row;
+@param  CountIn - the number of rows.
+@return true if OK, otherwise - false.
+@details The table is created if it does not exist, one statement is executed for each row.
+*/
+bool Archive::sendLiteStmt(const QString &TableIn, const QList<ArhRow> &ListRowsIn, const int FromIn, const int CountIn)
+{
+    if(CountIn <= 0 || (FromIn+CountIn) > ListRowsIn.size()) return (false);
+    if(!this->initLiteTable(TableIn)) return (false);
+
+    //a statement of one row is prepared once and executed for each row (there is no round-trip to a server)
+    sqlite3_stmt *Stmt = mLiteCli->getStmt(QString("INSERT INTO \"%1\"(stamp,profile,device_id,register_id,value,ex,err,sign) VALUES (?,?,?,?,?,?,?,?)").arg(TableIn));
+
+    if(Stmt == nullptr)
+    {
+        LOG_ERROR(QString("Error prepare statement (%1)! %2)").arg(QString::number(mLiteCli->getErrorNo()), mLiteCli->getError()), mFileLog, mUseLog);
+        return (false);
+    }
+
+    QString Stamp;
+    QByteArray StampUtf, Profile;
+
+    for(int i=0; i<CountIn; i++)
+    {
+        const ArhRow &Row = ListRowsIn.at(FromIn+i);
+
+        Register::packStampISO(Row.mStamp, Stamp);
+        StampUtf = Stamp.toUtf8();
+        Profile  = Row.mProfile.toUtf8();
+
+        sqlite3_bind_text(Stmt, 1, StampUtf.constData(), StampUtf.size(), SQLITE_TRANSIENT);
+        if(!Row.mProfile.isEmpty()) sqlite3_bind_text(Stmt, 2, Profile.constData(), Profile.size(), SQLITE_TRANSIENT);
+        if(Row.mDevID) sqlite3_bind_int(Stmt, 3, Row.mDevID);
+        if(Row.mRegID) sqlite3_bind_int(Stmt, 4, Row.mRegID);
+        sqlite3_bind_double(Stmt, 5, Row.mValue);
+        sqlite3_bind_int(Stmt, 6, Row.mEx);
+        sqlite3_bind_int(Stmt, 7, Row.mErr);
+        sqlite3_bind_int(Stmt, 8, Row.mSign);
+
+        if(!mLiteCli->sendStmt(Stmt))
+        {
+            LOG_ERROR(QString("Error send statement (%1)! %2)").arg(QString::number(mLiteCli->getErrorNo()), mLiteCli->getError()), mFileLog, mUseLog);
+            return (false);
+        }
+    }
+
+    LOG_DEBUG(QString("The statement sent successfully (%1: %2 rows)!").arg(TableIn, QString::number(CountIn)), mFileLog, mUseLog);
+
+    return (true);
+}
+
+
+/**
+@brief  Create a table of SQLite DB.
+@param  TableIn - name of table.
+@return true if the table exists, otherwise - false.
+*/
+bool Archive::initLiteTable(const QString &TableIn)
+{
+    if(mLiteTables.contains(TableIn)) return (true);
+
+    //the columns are the same as the columns of MySQL archive, stamp is a text in ISO-format
+    QString Query = QString("CREATE TABLE IF NOT EXISTS \"%1\"(stamp TEXT NOT NULL, profile TEXT, device_id INTEGER, register_id INTEGER, value REAL, ex INTEGER, err INTEGER, sign INTEGER);"
+                            "CREATE INDEX IF NOT EXISTS \"%1_reg\" ON \"%1\"(device_id, register_id, stamp);").arg(TableIn);
+
+    //expired rows are selected by profile and stamp
+    if(mRetention > 0) Query+= QString("CREATE INDEX IF NOT EXISTS \"%1_stamp\" ON \"%1\"(profile, stamp);").arg(TableIn);
+
+    if(!mLiteCli->sendQuery(Query))
+    {
+        LOG_ERROR(QString("Error create table %1 (%2)! %3").arg(TableIn, QString::number(mLiteCli->getErrorNo()), mLiteCli->getError()), mFileLog, mUseLog);
+        return (false);
+    }
+
+    mLiteTables.insert(TableIn);
+
+    return (true);
+}
+
+
+/**
+@brief  Start the background checkpoint of SQLite DB.
+@param  None.
+@return None.
+*/
+void Archive::startCheckpoint()
+{
+    if(mCkpt != nullptr) return;
+
+    mCkpt = new ArhCheckpoint();
+    mCkpt->mFile     = mDb;
+    mCkpt->mInterval = mCheckpoint;
+    mCkpt->mFileLog  = mFileLog;
+    mCkpt->mUseLog   = mUseLog;
+
+    mCkptThread = new QThread();
+    mCkpt->moveToThread(mCkptThread);
+
+    connect(mCkptThread, &QThread::started, mCkpt, &ArhCheckpoint::start);
+
+    mCkptThread->start();
+}
+
+
+/**
+@brief  Claim the background checkpoint of SQLite DB file.
+@param  None.
+@return true if the checkpoint of the file is owned by this archive, otherwise - false.
+@details The file is claimed by the first archive, it is released by stopCheckpoint.
+*/
+bool Archive::claimCheckpoint()
+{
+    if(mCkpt != nullptr) return (true);
+
+    QString File = QFileInfo(mDb).absoluteFilePath();
+    QMutexLocker Locker(&mCkptMutex);
+
+    if(mCkptFiles.contains(File)) return (false);
+
+    mCkptFiles.insert(File);
+    return (true);
+}
+
+
+/**
+@brief  Stop the background checkpoint of SQLite DB.
+@param  None.
+@return None.
+*/
+void Archive::stopCheckpoint()
+{
+    if(mCkpt == nullptr) return;
+
+    //the connection of checkpoint is closed before the file is released
+    QMetaObject::invokeMethod(mCkpt, "stop", Qt::BlockingQueuedConnection);
+
+    mCkptThread->quit();
+    mCkptThread->wait();
+    delete mCkpt;
+    delete mCkptThread;
+
+    mCkpt       = nullptr;
+    mCkptThread = nullptr;
+
+    QMutexLocker Locker(&mCkptMutex);
+    mCkptFiles.remove(QFileInfo(mDb).absoluteFilePath());
+}
+#endif
+
+
+/**
+@brief  Check connection with DB.
+@param  None.
+@return true if connection is established, otherwise - false.
+*/
+bool Archive::isDbConnected()
+{
+#ifdef WITH_SQLITE
+    if(mDriver == DRIVER__SQLITE) return (mLiteCli->isConnected());
+#endif
+
+    return (mDbCli->isConnected());
+}
+
+
+/**
+@brief  Check options of DB connection.
+@param  None.
+@return true if options are set, otherwise - false.
+*/
+bool Archive::isDbAllowed()
+{
+#ifdef WITH_SQLITE
+    if(mDriver == DRIVER__SQLITE) return ((!mDb.isEmpty()) ? true : false);
+#else
+    if(mDriver == DRIVER__SQLITE) return (false);
+#endif
+
+    return ((!mHost.isEmpty() && mPort > 0 && !mUser.isEmpty() && !mDb.isEmpty()) ? true : false);
+}
+
+
+/**
+@brief  Get connection with DB.
+@param  None.
+@return true if connection is established, otherwise - false.
+@details The opened connection is checked by ping.
+         A new connection is not tried before the end of the reconnect delay.
+*/
+bool Archive::connectDb()
+{
+    if(mDriver == DRIVER__SQLITE)
+    {
+#ifdef WITH_SQLITE
+        if(mLiteCli->isConnected()) return (true);
+
+        //the file is checkpointed by the archive that owns the checkpoint of it,
+        //other archives of the file do not checkpoint WAL if the owner exists
+        bool Owner = ((mCheckpoint > 0) ? this->claimCheckpoint() : false);
+
+        mLiteCli->mFile           = mDb;
+        mLiteCli->mAutoCheckpoint = ((mCheckpoint > 0) ? false : true);
+
+        if(mLiteCli->connect())
+        {
+            LOG_DEBUG(QString("SQLite DB is opened: %1").arg(mDb), mFileLog, mUseLog);
+
+            if(Owner) this->startCheckpoint();
+            return (true);
+        }
+
+        if(Owner && mCkpt == nullptr)
+        {
+            QMutexLocker Locker(&mCkptMutex);
+            mCkptFiles.remove(QFileInfo(mDb).absoluteFilePath());
+        }
+
+        LOG_ERROR(QString("Error open SQLite DB (%1)! %2) %3").arg(QString::number(mLiteCli->getErrorNo()), mLiteCli->getError(), mDb), mFileLog, mUseLog);
+#endif
+        return (false);
+    }
+
+    if(mDbCli->isConnected())
+    {
+        if(mDbCli->ping()) return (true);
+
+        LOG_WARN(QString("Connection with MySQL DB is lost (%1)! %2").arg(QString::number(mDbCli->getErrorNo()), mDbCli->getError()), mFileLog, mUseLog);
+        this->disconnectDb();
+    }
+
+    qint64 Now = QDateTime::currentMSecsSinceEpoch();
+    if(Now < mReconnectAt) return (false);
+
+    mDbCli->mHost   = mHost;
+    mDbCli->mPort   = mPort;
+    mDbCli->mUser   = mUser;
+    mDbCli->mPasswd = mPasswd;
+    mDbCli->mDB     = mDb;
+    mDbCli->mLocalInfile = mUseInfile;
+
+    if(mDbCli->connect())
+    {
+        LOG_DEBUG(QString("Connection with MySQL DB is established: %1@%2:%3/%4").arg(mDbCli->mUser, mDbCli->mHost, QString::number(mDbCli->mPort), mDbCli->mDB), mFileLog, mUseLog);
+
+        mReconnectDelay = 0;
+        mReconnectAt    = 0;
+        mInfileRefused  = false;
+        return (true);
+    }
+
+    mReconnectDelay = ((mReconnectDelay > 0) ? qMin(mReconnectDelay*2, mReconnectMax) : mReconnectMin);
+    mReconnectAt    = Now + static_cast<qint64>(mReconnectDelay)*1000;
+
+    LOG_ERROR(QString("Error connecting to DB (%1)! %2) Next attempt in %3 sec.").arg(QString::number(mDbCli->getErrorNo()), mDbCli->getError(), QString::number(mReconnectDelay)), mFileLog, mUseLog);
+
+    return (false);
+}
+
+
+/**
+@brief  Close connection with DB.
+@param  None.
+@return None.
+*/
+void Archive::disconnectDb()
+{
+#ifdef WITH_SQLITE
+    if(mLiteCli->isConnected())
+    {
+        mLiteCli->disconnect();
+        mLiteTables.clear();
+        LOG_DEBUG(QString("SQLite DB is closed."), mFileLog, mUseLog);
+    }
+#endif
+
+    if(mDbCli->isConnected())
+    {
+        mDbCli->disconnect();
+        LOG_DEBUG(QString("Connection with MySQL DB is closed."), mFileLog, mUseLog);
+    }
+}
+
+
+/**
+@brief  Keepalive of DB connection.
+@param  None.
+@return None.
+@details Ping the DB server, reconnect if the connection is lost.
+*/
+void Archive::keepalive()
+{
+    if(this->isDbAllowed())
+    {
+        LOG_TRACE(QString("Archive::keepalive()"), mFileLog, mUseLog);
+        this->connectDb();
+    }
+}
+
+
+/**
+@brief  Drain the spool.
+@param  None.
+@return None.
+@details Send up to mSpoolRate rows of the spool into DB.
+*/
+void Archive::drainSpool()
+{
+    if(!mSpool->isOpened() || mSpool->isEmpty() || !this->isDbAllowed()) return;
+    if(!this->connectDb()) return;
+
+    QByteArray Record;
+    QString Query, Table;
+    QList<ArhRow> ListRows;
+    ArhPart Part;
+    int Rows = 0, nRows;
+    bool Multi;
+
+    while(Rows < mSpoolRate && mSpool->peek(Record))
+    {
+        if(ArhSpool::unpack(Record, Query, nRows, Table, ListRows))
+        {
+            Part.mQuery = Query;
+            Part.mTable = Table;
+            Part.mRows  = &ListRows;
+            Part.mFrom  = 0;
+            Part.mCount = ((Query.isEmpty()) ? ListRows.size() : nRows);
+
+            //rows of SQLite are sent one by one, rows of MySQL by STMT__ROWS_MAX (LOAD DATA may be refused):
+            //such record is sent by one transaction, so a pop is done only after its commit
+            Multi = ((Query.isEmpty() && (mDriver == DRIVER__SQLITE || Part.mCount > STMT__ROWS_MAX)) ? true : false);
+
+            if(!((Multi) ? this->sendPartTrans(Part) : this->sendPart(Part)))
+            {
+                //the record stays in the spool
+                if(!this->isDbConnected()) break;
+
+                LOG_ERROR(QString("The spooled data is lost (%1 rows)!").arg(QString::number(Part.mCount)), mFileLog, mUseLog);
+            }
+
+            Rows+= qMax(Part.mCount, 1);
+        }
+        else
+        {
+            LOG_ERROR(QString("The spooled record is broken!"), mFileLog, mUseLog);
+        }
+
+        mSpool->pop();
+    }
+
+    if(Rows) LOG_DEBUG(QString("Archive::drainSpool(%1 rows, spool %2 bytes)").arg(QString::number(Rows), QString::number(mSpool->size())), mFileLog, mUseLog);
+}
+
+
+/**
+@brief  Maintenance of tables.
+@param  None.
+@return None.
+@details Roll up and delete expired rows by bounded chunks during one slice (MAINT__SLICE_MSEC).
+*/
+void Archive::maintain()
+{
+    if(mRetention <= 0 || mMaintTables.isEmpty() || !this->isDbAllowed()) return;
+
+    //the slice must not delay the next tick
+    if(mTimer->isActive() && mTimer->remainingTime() < MAINT__SLICE_MSEC) return;
+    if(!this->connectDb()) return;
+
+    QElapsedTimer Timer;
+    Timer.start();
+
+    QDateTime Now = QDateTime::currentDateTime();
+    QDateTime Expired = Now.addDays(-mRetention);
+    QDateTime RollupExpired = Now.addDays(-mRollupRetention);
+    QSet<QString>::const_iterator It;
+    int Rows = 0, Total = 0;
+
+    //the aggregates of the profile ("1min.max") expire with its rows, the rolled up rows are not aggregated
+    QStringList ListProfiles = ArhAggr::toString(ArhAggr::FUNC__MIN | ArhAggr::FUNC__MAX | ArhAggr::FUNC__AVG | ArhAggr::FUNC__TWA |
+                                                 ArhAggr::FUNC__FIRST | ArhAggr::FUNC__LAST | ArhAggr::FUNC__COUNT).split(QChar(','));
+
+    for(int i=0; i<ListProfiles.size(); i++) ListProfiles[i] = QString("%1.%2").arg(mProfile, ListProfiles.at(i));
+    if(mRollup.isEmpty()) ListProfiles.prepend(mProfile);
+
+    for(It = mMaintTables.constBegin(); It != mMaintTables.constEnd() && Rows >= 0; ++It)
+    {
+        Rows = this->checkMaintIndex(*It);
+        if(Rows <= 0) continue;
+
+        while(Timer.elapsed() < MAINT__SLICE_MSEC)
+        {
+            Rows = ((mRollup.isEmpty()) ? 0 : this->rollupRows(*It, Expired));
+            if(Rows == 0) Rows = this->expireRows(*It, ListProfiles, Expired);
+            if(Rows == 0 && mRollupRetention > 0) Rows = this->expireRows(*It, QStringList(mRollupProfile), RollupExpired);
+            if(Rows <= 0) break;
+
+            Total+= Rows;
+        }
+    }
+
+    //the rest of expired rows is handled by the next slices
+    mMaintTimer->setInterval(((Total > 0) ? MAINT__BUSY_MSEC : MAINT__IDLE_MSEC));
+
+    if(Total) LOG_DEBUG(QString("Archive::maintain(%1 rows, %2 msec)").arg(QString::number(Total), QString::number(Timer.elapsed())), mFileLog, mUseLog);
+}
+
+
+/**
+@brief  Send a query of maintenance.
+@param  QueryIn - SQL-query;
+@param  RowsIn - link to the number of changed rows.
+@return true if OK, otherwise - false.
+*/
+bool Archive::sendMaintQuery(const QString &QueryIn, int &RowsIn)
+{
+    RowsIn = 0;
+
+    if(mDriver == DRIVER__SQLITE)
+    {
+#ifdef WITH_SQLITE
+        if(mLiteCli->sendQuery(QueryIn))
+        {
+            RowsIn = mLiteCli->getChanges();
+            return (true);
+        }
+
+        LOG_ERROR(QString("Error send query of maintenance (%1)! %2)").arg(QString::number(mLiteCli->getErrorNo()), mLiteCli->getError()), mFileLog, mUseLog);
+#endif
+        return (false);
+    }
+
+    if(mDbCli->sendQuery(QueryIn))
+    {
+        RowsIn = static_cast<int>(mDbCli->getAffectedRows());
+        return (true);
+    }
+
+    LOG_ERROR(QString("Error send query of maintenance (%1)! %2)").arg(QString::number(mDbCli->getErrorNo()), mDbCli->getError()), mFileLog, mUseLog);
+
+    if(!mDbCli->ping()) this->disconnectDb();
+    return (false);
+}
+
+
+/**
+@brief  Send a query of maintenance and get one value.
+@param  QueryIn - SQL-query (SELECT);
+@param  ValueIn - link to value.
+@return true if OK, otherwise - false.
+*/
+bool Archive::selectMaintValue(const QString &QueryIn, QString &ValueIn)
+{
+    if(mDriver == DRIVER__SQLITE)
+    {
+#ifdef WITH_SQLITE
+        if(mLiteCli->selectValue(QueryIn, ValueIn)) return (true);
+
+        LOG_ERROR(QString("Error send query of maintenance (%1)! %2)").arg(QString::number(mLiteCli->getErrorNo()), mLiteCli->getError()), mFileLog, mUseLog);
+#endif
+        return (false);
+    }
+
+    if(mDbCli->selectValue(QueryIn, ValueIn)) return (true);
+
+    LOG_ERROR(QString("Error send query of maintenance (%1)! %2)").arg(QString::number(mDbCli->getErrorNo()), mDbCli->getError()), mFileLog, mUseLog);
+
+    if(!mDbCli->ping()) this->disconnectDb();
+    return (false);
+}
+
+
+/**
+@brief  Check the index of maintenance of a table.
+@param  TableIn - name of table.
+@return 1 if the index (`profile`,`stamp`) exists, 0 if it is absent (-1 if error).
+@details Without the index DELETE of MySQL scans and locks the whole table, so such table is not maintained.
+         A table is checked once (the result is kept in mMaintIndexed).
+*/
+int Archive::checkMaintIndex(const QString &TableIn)
+{
+    //the index of SQLite is created with the table (see initLiteTable)
+    if(mDriver == DRIVER__SQLITE) return (1);
+    if(mMaintIndexed.contains(TableIn)) return ((mMaintIndexed.value(TableIn)) ? 1 : 0);
+
+    //any index (PRIMARY too) that starts by `profile`,`stamp`
+    QString Value;
+    QString Query = QString("SELECT COUNT(*) FROM `information_schema`.`STATISTICS` s1 JOIN `information_schema`.`STATISTICS` s2 "
+                            "ON s2.`TABLE_SCHEMA`=s1.`TABLE_SCHEMA` AND s2.`TABLE_NAME`=s1.`TABLE_NAME` AND s2.`INDEX_NAME`=s1.`INDEX_NAME` "
+                            "WHERE s1.`TABLE_SCHEMA`=DATABASE() AND s1.`TABLE_NAME`='%1' AND s1.`COLUMN_NAME`='profile' AND s1.`SEQ_IN_INDEX`=1 "
+                            "AND s2.`COLUMN_NAME`='stamp' AND s2.`SEQ_IN_INDEX`=2").arg(TableIn);
+
+    if(!this->selectMaintValue(Query, Value)) return (-1);
+
+    bool Indexed = ((Value.toInt() > 0) ? true : false);
+    mMaintIndexed.insert(TableIn, Indexed);
+
+    if(!Indexed) LOG_WARN(QString("Table %1 has no index (`profile`,`stamp`), expired rows are not deleted! Add it: ALTER TABLE `%1` ADD INDEX `%1_stamp`(`profile`,`stamp`);").arg(TableIn), mFileLog, mUseLog);
+
+    return ((Indexed) ? 1 : 0);
+}
+
+
+/**
+@brief  Delete one chunk of rows.
+@param  TableIn - name of table;
+@param  WhereIn - condition.
+@return The number of deleted rows (-1 if error).
+*/
+int Archive::deleteChunk(const QString &TableIn, const QString &WhereIn)
+{
+    //each chunk is committed at once and is selected by the range of index (`profile`,`stamp`), so the locks are short
+    QString Query = ((mDriver == DRIVER__SQLITE) ? QString("DELETE FROM `%1` WHERE rowid IN (SELECT rowid FROM `%1` WHERE %2 LIMIT %3)").arg(TableIn, WhereIn, QString::number(mRetentionChunk))
+                                                 : QString("DELETE FROM `%1` WHERE %2 LIMIT %3").arg(TableIn, WhereIn, QString::number(mRetentionChunk)));
+    int Rows = 0;
+
+    return ((this->sendMaintQuery(Query, Rows)) ? Rows : -1);
+}
+
+
+/**
+@brief  Delete expired rows of profiles.
+@param  TableIn - name of table;
+@param  ListProfilesIn - profiles;
+@param  ExpiredIn - the rows older than this date and time are expired.
+@return The number of deleted rows or partitions (-1 if error).
+@details One partition or one chunk is deleted by a call.
+*/
+int Archive::expireRows(const QString &TableIn, const QStringList &ListProfilesIn, const QDateTime &ExpiredIn)
+{
+    if(mRetentionParts && ListProfilesIn.contains(mProfile))
+    {
+        int Res = this->dropPartition(TableIn, ExpiredIn);
+        if(Res != 0) return (Res);
+    }
+
+    QString Expired;
+    Register::packStampISO(ExpiredIn, Expired);
+
+    return (this->deleteChunk(TableIn, QString("`profile` IN ('%1') AND `stamp`<'%2'").arg(ListProfilesIn.join(QString("','")), Expired)));
+}
+
+
+/**
+@brief  Drop the oldest expired partition of MySQL table.
+@param  TableIn - name of table;
+@param  ExpiredIn - the rows older than this date and time are expired.
+@return 1 if a partition is dropped, 0 if there are no expired partitions (-1 if error).
+*/
+int Archive::dropPartition(const QString &TableIn, const QDateTime &ExpiredIn)
+{
+    QString Expired, Partition;
+    Register::packStampISO(ExpiredIn, Expired);
+
+    //the upper bound of the partition (LESS THAN) is not later than the expired stamp
+    QString Query = QString("SELECT `PARTITION_NAME` FROM `information_schema`.`PARTITIONS` WHERE `TABLE_SCHEMA`=DATABASE() AND `TABLE_NAME`='%1' AND `PARTITION_DESCRIPTION`<>'MAXVALUE' AND "
+                            "((`PARTITION_METHOD`='RANGE' AND `PARTITION_EXPRESSION` LIKE 'to_days(%stamp%)' AND CAST(`PARTITION_DESCRIPTION` AS SIGNED)<=TO_DAYS('%2')) OR "
+                            "(`PARTITION_METHOD`='RANGE COLUMNS' AND `PARTITION_EXPRESSION` LIKE '%stamp%' AND TRIM(BOTH '\\'' FROM `PARTITION_DESCRIPTION`)<='%2')) "
+                            "ORDER BY `PARTITION_ORDINAL_POSITION` LIMIT 1").arg(TableIn, Expired);
+
+    if(!this->selectMaintValue(Query, Partition)) return (-1);
+    if(Partition.isEmpty()) return (0);
+
+    int Rows = 0;
+    if(!this->sendMaintQuery(QString("ALTER TABLE `%1` DROP PARTITION `%2`").arg(TableIn, Partition), Rows)) return (-1);
+
+    Log::log(QString("Expired partition is dropped: %1.%2").arg(TableIn, Partition), mFileLog, mUseLog);
+
+    return (1);
+}
+
+
+/**
+@brief  Check that expired partitions may be dropped.
+@param  CommonIn - common options (the event archive);
+@param  ListProfilesIn - options of profiles (see toProfiles());
+@param  UseEventIn - the event archive is used.
+@return true if the rows of other archives of the DB expire not later than the rows of this profile, otherwise - false.
+@details Other profiles of the DB must have a retention not longer than this one (the rollup rows too),
+         the event archive is not maintained, so it must write to another DB.
+*/
+bool Archive::isPartsAllowed(const QJsonObject &CommonIn, const QList<QJsonObject> &ListProfilesIn, const bool UseEventIn)
+{
+    QList<QJsonObject> ListObjs = ListProfilesIn;
+    if(UseEventIn) ListObjs.append(CommonIn);
+
+    QJsonObject Obj;
+    int Retention = 0, RollupRetention = 0;
+
+    for(int i=0; i<ListObjs.size(); i++)
+    {
+        if(i == mIndex && i < ListProfilesIn.size()) continue;
+
+        Obj = ListObjs.at(i);
+
+        //the tables of another DB are not touched
+        if(Obj.value(FIELD__DRIVER).toString(DRIVER__MYSQL) == DRIVER__SQLITE) continue;
+        if(Obj.value(FIELD__HOST).toString("") != mHost || static_cast<quint32>(Obj.value(FIELD__PORT).toInt(0)) != mPort) continue;
+        if(Obj.value(FIELD__DB).toString(QString("")) != mDb) continue;
+
+        //the event archive keeps its rows forever
+        if(i >= ListProfilesIn.size()) return (false);
+
+        Retention = Obj.value(FIELD__RETENTION).toInt(0);
+        if(Retention <= 0 || Retention > mRetention) return (false);
+
+        if(!Obj.value(FIELD__ROLLUP).toString(QString("")).isEmpty())
+        {
+            RollupRetention = Obj.value(FIELD__ROLLUP_RETENTION).toInt(0);
+            if(RollupRetention <= 0 || RollupRetention > mRetention) return (false);
+        }
+    }
+
+    return (true);
+}
+
+
+/**
+@brief  Roll up expired rows of the profile.
+@param  TableIn - name of table;
+@param  ExpiredIn - the rows older than this date and time are expired.
+@return The number of handled rows (-1 if error).
+@details The rows are handled by windows of the rollup profile: the rollup row is inserted once for a window,
+         then the rows of the window are deleted by chunks (one chunk by a call).
+*/
+int Archive::rollupRows(const QString &TableIn, const QDateTime &ExpiredIn)
+{
+    QString Expired, From, To, Value;
+    Register::packStampISO(ExpiredIn, Expired);
+
+    int Period = getTimedProfile(mRollup)/1000;
+    QDateTime End = mMaintWindow.value(TableIn);
+
+    if(!End.isValid())
+    {
+        if(!this->selectMaintValue(QString("SELECT MIN(`stamp`) FROM `%1` WHERE `profile`='%2' AND `stamp`<'%3'").arg(TableIn, mProfile, Expired), Value)) return (-1);
+        if(Value.isEmpty()) return (0);
+
+        //the rows are stamped by the end of interval: the window (End-Period, End] is aligned by the rollup profile
+        QDateTime First = QDateTime::fromString(Value.left(19), QString("yyyy-MM-dd hh:mm:ss"));
+        if(!First.isValid()) return (0);
+
+        int Sec = First.time().msecsSinceStartOfDay()/1000;
+        End = QDateTime(First.date(), QTime(0, 0)).addSecs(Sec - (Sec % Period));
+        if(End < First) End = End.addSecs(Period);
+
+        //the window is handled when all its rows are expired
+        if(End >= ExpiredIn) return (0);
+
+        Register::packStampISO(End.addSecs(-Period), From);
+        Register::packStampISO(End, To);
+
+        //the rollup row is not inserted again if the window was interrupted (restart of server)
+        if(!this->selectMaintValue(QString("SELECT 1 FROM `%1` WHERE `profile`='%2' AND `stamp`='%3' LIMIT 1").arg(TableIn, mRollupProfile, To), Value)) return (-1);
+
+        if(Value.isEmpty())
+        {
+            int Rows = 0;
+            QString Query = QString("INSERT INTO `%1`(`stamp`,`profile`,`device_id`,`register_id`,`value`,`ex`,`err`,`sign`) "
+                                    "SELECT '%4','%3',`device_id`,`register_id`,AVG(`value`),MAX(`ex`),MAX(`err`),MAX(`sign`) FROM `%1` "
+                                    "WHERE `profile`='%2' AND `stamp`>'%5' AND `stamp`<='%4' GROUP BY `device_id`,`register_id`").arg(TableIn, mProfile, mRollupProfile, To, From);
+
+            if(!this->sendMaintQuery(Query, Rows)) return (-1);
+
+            LOG_DEBUG(QString("The rows are rolled up (%1: %2 -> %3 rows of %4)").arg(TableIn, mProfile, QString::number(Rows), To), mFileLog, mUseLog);
+        }
+
+        mMaintWindow.insert(TableIn, End);
+    }
+
+    Register::packStampISO(End.addSecs(-Period), From);
+    Register::packStampISO(End, To);
+
+    int Rows = this->deleteChunk(TableIn, QString("`profile`='%1' AND `stamp`>'%2' AND `stamp`<='%3'").arg(mProfile, From, To));
+
+    //the window is done (or error)
+    if(Rows < mRetentionChunk) mMaintWindow.remove(TableIn);
+
+    return ((Rows < 0) ? Rows : qMax(Rows, 1));
+}
@@ -22,16 +22,74 @@
 #define ARH_H
 
 #include <iostream>
+#include <cstring>
 #include <QObject>
 #include <QList>
+#include <QMap>
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+#include <QVector>
 #include <QTimer>
+#include <QThread>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QJsonObject>
+#include <QJsonArray>
 
 #include "log.h"
 #include "json.h"
 #include "mysql-cli.h"
+#ifdef WITH_SQLITE
+#include "sqlite-cli.h"
+#include "arh-checkpoint.h"
+#endif
+#include "arh-spool.h"
+#include "arh-aggr.h"
+#include "arh-store.h"
+#include "arh-comp.h"
+#include "snapshot.h"
 #include "network.h"
 
 
+/**
+@brief Part of archive transaction.
+@details Either SQL-query (mQuery) or rows of a table sent by prepared statement (mTable, mRows).
+*/
+class ArhPart
+{
+public:
+
+    /**
+    @brief SQL-query.
+    */
+    QString mQuery;
+
+    /**
+    @brief Name of table.
+    */
+    QString mTable;
+
+    /**
+    @brief Link to list of rows.
+    */
+    const QList<ArhRow> *mRows;
+
+    /**
+    @brief Index of the first row.
+    */
+    int mFrom;
+
+    /**
+    @brief The number of rows.
+    */
+    int mCount;
+};
+
+
 /**
 @brief Archive.
 */
@@ -74,10 +132,37 @@ public:
     static const QString FIELD__FILE_LOG;
     static const QString FIELD__FILE_LOG_EVENT;
     static const QString FIELD__MODE;
+    static const QString FIELD__KEEPALIVE;
+    static const QString FIELD__RECONNECT_MIN;
+    static const QString FIELD__RECONNECT_MAX;
+    static const QString FIELD__USE_STMT;
+    static const QString FIELD__USE_TRANS;
+    static const QString FIELD__USE_INFILE;
+    static const QString FIELD__TRANS_ROWS;
+    static const QString FIELD__TRANS_RETRY;
+    static const QString FIELD__SPOOL;
+    static const QString FIELD__SPOOL_MAX_SIZE;
+    static const QString FIELD__SPOOL_SEGMENT;
+    static const QString FIELD__SPOOL_RATE;
+    static const QString FIELD__SPOOL_TIMEOUT;
+    static const QString FIELD__AGGREGATE;
+    static const QString FIELD__STORE;
+    static const QString FIELD__STORE_PART;
+    static const QString FIELD__STORE_BLOCK;
+    static const QString FIELD__STORE_FLUSH;
+    static const QString FIELD__DRIVER;
+    static const QString FIELD__CHECKPOINT;
+    static const QString FIELD__PROFILES;
+    static const QString FIELD__RETENTION;
+    static const QString FIELD__RETENTION_CHUNK;
+    static const QString FIELD__RETENTION_PARTS;
+    static const QString FIELD__ROLLUP;
+    static const QString FIELD__ROLLUP_RETENTION;
 
     /**
     @brief Named profiles
     */
+    static const QString PROFILE__1SEC;
     static const QString PROFILE__1MIN;
     static const QString PROFILE__5MIN;
     static const QString PROFILE__15MIN;
@@ -88,6 +173,7 @@ public:
     /**
     @brief Timed profiles (msec)
     */
+    static const int PROFILE__1SEC_MSEC  = 1000;
     static const int PROFILE__1MIN_MSEC  = 60000;
     static const int PROFILE__5MIN_MSEC  = 300000;
     static const int PROFILE__15MIN_MSEC = 900000;
@@ -100,6 +186,65 @@ public:
     */
     static const QString DEFAUL__HOST;
     static const quint32 DEFAUL__PORT = 3306;
+    static const int DEFAUL__KEEPALIVE     = 60;
+    static const int DEFAUL__RECONNECT_MIN = 1;
+    static const int DEFAUL__RECONNECT_MAX = 300;
+    static const int DEFAUL__TRANS_ROWS    = 5000;
+    static const int DEFAUL__TRANS_RETRY   = 1;
+    static const int DEFAUL__SPOOL_MAX_SIZE = 102400;
+    static const int DEFAUL__SPOOL_SEGMENT  = 1024;
+    static const int DEFAUL__SPOOL_RATE     = 1000;
+    static const int DEFAUL__SPOOL_TIMEOUT  = 30;
+    static const int DEFAUL__STORE_PARTITION = 24;
+    static const int DEFAUL__STORE_BLOCK     = 256;
+    static const int DEFAUL__STORE_FLUSH     = 300;
+    static const int DEFAUL__CHECKPOINT      = 10;
+    static const int DEFAUL__RETENTION_CHUNK = 1000;
+
+    /**
+    @brief Limites
+    */
+    static const int KEEPALIVE__MAX     = 28800;
+    static const int RECONNECT__MAX_MAX = 3600;
+    static const int TRANS_ROWS__MAX    = 100000;
+    static const int TRANS_RETRY__MAX   = 10;
+    static const int SPOOL_SEGMENT__MIN = 16;
+    static const int SPOOL_RATE__MIN    = 1;
+    static const int STORE_PARTITION__MAX = 168;
+    static const int STORE_BLOCK__MIN     = 16;
+    static const int STORE_BLOCK__MAX     = 4096;
+    static const int CHECKPOINT__MAX      = 3600;
+    static const int RETENTION__MAX       = 36500;
+    static const int RETENTION_CHUNK__MIN = 100;
+    static const int RETENTION_CHUNK__MAX = 100000;
+
+    /**
+    @brief Interval of draining of the spool (msec)
+    */
+    static const int SPOOL__DRAIN_MSEC = 1000;
+
+    /**
+    @brief Maintenance of tables (retention and rollup)
+    @details MAINT__SLICE_MSEC - maximal time of one slice (the ticks of archive wait for it);
+             MAINT__BUSY_MSEC - interval while there are expired rows;
+             MAINT__IDLE_MSEC - interval while there are no expired rows.
+    */
+    static const int MAINT__SLICE_MSEC = 200;
+    static const int MAINT__BUSY_MSEC  = 1000;
+    static const int MAINT__IDLE_MSEC  = 60000;
+
+    /**
+    @brief Prepared statements
+    @details STMT__ROWS_MAX*STMT__COLUMNS must be less than 65535 (the limit of placeholders)
+    */
+    static const int STMT__COLUMNS   = 8;
+    static const int STMT__ROWS_MAX  = 512;
+    static const int STMT__CACHE_MAX = 32;
+
+    /**
+    @brief Maximal number of rows of one LOAD DATA LOCAL INFILE
+    */
+    static const int INFILE__ROWS_MAX = 65536;
 
     /**
     @brief Modes
@@ -107,6 +252,12 @@ public:
     static const quint8 MODE__PERIODIC = 0;
     static const quint8 MODE__EVENT    = 1;
 
+    /**
+    @brief Drivers of DB
+    */
+    static const QString DRIVER__MYSQL;
+    static const QString DRIVER__SQLITE;
+
 
     /**
     Public options
@@ -138,9 +289,23 @@ public:
 
     /**
     @brief Name of selected database.
+    @detailed Path to the database file for DRIVER__SQLITE.
     */
     QString mDb;
 
+    /**
+    @brief Driver of DB (DRIVER__MYSQL or DRIVER__SQLITE).
+    @detailed DRIVER__MYSQL by default. Host, Port, User and Passwd are not used by DRIVER__SQLITE.
+              DRIVER__SQLITE is supported if the server is built with SQLite (qmake CONFIG+=sqlite, WITH_SQLITE).
+    */
+    QString mDriver;
+
+    /**
+    @brief Interval of checkpoint of WAL by the background thread (sec).
+    @detailed Is used only by DRIVER__SQLITE (0 - WAL is checkpointed by the archive itself).
+    */
+    int mCheckpoint;
+
     /**
     @brief Name of profile.
     */
@@ -156,6 +321,117 @@ public:
     */
     bool mUseLog;
 
+    /**
+    @brief Interval of keepalive ping of DB connection (sec).
+    @detailed 0 - keepalive is disabled.
+    */
+    int mKeepalive;
+
+    /**
+    @brief Initial delay before reconnect to DB (sec).
+    @detailed The delay is doubled after each failed attempt up to mReconnectMax.
+    */
+    int mReconnectMin;
+
+    /**
+    @brief Maximal delay before reconnect to DB (sec).
+    */
+    int mReconnectMax;
+
+    /**
+    @brief Use prepared statements to save data into DB.
+    @detailed true by default (is not used for SQL_PROC_TRM).
+    */
+    bool mUseStmt;
+
+    /**
+    @brief Save all data of one tick in one transaction.
+    @detailed false by default (autocommit of each query).
+    */
+    bool mUseTrans;
+
+    /**
+    @brief Use LOAD DATA LOCAL INFILE to save rows into MySQL DB.
+    @detailed false by default (the rows are streamed from memory, prepared statements are used if the server refuses local infile).
+    */
+    bool mUseInfile;
+
+    /**
+    @brief The server refused LOAD DATA LOCAL INFILE.
+    @detailed Is reset by connection with DB.
+    */
+    bool mInfileRefused;
+
+    /**
+    @brief Maximal number of rows in one transaction.
+    @detailed A tick with more rows is committed by several transactions.
+    */
+    int mTransRows;
+
+    /**
+    @brief The number of retries of a failed transaction.
+    @detailed The transaction is rolled back and sent again (0 - no retries).
+    */
+    int mTransRetry;
+
+    /**
+    @brief Path to directory of spool.
+    @detailed The data is kept in the spool while DB is unavailable or slow ("" - disabled).
+    */
+    QString mSpoolDir;
+
+    /**
+    @brief Maximal size of the spool (KB).
+    @detailed The oldest segments are dropped if the spool is larger.
+    */
+    int mSpoolMaxSize;
+
+    /**
+    @brief Size of one segment of the spool (KB).
+    */
+    int mSpoolSegment;
+
+    /**
+    @brief Maximal number of rows sent from the spool per second.
+    */
+    int mSpoolRate;
+
+    /**
+    @brief Maximal time of saving data of one tick into DB (sec).
+    @detailed The rest of data is spooled (0 - disabled).
+    */
+    int mSpoolTimeout;
+
+    /**
+    @brief Aggregates of registers between ticks (bit mask of ArhAggr::FUNC__*).
+    @detailed Option "Aggregate" is a list of functions: "min,max,avg,twa,first,last,count" ("" - disabled).
+              Is used only in periodic mode.
+    */
+    quint8 mAggregate;
+
+    /**
+    @brief Path to directory of the embedded store.
+    @detailed Registers of devices with option "ArhStore" are written each survey cycle ("" - disabled).
+              Is used only in periodic mode.
+    */
+    QString mStoreDir;
+
+    /**
+    @brief Length of time partition of the store (hours).
+    */
+    int mStorePartition;
+
+    /**
+    @brief The number of samples of one block of the store.
+    */
+    int mStoreBlock;
+
+    /**
+    @brief Interval of writing of open blocks of the store (sec).
+    @detailed 0 - the blocks are written only when they are full.
+    */
+    int mStoreFlush;
+
 
     /**
     Public methods
@@ -170,10 +446,30 @@ public:
 
     /**
     @brief  Read configuration from a file.
-    @param  FileIn - path to a file.
+    @param  FileIn - path to a file;
+    @param  IdxIn - index of profile (see toProfiles());
+    @param  UseEventIn - the event archive is used (it writes to the DB of the common options).
     @return true if success, otherwise - false.
+    @details The event archive reads the common options (Profiles are not used).
     */
-    bool readFileConfig(const QString &FileIn);
+    bool readFileConfig(const QString &FileIn, const int IdxIn = 0, const bool UseEventIn = false);
+
+    /**
+    @brief  Get options of profiles.
+    @param  DocIn - link to JsonDocument;
+    @param  ListProfilesIn - link to list of options of profiles.
+    @return The number of profiles.
+    @details Each item of "Profiles" is merged over the common options: { ...common options..., Profiles:[ { Profile:"1min", ... }, ... ] }
+             The common options are one profile if "Profiles" is not set.
+    */
+    static int toProfiles(const QJsonDocument &DocIn, QList<QJsonObject> &ListProfilesIn);
+
+    /**
+    @brief  Get the number of profiles of a configuration file.
+    @param  FileIn - path to a file.
+    @return The number of profiles.
+    */
+    static int sizeProfiles(const QString &FileIn);
 
     /**
     @brief  Check option "Profile".
@@ -203,6 +499,14 @@ public:
     */
     int getTimedProfile(const QString &ProfileIn);
 
+    /**
+    @brief  Get the store.
+    @param  None.
+    @return Pointer to the store or nullptr if the store is not opened.
+    @details The store is thread-safe: it is read by queries of history from other threads.
+    */
+    ArhStore *getStore();
+
 
 public slots:
 
@@ -230,6 +534,47 @@ public slots:
     */
     void save();
 
+    /**
+    @brief  Keepalive of DB connection.
+    @param  None.
+    @return None.
+    @details Ping the DB server, reconnect if the connection is lost.
+    */
+    void keepalive();
+
+    /**
+    @brief  Drain the spool.
+    @param  None.
+    @return None.
+    @details Send up to mSpoolRate rows of the spool into DB.
+    */
+    void drainSpool();
+
+    /**
+    @brief  Maintenance of tables.
+    @param  None.
+    @return None.
+    @details Roll up and delete expired rows by bounded chunks during one slice (MAINT__SLICE_MSEC).
+    */
+    void maintain();
+
+    /**
+    @brief  Accumulate the current snapshot.
+    @param  None.
+    @return None.
+    @details Update running aggregates of registers (O(1) per register) and append samples into the store.
+             Is called after each survey cycle, a snapshot is accumulated once.
+    */
+    void accumulate();
+
+    /**
+    @brief  Save rows of events into a storage.
+    @param  ListDevicesIn - list of devices with rows of events.
+    @return None.
+    @details Is called by the survey (queued) when events of registers have been raised or cleared (event mode only).
+    */
+    void addEvents(const QList<SnapshotDevice> &ListDevicesIn);
+
 
 private:
 
@@ -243,11 +588,163 @@ private:
     */
     quint8 mMode;
 
+    /**
+    @brief Index of profile (see toProfiles()).
+    @details The embedded store is written only by the first profile.
+    */
+    int mIndex;
+
+    /**
+    @brief Retention of rows of the profile (days).
+    @details 0 - the rows are kept forever (periodic mode only).
+             Rows are deleted by the range of index (`profile`,`stamp`): it is created for SQLite,
+             a table of MySQL without it is not maintained (see checkMaintIndex), the index is added by
+             ALTER TABLE `{table}` ADD INDEX `{table}_stamp`(`profile`,`stamp`);
+    */
+    int mRetention;
+
+    /**
+    @brief The number of rows deleted by one query.
+    */
+    int mRetentionChunk;
+
+    /**
+    @brief Drop expired partitions of MySQL tables.
+    @details false by default. The table must be partitioned by RANGE(TO_DAYS(`stamp`)) or RANGE COLUMNS(`stamp`)
+             Is disabled if other archives of the DB keep rows longer (see isPartsAllowed), is not used with mRollup.
+    */
+    bool mRetentionParts;
+
+    /**
+    @brief Profile of rollup ("" - expired rows are deleted).
+    @details Expired rows are averaged by windows of this profile into rows of mRollupProfile (in the same table) before they are deleted.
+             Must be coarser than the profile.
+    */
+    QString mRollup;
+
+    /**
+    @brief Profile of rollup rows: "{mProfile}.{mRollup}" ("1sec.hour").
+    @details Differs from the names of profiles and of aggregates, so the rows of other profiles are not touched.
+    */
+    QString mRollupProfile;
+
+    /**
+    @brief Retention of rows of the rollup profile (days).
+    @details 0 - the rows are kept forever.
+    */
+    int mRollupRetention;
+
     /**
     @brief Timer.
     */
     QTimer *mTimer;
 
+    /**
+    @brief Timer of keepalive.
+    */
+    QTimer *mKeepTimer;
+
+    /**
+    @brief Connection with DB.
+    @details Is kept open between the ticks of archive.
+    */
+    HelperMySQL *mDbCli;
+
+#ifdef WITH_SQLITE
+    /**
+    @brief Connection with SQLite DB (DRIVER__SQLITE).
+    */
+    HelperSQLite *mLiteCli;
+
+    /**
+    @brief Tables of SQLite DB that have been created.
+    */
+    QSet<QString> mLiteTables;
+
+    /**
+    @brief Background checkpoint of SQLite DB.
+    */
+    ArhCheckpoint *mCkpt;
+    QThread *mCkptThread;
+
+    /**
+    @brief SQLite DB files that have the background checkpoint (absolute paths).
+    @detailed One checkpoint is run for a file, it is owned by the first archive connected to the file (see claimCheckpoint).
+    */
+    static QSet<QString> mCkptFiles;
+    static QMutex mCkptMutex;
+#endif
+
+    /**
+    @brief Current delay before reconnect to DB (sec).
+    */
+    int mReconnectDelay;
+
+    /**
+    @brief Date and time of next attempt to connect to DB (msec since epoch).
+    */
+    qint64 mReconnectAt;
+
+    /**
+    @brief Spool.
+    */
+    ArhSpool *mSpool;
+
+    /**
+    @brief Timer of draining of the spool.
+    */
+    QTimer *mSpoolTimer;
+
+    /**
+    @brief Timer of maintenance of tables.
+    */
+    QTimer *mMaintTimer;
+
+    /**
+    @brief Tables of DB written by the archive (maintenance).
+    */
+    QSet<QString> mMaintTables;
+
+    /**
+    @brief The end of the current rollup window of a table.
+    */
+    QHash<QString, QDateTime> mMaintWindow;
+
+    /**
+    @brief Tables of DB checked for the index of maintenance (true - the index exists).
+    */
+    QHash<QString, bool> mMaintIndexed;
+
+    /**
+    @brief Running aggregates of registers (key = DevID << 16 | RegID).
+    */
+    QHash<quint32, ArhAggr> mMapAggr;
+
+    /**
+    @brief Version of the last accumulated snapshot.
+    */
+    quint64 mAggrVersion;
+
+    /**
+    @brief Compression of archived values of registers (key = DevID << 16 | RegID).
+    */
+    QHash<quint32, ArhComp> mMapComp;
+
+    /**
+    @brief Settings of compression have been taken.
+    */
+    bool mCompInited;
+
+    /**
+    @brief Embedded store.
+    */
+    ArhStore *mStore;
+
+    /**
+    @brief Date and time of the next writing of open blocks of the store (msec since epoch).
+    */
+    qint64 mStoreFlushAt;
+
     /**
     @brief Link to list of networks.
     */
@@ -269,10 +766,63 @@ private:
     @brief  Pack device data into SQL.
     @param  NetIn - pointer to Network;
     @param  DevIdxIn - index of device in the list of devices (0...NetIn->sizeListDevices()-1);
+    @param  StringIn - link to string buffer;
+    @param  RowsIn - link to the number of packed rows.
+    @return true if OK, otherwise - false.
+    */
+    bool toSql(Network *NetIn, const int DevIdxIn, QString &StringIn, int &RowsIn);
+
+    /**
+    @brief  Pack archive rows into SQL.
+    @param  TableIn - name of table;
+    @param  ListRowsIn - list of rows;
+    @param  FromIn - index of the first row;
+    @param  CountIn - the number of rows;
     @param  StringIn - link to string buffer
     @return true if OK, otherwise - false.
     */
-    bool toSql(Network *NetIn, const int DevIdxIn, QString &StringIn);
+    bool toSql(const QString &TableIn, const QList<ArhRow> &ListRowsIn, const int FromIn, const int CountIn, QString &StringIn);
+
+    /**
+    @brief  Pack archive rows into tab-separated format of LOAD DATA.
+    @param  ListRowsIn - list of rows;
+    @param  FromIn - index of the first row;
+    @param  CountIn - the number of rows;
+    @param  DataIn - link to data buffer
+    @return true if OK, otherwise - false.
+    */
+    bool toInfile(const QList<ArhRow> &ListRowsIn, const int FromIn, const int CountIn, QByteArray &DataIn);
+
+    /**
+    @brief  Save data of snapshot into a storage.
+    @param  SnapIn - snapshot.
+    @return None.
+    @details Device locks are not taken, all devices are archived from the same survey cycle.
+             Aggregates of registers are archived with profiles "{mProfile}.{function}".
+             Values of registers with compression settings are filtered by ArhComp.
+    */
+    void saveSnapshot(const Snapshot &SnapIn);
+
+    /**
+    @brief  Route rows of a device to its storage.
+    @param  DevIn - device;
+    @param  ListRowsIn - rows of the device;
+    @param  ListDbDataIn - link to list of data (queries);
+    @param  ListDbRowsIn - link to the number of rows of each query;
+    @param  MapDbRowsIn - link to rows by tables (for prepared statements).
+    @return None.
+    @details Rows of a file are saved at once, rows of a table are collected for saveData().
+    */
+    void toData(const SnapshotDevice &DevIn, const QList<ArhRow> &ListRowsIn, QList<QString> &ListDbDataIn, QList<int> &ListDbRowsIn, QMap<QString, QList<ArhRow> > &MapDbRowsIn);
+
+    /**
+    @brief  Save data of a tick into DB.
+    @param  ListDataIn - list of data (queries);
+    @param  ListRowsIn - the number of rows of each query;
+    @param  MapRowsIn - rows by tables (for prepared statements).
+    @return None.
+    */
+    void saveData(const QList<QString> &ListDataIn, const QList<int> &ListRowsIn, const QMap<QString, QList<ArhRow> > &MapRowsIn);
 
     /**
     @brief  Save data into a File.
@@ -289,6 +839,243 @@ private:
     */
     bool saveToDb(const QList<QString> &ListDataIn);
 
+    /**
+    @brief  Split data of a tick into parts.
+    @param  ListDataIn - list of data (queries);
+    @param  ListRowsIn - the number of rows of each query;
+    @param  MapRowsIn - rows by tables (for prepared statements);
+    @param  ListPartsIn - link to list of parts.
+    @return The number of parts.
+    @details Rows of a table are split by STMT__ROWS_MAX or INFILE__ROWS_MAX (mTransRows if it is less).
+    */
+    int toParts(const QList<QString> &ListDataIn, const QList<int> &ListRowsIn, const QMap<QString, QList<ArhRow> > &MapRowsIn, QList<ArhPart> &ListPartsIn);
+
+    /**
+    @brief  Save data into a DB part by part (autocommit).
+    @param  ListPartsIn - list of parts.
+    @return true if OK, otherwise - false.
+    @details The parts are spooled if DB is unavailable or slow.
+    */
+    bool saveToDbParts(const QList<ArhPart> &ListPartsIn);
+
+    /**
+    @brief  Save data into a DB by transactions.
+    @param  ListPartsIn - list of parts.
+    @return true if OK, otherwise - false.
+    @details The parts are grouped into transactions of up to mTransRows rows.
+             A failed transaction is rolled back and sent again up to mTransRetry times.
+             The parts are spooled if DB is unavailable or slow.
+    */
+    bool saveToDbTrans(const QList<ArhPart> &ListPartsIn);
+
+    /**
+    @brief  Send part of data.
+    @param  PartIn - part.
+    @return true if OK, otherwise - false.
+    @details The connection is closed if it is lost.
+    */
+    bool sendPart(const ArhPart &PartIn);
+
+    /**
+    @brief  Send part of data by one transaction.
+    @param  PartIn - part.
+    @return true if OK, otherwise - false.
+    @details Is used for a spooled record of several statements, so the record is either committed or rolled back
+             at once (it is not sent twice by the next drain).
+    */
+    bool sendPartTrans(const ArhPart &PartIn);
+
+    /**
+    @brief  Save part of data into the spool.
+    @param  PartIn - part.
+    @return true if OK, otherwise - false.
+    */
+    bool toSpool(const ArhPart &PartIn);
+
+    /**
+    @brief  Check the time of saving data into DB.
+    @param  TimerIn - timer started with the saving.
+    @return true if DB is slow, otherwise - false.
+    @details Is used only with the spool.
+    */
+    bool isSlow(const QElapsedTimer &TimerIn);
+
+    /**
+    @brief  Send rows of a table by prepared statement.
+    @param  TableIn - name of table;
+    @param  ListRowsIn - list of rows;
+    @param  FromIn - index of the first row;
+    @param  CountIn - the number of rows (1...STMT__ROWS_MAX).
+    @return true if OK, otherwise - false.
+    @details SQL-query is used if the statement can not be prepared.
+    */
+    bool sendStmt(const QString &TableIn, const QList<ArhRow> &ListRowsIn, const int FromIn, const int CountIn);
+
+    /**
+    @brief  Send rows of a table by LOAD DATA LOCAL INFILE.
+    @param  TableIn - name of table;
+    @param  ListRowsIn - list of rows;
+    @param  FromIn - index of the first row;
+    @param  CountIn - the number of rows.
+    @return true if OK, otherwise - false.
+    @details The rows are sent by prepared statements (by STMT__ROWS_MAX) if local infile is disabled or refused by the server.
+    */
+    bool sendInfile(const QString &TableIn, const QList<ArhRow> &ListRowsIn, const int FromIn, const int CountIn);
+
+#ifdef WITH_SQLITE
+    /**
+    @brief  Save data into SQLite DB.
+    @param  ListPartsIn - list of parts.
+    @return true if OK, otherwise - false.
+    @details All parts of a tick are saved by one transaction, the parts are spooled if the transaction is failed.
+    */
+    bool saveToLite(const QList<ArhPart> &ListPartsIn);
+
+    /**
+    @brief  Send rows of a table into SQLite DB by prepared statement.
+    @param  TableIn - name of table;
+    @param  ListRowsIn - list of rows;
+    @param  FromIn - index of the first row;
+    @param  CountIn - the number of rows.
+    @return true if OK, otherwise - false.
+    @details The table is created if it does not exist, one statement is executed for each row.
+    */
+    bool sendLiteStmt(const QString &TableIn, const QList<ArhRow> &ListRowsIn, const int FromIn, const int CountIn);
+
+    /**
+    @brief  Create a table of SQLite DB.
+    @param  TableIn - name of table.
+    @return true if the table exists, otherwise - false.
+    */
+    bool initLiteTable(const QString &TableIn);
+
+    /**
+    @brief  Start the background checkpoint of SQLite DB.
+    @param  None.
+    @return None.
+    */
+    void startCheckpoint();
+
+    /**
+    @brief  Claim the background checkpoint of SQLite DB file.
+    @param  None.
+    @return true if the checkpoint of the file is owned by this archive, otherwise - false.
+    @details The file is claimed by the first archive, it is released by stopCheckpoint.
+    */
+    bool claimCheckpoint();
+#endif
+
+    /**
+    @brief  Send a query of maintenance.
+    @param  QueryIn - SQL-query;
+    @param  RowsIn - link to the number of changed rows.
+    @return true if OK, otherwise - false.
+    */
+    bool sendMaintQuery(const QString &QueryIn, int &RowsIn);
+
+    /**
+    @brief  Send a query of maintenance and get one value.
+    @param  QueryIn - SQL-query (SELECT);
+    @param  ValueIn - link to value.
+    @return true if OK, otherwise - false.
+    */
+    bool selectMaintValue(const QString &QueryIn, QString &ValueIn);
+
+    /**
+    @brief  Check the index of maintenance of a table.
+    @param  TableIn - name of table.
+    @return 1 if the index (`profile`,`stamp`) exists, 0 if it is absent (-1 if error).
+    @details Without the index DELETE of MySQL scans and locks the whole table, so such table is not maintained.
+             A table is checked once (the result is kept in mMaintIndexed).
+    */
+    int checkMaintIndex(const QString &TableIn);
+
+    /**
+    @brief  Delete one chunk of rows.
+    @param  TableIn - name of table;
+    @param  WhereIn - condition.
+    @return The number of deleted rows (-1 if error).
+    */
+    int deleteChunk(const QString &TableIn, const QString &WhereIn);
+
+    /**
+    @brief  Delete expired rows of profiles.
+    @param  TableIn - name of table;
+    @param  ListProfilesIn - profiles;
+    @param  ExpiredIn - the rows older than this date and time are expired.
+    @return The number of deleted rows or partitions (-1 if error).
+    @details One partition or one chunk is deleted by a call.
+    */
+    int expireRows(const QString &TableIn, const QStringList &ListProfilesIn, const QDateTime &ExpiredIn);
+
+    /**
+    @brief  Drop the oldest expired partition of MySQL table.
+    @param  TableIn - name of table;
+    @param  ExpiredIn - the rows older than this date and time are expired.
+    @return 1 if a partition is dropped, 0 if there are no expired partitions (-1 if error).
+    */
+    int dropPartition(const QString &TableIn, const QDateTime &ExpiredIn);
+
+    /**
+    @brief  Check that expired partitions may be dropped.
+    @param  CommonIn - common options (the event archive);
+    @param  ListProfilesIn - options of profiles (see toProfiles());
+    @param  UseEventIn - the event archive is used.
+    @return true if the rows of other archives of the DB expire not later than the rows of this profile, otherwise - false.
+    @details Other profiles of the DB must have a retention not longer than this one (the rollup rows too),
+             the event archive is not maintained, so it must write to another DB.
+    */
+    bool isPartsAllowed(const QJsonObject &CommonIn, const QList<QJsonObject> &ListProfilesIn, const bool UseEventIn);
+
+    /**
+    @brief  Roll up expired rows of the profile.
+    @param  TableIn - name of table;
+    @param  ExpiredIn - the rows older than this date and time are expired.
+    @return The number of handled rows (-1 if error).
+    @details The rows are handled by windows of the rollup profile: the rollup row is inserted once for a window,
+             then the rows of the window are deleted by chunks (one chunk by a call).
+    */
+    int rollupRows(const QString &TableIn, const QDateTime &ExpiredIn);
+
+#ifdef WITH_SQLITE
+    /**
+    @brief  Stop the background checkpoint of SQLite DB.
+    @param  None.
+    @return None.
+    */
+    void stopCheckpoint();
+#endif
+
+    /**
+    @brief  Check connection with DB.
+    @param  None.
+    @return true if connection is established, otherwise - false.
+    */
+    bool isDbConnected();
+
+    /**
+    @brief  Check options of DB connection.
+    @param  None.
+    @return true if options are set, otherwise - false.
+    */
+    bool isDbAllowed();
+
+    /**
+    @brief  Get connection with DB.
+    @param  None.
+    @return true if connection is established, otherwise - false.
+    @details The opened connection is checked by ping.
+             A new connection is not tried before the end of the reconnect delay.
+    */
+    bool connectDb();
+
+    /**
+    @brief  Close connection with DB.
+    @param  None.
+    @return None.
+    */
+    void disconnectDb();
+
     /**
     @brief  Stop timer.
     @param  none.
@@ -168,3 +168,41 @@ void printDwordByBytes(const quint32 NumIn, const quint8 BaseIn)
     Byte = BYTE3(NumIn);
     std::cout << QString::number(Byte, Base).toStdString();
 }
+
+
+/**
+@brief      calculate CRC-32 (IEEE 802.3, as gzip).
+@param      DataIn - data.
+@return     CRC-32.
+@details    Thread-safe (frames of spool and store, segments of Log):
+            the table is built once by initialization of local static (is synchronized since C++11).
+*/
+quint32 crc32(const QByteArray &DataIn)
+{
+    struct Crc32Table
+    {
+        quint32 mItems[256];
+    };
+
+    static const Crc32Table Table = []()
+    {
+        Crc32Table Res;
+        quint32 C;
+
+        for(quint32 n=0; n<256; n++)
+        {
+            C = n;
+            for(int k=0; k<8; k++) C = ((C & 1) ? (0xEDB88320 ^ (C>>1)) : (C>>1));
+            Res.mItems[n] = C;
+        }
+
+        return (Res);
+    }();
+
+    quint32 Crc = 0xFFFFFFFF;
+    const uchar *Data = reinterpret_cast<const uchar *>(DataIn.constData());
+
+    for(int i=0; i<DataIn.size(); i++) Crc = Table.mItems[(Crc ^ Data[i]) & 0xFF] ^ (Crc>>8);
+
+    return (Crc ^ 0xFFFFFFFF);
+}
@@ -27,6 +27,7 @@
 #include <iostream>
 #include <QtGlobal>
 #include <QString>
+#include <QByteArray>
 
 //* PartIn == 0: first 4 bit of DWord
 //* PartIn == 1: second 4 bit of DWord
@@ -206,4 +207,13 @@ void print8Bits(const quint8 NumIn);
 */
 void printDwordByBytes(const quint32 NumIn, const quint8 BaseIn);
 
+
+/**
+@brief      calculate CRC-32 (IEEE 802.3, as gzip).
+@param      DataIn - data.
+@return     CRC-32.
+@details    Thread-safe (frames of spool and store, segments of Log).
+*/
+quint32 crc32(const QByteArray &DataIn);
+
 #endif /* BIT_H_ */
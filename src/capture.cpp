@@ -0,0 +1,293 @@
+/* Copyright (C) 2019 ATgroup09
+*  Contact: atgroup09@gmail.com
+*
+*  This file is part of the HMI server component.
+*
+*  The code in this page is free software: you can
+*  redistribute it and/or modify it under the terms of the GNU
+*  General Public License (GNU GPL) as published by the Free Software
+*  Foundation, either version 3 of the License, or (at your option)
+*  any later version.  The code is distributed WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS
+*  FOR A PARTICULAR PURPOSE.  See the GNU GPL for more details.
+*
+*  As additional permission under GNU GPL version 3 section 7, you
+*  may distribute non-source (e.g., minimized or compacted) forms of
+*  that code without the copy of the GNU GPL normally required by
+*  section 4, provided you include this license notice and a URL
+*  through which recipients can access the Corresponding Source.
+*/
+
+#include "capture.h"
+
+
+/**
+@brief Options.
+*/
+quint8 Capture::mMode = Capture::MODE__OFF;
+QFile *Capture::mFile = nullptr;
+QDataStream *Capture::mStream = nullptr;
+QElapsedTimer Capture::mTimer;
+QHash<QByteArray, QList<CaptureRecord> > Capture::mRecords;
+QHash<QByteArray, int> Capture::mPos;
+bool Capture::mLoop = false;
+quint32 Capture::mSize = 0;
+QMutex Capture::mMutex;
+
+
+/**
+@brief  Constructor.
+@param  None.
+@return None.
+*/
+Capture::Capture(QObject *parent) : QObject(parent)
+{
+
+}
+
+
+/**
+@brief  Destructor.
+@param  None.
+@return None.
+*/
+Capture::~Capture()
+{
+
+}
+
+
+/**
+@brief  Get key of request.
+@param  ProtoIn - protocol;
+@param  BusIn - bus;
+@param  RequestIn - raw request.
+@return Key.
+*/
+QByteArray Capture::toKey(quint8 ProtoIn, const QByteArray &BusIn, const QByteArray &RequestIn)
+{
+    QByteArray Key;
+
+    Key.reserve(BusIn.size()+RequestIn.size()+2);
+    Key.append(static_cast<char>(ProtoIn));
+    Key.append(BusIn);
+    Key.append('\0');
+    Key.append(RequestIn);
+
+    return (Key);
+}
+
+
+/**
+@brief  Start capture.
+@param  FileIn - path to a file (is rewritten).
+@return True if started, otherwise - False.
+*/
+bool Capture::startCapture(const QString &FileIn)
+{
+    Capture::stop();
+
+    QMutexLocker Locker(&mMutex);
+
+    mFile = new QFile(FileIn);
+
+    if(mFile->open(QIODevice::WriteOnly|QIODevice::Truncate))
+    {
+        mStream = new QDataStream(mFile);
+        mStream->setVersion(QDataStream::Qt_5_0);
+        *mStream << MAGIC << VERSION;
+
+        mSize = 0;
+        mMode = MODE__CAPTURE;
+        mTimer.start();
+
+        return (true);
+    }
+
+    delete mFile;
+    mFile = nullptr;
+
+    return (false);
+}
+
+
+/**
+@brief  Start replay.
+@param  FileIn - path to a file;
+@param  LoopIn - true: start from first record of a request when records are over.
+@return True if started (the file contains records), otherwise - False.
+*/
+bool Capture::startReplay(const QString &FileIn, bool LoopIn)
+{
+    Capture::stop();
+
+    QMutexLocker Locker(&mMutex);
+
+    QFile File(FileIn);
+
+    if(File.open(QIODevice::ReadOnly))
+    {
+        QDataStream Stream(&File);
+        Stream.setVersion(QDataStream::Qt_5_0);
+
+        quint32 Magic   = 0;
+        quint16 Version = 0;
+        Stream >> Magic >> Version;
+
+        if(Magic == MAGIC && Version == VERSION)
+        {
+            CaptureRecord Rec;
+
+            while(!Stream.atEnd())
+            {
+                Stream >> Rec.mStamp >> Rec.mProto >> Rec.mBus >> Rec.mRequest >> Rec.mResult >> Rec.mErrNo >> Rec.mResponse;
+                if(Stream.status() != QDataStream::Ok) break;
+
+                mRecords[Capture::toKey(Rec.mProto, Rec.mBus, Rec.mRequest)].append(Rec);
+                mSize++;
+            }
+        }
+
+        File.close();
+    }
+
+    if(mSize)
+    {
+        mLoop = LoopIn;
+        mMode = MODE__REPLAY;
+        return (true);
+    }
+
+    return (false);
+}
+
+
+/**
+@brief  Stop capture or replay.
+@param  None.
+@return None.
+*/
+void Capture::stop()
+{
+    QMutexLocker Locker(&mMutex);
+
+    if(mStream)
+    {
+        delete mStream;
+        mStream = nullptr;
+    }
+
+    if(mFile)
+    {
+        mFile->close();
+        delete mFile;
+        mFile = nullptr;
+    }
+
+    mRecords.clear();
+    mPos.clear();
+    mSize = 0;
+    mMode = MODE__OFF;
+}
+
+
+/**
+@brief  Check capture mode.
+@param  None.
+@return True if capture is on, otherwise - False.
+*/
+bool Capture::isCapture()
+{
+    return (((mMode == MODE__CAPTURE) ? true : false));
+}
+
+
+/**
+@brief  Check replay mode.
+@param  None.
+@return True if replay is on, otherwise - False.
+*/
+bool Capture::isReplay()
+{
+    return (((mMode == MODE__REPLAY) ? true : false));
+}
+
+
+/**
+@brief  Write transaction (capture mode).
+@param  ProtoIn - protocol;
+@param  BusIn - bus;
+@param  RequestIn - raw request;
+@param  ResultIn - result;
+@param  ErrNoIn - error code;
+@param  ResponseIn - raw response.
+@return None.
+*/
+void Capture::record(quint8 ProtoIn, const QString &BusIn, const QByteArray &RequestIn, qint32 ResultIn, qint32 ErrNoIn, const QByteArray &ResponseIn)
+{
+    QMutexLocker Locker(&mMutex);
+
+    if(mMode == MODE__CAPTURE && mStream)
+    {
+        quint64 Stamp = static_cast<quint64>(mTimer.nsecsElapsed());
+
+        *mStream << Stamp << ProtoIn << BusIn.toUtf8() << RequestIn << ResultIn << ErrNoIn << ResponseIn;
+        mSize++;
+    }
+}
+
+
+/**
+@brief  Take transaction (replay mode).
+@param  ProtoIn - protocol;
+@param  BusIn - bus;
+@param  RequestIn - raw request;
+@param  ResultIn - link to result;
+@param  ErrNoIn - link to error code;
+@param  ResponseIn - link to raw response.
+@return True if the request is found, otherwise - False.
+*/
+bool Capture::replay(quint8 ProtoIn, const QString &BusIn, const QByteArray &RequestIn, qint32 &ResultIn, qint32 &ErrNoIn, QByteArray &ResponseIn)
+{
+    QMutexLocker Locker(&mMutex);
+
+    if(mMode == MODE__REPLAY)
+    {
+        QByteArray Key = Capture::toKey(ProtoIn, BusIn.toUtf8(), RequestIn);
+        QHash<QByteArray, QList<CaptureRecord> >::const_iterator It = mRecords.constFind(Key);
+
+        if(It != mRecords.constEnd())
+        {
+            int Pos = mPos.value(Key, 0);
+
+            if(Pos >= It.value().size())
+            {
+                if(!mLoop) return (false);
+                Pos = 0;
+            }
+
+            const CaptureRecord &Rec = It.value().at(Pos);
+
+            ResultIn   = Rec.mResult;
+            ErrNoIn    = Rec.mErrNo;
+            ResponseIn = Rec.mResponse;
+
+            mPos[Key] = Pos+1;
+
+            return (true);
+        }
+    }
+
+    return (false);
+}
+
+
+/**
+@brief  Get the number of records (captured or loaded).
+@param  None.
+@return The number of records.
+*/
+quint32 Capture::size()
+{
+    return (mSize);
+}
@@ -0,0 +1,261 @@
+/* Copyright (C) 2019 ATgroup09
+*  Contact: atgroup09@gmail.com
+*
+*  This file is part of the HMI server component.
+*
+*  The code in this page is free software: you can
+*  redistribute it and/or modify it under the terms of the GNU
+*  General Public License (GNU GPL) as published by the Free Software
+*  Foundation, either version 3 of the License, or (at your option)
+*  any later version.  The code is distributed WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS
+*  FOR A PARTICULAR PURPOSE.  See the GNU GPL for more details.
+*
+*  As additional permission under GNU GPL version 3 section 7, you
+*  may distribute non-source (e.g., minimized or compacted) forms of
+*  that code without the copy of the GNU GPL normally required by
+*  section 4, provided you include this license notice and a URL
+*  through which recipients can access the Corresponding Source.
+*/
+
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <QList>
+#include <QHash>
+#include <QFile>
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QMutexLocker>
+
+
+/**
+@brief Record of bus traffic (one transaction).
+*/
+class CaptureRecord
+{
+public:
+
+    /**
+    @brief Monotonic time stamp (nsec from start of capture).
+    */
+    quint64 mStamp;
+
+    /**
+    @brief Protocol (Capture::PROTO__*).
+    */
+    quint8 mProto;
+
+    /**
+    @brief Bus (serial port or "IP:Port").
+    */
+    QByteArray mBus;
+
+    /**
+    @brief Raw request.
+    */
+    QByteArray mRequest;
+
+    /**
+    @brief Result of transaction (the number of registers, bytes, -1 if error).
+    */
+    qint32 mResult;
+
+    /**
+    @brief Error code (errno or QSerialPort::SerialPortError).
+    */
+    qint32 mErrNo;
+
+    /**
+    @brief Raw response (data).
+    */
+    QByteArray mResponse;
+};
+
+
+/**
+@brief      Capture and replay of bus traffic.
+@detailed   Capture: every transaction of HelperModBusClient and SerialPort is written into binary file.
+            Replay: transactions are not sent to the bus, responses are taken from the file;
+                    a request is matched by protocol, bus and raw request (in order of capture).
+            File: [quint32 MAGIC][quint16 VERSION][record]...
+                  record = [quint64 Stamp][quint8 Proto][QByteArray Bus][QByteArray Request][qint32 Result][qint32 ErrNo][QByteArray Response]
+*/
+class Capture : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    explicit Capture(QObject *parent = nullptr);
+    ~Capture();
+
+
+    /**
+    Public constants
+    */
+
+    /**
+    @brief Header of file
+    */
+    static const quint32 MAGIC   = 0x57534350;
+    static const quint16 VERSION = 1;
+
+    /**
+    @brief Protocols
+    */
+    static const quint8 PROTO__MODBUS_RTU = 1;
+    static const quint8 PROTO__MODBUS_TCP = 2;
+    static const quint8 PROTO__DCON       = 3;
+
+    /**
+    @brief Modes
+    */
+    static const quint8 MODE__OFF     = 0;
+    static const quint8 MODE__CAPTURE = 1;
+    static const quint8 MODE__REPLAY  = 2;
+
+
+    /**
+    Public methods
+    */
+
+    /**
+    @brief  Start capture.
+    @param  FileIn - path to a file (is rewritten).
+    @return True if started, otherwise - False.
+    */
+    static bool startCapture(const QString &FileIn);
+
+    /**
+    @brief  Start replay.
+    @param  FileIn - path to a file;
+    @param  LoopIn - true: start from first record of a request when records are over.
+    @return True if started (the file contains records), otherwise - False.
+    */
+    static bool startReplay(const QString &FileIn, bool LoopIn);
+
+    /**
+    @brief  Stop capture or replay.
+    @param  None.
+    @return None.
+    */
+    static void stop();
+
+    /**
+    @brief  Check capture mode.
+    @param  None.
+    @return True if capture is on, otherwise - False.
+    */
+    static bool isCapture();
+
+    /**
+    @brief  Check replay mode.
+    @param  None.
+    @return True if replay is on, otherwise - False.
+    */
+    static bool isReplay();
+
+    /**
+    @brief  Write transaction (capture mode).
+    @param  ProtoIn - protocol;
+    @param  BusIn - bus;
+    @param  RequestIn - raw request;
+    @param  ResultIn - result;
+    @param  ErrNoIn - error code;
+    @param  ResponseIn - raw response.
+    @return None.
+    */
+    static void record(quint8 ProtoIn, const QString &BusIn, const QByteArray &RequestIn, qint32 ResultIn, qint32 ErrNoIn, const QByteArray &ResponseIn);
+
+    /**
+    @brief  Take transaction (replay mode).
+    @param  ProtoIn - protocol;
+    @param  BusIn - bus;
+    @param  RequestIn - raw request;
+    @param  ResultIn - link to result;
+    @param  ErrNoIn - link to error code;
+    @param  ResponseIn - link to raw response.
+    @return True if the request is found, otherwise - False.
+    */
+    static bool replay(quint8 ProtoIn, const QString &BusIn, const QByteArray &RequestIn, qint32 &ResultIn, qint32 &ErrNoIn, QByteArray &ResponseIn);
+
+    /**
+    @brief  Get the number of records (captured or loaded).
+    @param  None.
+    @return The number of records.
+    */
+    static quint32 size();
+
+
+private:
+
+    /**
+    Private options
+    */
+
+    /**
+    @brief Mode.
+    */
+    static quint8 mMode;
+
+    /**
+    @brief Capture :: File.
+    */
+    static QFile *mFile;
+
+    /**
+    @brief Capture :: Stream of file.
+    */
+    static QDataStream *mStream;
+
+    /**
+    @brief Capture :: Monotonic timer.
+    */
+    static QElapsedTimer mTimer;
+
+    /**
+    @brief Replay :: Records by key (see toKey()).
+    */
+    static QHash<QByteArray, QList<CaptureRecord> > mRecords;
+
+    /**
+    @brief Replay :: Position of next record by key.
+    */
+    static QHash<QByteArray, int> mPos;
+
+    /**
+    @brief Replay :: Loop records.
+    */
+    static bool mLoop;
+
+    /**
+    @brief The number of records.
+    */
+    static quint32 mSize;
+
+    /**
+    @brief Mutex.
+    */
+    static QMutex mMutex;
+
+
+    /**
+    Private methods
+    */
+
+    /**
+    @brief  Get key of request.
+    @param  ProtoIn - protocol;
+    @param  BusIn - bus;
+    @param  RequestIn - raw request.
+    @return Key.
+    */
+    static QByteArray toKey(quint8 ProtoIn, const QByteArray &BusIn, const QByteArray &RequestIn);
+};
+
+#endif // CAPTURE_H
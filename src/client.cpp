@@ -21,6 +21,12 @@
 #include "client.h"
 
 
+/**
+@brief ID of the last created client.
+*/
+quint64 Client::mLastID = 0;
+
+
 /**
 @brief  Constructor.
 @param  None.
@@ -28,9 +34,13 @@
 */
 Client::Client(QObject *parent) : QObject(parent)
 {
+    mID        = ++mLastID;
     mIsWs      = false;
     mWsUri     = QString("");
-    mWebSocket = nullptr;
+    mWebSocket  = nullptr;
+    mRole       = 0;
+    mSubEvents  = false;
+    mPingMissed = 0;
     this->refreshStampActivity();
 }
 
@@ -93,6 +103,47 @@ void Client::reconnect()
 }
 
 
+/**
+@brief  Send ping.
+@param  None.
+@return None.
+@detailed The counter of missed pong is incremented (it is reset by refreshPing()).
+*/
+void Client::ping()
+{
+    if(mWebSocket != nullptr)
+    {
+        if(mWebSocket->state() == QAbstractSocket::ConnectedState)
+        {
+            if(mPingMissed < 255) mPingMissed++;
+            mWebSocket->ping();
+        }
+    }
+}
+
+
+/**
+@brief  Reset the counter of missed pong.
+@param  None.
+@return None.
+*/
+void Client::refreshPing()
+{
+    mPingMissed = 0;
+}
+
+
+/**
+@brief  Get the number of missed pong.
+@param  None.
+@return The number of ping sent without answer.
+*/
+quint8 Client::getPingMissed()
+{
+    return (mPingMissed);
+}
+
+
 /**
 @brief  Refresh Stamp of Activity.
 @param  None.
@@ -124,3 +175,40 @@ QDateTime Client::getStampActivity(const qint16 SecIn)
 {
     return (mStampActivity.addSecs(SecIn));
 }
+
+
+/**
+@brief  Constructor.
+@param  WebSocketIn - WebSocket of the client;
+@param  MsgIn - message.
+@return None.
+@detailed The time of enqueueing is fixed.
+*/
+ClientMsg::ClientMsg(QWebSocket *WebSocketIn, const QString &MsgIn, QObject *parent) : QObject(parent)
+{
+    mWebSocket = WebSocketIn;
+    mMsg       = MsgIn;
+    mTimer.start();
+}
+
+
+/**
+@brief  Destructor.
+@param  None.
+@return None.
+*/
+ClientMsg::~ClientMsg()
+{
+
+}
+
+
+/**
+@brief  Get time since enqueueing.
+@param  None.
+@return Time (msec).
+*/
+qint64 ClientMsg::getLatency()
+{
+    return (mTimer.elapsed());
+}
@@ -23,6 +23,8 @@
 
 #include <QObject>
 #include <QDateTime>
+#include <QElapsedTimer>
+#include <QPointer>
 #include <QtWebSockets>
 #include <QUrl>
 
@@ -44,6 +46,12 @@ public:
     Public options
     */
 
+    /**
+    @brief ID of client (unique while the server is running).
+    @detailed Is used instead of the pointer to WebSocket by tasks of other threads (a new socket may get the address of a deleted one).
+    */
+    quint64 mID;
+
     /**
     @brief Sign of Ws-client.
     */
@@ -55,6 +63,16 @@ public:
     */
     QWebSocket *mWebSocket;
 
+    /**
+    @brief Role of client (see Config::ROLE__*).
+    */
+    quint8 mRole;
+
+    /**
+    @brief The client is subscribed to events of registers (see Server::event()).
+    */
+    bool mSubEvents;
+
 
     /**
     Public methods
@@ -102,6 +120,28 @@ public:
     */
     void reconnect();
 
+    /**
+    @brief  Send ping.
+    @param  None.
+    @return None.
+    @detailed The counter of missed pong is incremented (it is reset by refreshPing()).
+    */
+    void ping();
+
+    /**
+    @brief  Reset the counter of missed pong.
+    @param  None.
+    @return None.
+    */
+    void refreshPing();
+
+    /**
+    @brief  Get the number of missed pong.
+    @param  None.
+    @return The number of ping sent without answer.
+    */
+    quint8 getPingMissed();
+
 
 private:
 
@@ -113,6 +153,85 @@ private:
     @brief DateTime of last activity.
     */
     QDateTime mStampActivity;
+
+    /**
+    @brief The number of ping sent without answer.
+    */
+    quint8 mPingMissed;
+
+    /**
+    @brief ID of the last created client.
+    @detailed Clients are created by the main thread only.
+    */
+    static quint64 mLastID;
+};
+
+
+
+/**
+@brief Message of a client (queued until next survey).
+*/
+class ClientMsg : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /**
+    @brief  Constructor.
+    @param  WebSocketIn - WebSocket of the client;
+    @param  MsgIn - message.
+    @return None.
+    @detailed The time of enqueueing is fixed.
+    */
+    explicit ClientMsg(QWebSocket *WebSocketIn, const QString &MsgIn, QObject *parent = nullptr);
+
+    /**
+    @brief  Destructor.
+    @param  None.
+    @return None.
+    */
+    ~ClientMsg();
+
+
+    /**
+    Public options
+    */
+
+    /**
+    @brief Pointer to WebSocket of the client.
+    @detailed Is nullptr if the client has been deleted.
+    */
+    QPointer<QWebSocket> mWebSocket;
+
+    /**
+    @brief Message.
+    */
+    QString mMsg;
+
+
+    /**
+    Public methods
+    */
+
+    /**
+    @brief  Get time since enqueueing.
+    @param  None.
+    @return Time (msec).
+    */
+    qint64 getLatency();
+
+
+private:
+
+    /**
+    Private options
+    */
+
+    /**
+    @brief Timer of enqueueing.
+    */
+    QElapsedTimer mTimer;
 };
 
 #endif // CLIENT_H
@@ -29,34 +29,71 @@ const QString Config::FIELD__PORT               = "Port";
 const QString Config::FIELD__CONN_MAX           = "ConnMax";
 const QString Config::FIELD__CONN_PER_CLI       = "ConnPerCli";
 const QString Config::FIELD__CONN_LIFE_TIME     = "ConnLifeTime";
+const QString Config::FIELD__PING_INTERVAL      = "PingInterval";
+const QString Config::FIELD__PING_MISS          = "PingMiss";
 const QString Config::FIELD__SURVEY_DELAY       = "SurveyDelay";
 const QString Config::FIELD__FIRST_SURVEY_NOW   = "FirstSurveyNow";
 const QString Config::FIELD__RANDOM             = "Random";
 const QString Config::FIELD__USE_LOG            = "UseLog";
+const QString Config::FIELD__LOG_BUFF           = "LogBuff";
+const QString Config::FIELD__LOG_FLUSH          = "LogFlush";
+const QString Config::FIELD__LOG_BLOCK          = "LogBlock";
+const QString Config::FIELD__LOG_LEVEL          = "LogLevel";
+const QString Config::FIELD__LOG_MAX_SIZE       = "LogMaxSize";
+const QString Config::FIELD__LOG_DAILY          = "LogDaily";
+const QString Config::FIELD__LOG_KEEP           = "LogKeep";
+const QString Config::FIELD__LOG_GZIP           = "LogGzip";
 const QString Config::FIELD__USE_WS             = "UseWs";
 const QString Config::FIELD__USE_WS_CLI         = "UseWsCli";
 const QString Config::FIELD__USE_WS_BLACK       = "UseWsBlack";
 const QString Config::FIELD__USE_ARH            = "UseArh";
 const QString Config::FIELD__USE_EVENT          = "UseEvent";
+const QString Config::FIELD__EVENT_BUFF         = "EventBuff";
 const QString Config::FIELD__WS_BLACK           = "WsBlack";
 const QString Config::FIELD__WS_CLI             = "WsCli";
 const QString Config::FIELD__ROLES              = "Roles";
 const QString Config::FIELD__ARH                = "Arh";
 const QString Config::FIELD__NETWORKS           = "Networks";
+const QString Config::FIELD__CAPTURE            = "Capture";
+const QString Config::FIELD__REPLAY             = "Replay";
+const QString Config::FIELD__REPLAY_LOOP        = "ReplayLoop";
 const QString Config::FIELD__LOG                = "Log";
 
-//** roles
+//** roles, black-list
 const QString Config::FIELD__IP                 = "IP";
 const QString Config::FIELD__ROLE               = "Role";
+const QString Config::FIELD__ALLOW              = "Allow";
 
 //** TimeStamp of JSON-object that will be send to WS-clients
 const QString Config::FIELD__STAMP              = "Stamp";
+const QString Config::FIELD__AGE                = "Age";
 
 const QString Config::FIELD__SRV_ID             = "SrvID";
 const QString Config::FIELD__NET_ID             = "NetID";
 const QString Config::FIELD__DEV_ID             = "DevID";
 const QString Config::FIELD__DATA               = "Data";
 
+//** requests of clients
+const QString Config::FIELD__CMD                = "Cmd";
+const QString Config::FIELD__REQ_ID             = "ReqID";
+const QString Config::FIELD__VAR                = "Var";
+const QString Config::FIELD__RES                = "Res";
+const QString Config::FIELD__LATENCY            = "Latency";
+const QString Config::FIELD__EX                 = "Ex";
+
+//** history queries of clients
+const QString Config::FIELD__FROM               = "From";
+const QString Config::FIELD__TO                 = "To";
+const QString Config::FIELD__POINTS             = "Points";
+const QString Config::FIELD__ALG                = "Alg";
+const QString Config::FIELD__CHUNK              = "Chunk";
+const QString Config::FIELD__LAST               = "Last";
+
+//** events of registers that will be send to WS-clients
+const QString Config::FIELD__EVENTS             = "Events";
+const QString Config::FIELD__SEQ                = "Seq";
+const QString Config::FIELD__SUB                = "Sub";
+
 /**
 @brief Client roles
 */
@@ -65,6 +102,15 @@ const QString Config::ROLE__VIEWER_STR           = "viewer";
 const quint8  Config::ROLE__MANAGER              = 1;
 const QString Config::ROLE__MANAGER_STR          = "manager";
 
+/**
+@brief Commands of clients
+*/
+const QString Config::CMD__WRITE                 = "write";
+const QString Config::CMD__READ                  = "read";
+const QString Config::CMD__HISTORY               = "history";
+const QString Config::CMD__TREND                 = "trend";
+const QString Config::CMD__EVENT                 = "event";
+
 
 /**
 @def Values by default.
@@ -107,6 +153,16 @@ void Config::byDefault()
     mConnMax        = 0;
     mConnPerCli     = 0;
     mConnLifeTime   = CONN_LIFE_TIME_OFF;
+    mPingInterval   = PING_INTERVAL_OFF;
+    mPingMiss       = PING_MISS_DEF;
+    mLogBuff        = LOG_BUFF_DEF;
+    mLogFlush       = LOG_FLUSH_DEF;
+    mLogBlock       = false;
+    mLogLevel       = Log::LEVEL__INFO;
+    mLogMaxSize     = 0;
+    mLogDaily       = false;
+    mLogKeep        = LOG_KEEP_DEF;
+    mLogGzip        = false;
     mSurveyDelay    = SURVEY_DELAY_MIN;
     mFirstSurveyNow = false;
     mRandom         = false;
@@ -115,11 +171,15 @@ void Config::byDefault()
     mUseWsBlack     = false;
     mUseArh         = false;
     mUseEvent       = false;
+    mEventBuff      = EVENT_BUFF_DEF;
     mFileWsBlack    = QString("");
     mFileWsCli      = QString("");
     mFileRoles      = QString("");
     mFileArh        = QString("");
     mFileNetworks   = QString("");
+    mFileCapture    = QString("");
+    mFileReplay     = QString("");
+    mReplayLoop     = false;
 
     if(mFileLogArg.isEmpty())
     {
@@ -128,8 +188,11 @@ void Config::byDefault()
     }
 
     mListWsBlack.clear();
+    mListWsWhite.clear();
+    mTrieWsBlack.clear();
     mListWsCli.clear();
     mListRoles.clear();
+    mTrieRoles.clear();
 
     this->clearListNetworks();
 }
@@ -151,12 +214,21 @@ bool Config::fromJson(const QJsonObject &DataIn)
         mConnMax      = static_cast<quint8>(DataIn.value(FIELD__CONN_MAX).toInt(0));
         mConnPerCli   = static_cast<quint8>(DataIn.value(FIELD__CONN_PER_CLI).toInt(0));
         mConnLifeTime = static_cast<qint32>(DataIn.value(FIELD__CONN_LIFE_TIME).toInt(CONN_LIFE_TIME_OFF));
+        mPingInterval = static_cast<quint32>(DataIn.value(FIELD__PING_INTERVAL).toInt(PING_INTERVAL_OFF));
+        mPingMiss     = static_cast<quint8>(DataIn.value(FIELD__PING_MISS).toInt(PING_MISS_DEF));
+        mLogBuff      = static_cast<quint32>(DataIn.value(FIELD__LOG_BUFF).toInt(LOG_BUFF_DEF));
+        mLogFlush     = static_cast<quint32>(DataIn.value(FIELD__LOG_FLUSH).toInt(LOG_FLUSH_DEF));
+        mLogLevel     = Log::toLevel(DataIn.value(FIELD__LOG_LEVEL).toString(Log::LEVEL__INFO_STR), Log::LEVEL__INFO);
+        mLogMaxSize   = static_cast<quint32>(DataIn.value(FIELD__LOG_MAX_SIZE).toInt(0));
+        mLogKeep      = static_cast<quint16>(DataIn.value(FIELD__LOG_KEEP).toInt(LOG_KEEP_DEF));
         mSurveyDelay  = static_cast<quint32>(DataIn.value(FIELD__SURVEY_DELAY).toInt(0));
         mFileWsBlack  = DataIn.value(FIELD__WS_BLACK).toString(QString(""));
         mFileWsCli    = DataIn.value(FIELD__WS_CLI).toString(QString(""));
         mFileRoles    = DataIn.value(FIELD__ROLES).toString(QString(""));
         mFileArh      = DataIn.value(FIELD__ARH).toString(QString(""));
         mFileNetworks = DataIn.value(FIELD__NETWORKS).toString(QString(""));
+        mFileCapture  = DataIn.value(FIELD__CAPTURE).toString(QString(""));
+        mFileReplay   = DataIn.value(FIELD__REPLAY).toString(QString(""));
 
         int Boo = (DataIn.value(FIELD__FIRST_SURVEY_NOW).toInt(0));
         mFirstSurveyNow = ((Boo) ? true : false);
@@ -179,6 +251,20 @@ bool Config::fromJson(const QJsonObject &DataIn)
         Boo = (DataIn.value(FIELD__USE_EVENT).toInt(0));
         mUseEvent = ((Boo) ? true : false);
 
+        mEventBuff = static_cast<quint32>(DataIn.value(FIELD__EVENT_BUFF).toInt(EVENT_BUFF_DEF));
+
+        Boo = (DataIn.value(FIELD__LOG_BLOCK).toInt(0));
+        mLogBlock = ((Boo) ? true : false);
+
+        Boo = (DataIn.value(FIELD__LOG_DAILY).toInt(0));
+        mLogDaily = ((Boo) ? true : false);
+
+        Boo = (DataIn.value(FIELD__LOG_GZIP).toInt(0));
+        mLogGzip = ((Boo) ? true : false);
+
+        Boo = (DataIn.value(FIELD__REPLAY_LOOP).toInt(0));
+        mReplayLoop = ((Boo) ? true : false);
+
         if(mFileLogArg.isEmpty())
         {
             mFileLog = DataIn.value(FIELD__LOG).toString(QString(""));
@@ -249,6 +335,18 @@ void Config::toString(QString &StringIn)
     StringIn+= QString::number(mConnLifeTime);
     StringIn+= QString("\r\n");
 
+    StringIn+= QString(" - ");
+    StringIn+= Config::FIELD__PING_INTERVAL;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(mPingInterval);
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= Config::FIELD__PING_MISS;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(mPingMiss);
+    StringIn+= QString("\r\n");
+
     StringIn+= QString(" - ");
     StringIn+= Config::FIELD__SURVEY_DELAY;
     StringIn+= QString(" = ");
@@ -273,6 +371,54 @@ void Config::toString(QString &StringIn)
     StringIn+= QString::number(((mUseLog) ? 1 : 0));
     StringIn+= QString("\r\n");
 
+    StringIn+= QString(" - ");
+    StringIn+= Config::FIELD__LOG_BUFF;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(mLogBuff);
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= Config::FIELD__LOG_FLUSH;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(mLogFlush);
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= Config::FIELD__LOG_BLOCK;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(((mLogBlock) ? 1 : 0));
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= Config::FIELD__LOG_LEVEL;
+    StringIn+= QString(" = ");
+    StringIn+= Log::fromLevel(mLogLevel);
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= Config::FIELD__LOG_MAX_SIZE;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(mLogMaxSize);
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= Config::FIELD__LOG_DAILY;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(((mLogDaily) ? 1 : 0));
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= Config::FIELD__LOG_KEEP;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(mLogKeep);
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= Config::FIELD__LOG_GZIP;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(((mLogGzip) ? 1 : 0));
+    StringIn+= QString("\r\n");
+
     StringIn+= QString(" - ");
     StringIn+= Config::FIELD__USE_WS;
     StringIn+= QString(" = ");
@@ -303,6 +449,12 @@ void Config::toString(QString &StringIn)
     StringIn+= QString::number(((mUseEvent) ? 1 : 0));
     StringIn+= QString("\r\n");
 
+    StringIn+= QString(" - ");
+    StringIn+= Config::FIELD__EVENT_BUFF;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(mEventBuff);
+    StringIn+= QString("\r\n");
+
     StringIn+= QString(" - ");
     StringIn+= FIELD__WS_BLACK;
     StringIn+= QString(" = ");
@@ -324,6 +476,17 @@ void Config::toString(QString &StringIn)
         StringIn+= QString("\r\n");
     }
 
+    StringIn+= QString(" ListWsWhite.size() = %1").arg(QString::number(mListWsWhite.size()));
+    StringIn+= QString("\r\n");
+
+    Keys = mListWsWhite.keys();
+    for(i=0; i<Keys.size(); i++)
+    {
+        Key = Keys.at(i);
+        StringIn+= QString(" client[%1] = %2:%3").arg(QString::number(i), Key, QString::number(mListWsWhite.value(Key)));
+        StringIn+= QString("\r\n");
+    }
+
     StringIn+= QString(" - ");
     StringIn+= FIELD__WS_CLI;
     StringIn+= QString(" = ");
@@ -390,6 +553,24 @@ void Config::toString(QString &StringIn)
     StringIn+= QString(" = ");
     StringIn+= mFileArh;
     StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__CAPTURE;
+    StringIn+= QString(" = ");
+    StringIn+= mFileCapture;
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__REPLAY;
+    StringIn+= QString(" = ");
+    StringIn+= mFileReplay;
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__REPLAY_LOOP;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(((mReplayLoop) ? 1 : 0));
+    StringIn+= QString("\r\n");
 }
 
 
@@ -440,6 +621,138 @@ void Config::toJsonString(QString &StringIn)
 }
 
 
+/**
+@brief  Public method: Pack events of registers to JSON string.
+@param  SeqIn - sequence number of the message;
+@param  StampIn - date and time of survey cycle (msec since epoch);
+@param  ListEventsIn - list of events (see evaluateEvents());
+@param  StringIn - link to string buffer.
+@return None.
+@detailed { SrvID:..., Cmd:"event", Seq:n, Stamp:msec, Data:[ { NetID:..., DevID:..., Events:[ {...}, ... ] }, ... ] }
+*/
+void Config::toEventString(const quint64 SeqIn, const qint64 StampIn, const QJsonArray &ListEventsIn, QString &StringIn)
+{
+    QJsonDocument Doc;
+    QJsonObject Obj;
+
+    Obj.insert(FIELD__SRV_ID, QJsonValue(mID));
+    Obj.insert(FIELD__CMD, QJsonValue(CMD__EVENT));
+    Obj.insert(FIELD__SEQ, QJsonValue(static_cast<double>(SeqIn)));
+    Obj.insert(FIELD__STAMP, QJsonValue(static_cast<double>(StampIn)));
+    Obj.insert(FIELD__DATA, QJsonValue(ListEventsIn));
+    Doc.setObject(Obj);
+
+    StringIn+= QString(Doc.toJson(QJsonDocument::Compact));
+}
+
+
+/**
+@brief  Public method: Pack data of devices into snapshot.
+@param  SnapIn - link to snapshot.
+@return The number of packed devices.
+@detailed Is called by the survey thread at the end of cycle (see Snapshot).
+*/
+int Config::toSnapshot(Snapshot &SnapIn)
+{
+    Network *Net = nullptr;
+    SnapshotDevice Dev;
+    int i, j, nDevs;
+
+    for(i=0; i<mListNetworks.size(); i++)
+    {
+        Net = mListNetworks.at(i);
+
+        if(Net != nullptr)
+        {
+            nDevs = Net->sizeListDevices();
+
+            for(j=0; j<nDevs; j++)
+            {
+                Dev.mNetID    = Net->mID;
+                Dev.mDevID    = Net->getDeviceID(j);
+                Dev.mArhFile  = Net->getDeviceArhFile(j);
+                Dev.mArhTable = Net->getDeviceArhTable(j);
+                Dev.mArhStore = Net->getDeviceArhStore(j);
+                Dev.mListRows.clear();
+
+                if(!Dev.mArhFile.isEmpty() || !Dev.mArhTable.isEmpty() || Dev.mArhStore)
+                {
+                    Net->getDeviceArh(QString(""), false, j, Dev.mListRows);
+                }
+
+                SnapIn.mListDevices.append(Dev);
+            }
+        }
+    }
+
+    return (SnapIn.mListDevices.size());
+}
+
+
+/**
+@brief  Public method: Evaluate events of registers of a network.
+@param  IdxIn - index of list of networks (0...ListNetworks.size()-1);
+@param  StampIn - date and time of the survey of the network (msec since epoch);
+@param  ListDevicesIn - link to list of devices with archive rows of events;
+@param  ListEventsIn - link to list of JSON-objects.
+@return The number of raised or cleared events.
+@detailed Is called by the survey thread as soon as the network has been surveyed (see networkSurveyed()).
+          ListEventsIn = [ { NetID:..., DevID:..., Events:[ {...}, ... ] }, ... ]
+*/
+int Config::evaluateEvents(const int IdxIn, const qint64 StampIn, QList<SnapshotDevice> &ListDevicesIn, QJsonArray &ListEventsIn)
+{
+    Network *Net = nullptr;
+    SnapshotDevice Dev;
+    QJsonArray ListEvents;
+    QJsonObject Obj;
+    int j, nDevs, Res, Num = 0;
+
+    if(IdxIn >= 0 && IdxIn < mListNetworks.size())
+    {
+        Net = mListNetworks.at(IdxIn);
+
+        if(Net != nullptr && Net->mAllow)
+        {
+            nDevs = Net->sizeListDevices();
+
+            for(j=0; j<nDevs; j++)
+            {
+                Dev.mListRows.clear();
+                ListEvents = QJsonArray();
+
+                Res = Net->evaluateDeviceEvents(j, StampIn, Dev.mListRows, ListEvents);
+
+                if(Res > 0)
+                {
+                    Num+= Res;
+                    Dev.mNetID    = Net->mID;
+                    Dev.mDevID    = Net->getDeviceID(j);
+                    Dev.mArhFile  = Net->getDeviceArhFile(j);
+                    Dev.mArhTable = Net->getDeviceArhTable(j);
+                    Dev.mArhStore = Net->getDeviceArhStore(j);
+
+                    if(!Dev.mListRows.isEmpty() && (!Dev.mArhFile.isEmpty() || !Dev.mArhTable.isEmpty() || Dev.mArhStore))
+                    {
+                        ListDevicesIn.append(Dev);
+                    }
+
+                    if(!ListEvents.isEmpty())
+                    {
+                        Obj = QJsonObject();
+                        Obj.insert(FIELD__NET_ID, QJsonValue(Net->mID));
+                        Obj.insert(FIELD__DEV_ID, QJsonValue(Dev.mDevID));
+                        Obj.insert(FIELD__EVENTS, QJsonValue(ListEvents));
+                        ListEventsIn.append(Obj);
+                    }
+                }
+            }
+        }
+    }
+
+    return (Num);
+}
+
+
 /**
 @brief  Public method: Check option "Port".
 @param  None.
@@ -474,6 +787,13 @@ bool Config::normilize()
     if(mConnLifeTime < CONN_LIFE_TIME_OFF) mConnLifeTime = CONN_LIFE_TIME_OFF;
     if(mConnLifeTime > CONN_LIFE_TIME_MAX) mConnLifeTime = CONN_LIFE_TIME_MAX;
     if(mSurveyDelay < SURVEY_DELAY_MIN)    mSurveyDelay  = SURVEY_DELAY_MIN;
+    if(mPingInterval != PING_INTERVAL_OFF && mPingInterval < PING_INTERVAL_MIN) mPingInterval = PING_INTERVAL_MIN;
+    if(mPingMiss < PING_MISS_MIN) mPingMiss = PING_MISS_MIN;
+    if(mLogFlush != LOG_FLUSH_OFF && mLogFlush < LOG_FLUSH_MIN) mLogFlush = LOG_FLUSH_MIN;
+    if(mLogBuff < LogRing::SIZE_MIN) mLogBuff = LogRing::SIZE_MIN;
+    if(mLogBuff > LogRing::SIZE_MAX) mLogBuff = LogRing::SIZE_MAX;
+    if(mLogKeep < LOG_KEEP_MIN) mLogKeep = LOG_KEEP_MIN;
+    if(mEventBuff > EVENT_BUFF_MAX) mEventBuff = EVENT_BUFF_MAX;
 
     return (this->isCorrect());
 }
@@ -527,28 +847,56 @@ quint16 Config::parseDataWsBlack(const QJsonArray &DataIn)
     if(!DataIn.isEmpty())
     {
         QJsonValue Val;
+        QJsonObject Obj;
         QStringList StrParts;
         QString Key;
+        quint16 Port;
+        int Allow;
         bool Ok;
 
         for(int i=0; i<DataIn.size(); i++)
         {
-            Val = DataIn.at(i);
+            Val   = DataIn.at(i);
+            Key   = QString();
+            Port  = 0;
+            Allow = 0;
 
             if(Val.isString())
             {
-                StrParts = Val.toString(QString()).split(':');
+                Key = Val.toString(QString()).trimmed();
+
+                //"IPv4:Port" (IPv6 contains more than one ':')
+                if(Key.count(':') == 1)
+                {
+                    StrParts = Key.split(':');
+                    Key      = StrParts.at(0);
+                    Port     = static_cast<quint16>(StrParts.at(1).toInt(&Ok));
+                }
+            }
+            else if(Val.isObject())
+            {
+                Obj   = Val.toObject();
+                Key   = Obj.value(FIELD__IP).toString(QString()).trimmed();
+                Port  = static_cast<quint16>(Obj.value(FIELD__PORT).toInt(0));
+                Allow = Obj.value(FIELD__ALLOW).toInt(0);
+            }
 
-                if(StrParts.size())
+            if(!Key.isEmpty())
+            {
+                if(mTrieWsBlack.add(Key, ((Allow) ? IpTrie::ALLOW : IpTrie::DENY), Port))
                 {
-                    Key = StrParts.at(0);
-                    mListWsBlack[Key] = ((StrParts.size() > 1) ? static_cast<quint16>(StrParts.at(1).toInt(&Ok)) : static_cast<quint16>(0));
+                    if(Allow) mListWsWhite[Key] = Port;
+                    else      mListWsBlack[Key] = Port;
+                }
+                else
+                {
+                    LOG_WARN(QString("Config::parseDataWsBlack(): bad address %1").arg(Key), mFileLog, mUseLog, false);
                 }
             }
         }
     }
 
-    return (static_cast<quint16>(mListWsBlack.size()));
+    return (static_cast<quint16>(mTrieWsBlack.size()));
 }
 
 
@@ -632,6 +980,7 @@ quint16 Config::parseDataRoles(const QJsonArray &DataIn)
         QJsonObject Obj;
         QString IP;
         QString Role;
+        quint8 Val;
 
         for(int i=0; i<DataIn.size(); i++)
         {
@@ -639,11 +988,21 @@ quint16 Config::parseDataRoles(const QJsonArray &DataIn)
 
             if(!Obj.isEmpty())
             {
-                IP = Obj.value(FIELD__IP).toString(QString());
+                IP = Obj.value(FIELD__IP).toString(QString()).trimmed();
                 if(!IP.isEmpty())
                 {
                     Role = Obj.value(FIELD__ROLE).toString(QString());
-                    if(Role == ROLE__MANAGER_STR) mListRoles[IP] = ROLE__MANAGER;
+                    Val  = ((Role == ROLE__MANAGER_STR) ? ROLE__MANAGER : ROLE__VIEWER);
+
+                    //viewer is kept too: it overrides manager of a wider subnet
+                    if(mTrieRoles.add(IP, Val, 0))
+                    {
+                        if(Val == ROLE__MANAGER) mListRoles[IP] = Val;
+                    }
+                    else
+                    {
+                        LOG_WARN(QString("Config::parseDataRoles(): bad address %1").arg(IP), mFileLog, mUseLog, false);
+                    }
                 }
             }
         }
@@ -653,6 +1012,41 @@ quint16 Config::parseDataRoles(const QJsonArray &DataIn)
 }
 
 
+/**
+@brief  Check a client by black-list.
+@param  HostIn - address of the client;
+@param  PortIn - port of the client.
+@return True if the client is forbidden, otherwise - False.
+@detailed The longest matched rule (IPv4 or IPv6 subnet) is used.
+*/
+bool Config::isBlocked(const QHostAddress &HostIn, quint16 PortIn)
+{
+    quint8 Val = IpTrie::ALLOW;
+
+    if(mTrieWsBlack.find(HostIn, PortIn, Val))
+    {
+        return (((Val == IpTrie::DENY) ? true : false));
+    }
+
+    return (false);
+}
+
+
+/**
+@brief  Get role of a client.
+@param  HostIn - address of the client.
+@return Role of the client (ROLE__VIEWER if the client is not in list of roles).
+*/
+quint8 Config::getRole(const QHostAddress &HostIn)
+{
+    quint8 Val = ROLE__VIEWER;
+
+    if(mTrieRoles.find(HostIn, 0, Val)) return (Val);
+
+    return (ROLE__VIEWER);
+}
+
+
 /**
 @brief  Read list of networks from file.
 @param  FileIn - path to a file.
@@ -756,6 +1150,29 @@ bool Config::survey()
 }
 
 
+/**
+@brief  Public method: Push current raw-values into trends of registers.
+@param  StampIn - date and time of survey cycle (msec since epoch).
+@return The number of registers that have trend.
+*/
+quint32 Config::pushTrends(const qint64 StampIn)
+{
+    quint32 Num = 0;
+    Network *Net = nullptr;
+
+    for(int i=0; i<mListNetworks.size(); i++)
+    {
+        Net = mListNetworks.at(i);
+        if(Net)
+        {
+            if(Net->mAllow) Num+= Net->pushTrends(StampIn);
+        }
+    }
+
+    return (Num);
+}
+
+
 /**
 @brief  Private method: Start survey.
 @param  RandomIn - true if the survey is randomized.
@@ -763,11 +1180,11 @@ bool Config::survey()
 */
 bool Config::survey(const bool RandomIn)
 {
-    Log::log(QString("Config::survey(%1)").arg(((RandomIn) ? QString("randomized") : QString("real"))), mFileLog, mUseLog);
+    LOG_DEBUG(QString("Config::survey(%1)").arg(((RandomIn) ? QString("randomized") : QString("real"))), mFileLog, mUseLog);
 
     if(this->isCorrect())
     {
-        Log::log(QString("ListNetworks.size() = %1\r\n").arg(QString::number(mListNetworks.size())), mFileLog, mUseLog, false);
+        LOG_DEBUG(QString("ListNetworks.size() = %1\r\n").arg(QString::number(mListNetworks.size())), mFileLog, mUseLog, false);
         Network *Net = nullptr;
 
         for(int i=0; i<mListNetworks.size(); i++)
@@ -780,14 +1197,16 @@ bool Config::survey(const bool RandomIn)
                 {
                     if(!RandomIn)
                     {
-                        Log::log(QString("network[%1].survey()").arg(QString::number(i)), mFileLog, mUseLog, false);
+                        LOG_DEBUG(QString("network[%1].survey()").arg(QString::number(i)), mFileLog, mUseLog, false);
                         Net->survey();
                     }
                     else
                     {
-                        Log::log(QString("network[%1].randomize()").arg(QString::number(i)), mFileLog, mUseLog, false);
+                        LOG_DEBUG(QString("network[%1].randomize()").arg(QString::number(i)), mFileLog, mUseLog, false);
                         Net->randomize();
                     }
+
+                    emit networkSurveyed(i);
                 }
             }
         }
@@ -796,7 +1215,7 @@ bool Config::survey(const bool RandomIn)
     }
     else
     {
-        Log::log(QString("The configuration is incorrect!"), mFileLog, mUseLog, false);
+        LOG_ERROR(QString("The configuration is incorrect!"), mFileLog, mUseLog, false);
     }
 
     return (false);
@@ -806,13 +1225,31 @@ bool Config::survey(const bool RandomIn)
 /**
 @brief  Write data.
 @param  MsgIn - data message.
-@return None.
 @return True if the data has written, otherwise - False.
 @detailed MsgIn = { SrvID:Config.ID, NetID:Config.Net[n].ID, DevID:Config.Net[n].Dev[d].ID, Data:{ RegVar:RegValue, ... }, Stamp:CurrentTimeStamp }
 */
 bool Config::write(const QString &MsgIn)
 {
-    Log::log(QString("Config::write(%1)").arg(MsgIn), mFileLog, mUseLog);
+    QJsonObject Reply;
+    return (this->write(MsgIn, Reply));
+}
+
+
+/**
+@brief  Write data.
+@param  MsgIn - data message;
+@param  ReplyIn - link to JsonObject-reply.
+@return True if the data has written, otherwise - False.
+@detailed MsgIn   = { SrvID:Config.ID, NetID:Config.Net[n].ID, DevID:Config.Net[n].Dev[d].ID, ReqID:RequestID, Data:{ RegVar:RegValue, ... }, Stamp:CurrentTimeStamp }
+          ReplyIn = { SrvID, NetID, DevID, Cmd:"write", ReqID, Res:0|1, Ex:ExceptionCode }
+          Ex: 0 - OK, >0 - ModBus exception code, -1 - other error.
+*/
+bool Config::write(const QString &MsgIn, QJsonObject &ReplyIn)
+{
+    LOG_DEBUG(QString("Config::write(%1)").arg(MsgIn), mFileLog, mUseLog);
+
+    bool Res = false;
+    int  Ex  = -1;
 
     if(!MsgIn.isEmpty())
     {
@@ -824,11 +1261,12 @@ bool Config::write(const QString &MsgIn)
             if(!Obj.isEmpty())
             {
                 QString SrvID = Obj.value(FIELD__SRV_ID).toString(QString(""));
+                quint16 NetID = static_cast<quint16>(Obj.value(FIELD__NET_ID).toInt(0));
+                quint16 DevID = static_cast<quint16>(Obj.value(FIELD__DEV_ID).toInt(0));
+
                 if(SrvID == mID)
                 {
-                    Log::log(QString("SrvID(%1)==Config.mID(%2)").arg(SrvID, mID), mFileLog, mUseLog, false);
-                    quint16     NetID = static_cast<quint16>(Obj.value(FIELD__NET_ID).toInt(0));
-                    quint16     DevID = static_cast<quint16>(Obj.value(FIELD__DEV_ID).toInt(0));
+                    LOG_DEBUG(QString("SrvID(%1)==Config.mID(%2)").arg(SrvID, mID), mFileLog, mUseLog, false);
                     QJsonObject Data  = Obj.value(FIELD__DATA).toObject();
                     Network *Net;
 
@@ -839,15 +1277,208 @@ bool Config::write(const QString &MsgIn)
                         {
                             if(Net->mAllow && Net->mID == NetID)
                             {
-                                Net->write(DevID, Data);
-                                return (true);
+                                Res = Net->write(DevID, Data, Ex);
+                                break;
                             }
                         }
                     }
                 }
+
+                ReplyIn.insert(FIELD__SRV_ID, QJsonValue(mID));
+                ReplyIn.insert(FIELD__NET_ID, QJsonValue(NetID));
+                ReplyIn.insert(FIELD__DEV_ID, QJsonValue(DevID));
+                ReplyIn.insert(FIELD__CMD, QJsonValue(CMD__WRITE));
+                ReplyIn.insert(FIELD__REQ_ID, Obj.value(FIELD__REQ_ID));
+                ReplyIn.insert(FIELD__RES, QJsonValue(((Res) ? 1 : 0)));
+                ReplyIn.insert(FIELD__EX, QJsonValue(Ex));
             }
         }
     }
 
-    return (false);
+    return (Res);
+}
+
+
+/**
+@brief  Read data (on demand).
+@param  ObjIn - request message;
+@param  ReplyIn - link to JsonObject-reply.
+@return True if the data has read, otherwise - False.
+@detailed ObjIn   = { SrvID:Config.ID, NetID:Config.Net[n].ID, DevID:Config.Net[n].Dev[d].ID, Cmd:"read", ReqID:RequestID, Var:RegVar or [RegVar, ...] }
+          ReplyIn = { SrvID, NetID, DevID, Cmd:"read", ReqID, Res:0|1, Latency:msec, Stamp, Data:{ RegVar:RegValue, ... } }
+          Only groups of registers that contain the variables are read (all groups if Var is not set).
+*/
+bool Config::readData(const QJsonObject &ObjIn, QJsonObject &ReplyIn)
+{
+    quint16 NetID = static_cast<quint16>(ObjIn.value(FIELD__NET_ID).toInt(0));
+    quint16 DevID = static_cast<quint16>(ObjIn.value(FIELD__DEV_ID).toInt(0));
+    QJsonObject Data;
+    QStringList Vars;
+    qint64 Latency = 0;
+    bool Res = false;
+
+    LOG_DEBUG(QString("Config::readData(NetID:%1,DevID:%2)").arg(QString::number(NetID), QString::number(DevID)), mFileLog, mUseLog);
+
+    QJsonValue Var = ObjIn.value(FIELD__VAR);
+    if(Var.isArray())
+    {
+        QJsonArray Arr = Var.toArray();
+        for(int i=0; i<Arr.size(); i++)
+        {
+            if(Arr.at(i).isString()) Vars.append(Arr.at(i).toString());
+        }
+    }
+    else if(Var.isString())
+    {
+        Vars.append(Var.toString());
+    }
+
+    QString SrvID = ObjIn.value(FIELD__SRV_ID).toString(QString(""));
+    if(SrvID == mID)
+    {
+        Network *Net;
+
+        for(int i=0; i<mListNetworks.size(); i++)
+        {
+            Net = mListNetworks.at(i);
+            if(Net)
+            {
+                if(Net->mAllow && Net->mID == NetID)
+                {
+                    QElapsedTimer Timer;
+                    Timer.start();
+                    Res = Net->read(DevID, Vars, Data);
+                    Latency = Timer.elapsed();
+                    break;
+                }
+            }
+        }
+    }
+
+    ReplyIn.insert(FIELD__SRV_ID, QJsonValue(mID));
+    ReplyIn.insert(FIELD__NET_ID, QJsonValue(NetID));
+    ReplyIn.insert(FIELD__DEV_ID, QJsonValue(DevID));
+    ReplyIn.insert(FIELD__CMD, QJsonValue(CMD__READ));
+    ReplyIn.insert(FIELD__REQ_ID, ObjIn.value(FIELD__REQ_ID));
+    ReplyIn.insert(FIELD__RES, QJsonValue(((Res) ? 1 : 0)));
+    ReplyIn.insert(FIELD__LATENCY, QJsonValue(Latency));
+    ReplyIn.insert(FIELD__STAMP, QJsonValue((QDateTime::currentMSecsSinceEpoch()/1000)));
+    ReplyIn.insert(FIELD__DATA, QJsonValue(Data));
+
+    return (Res);
+}
+
+
+/**
+@brief  Read trends (on demand).
+@param  ObjIn - request message;
+@param  ReplyIn - link to JsonObject-reply.
+@return True if the device has trends, otherwise - False.
+@detailed ObjIn   = { SrvID:Config.ID, NetID:Config.Net[n].ID, DevID:Config.Net[n].Dev[d].ID, Cmd:"trend", ReqID:RequestID, Var:RegVar or [RegVar, ...] }
+          ReplyIn = { SrvID, NetID, DevID, Cmd:"trend", ReqID, Res:0|1, Stamp, Data:{ RegVar:[[msec, RegValue], ...], ... } }
+          Trends are read from memory (the device is not read), all trends of the device if Var is not set.
+*/
+bool Config::readTrend(const QJsonObject &ObjIn, QJsonObject &ReplyIn)
+{
+    quint16 NetID = static_cast<quint16>(ObjIn.value(FIELD__NET_ID).toInt(0));
+    quint16 DevID = static_cast<quint16>(ObjIn.value(FIELD__DEV_ID).toInt(0));
+    QJsonObject Data;
+    QStringList Vars;
+    bool Res = false;
+
+    LOG_DEBUG(QString("Config::readTrend(NetID:%1,DevID:%2)").arg(QString::number(NetID), QString::number(DevID)), mFileLog, mUseLog);
+
+    QJsonValue Var = ObjIn.value(FIELD__VAR);
+    if(Var.isArray())
+    {
+        QJsonArray Arr = Var.toArray();
+        for(int i=0; i<Arr.size(); i++)
+        {
+            if(Arr.at(i).isString()) Vars.append(Arr.at(i).toString());
+        }
+    }
+    else if(Var.isString())
+    {
+        Vars.append(Var.toString());
+    }
+
+    QString SrvID = ObjIn.value(FIELD__SRV_ID).toString(QString(""));
+    if(SrvID == mID)
+    {
+        Network *Net;
+
+        for(int i=0; i<mListNetworks.size(); i++)
+        {
+            Net = mListNetworks.at(i);
+            if(Net)
+            {
+                if(Net->mAllow && Net->mID == NetID)
+                {
+                    Res = Net->readTrend(DevID, Vars, Data);
+                    break;
+                }
+            }
+        }
+    }
+
+    ReplyIn.insert(FIELD__SRV_ID, QJsonValue(mID));
+    ReplyIn.insert(FIELD__NET_ID, QJsonValue(NetID));
+    ReplyIn.insert(FIELD__DEV_ID, QJsonValue(DevID));
+    ReplyIn.insert(FIELD__CMD, QJsonValue(CMD__TREND));
+    ReplyIn.insert(FIELD__REQ_ID, ObjIn.value(FIELD__REQ_ID));
+    ReplyIn.insert(FIELD__RES, QJsonValue(((Res) ? 1 : 0)));
+    ReplyIn.insert(FIELD__STAMP, QJsonValue((QDateTime::currentMSecsSinceEpoch()/1000)));
+    ReplyIn.insert(FIELD__DATA, QJsonValue(Data));
+
+    return (Res);
+}
+
+
+/**
+@brief  Prepare a history query.
+@param  ObjIn - request message;
+@param  HeadIn - link to JsonObject with common fields of reply;
+@param  DevIdIn - link to device ID;
+@param  RegIdIn - link to register ID.
+@return True if the register is found, otherwise - False.
+@detailed ObjIn  = { SrvID:Config.ID, NetID, DevID, Cmd:"history", ReqID:RequestID, Var:RegVar, From:sec, To:sec, Points:N, Alg:"minmax"|"lttb" }
+          HeadIn = { SrvID, NetID, DevID, Cmd:"history", ReqID, Var }
+*/
+bool Config::toHistoryHead(const QJsonObject &ObjIn, QJsonObject &HeadIn, quint16 &DevIdIn, quint16 &RegIdIn)
+{
+    quint16 NetID = static_cast<quint16>(ObjIn.value(FIELD__NET_ID).toInt(0));
+    QString Var   = ObjIn.value(FIELD__VAR).toString(QString(""));
+
+    DevIdIn = static_cast<quint16>(ObjIn.value(FIELD__DEV_ID).toInt(0));
+    RegIdIn = 0;
+
+    LOG_DEBUG(QString("Config::toHistoryHead(NetID:%1,DevID:%2,Var:%3)").arg(QString::number(NetID), QString::number(DevIdIn), Var), mFileLog, mUseLog);
+
+    QString SrvID = ObjIn.value(FIELD__SRV_ID).toString(QString(""));
+    if(SrvID == mID && !Var.isEmpty())
+    {
+        Network *Net;
+
+        for(int i=0; i<mListNetworks.size(); i++)
+        {
+            Net = mListNetworks.at(i);
+            if(Net)
+            {
+                if(Net->mAllow && Net->mID == NetID)
+                {
+                    RegIdIn = Net->getDeviceRegID(DevIdIn, Var);
+                    break;
+                }
+            }
+        }
+    }
+
+    HeadIn.insert(FIELD__SRV_ID, QJsonValue(mID));
+    HeadIn.insert(FIELD__NET_ID, QJsonValue(NetID));
+    HeadIn.insert(FIELD__DEV_ID, QJsonValue(DevIdIn));
+    HeadIn.insert(FIELD__CMD, QJsonValue(CMD__HISTORY));
+    HeadIn.insert(FIELD__REQ_ID, ObjIn.value(FIELD__REQ_ID));
+    HeadIn.insert(FIELD__VAR, QJsonValue(Var));
+
+    return ((RegIdIn > 0) ? true : false);
 }
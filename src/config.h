@@ -25,6 +25,7 @@
 #include <QString>
 #include <QStringList>
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QMap>
 #include <QFile>
 #include <QJsonDocument>
@@ -36,6 +37,8 @@
 #include "log.h"
 #include "json.h"
 #include "network.h"
+#include "ip-trie.h"
+#include "snapshot.h"
 
 
 /**
@@ -74,34 +77,73 @@ public:
     static const QString FIELD__CONN_MAX;
     static const QString FIELD__CONN_PER_CLI;
     static const QString FIELD__CONN_LIFE_TIME;
+    static const QString FIELD__PING_INTERVAL;
+    static const QString FIELD__PING_MISS;
     static const QString FIELD__SURVEY_DELAY;
     static const QString FIELD__FIRST_SURVEY_NOW;
     static const QString FIELD__RANDOM;
     static const QString FIELD__USE_LOG;
+    static const QString FIELD__LOG_BUFF;
+    static const QString FIELD__LOG_FLUSH;
+    static const QString FIELD__LOG_BLOCK;
+    static const QString FIELD__LOG_LEVEL;
+    static const QString FIELD__LOG_MAX_SIZE;
+    static const QString FIELD__LOG_DAILY;
+    static const QString FIELD__LOG_KEEP;
+    static const QString FIELD__LOG_GZIP;
     static const QString FIELD__USE_WS;
     static const QString FIELD__USE_WS_CLI;
     static const QString FIELD__USE_WS_BLACK;
     static const QString FIELD__USE_ARH;
     static const QString FIELD__USE_EVENT;
+    static const QString FIELD__EVENT_BUFF;
     static const QString FIELD__WS_BLACK;
     static const QString FIELD__WS_CLI;
     static const QString FIELD__ROLES;
     static const QString FIELD__ARH;
     static const QString FIELD__NETWORKS;
     static const QString FIELD__LOG;
+    static const QString FIELD__CAPTURE;
+    static const QString FIELD__REPLAY;
+    static const QString FIELD__REPLAY_LOOP;
 
-    //** roles
+    //** roles, black-list
     static const QString FIELD__IP;
     static const QString FIELD__ROLE;
+    static const QString FIELD__ALLOW;
 
     //** TimeStamp of JSON-object that will be send to WS-clients
     static const QString FIELD__STAMP;
 
+    //** Age of cached JSON-object (msec) that will be send to new WS-clients
+    static const QString FIELD__AGE;
+
     static const QString FIELD__SRV_ID;
     static const QString FIELD__NET_ID;
     static const QString FIELD__DEV_ID;
     static const QString FIELD__DATA;
 
+    //** requests of clients
+    static const QString FIELD__CMD;
+    static const QString FIELD__REQ_ID;
+    static const QString FIELD__VAR;
+    static const QString FIELD__RES;
+    static const QString FIELD__LATENCY;
+    static const QString FIELD__EX;
+
+    //** history queries of clients
+    static const QString FIELD__FROM;
+    static const QString FIELD__TO;
+    static const QString FIELD__POINTS;
+    static const QString FIELD__ALG;
+    static const QString FIELD__CHUNK;
+    static const QString FIELD__LAST;
+
+    //** events of registers that will be send to WS-clients
+    static const QString FIELD__EVENTS;
+    static const QString FIELD__SEQ;
+    static const QString FIELD__SUB;
+
     /**
     @brief Limites
     */
@@ -110,6 +152,18 @@ public:
     static const qint32  CONN_LIFE_TIME_MIN = 0;
     static const qint32  CONN_LIFE_TIME_MAX = 65000;
     static const quint32 SURVEY_DELAY_MIN   = 300;
+    static const quint32 PING_INTERVAL_OFF  = 0;
+    static const quint32 PING_INTERVAL_MIN  = 1000;
+    static const quint8  PING_MISS_DEF      = 3;
+    static const quint8  PING_MISS_MIN      = 1;
+    static const quint32 LOG_BUFF_DEF       = 4096;
+    static const quint32 LOG_FLUSH_OFF      = 0;
+    static const quint32 LOG_FLUSH_DEF      = 1000;
+    static const quint32 LOG_FLUSH_MIN      = 50;
+    static const quint16 LOG_KEEP_DEF       = 5;
+    static const quint16 LOG_KEEP_MIN       = 1;
+    static const quint32 EVENT_BUFF_DEF     = 1000;
+    static const quint32 EVENT_BUFF_MAX     = 100000;
 
     /**
     @brief Client roles
@@ -119,6 +173,15 @@ public:
     static const quint8  ROLE__MANAGER;
     static const QString ROLE__MANAGER_STR;
 
+    /**
+    @brief Commands of clients
+    */
+    static const QString CMD__WRITE;
+    static const QString CMD__READ;
+    static const QString CMD__HISTORY;
+    static const QString CMD__TREND;
+    static const QString CMD__EVENT;
+
 
     /**
     Public options
@@ -150,6 +213,17 @@ public:
     */
     qint32 mConnLifeTime;
 
+    /**
+    @brief Interval of WebSocket ping to connected clients (msec).
+    @detailed 0 - ping is off (ConnLifeTime is used)
+    */
+    quint32 mPingInterval;
+
+    /**
+    @brief The number of missed pong to disconnect a client.
+    */
+    quint8 mPingMiss;
+
     /**
     @brief The Delay between surveys (msec).
     */
@@ -170,6 +244,50 @@ public:
     */
     bool mUseLog;
 
+    /**
+    @brief Size of buffer of log (the number of messages).
+    */
+    quint32 mLogBuff;
+
+    /**
+    @brief Flush interval of log (msec).
+    @detailed 0 - log is written immediately (without writer thread)
+    */
+    quint32 mLogFlush;
+
+    /**
+    @brief Wait if buffer of log is full.
+    @detailed false - the message is dropped
+    */
+    bool mLogBlock;
+
+    /**
+    @brief Level of log (Log::LEVEL__*).
+    @detailed Can be changed by SIGUSR1 (more verbose), SIGUSR2 (less verbose) or by restart of the service.
+    */
+    quint8 mLogLevel;
+
+    /**
+    @brief Rotation of log :: Max. size of log-file (KB).
+    @detailed 0 - is not used
+    */
+    quint32 mLogMaxSize;
+
+    /**
+    @brief Rotation of log :: Rotate every day.
+    */
+    bool mLogDaily;
+
+    /**
+    @brief Rotation of log :: The number of kept segments.
+    */
+    quint16 mLogKeep;
+
+    /**
+    @brief Rotation of log :: Compress segments (gzip).
+    */
+    bool mLogGzip;
+
     /**
     @brief Use WebSocket-server.
     */
@@ -195,6 +313,12 @@ public:
     */
     bool mUseEvent;
 
+    /**
+    @brief The number of event messages kept for clients that reconnect (see Server::event()).
+    @detailed 0 - missed events are not sent again
+    */
+    quint32 mEventBuff;
+
     /**
     @brief Path to a file that contains list of forbidden WebSocket-clients (JSON).
     */
@@ -220,6 +344,23 @@ public:
     */
     QString mFileNetworks;
 
+    /**
+    @brief Path to a file of capture of bus traffic (binary).
+    @detailed Empty - capture is off
+    */
+    QString mFileCapture;
+
+    /**
+    @brief Path to a file of capture to replay (the bus is not used).
+    @detailed Empty - replay is off; replay has priority over capture
+    */
+    QString mFileReplay;
+
+    /**
+    @brief Replay the capture in loop.
+    */
+    bool mReplayLoop;
+
     /**
     @brief Path to a logout-file.
     */
@@ -232,12 +373,26 @@ public:
 
     /**
     @brief List of parsed forbidden WebSocket-clients.
-    @detailed "HostOrIP:Port"
+    @detailed "IPOrSubnet":Port
               ...
               * Port 0 - all ports
     */
     QMap<QString, quint16> mListWsBlack;
 
+    /**
+    @brief List of parsed allowed WebSocket-clients (exceptions of black-list).
+    @detailed "IPOrSubnet":Port
+              ...
+              * Port 0 - all ports
+    */
+    QMap<QString, quint16> mListWsWhite;
+
+    /**
+    @brief Trie of black-list (compiled from mListWsBlack and mListWsWhite).
+    @detailed Value: IpTrie::DENY or IpTrie::ALLOW; the longest matched prefix wins.
+    */
+    IpTrie mTrieWsBlack;
+
     /**
     @brief List of predefined WebSocket-clients.
     @detailed "HostOrIP:Port"
@@ -247,11 +402,17 @@ public:
 
     /**
     @brief List of parsed roles of allowed clients.
-    @detailed "HostOrIP":"Role"
+    @detailed "IPOrSubnet":"Role"
               ...
     */
     QMap<QString, quint8> mListRoles;
 
+    /**
+    @brief Trie of roles (compiled from mListRoles).
+    @detailed Value: ROLE__VIEWER or ROLE__MANAGER; the longest matched prefix wins.
+    */
+    IpTrie mTrieRoles;
+
     /**
     @brief List of networks.
     */
@@ -298,6 +459,37 @@ public:
     */
     void toJsonString(QString &StringIn);
 
+    /**
+    @brief  Pack events of registers to JSON string.
+    @param  SeqIn - sequence number of the message;
+    @param  StampIn - date and time of survey cycle (msec since epoch);
+    @param  ListEventsIn - list of events (see evaluateEvents());
+    @param  StringIn - link to string buffer.
+    @return None.
+    @detailed { SrvID:..., Cmd:"event", Seq:n, Stamp:msec, Data:[ { NetID:..., DevID:..., Events:[ {...}, ... ] }, ... ] }
+    */
+    void toEventString(const quint64 SeqIn, const qint64 StampIn, const QJsonArray &ListEventsIn, QString &StringIn);
+
+    /**
+    @brief  Pack data of devices into snapshot.
+    @param  SnapIn - link to snapshot.
+    @return The number of packed devices.
+    @detailed Is called by the survey thread at the end of cycle (see Snapshot).
+    */
+    int toSnapshot(Snapshot &SnapIn);
+
+    /**
+    @brief  Evaluate events of registers of a network.
+    @param  IdxIn - index of list of networks (0...ListNetworks.size()-1);
+    @param  StampIn - date and time of the survey of the network (msec since epoch);
+    @param  ListDevicesIn - link to list of devices with archive rows of events;
+    @param  ListEventsIn - link to list of JSON-objects.
+    @return The number of raised or cleared events.
+    @detailed Is called by the survey thread as soon as the network has been surveyed (see networkSurveyed()).
+              ListEventsIn = [ { NetID:..., DevID:..., Events:[ {...}, ... ] }, ... ]
+    */
+    int evaluateEvents(const int IdxIn, const qint64 StampIn, QList<SnapshotDevice> &ListDevicesIn, QJsonArray &ListEventsIn);
+
     /**
     @brief  Check option "Port".
     @param  None.
@@ -347,6 +539,22 @@ public:
     */
     quint16 readFileRoles(const QString &FileIn);
 
+    /**
+    @brief  Check a client by black-list.
+    @param  HostIn - address of the client;
+    @param  PortIn - port of the client.
+    @return True if the client is forbidden, otherwise - False.
+    @detailed The longest matched rule (IPv4 or IPv6 subnet) is used.
+    */
+    bool isBlocked(const QHostAddress &HostIn, quint16 PortIn);
+
+    /**
+    @brief  Get role of a client.
+    @param  HostIn - address of the client.
+    @return Role of the client (ROLE__VIEWER if the client is not in list of roles).
+    */
+    quint8 getRole(const QHostAddress &HostIn);
+
     /**
     @brief  Read list of networks from file.
     @param  FileIn - path to a file.
@@ -382,13 +590,80 @@ public:
     */
     bool survey();
 
+    /**
+    @brief  Push current raw-values into trends of registers.
+    @param  StampIn - date and time of survey cycle (msec since epoch).
+    @return The number of registers that have trend.
+    */
+    quint32 pushTrends(const qint64 StampIn);
+
     /**
     @brief  Write data.
     @param  MsgIn - data message.
-    @return None.
+    @return True if the data has written, otherwise - False.
     */
     bool write(const QString &MsgIn);
 
+    /**
+    @brief  Write data.
+    @param  MsgIn - data message;
+    @param  ReplyIn - link to JsonObject-reply.
+    @return True if the data has written, otherwise - False.
+    @detailed MsgIn   = { SrvID:Config.ID, NetID:Config.Net[n].ID, DevID:Config.Net[n].Dev[d].ID, ReqID:RequestID, Data:{ RegVar:RegValue, ... }, Stamp:CurrentTimeStamp }
+              ReplyIn = { SrvID, NetID, DevID, Cmd:"write", ReqID, Res:0|1, Ex:ExceptionCode }
+              Ex: 0 - OK, >0 - ModBus exception code, -1 - other error.
+    */
+    bool write(const QString &MsgIn, QJsonObject &ReplyIn);
+
+    /**
+    @brief  Read data (on demand).
+    @param  ObjIn - request message;
+    @param  ReplyIn - link to JsonObject-reply.
+    @return True if the data has read, otherwise - False.
+    @detailed ObjIn   = { SrvID:Config.ID, NetID:Config.Net[n].ID, DevID:Config.Net[n].Dev[d].ID, Cmd:"read", ReqID:RequestID, Var:RegVar or [RegVar, ...] }
+              ReplyIn = { SrvID, NetID, DevID, Cmd:"read", ReqID, Res:0|1, Latency:msec, Stamp, Data:{ RegVar:RegValue, ... } }
+              Only groups of registers that contain the variables are read (all groups if Var is not set).
+    */
+    bool readData(const QJsonObject &ObjIn, QJsonObject &ReplyIn);
+
+    /**
+    @brief  Read trends (on demand).
+    @param  ObjIn - request message;
+    @param  ReplyIn - link to JsonObject-reply.
+    @return True if the device has trends, otherwise - False.
+    @detailed ObjIn   = { SrvID:Config.ID, NetID:Config.Net[n].ID, DevID:Config.Net[n].Dev[d].ID, Cmd:"trend", ReqID:RequestID, Var:RegVar or [RegVar, ...] }
+              ReplyIn = { SrvID, NetID, DevID, Cmd:"trend", ReqID, Res:0|1, Stamp, Data:{ RegVar:[[msec, RegValue], ...], ... } }
+              Trends are read from memory (the device is not read), all trends of the device if Var is not set.
+    */
+    bool readTrend(const QJsonObject &ObjIn, QJsonObject &ReplyIn);
+
+    /**
+    @brief  Prepare a history query.
+    @param  ObjIn - request message;
+    @param  HeadIn - link to JsonObject with common fields of reply;
+    @param  DevIdIn - link to device ID;
+    @param  RegIdIn - link to register ID.
+    @return True if the register is found, otherwise - False.
+    @detailed ObjIn  = { SrvID:Config.ID, NetID, DevID, Cmd:"history", ReqID:RequestID, Var:RegVar, From:sec, To:sec, Points:N, Alg:"minmax"|"lttb" }
+              HeadIn = { SrvID, NetID, DevID, Cmd:"history", ReqID, Var }
+    */
+    bool toHistoryHead(const QJsonObject &ObjIn, QJsonObject &HeadIn, quint16 &DevIdIn, quint16 &RegIdIn);
+
+
+signals:
+
+    /**
+    Signals
+    */
+
+    /**
+    @brief  A network has been surveyed.
+    @param  IdxIn - index of list of networks (0...ListNetworks.size()-1).
+    @return None.
+    @detailed Is emitted by the survey thread after each network (before the end of cycle).
+    */
+    void networkSurveyed(const int IdxIn);
+
 
 private:
 
@@ -404,7 +679,9 @@ private:
     /**
     @brief  Parse data of forbidden WebSocket-clients.
     @param  DataIn - data.
-    @return The number of forbidden clients.
+    @return The number of rules.
+    @detailed DataIn = [ "IP", "IP:Port", "IP/Prefix", { "IP":"IPOrSubnet", "Port":Port, "Allow":0|1 }, ... ]
+              IPv4 and IPv6 are supported (Port is not parsed from string for IPv6).
     */
     quint16 parseDataWsBlack(const QJsonArray &DataIn);
 
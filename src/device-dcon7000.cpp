@@ -61,7 +61,7 @@ quint16 DeviceDCON7000::cmdAA6(SerialPort *SerialPortIn, Register *RegisterIn)
 
             DCON7000::cmdAA6(static_cast<quint8>(mBaseAddr), mChecksum, Request);
 
-            Log::log(QString("Request: %1").arg(QString(Request)), mFileLog, mUseLog);
+            LOG_TRACE(QString("Request: %1").arg(QString(Request)), mFileLog, mUseLog);
 
             if(SerialPortIn->write(Request))
             {
@@ -69,17 +69,17 @@ quint16 DeviceDCON7000::cmdAA6(SerialPort *SerialPortIn, Register *RegisterIn)
 
                 if((SerialPortIn->getError()) != QSerialPort::ReadError)
                 {
-                    Log::log(QString("Response: %1").arg(QString(Response)), mFileLog, mUseLog);
+                    LOG_TRACE(QString("Response: %1").arg(QString(Response)), mFileLog, mUseLog);
 
                     if(RegisterIn->mDevClass == Device::CLASS__I7041)
                     {
                         Result = DCON7000::respAA6_7041(Response);
-                        Log::log(QString("Result: %1").arg(QString::number(Result)), mFileLog, mUseLog);
+                        LOG_TRACE(QString("Result: %1").arg(QString::number(Result)), mFileLog, mUseLog);
                     }
                 }
                 else
                 {
-                    Log::log(QString("Error read data from serial port '%1' (%2)! %3").arg(SerialPortIn->mPortN, QString::number(SerialPortIn->getError()), SerialPortIn->getErrorString()), mFileLog, mUseLog);
+                    LOG_ERROR(QString("Error read data from serial port '%1' (%2)! %3").arg(SerialPortIn->mPortN, QString::number(SerialPortIn->getError()), SerialPortIn->getErrorString()), mFileLog, mUseLog);
                 }
             }
         }
@@ -124,7 +124,7 @@ quint16 DeviceDCON7000::readGroup(SerialPort *SerialPortIn, RegsGroup *GroupIn)
         }
         else
         {
-            Log::log(QString("The class '%1' of registers is not supported!").arg(GroupIn->getClass()), mFileLog, mUseLog);
+            LOG_ERROR(QString("The class '%1' of registers is not supported!").arg(GroupIn->getClass()), mFileLog, mUseLog);
         }
     }
 
@@ -143,7 +143,7 @@ quint16 DeviceDCON7000::readGroup(SerialPort *SerialPortIn, RegsGroup *GroupIn)
 */
 quint16 DeviceDCON7000::readRegisters(const QString &SerialPortIn, const quint32 SpdIn, const QString &PrtyIn, const quint8 DataBitsIn, const quint8 StopBitsIn)
 {
-    Log::log(QString("DeviceDCON7000::readRegisters(SerialPort=%1,Spd=%2,Prty=%3,DataBits=%4,StopBits=%5,Class=%6,BaseAddr=%7)").arg(SerialPortIn, QString::number(SpdIn), PrtyIn, QString::number(DataBitsIn), QString::number(StopBitsIn), mClass, QString::number(mBaseAddr)), mFileLog, mUseLog);
+    LOG_DEBUG(QString("DeviceDCON7000::readRegisters(SerialPort=%1,Spd=%2,Prty=%3,DataBits=%4,StopBits=%5,Class=%6,BaseAddr=%7)").arg(SerialPortIn, QString::number(SpdIn), PrtyIn, QString::number(DataBitsIn), QString::number(StopBitsIn), mClass, QString::number(mBaseAddr)), mFileLog, mUseLog);
 
     quint16 Result = 0;
 
@@ -166,21 +166,21 @@ quint16 DeviceDCON7000::readRegisters(const QString &SerialPortIn, const quint32
             for(int i=0; i<mListRegsGroups.size(); i++)
             {
                 Group = mListRegsGroups.at(i);
-                Result+= readGroup(Port, Group);
+                if(this->isReadRequested(Group)) Result+= readGroup(Port, Group);
             }
 //MUTEX UNLOCK
             Port->close();
         }
         else
         {
-            Log::log(QString("Error connection with '%1' (%2)! %3").arg(Port->mPortN, QString::number(Port->getError()), Port->getErrorString()), mFileLog, mUseLog, false);
+            LOG_ERROR(QString("Error connection with '%1' (%2)! %3").arg(Port->mPortN, QString::number(Port->getError()), Port->getErrorString()), mFileLog, mUseLog, false);
         }
 
         delete Port;
     }
     else
     {
-        Log::log(QString("The configuration is incorrect or list of registers is empty!"), mFileLog, mUseLog, false);
+        LOG_ERROR(QString("The configuration is incorrect or list of registers is empty!"), mFileLog, mUseLog, false);
     }
 
     return (Result);
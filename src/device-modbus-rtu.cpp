@@ -173,7 +173,7 @@ int DeviceModBusRTU::readRegs(HelperModBusRTUClient *ModBusCliIn, RegsGroup *Gro
 */
 quint16 DeviceModBusRTU::readRegisters(const QString &SerialPortIn, const quint32 SpdIn, const QString &PrtyIn, const quint8 DataBitsIn, const quint8 StopBitsIn, const QString &ModeIn)
 {
-    Log::log(QString("DeviceModBusRTU::readRegisters(SerialPort=%1,Spd=%2,Prty=%3,DataBits=%4,StopBits=%5,Mode=%6,Class=%7,BaseAddr=%8)").arg(SerialPortIn, QString::number(SpdIn), PrtyIn, QString::number(DataBitsIn), QString::number(StopBitsIn), ModeIn, mClass, QString::number(mBaseAddr)), mFileLog, mUseLog);
+    LOG_DEBUG(QString("DeviceModBusRTU::readRegisters(SerialPort=%1,Spd=%2,Prty=%3,DataBits=%4,StopBits=%5,Mode=%6,Class=%7,BaseAddr=%8)").arg(SerialPortIn, QString::number(SpdIn), PrtyIn, QString::number(DataBitsIn), QString::number(StopBitsIn), ModeIn, mClass, QString::number(mBaseAddr)), mFileLog, mUseLog);
 
     quint16 Num = 0;
 
@@ -201,7 +201,7 @@ quint16 DeviceModBusRTU::readRegisters(const QString &SerialPortIn, const quint3
 
                 if(Group)
                 {
-                    if(!(Group->size() > 0 && Group->isAllowToRead() && (Group->isClass(Register::CLASS__COIL) || Group->isClass(Register::CLASS__DISC) || Group->isClass(Register::CLASS__IN) || Group->isClass(Register::CLASS__INPT) || Group->isClass(Register::CLASS__HOLDING))))
+                    if(!(this->isReadRequested(Group) && Group->size() > 0 && Group->isAllowToRead() && (Group->isClass(Register::CLASS__COIL) || Group->isClass(Register::CLASS__DISC) || Group->isClass(Register::CLASS__IN) || Group->isClass(Register::CLASS__INPT) || Group->isClass(Register::CLASS__HOLDING))))
                     {
                         continue;
                     }
@@ -211,16 +211,16 @@ quint16 DeviceModBusRTU::readRegisters(const QString &SerialPortIn, const quint3
 
                     if(Res == -3)
                     {
-                        Log::log(QString("Error read data from '%1' (%2)! %3").arg(ModBusCli->mSerialPortNum, QString::number(ModBusCli->getErrorNo()), ModBusCli->getError()), mFileLog, mUseLog, false);
+                        LOG_ERROR(QString("Error read data from '%1' (%2)! %3").arg(ModBusCli->mSerialPortNum, QString::number(ModBusCli->getErrorNo()), ModBusCli->getError()), mFileLog, mUseLog, false);
                     }
                     else if(Res == -2)
                     {
-                        Log::log(QString("Error connection with '%1' after reconnect (%2)! %3").arg(ModBusCli->mSerialPortNum, QString::number(ModBusCli->getErrorNo()), ModBusCli->getError()), mFileLog, mUseLog, false);
+                        LOG_ERROR(QString("Error connection with '%1' after reconnect (%2)! %3").arg(ModBusCli->mSerialPortNum, QString::number(ModBusCli->getErrorNo()), ModBusCli->getError()), mFileLog, mUseLog, false);
                         break;
                     }
                     else if(Res == -1)
                     {
-                        Log::log(QString("The class '%1' of registers is not supported!").arg(Group->getClass()), mFileLog, mUseLog, false);
+                        LOG_ERROR(QString("The class '%1' of registers is not supported!").arg(Group->getClass()), mFileLog, mUseLog, false);
                     }
                     else
                     {
@@ -233,14 +233,14 @@ quint16 DeviceModBusRTU::readRegisters(const QString &SerialPortIn, const quint3
         }
         else
         {
-            Log::log(QString("Error connection with '%1' (%2)! %3").arg(ModBusCli->mSerialPortNum, QString::number(ModBusCli->getErrorNo()), ModBusCli->getError()), mFileLog, mUseLog, false);
+            LOG_ERROR(QString("Error connection with '%1' (%2)! %3").arg(ModBusCli->mSerialPortNum, QString::number(ModBusCli->getErrorNo()), ModBusCli->getError()), mFileLog, mUseLog, false);
         }
 
         delete ModBusCli;
     }
     else
     {
-        Log::log(QString("The configuration is incorrect or list of registers is empty!"), mFileLog, mUseLog, false);
+        LOG_ERROR(QString("The configuration is incorrect or list of registers is empty!"), mFileLog, mUseLog, false);
     }
 
     return (Num);
@@ -279,6 +279,7 @@ int DeviceModBusRTU::writeBits(HelperModBusRTUClient *ModBusCliIn, RegsGroup *Gr
                 quint8  *Values = new quint8[GroupIn->size()];
                 quint16 Len = GroupIn->getValues(Values, GroupIn->size());
                 Res = ModBusCliIn->writeCoilRegs(Values, GroupIn->getFirstAddr(), Len);
+                if(Res == HelperModBusClient::ERROR_RES) Res = -3;
                 delete Values;
             }
             else
@@ -323,6 +324,7 @@ int DeviceModBusRTU::writeRegs(HelperModBusRTUClient *ModBusCliIn, RegsGroup *Gr
                 quint16 *Values = new quint16[GroupIn->size()];
                 quint16 Len = GroupIn->getValues(Values, GroupIn->size());
                 Res = ModBusCliIn->writeHoldingRegs(Values, GroupIn->getFirstAddr(), Len);
+                if(Res == HelperModBusClient::ERROR_RES) Res = -3;
                 delete Values;
             }
             else
@@ -365,9 +367,10 @@ quint16 DeviceModBusRTU::writeRegisters(const QString &SerialPortIn, const quint
 */
 quint16 DeviceModBusRTU::writeRegisters(const QString &SerialPortIn, const quint32 SpdIn, const QString &PrtyIn, const quint8 DataBitsIn, const quint8 StopBitsIn, const QString &ModeIn, QJsonObject &ObjIn)
 {
-    Log::log(QString("DeviceModBusRTU::writeRegisters(SerialPort=%1,Spd=%2,Prty=%3,DataBits=%4,StopBits=%5,Mode=%6,Class=%7,BaseAddr=%8)").arg(SerialPortIn, QString::number(SpdIn), PrtyIn, QString::number(DataBitsIn), QString::number(StopBitsIn), ModeIn, mClass, QString::number(mBaseAddr)), mFileLog, mUseLog);
+    LOG_DEBUG(QString("DeviceModBusRTU::writeRegisters(SerialPort=%1,Spd=%2,Prty=%3,DataBits=%4,StopBits=%5,Mode=%6,Class=%7,BaseAddr=%8)").arg(SerialPortIn, QString::number(SpdIn), PrtyIn, QString::number(DataBitsIn), QString::number(StopBitsIn), ModeIn, mClass, QString::number(mBaseAddr)), mFileLog, mUseLog);
 
     quint16 Num = 0;
+    mWriteEx    = 0;
 
     if(this->isCorrect() && this->sizeListRegisters() > 0)
     {
@@ -408,16 +411,19 @@ quint16 DeviceModBusRTU::writeRegisters(const QString &SerialPortIn, const quint
 
                     if(Res == -3)
                     {
-                        Log::log(QString("Error write data from '%1' (%2)! %3").arg(ModBusCli->mSerialPortNum, QString::number(ModBusCli->getErrorNo()), ModBusCli->getError()), mFileLog, mUseLog, false);
+                        mWriteEx = ModBusCli->getException();
+                        if(mWriteEx == 0) mWriteEx = -1;
+                        LOG_ERROR(QString("Error write data from '%1' (%2)! %3").arg(ModBusCli->mSerialPortNum, QString::number(ModBusCli->getErrorNo()), ModBusCli->getError()), mFileLog, mUseLog, false);
                     }
                     else if(Res == -2)
                     {
-                        Log::log(QString("Error connection with '%1' after reconnect (%2)! %3").arg(ModBusCli->mSerialPortNum, QString::number(ModBusCli->getErrorNo()), ModBusCli->getError()), mFileLog, mUseLog, false);
+                        mWriteEx = -1;
+                        LOG_ERROR(QString("Error connection with '%1' after reconnect (%2)! %3").arg(ModBusCli->mSerialPortNum, QString::number(ModBusCli->getErrorNo()), ModBusCli->getError()), mFileLog, mUseLog, false);
                         break;
                     }
                     else if(Res == -1)
                     {
-                        Log::log(QString("The class '%1' of registers is not supported!").arg(Group->getClass()), mFileLog, mUseLog, false);
+                        LOG_ERROR(QString("The class '%1' of registers is not supported!").arg(Group->getClass()), mFileLog, mUseLog, false);
                     }
                     else
                     {
@@ -430,14 +436,15 @@ quint16 DeviceModBusRTU::writeRegisters(const QString &SerialPortIn, const quint
         }
         else
         {
-            Log::log(QString("Error connection with '%1' (%2)! %3").arg(ModBusCli->mSerialPortNum, QString::number(ModBusCli->getErrorNo()), ModBusCli->getError()), mFileLog, mUseLog, false);
+            mWriteEx = -1;
+            LOG_ERROR(QString("Error connection with '%1' (%2)! %3").arg(ModBusCli->mSerialPortNum, QString::number(ModBusCli->getErrorNo()), ModBusCli->getError()), mFileLog, mUseLog, false);
         }
 
         delete ModBusCli;
     }
     else
     {
-        Log::log(QString("The configuration is incorrect or list of registers is empty!"), mFileLog, mUseLog, false);
+        LOG_ERROR(QString("The configuration is incorrect or list of registers is empty!"), mFileLog, mUseLog, false);
     }
 
     return (Num);
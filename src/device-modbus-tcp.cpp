@@ -167,7 +167,7 @@ int DeviceModBusTCP::readRegs(HelperModBusTCPClient *ModBusCliIn, RegsGroup *Gro
 */
 quint16 DeviceModBusTCP::readRegisters()
 {
-    Log::log(QString("DeviceModBusTCP::readRegisters(IP=%1,Port=%2,BaseAddr=%3)").arg(mIP, QString::number(mPort), QString::number(mBaseAddr)), mFileLog, mUseLog);
+    LOG_DEBUG(QString("DeviceModBusTCP::readRegisters(IP=%1,Port=%2,BaseAddr=%3)").arg(mIP, QString::number(mPort), QString::number(mBaseAddr)), mFileLog, mUseLog);
 
     quint16 Num = 0;
 
@@ -190,7 +190,7 @@ quint16 DeviceModBusTCP::readRegisters()
 
                 if(Group)
                 {
-                    if(!(Group->size() > 0 && Group->isAllowToRead() && (Group->isClass(Register::CLASS__COIL) || Group->isClass(Register::CLASS__DISC) || Group->isClass(Register::CLASS__IN) || Group->isClass(Register::CLASS__INPT) || Group->isClass(Register::CLASS__HOLDING))))
+                    if(!(this->isReadRequested(Group) && Group->size() > 0 && Group->isAllowToRead() && (Group->isClass(Register::CLASS__COIL) || Group->isClass(Register::CLASS__DISC) || Group->isClass(Register::CLASS__IN) || Group->isClass(Register::CLASS__INPT) || Group->isClass(Register::CLASS__HOLDING))))
                     {
                         continue;
                     }
@@ -200,16 +200,16 @@ quint16 DeviceModBusTCP::readRegisters()
 
                     if(Res == -3)
                     {
-                        Log::log(QString("Error read data from '%1:%2' (%3)! %4").arg(ModBusCli->mIP, QString::number(mPort), QString::number(ModBusCli->getErrorNo()), ModBusCli->getError()), mFileLog, mUseLog, false);
+                        LOG_ERROR(QString("Error read data from '%1:%2' (%3)! %4").arg(ModBusCli->mIP, QString::number(mPort), QString::number(ModBusCli->getErrorNo()), ModBusCli->getError()), mFileLog, mUseLog, false);
                     }
                     else if(Res == -2)
                     {
-                        Log::log(QString("Error connection with '%1:%2' after reconnect (%3)! %4").arg(ModBusCli->mIP, QString::number(mPort), QString::number(ModBusCli->getErrorNo()), ModBusCli->getError()), mFileLog, mUseLog, false);
+                        LOG_ERROR(QString("Error connection with '%1:%2' after reconnect (%3)! %4").arg(ModBusCli->mIP, QString::number(mPort), QString::number(ModBusCli->getErrorNo()), ModBusCli->getError()), mFileLog, mUseLog, false);
                         break;
                     }
                     else if(Res == -1)
                     {
-                        Log::log(QString("The class '%1' of registers is not supported!").arg(Group->getClass()), mFileLog, mUseLog, false);
+                        LOG_ERROR(QString("The class '%1' of registers is not supported!").arg(Group->getClass()), mFileLog, mUseLog, false);
                     }
                     else
                     {
@@ -222,14 +222,14 @@ quint16 DeviceModBusTCP::readRegisters()
         }
         else
         {
-            Log::log(QString("Error connection with '%1:%2' (%3)! %4").arg(ModBusCli->mIP, QString::number(mPort), QString::number(ModBusCli->getErrorNo()), ModBusCli->getError()), mFileLog, mUseLog, false);
+            LOG_ERROR(QString("Error connection with '%1:%2' (%3)! %4").arg(ModBusCli->mIP, QString::number(mPort), QString::number(ModBusCli->getErrorNo()), ModBusCli->getError()), mFileLog, mUseLog, false);
         }
 
         delete ModBusCli;
     }
     else
     {
-        Log::log(QString("The configuration is incorrect or list of registers is empty!"), mFileLog, mUseLog, false);
+        LOG_ERROR(QString("The configuration is incorrect or list of registers is empty!"), mFileLog, mUseLog, false);
     }
 
     return (Num);
@@ -268,6 +268,7 @@ int DeviceModBusTCP::writeBits(HelperModBusTCPClient *ModBusCliIn, RegsGroup *Gr
                 quint8  *Values = new quint8[GroupIn->size()];
                 quint16 Len = GroupIn->getValues(Values, GroupIn->size());
                 Res = ModBusCliIn->writeCoilRegs(Values, GroupIn->getFirstAddr(), Len);
+                if(Res == HelperModBusClient::ERROR_RES) Res = -3;
                 delete Values;
             }
             else
@@ -312,6 +313,7 @@ int DeviceModBusTCP::writeRegs(HelperModBusTCPClient *ModBusCliIn, RegsGroup *Gr
                 quint16 *Values = new quint16[GroupIn->size()];
                 quint16 Len = GroupIn->getValues(Values, GroupIn->size());
                 Res = ModBusCliIn->writeHoldingRegs(Values, GroupIn->getFirstAddr(), Len);
+                if(Res == HelperModBusClient::ERROR_RES) Res = -3;
                 delete Values;
             }
             else
@@ -343,9 +345,10 @@ quint16 DeviceModBusTCP::writeRegisters()
 */
 quint16 DeviceModBusTCP::writeRegisters(QJsonObject &ObjIn)
 {
-    Log::log(QString("DeviceModBusTCP::writeRegisters(IP=%1,Port=%2,BaseAddr=%3)").arg(mIP, QString::number(mPort), QString::number(mBaseAddr)), mFileLog, mUseLog);
+    LOG_DEBUG(QString("DeviceModBusTCP::writeRegisters(IP=%1,Port=%2,BaseAddr=%3)").arg(mIP, QString::number(mPort), QString::number(mBaseAddr)), mFileLog, mUseLog);
 
     quint16 Num = 0;
+    mWriteEx    = 0;
 
     if(this->isCorrectBaseAddr() && this->isCorrectIP() && this->isCorrectPort() && this->sizeListRegisters() > 0)
     {
@@ -382,16 +385,19 @@ quint16 DeviceModBusTCP::writeRegisters(QJsonObject &ObjIn)
 
                     if(Res == -3)
                     {
-                        Log::log(QString("Error write data to '%1:%2' (%3)! %4").arg(ModBusCli->mIP, QString::number(mPort), QString::number(ModBusCli->getErrorNo()), ModBusCli->getError()), mFileLog, mUseLog, false);
+                        mWriteEx = ModBusCli->getException();
+                        if(mWriteEx == 0) mWriteEx = -1;
+                        LOG_ERROR(QString("Error write data to '%1:%2' (%3)! %4").arg(ModBusCli->mIP, QString::number(mPort), QString::number(ModBusCli->getErrorNo()), ModBusCli->getError()), mFileLog, mUseLog, false);
                     }
                     else if(Res == -2)
                     {
-                        Log::log(QString("Error connection with '%1:%2' after reconnect (%3)! %4").arg(ModBusCli->mIP, QString::number(mPort), QString::number(ModBusCli->getErrorNo()), ModBusCli->getError()), mFileLog, mUseLog, false);
+                        mWriteEx = -1;
+                        LOG_ERROR(QString("Error connection with '%1:%2' after reconnect (%3)! %4").arg(ModBusCli->mIP, QString::number(mPort), QString::number(ModBusCli->getErrorNo()), ModBusCli->getError()), mFileLog, mUseLog, false);
                         break;
                     }
                     else if(Res == -1)
                     {
-                        Log::log(QString("The class '%1' of registers is not supported!").arg(Group->getClass()), mFileLog, mUseLog, false);
+                        LOG_ERROR(QString("The class '%1' of registers is not supported!").arg(Group->getClass()), mFileLog, mUseLog, false);
                     }
                     else
                     {
@@ -404,14 +410,15 @@ quint16 DeviceModBusTCP::writeRegisters(QJsonObject &ObjIn)
         }
         else
         {
-            Log::log(QString("Error connection with '%1:%2' (%3)! %4").arg(ModBusCli->mIP, QString::number(mPort), QString::number(ModBusCli->getErrorNo()), ModBusCli->getError()), mFileLog, mUseLog, false);
+            mWriteEx = -1;
+            LOG_ERROR(QString("Error connection with '%1:%2' (%3)! %4").arg(ModBusCli->mIP, QString::number(mPort), QString::number(ModBusCli->getErrorNo()), ModBusCli->getError()), mFileLog, mUseLog, false);
         }
 
         delete ModBusCli;
     }
     else
     {
-        Log::log(QString("The configuration is incorrect or list of registers is empty!"), mFileLog, mUseLog, false);
+        LOG_ERROR(QString("The configuration is incorrect or list of registers is empty!"), mFileLog, mUseLog, false);
     }
 
     return (Num);
@@ -40,6 +40,7 @@ const QString Device::FIELD__WAIT_READ       = "WaitRead";
 //** archive
 const QString Device::FIELD__ARH_TABLE       = "ArhTable";
 const QString Device::FIELD__ARH_FILE        = "ArhFile";
+const QString Device::FIELD__ARH_STORE       = "ArhStore";
 
 /**
 @brief Classes.
@@ -65,6 +66,7 @@ Device::Device(QObject *parent) : QObject(parent)
     mNetProtoComm = QString("");
     mUseLog       = false;
     mFileLog      = QString("");
+    mWriteEx      = 0;
 
     this->byDefault();
 }
@@ -100,6 +102,7 @@ void Device::byDefault()
     mWaitRead       = -1;
     mArhTable       = QString("");
     mArhFile        = QString("");
+    mArhStore       = false;
 
     this->clearListRegisters();
 }
@@ -132,6 +135,9 @@ bool Device::fromJson(const QJsonObject &DataIn)
         Boo = (DataIn.value(FIELD__CHECKSUM).toInt(static_cast<int>(DENY)));
         mChecksum = ((Boo) ? true : false);
 
+        Boo = DataIn.value(FIELD__ARH_STORE).toInt(0);
+        mArhStore = ((Boo) ? true : false);
+
         Boo = (DataIn.value(FIELD__RECONNECT).toInt(static_cast<int>(DENY)));
         mReconnect = ((Boo) ? true : false);
 
@@ -139,7 +145,11 @@ bool Device::fromJson(const QJsonObject &DataIn)
 
         if(mAllow && !mFileRegisters.isEmpty())
         {
-            if(this->readFileRegisters(mFileRegisters)) this->initCalcRegisters();
+            if(this->readFileRegisters(mFileRegisters))
+            {
+                this->initCalcRegisters();
+                this->initEventRegisters();
+            }
         }
     }
 
@@ -238,6 +248,12 @@ void Device::toString(QString &StringIn)
     StringIn+= mArhFile;
     StringIn+= QString("\r\n");
 
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__ARH_STORE;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(((mArhStore) ? 1 : 0));
+    StringIn+= QString("\r\n");
+
     StringIn+= QString(" - ");
     StringIn+= FIELD__REGISTERS;
     StringIn+= QString(" = ");
@@ -423,11 +439,41 @@ int Device::toSqlEvent(const QString &ProfileIn, QList<QString> &ListStringsIn)
 }
 
 
+/**
+@brief  Pack value of registers into list of archive rows.
+@param  ProfileIn - name of profile;
+@param  EventsIn - true for event values, false for current values;
+@param  ListRowsIn - link to list of rows.
+@return The number of packed values.
+@detailed Binary analogue of toSql() for prepared statements.
+          Required: mArhTable, mArhFile or mArhStore
+*/
+int Device::toArh(const QString &ProfileIn, bool EventsIn, QList<ArhRow> &ListRowsIn)
+{
+    int Res = 0;
+
+    if(!mArhFile.isEmpty() || !mArhTable.isEmpty() || mArhStore)
+    {
+        RegsGroup *Group = nullptr;
+//MUTEX LOCK
+        QMutexLocker MutexLk(&mMutex);
+        for(int i=0; i<mListRegsGroups.size(); i++)
+        {
+            Group = mListRegsGroups.at(i);
+            if(Group) Res+= Group->toArhValue(ProfileIn, EventsIn, ListRowsIn);
+        }
+//MUTEX UNLOCK
+    }
+
+    return (Res);
+}
+
+
 /**
 @brief  Merge list of string buffers into one SQL.
 @param  ListStringsIn - link to list of string buffers;
 @param  StringIn - string buffer.
-@return The number of merged values.
+@return The number of merged items (SQL__HEAD_ITEMS header items included).
 */
 int Device::mergeSql(const QList<QString> &ListStringsIn, QString &StringIn)
 {
@@ -444,7 +490,7 @@ int Device::mergeSql(const QList<QString> &ListStringsIn, QString &StringIn)
 
             if(!Str.isEmpty())
             {
-                if(Res > 3) StringIn+= QString(",");
+                if(Res > SQL__HEAD_ITEMS) StringIn+= QString(",");
                 StringIn+= Str;
                 Res++;
             }
@@ -605,11 +651,11 @@ quint16 Device::parseDataRegisters(const QJsonDocument &DocIn)
                 }
                 else
                 {
-                    if(mUseLog)
+                    if(mUseLog && Log::isLevel(Log::LEVEL__WARN))
                     {
                         LogBuff = QString("The register is incorrect!\r\n");
                         Reg->toString(LogBuff);
-                        Log::log(LogBuff, mFileLog, mUseLog, false);
+                        LOG_WARN(LogBuff, mFileLog, mUseLog, false);
                     }
                     delete Reg;
                 }
@@ -634,6 +680,7 @@ void Device::clearListRegisters()
         RegsGroup *Group = nullptr;
 //MUTEX LOCK
         QMutexLocker MutexLk(&mMutex);
+        mListEventRegs.clear();
         while(mListRegsGroups.size())
         {
             Group = mListRegsGroups.takeLast();
@@ -693,7 +740,7 @@ bool Device::isListRegistersEmpty()
 */
 quint16 Device::randomize()
 {
-    Log::log(QString("Device::randomize(%1.%2)").arg(mClass, QString::number(mBaseAddr)), mFileLog, mUseLog);
+    LOG_DEBUG(QString("Device::randomize(%1.%2)").arg(mClass, QString::number(mBaseAddr)), mFileLog, mUseLog);
 
     quint16 Num = 0;
     RegsGroup *Group = nullptr;
@@ -709,6 +756,95 @@ quint16 Device::randomize()
 }
 
 
+/**
+@brief  Push current raw-values into trends of registers.
+@param  StampIn - date and time of survey cycle (msec since epoch).
+@return The number of registers that have trend.
+*/
+quint16 Device::pushTrends(const qint64 StampIn)
+{
+    quint16 Num = 0;
+    RegsGroup *Group = nullptr;
+//MUTEX LOCK
+    QMutexLocker MutexLk(&mMutex);
+    for(int i=0; i<mListRegsGroups.size(); i++)
+    {
+        Group = mListRegsGroups.at(i);
+        if(Group) Num+= Group->pushTrends(StampIn);
+    }
+//MUTEX UNLOCK
+    return (Num);
+}
+
+
+/**
+@brief  Pack trends of registers to JSON buffer.
+@param  ListVarsIn - list of variable names (empty list - all registers);
+@param  ObjIn - link to JsonObject.
+@return The number of packed trends.
+@detailed ObjIn = { RegVar:[[msec, RegValue], ...], ... }
+*/
+quint16 Device::toTrendJson(const QStringList &ListVarsIn, QJsonObject &ObjIn)
+{
+    quint16 Num = 0;
+    RegsGroup *Group = nullptr;
+//MUTEX LOCK
+    QMutexLocker MutexLk(&mMutex);
+    for(int i=0; i<mListRegsGroups.size(); i++)
+    {
+        Group = mListRegsGroups.at(i);
+        if(Group) Num+= Group->toTrendJson(ListVarsIn, ObjIn);
+    }
+//MUTEX UNLOCK
+    return (Num);
+}
+
+
+/**
+@brief  Get settings of compression of archive of registers.
+@param  MapCompIn - link to map of compressions (key = DevID << 16 | RegID).
+@return The number of registers with compression.
+*/
+quint16 Device::toArhComp(QHash<quint32, ArhComp> &MapCompIn)
+{
+    quint16 Num = 0;
+    RegsGroup *Group = nullptr;
+//MUTEX LOCK
+    QMutexLocker MutexLk(&mMutex);
+    for(int i=0; i<mListRegsGroups.size(); i++)
+    {
+        Group = mListRegsGroups.at(i);
+        if(Group) Num+= Group->toArhComp(MapCompIn);
+    }
+//MUTEX UNLOCK
+    return (Num);
+}
+
+
+/**
+@brief  Evaluate events of registers.
+@param  StampIn - date and time of survey cycle (msec since epoch);
+@param  ListRowsIn - link to list of archive rows;
+@param  ListEventsIn - link to list of JSON-objects.
+@return The number of raised or cleared events.
+@detailed Only registers with events are visited (see Register::evaluateEvents()).
+*/
+int Device::evaluateEvents(const qint64 StampIn, QList<ArhRow> &ListRowsIn, QJsonArray &ListEventsIn)
+{
+    int Num = 0;
+    Register *Reg = nullptr;
+//MUTEX LOCK
+    QMutexLocker MutexLk(&mMutex);
+    for(int i=0; i<mListEventRegs.size(); i++)
+    {
+        Reg = mListEventRegs.at(i);
+        if(Reg) Num+= Reg->evaluateEvents(StampIn, ListRowsIn, ListEventsIn);
+    }
+//MUTEX UNLOCK
+    return (Num);
+}
+
+
 /**
 @brief  Read registers by Serial.
 @param  SerialPortIn - the name (full path) of serial port,
@@ -721,7 +857,7 @@ quint16 Device::randomize()
 */
 quint16 Device::readRegisters(const QString &SerialPortIn, const quint32 SpdIn, const QString &PrtyIn, const quint8 DataBitsIn, const quint8 StopBitsIn, const QString &ModeIn)
 {
-    Log::log(QString("%1 %2 %3 %4 %5 %6").arg(SerialPortIn, QString::number(SpdIn), PrtyIn, QString::number(DataBitsIn), QString::number(StopBitsIn), ModeIn), mFileLog, mUseLog);
+    LOG_DEBUG(QString("%1 %2 %3 %4 %5 %6").arg(SerialPortIn, QString::number(SpdIn), PrtyIn, QString::number(DataBitsIn), QString::number(StopBitsIn), ModeIn), mFileLog, mUseLog);
     return (static_cast<quint16>(0));
 }
 
@@ -737,7 +873,7 @@ quint16 Device::readRegisters(const QString &SerialPortIn, const quint32 SpdIn,
 */
 quint16 Device::readRegisters(const QString &SerialPortIn, const quint32 SpdIn, const QString &PrtyIn, const quint8 DataBitsIn, const quint8 StopBitsIn)
 {
-    Log::log(QString("%1 %2 %3 %4 %5 %6 %7").arg(SerialPortIn, QString::number(SpdIn), PrtyIn, QString::number(DataBitsIn), QString::number(StopBitsIn), (mChecksum ? QString("1") : QString("0")), QString::number(mWaitRead)), mFileLog, mUseLog);
+    LOG_DEBUG(QString("%1 %2 %3 %4 %5 %6 %7").arg(SerialPortIn, QString::number(SpdIn), PrtyIn, QString::number(DataBitsIn), QString::number(StopBitsIn), (mChecksum ? QString("1") : QString("0")), QString::number(mWaitRead)), mFileLog, mUseLog);
     return (static_cast<quint16>(0));
 }
 
@@ -828,7 +964,7 @@ quint16 Device::writeRegisters(QJsonObject &ObjIn)
 */
 quint16 Device::readDummyRegisters()
 {
-    Log::log(QString("Device::readDummyRegisters(%1.%2)").arg(mClass, QString::number(mBaseAddr)), mFileLog, mUseLog);
+    LOG_DEBUG(QString("Device::readDummyRegisters(%1.%2)").arg(mClass, QString::number(mBaseAddr)), mFileLog, mUseLog);
 
     quint16 Result   = 0;
     RegsGroup *Group = nullptr;
@@ -844,7 +980,7 @@ quint16 Device::readDummyRegisters()
 
         if(Group)
         {
-            if(Group->size() > 0)
+            if(Group->size() > 0 && this->isReadRequested(Group))
             {
                 Values = new quint16[Group->size()];
 
@@ -918,7 +1054,7 @@ QList<quint16 *> Device::getValues(const QList<quint16> &ListIDsIn)
 //MUTEX UNLOCK
     }
 
-    Log::log(QString("Device::getValues() = %1").arg(QString::number(ListValues.size())), mFileLog, mUseLog);
+    LOG_DEBUG(QString("Device::getValues() = %1").arg(QString::number(ListValues.size())), mFileLog, mUseLog);
 
     return (ListValues);
 }
@@ -949,7 +1085,7 @@ QList<Register *> Device::getRegisters(const QString ClassIn)
 //MUTEX UNLOCK
     }
 
-    Log::log(QString("Device::getRegisters(%1) = %2").arg(ClassIn, QString::number(ListRegs.size())), mFileLog, mUseLog);
+    LOG_DEBUG(QString("Device::getRegisters(%1) = %2").arg(ClassIn, QString::number(ListRegs.size())), mFileLog, mUseLog);
 
     return (ListRegs);
 }
@@ -976,3 +1112,114 @@ void Device::initCalcRegisters()
         }
     }
 }
+
+
+/**
+@brief  Init. registers with events.
+@param  None.
+@return None.
+*/
+void Device::initEventRegisters()
+{
+    Log::log(QString("Device::initEventRegisters()"), mFileLog, mUseLog);
+
+    RegsGroup *Group = nullptr;
+    QList<Register *> ListRegs;
+//MUTEX LOCK
+    QMutexLocker MutexLk(&mMutex);
+    mListEventRegs.clear();
+    for(int i=0; i<mListRegsGroups.size(); i++)
+    {
+        Group = mListRegsGroups.at(i);
+        if(Group != nullptr)
+        {
+            ListRegs = Group->getAll();
+            for(int j=0; j<ListRegs.size(); j++)
+            {
+                if(ListRegs.at(j) && !ListRegs.at(j)->isListEventsEmpty()) mListEventRegs.append(ListRegs.at(j));
+            }
+        }
+    }
+//MUTEX UNLOCK
+}
+
+
+/**
+@brief  Set filter of registers groups to read.
+@param  ListVarsIn - list of variable names.
+@return None.
+@detailed Only groups that contain one of the variables will be read by readRegisters(),
+          empty list - all groups.
+*/
+void Device::setReadFilter(const QStringList &ListVarsIn)
+{
+    mListReadVars = ListVarsIn;
+}
+
+
+/**
+@brief  Clear filter of registers groups to read.
+@param  None.
+@return None.
+*/
+void Device::clearReadFilter()
+{
+    mListReadVars.clear();
+}
+
+
+/**
+@brief  Get ID of register by variable name.
+@param  VarIn - variable name.
+@return ID of register or 0 if the device does not contain the variable.
+*/
+quint16 Device::getRegID(const QString &VarIn)
+{
+    quint16 Res = 0;
+    RegsGroup *Group = nullptr;
+//MUTEX LOCK
+    QMutexLocker MutexLk(&mMutex);
+    for(int i=0; i<mListRegsGroups.size(); i++)
+    {
+        Group = mListRegsGroups.at(i);
+        if(Group) Res = Group->getIDByVar(VarIn);
+        if(Res > 0) break;
+    }
+//MUTEX UNLOCK
+    return (Res);
+}
+
+
+/**
+@brief  Check a group by filter to read.
+@param  GroupIn - pointer to group.
+@return True if the group is requested to read, otherwise - False.
+*/
+bool Device::isReadRequested(RegsGroup *GroupIn)
+{
+    if(GroupIn)
+    {
+        if(mListReadVars.isEmpty()) return (true);
+
+        for(int i=0; i<mListReadVars.size(); i++)
+        {
+            if(GroupIn->hasVar(mListReadVars.at(i))) return (true);
+        }
+    }
+
+    return (false);
+}
+
+
+/**
+@brief  Get result of last writing.
+@param  None.
+@return Result:
+@arg      = 0 - OK
+@arg      > 0 - ModBus exception code
+@arg     = -1 - error connection or write data (without exception code)
+*/
+int Device::getWriteException()
+{
+    return (mWriteEx);
+}
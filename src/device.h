@@ -32,6 +32,7 @@
 #include <QList>
 #include <QMap>
 #include <QMutex>
+#include <QStringList>
 
 #include "log.h"
 #include "json.h"
@@ -87,6 +88,7 @@ public:
     //** archive
     static const QString FIELD__ARH_TABLE;
     static const QString FIELD__ARH_FILE;
+    static const QString FIELD__ARH_STORE;
 
     /**
     @brief Permission codes.
@@ -107,6 +109,11 @@ public:
     static const QString PROTO_COMM__ETH;
     static const QString PROTO_COMM__DUMMY;
 
+    /**
+    @brief The number of header items of SQL (INSERT, field names, VALUES) merged by mergeSql().
+    */
+    static const int SQL__HEAD_ITEMS = 3;
+
 
     /**
     Public options
@@ -175,6 +182,11 @@ public:
     */
     QString mArhFile;
 
+    /**
+    @brief Write registers into the embedded store of archive (each survey cycle).
+    */
+    bool mArhStore;
+
     /**
     @brief Network Communication protocol.
     */
@@ -307,11 +319,22 @@ public:
     */
     int toSqlEvent(const QString &ProfileIn, QList<QString> &ListStringsIn);
 
+    /**
+    @brief  Pack value of registers into list of archive rows.
+    @param  ProfileIn - name of profile;
+    @param  EventsIn - true for event values, false for current values;
+    @param  ListRowsIn - link to list of rows.
+    @return The number of packed values.
+    @detailed Binary analogue of toSql() for prepared statements.
+              Required: mArhTable, mArhFile or mArhStore
+    */
+    int toArh(const QString &ProfileIn, bool EventsIn, QList<ArhRow> &ListRowsIn);
+
     /**
     @brief  Merge list of string buffers into one SQL.
     @param  ListStringsIn - link to list of string buffers;
     @param  StringIn - string buffer.
-    @return The number of merged values.
+    @return The number of merged items (SQL__HEAD_ITEMS header items included).
     @details Items 0, 1, 2 must be header values (INSERT, field names, VALUES)
     */
     static int mergeSql(const QList<QString> &ListStringsIn, QString &StringIn);
@@ -393,6 +416,39 @@ public:
     */
     quint16 randomize();
 
+    /**
+    @brief  Push current raw-values into trends of registers.
+    @param  StampIn - date and time of survey cycle (msec since epoch).
+    @return The number of registers that have trend.
+    */
+    quint16 pushTrends(const qint64 StampIn);
+
+    /**
+    @brief  Pack trends of registers to JSON buffer.
+    @param  ListVarsIn - list of variable names (empty list - all registers);
+    @param  ObjIn - link to JsonObject.
+    @return The number of packed trends.
+    @detailed ObjIn = { RegVar:[[msec, RegValue], ...], ... }
+    */
+    quint16 toTrendJson(const QStringList &ListVarsIn, QJsonObject &ObjIn);
+
+    /**
+    @brief  Get settings of compression of archive of registers.
+    @param  MapCompIn - link to map of compressions (key = DevID << 16 | RegID).
+    @return The number of registers with compression.
+    */
+    quint16 toArhComp(QHash<quint32, ArhComp> &MapCompIn);
+
+    /**
+    @brief  Evaluate events of registers.
+    @param  StampIn - date and time of survey cycle (msec since epoch);
+    @param  ListRowsIn - link to list of archive rows;
+    @param  ListEventsIn - link to list of JSON-objects.
+    @return The number of raised or cleared events.
+    @detailed Only registers with events are visited (see Register::evaluateEvents()).
+    */
+    int evaluateEvents(const qint64 StampIn, QList<ArhRow> &ListRowsIn, QJsonArray &ListEventsIn);
+
     /**
     @brief  Read registers by Serial.
     @param  SerialPortIn - the name (full path) of serial port,
@@ -471,6 +527,39 @@ public:
     */
     quint16 readDummyRegisters();
 
+    /**
+    @brief  Set filter of registers groups to read.
+    @param  ListVarsIn - list of variable names.
+    @return None.
+    @detailed Only groups that contain one of the variables will be read by readRegisters(),
+              empty list - all groups.
+    */
+    void setReadFilter(const QStringList &ListVarsIn);
+
+    /**
+    @brief  Clear filter of registers groups to read.
+    @param  None.
+    @return None.
+    */
+    void clearReadFilter();
+
+    /**
+    @brief  Get ID of register by variable name.
+    @param  VarIn - variable name.
+    @return ID of register or 0 if the device does not contain the variable.
+    */
+    quint16 getRegID(const QString &VarIn);
+
+    /**
+    @brief  Get result of last writing.
+    @param  None.
+    @return Result:
+    @arg      = 0 - OK
+    @arg      > 0 - ModBus exception code
+    @arg     = -1 - error connection or write data (without exception code)
+    */
+    int getWriteException();
+
 
 protected:
 
@@ -488,6 +577,21 @@ protected:
     */
     QMutex mMutex;
 
+    /**
+    @brief Filter of registers groups to read (list of variable names).
+    */
+    QStringList mListReadVars;
+
+    /**
+    @brief Registers with events.
+    */
+    QList<Register *> mListEventRegs;
+
+    /**
+    @brief Result of last writing (see getWriteException()).
+    */
+    int mWriteEx;
+
 
     /**
     Private methods
@@ -534,6 +638,20 @@ protected:
     @return None.
     */
     void initCalcRegisters();
+
+    /**
+    @brief  Init. registers with events.
+    @param  None.
+    @return None.
+    */
+    void initEventRegisters();
+
+    /**
+    @brief  Check a group by filter to read.
+    @param  GroupIn - pointer to group.
+    @return True if the group is requested to read, otherwise - False.
+    */
+    bool isReadRequested(RegsGroup *GroupIn);
 };
 
 #endif // DEVICE_H
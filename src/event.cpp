@@ -32,6 +32,9 @@ const QString Event::FIELD__EX          = "Ex";
 const QString Event::FIELD__ERR         = "Err";
 const QString Event::FIELD__STAMP       = "Stamp";
 const QString Event::FIELD__STAMP_CONF  = "StampConfirmed";
+const QString Event::FIELD__HYST        = "Hyst";
+const QString Event::FIELD__DEBOUNCE    = "Debounce";
+const QString Event::FIELD__ACTIVE      = "Active";
 
 /**
 @brief Algorithms
@@ -78,6 +81,13 @@ void Event::byDefault()
     mSign = 0;
     mEx   = -1;
     mErr  = 0;
+    mValue    = 0;
+    mHyst     = 0.0;
+    mDebounce = 0;
+
+    mActive       = false;
+    mPending      = false;
+    mPendingSince = 0;
 
     this->reset();
 }
@@ -101,6 +111,10 @@ bool Event::fromJson(const QJsonObject &DataIn)
         mSign = static_cast<qint16>(DataIn.value(FIELD__SIGN).toInt(0));
         mEx   = static_cast<qint16>(DataIn.value(FIELD__EX).toInt(0));
         mErr  = static_cast<qint16>(DataIn.value(FIELD__ERR).toInt(0));
+        mHyst     = DataIn.value(FIELD__HYST).toDouble(0.0);
+        mDebounce = static_cast<quint32>(DataIn.value(FIELD__DEBOUNCE).toInt(0));
+
+        if(mHyst < 0.0) mHyst = 0.0;
     }
 
     return (this->isCorrect());
@@ -142,6 +156,18 @@ void Event::toString(QString &StringIn)
     StringIn+= QString::number(mRef);
     StringIn+= QString("\r\n");
 
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__HYST;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(mHyst);
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__DEBOUNCE;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(mDebounce);
+    StringIn+= QString("\r\n");
+
     StringIn+= QString(" - ");
     StringIn+= FIELD__STAMP;
     StringIn+= QString(" = ");
@@ -174,6 +200,9 @@ void Event::toString(QString &StringIn)
 
     StringIn+= QString(" * the event %1").arg(((this->isReady()) ? QString("is ready") : QString("is not ready")));
     StringIn+= QString("\r\n");
+
+    StringIn+= QString(" * the event %1").arg(((mActive) ? QString("is active") : QString("is not active")));
+    StringIn+= QString("\r\n");
 }
 
 
@@ -268,3 +297,89 @@ bool Event::isConfirmed()
 {
     return (!this->isReady());
 }
+
+
+/**
+@brief  Evaluate a new value.
+@param  ValueIn - formatted value;
+@param  RawValueIn - raw-value;
+@param  StampIn - date and time of the value (msec since epoch).
+@return True if the event has been raised or cleared (the event is ready), otherwise - False.
+*/
+bool Event::evaluate(const double ValueIn, const quint16 RawValueIn, const qint64 StampIn)
+{
+    if(this->isRaised(ValueIn) == mActive)
+    {
+        //the state is back before debounce has elapsed
+        mPending = false;
+        return (false);
+    }
+
+    if(!mPending)
+    {
+        mPending      = true;
+        mPendingSince = StampIn;
+    }
+
+    if(StampIn - mPendingSince < static_cast<qint64>(mDebounce)) return (false);
+
+    mActive  = !mActive;
+    mPending = false;
+    mValue   = RawValueIn;
+    mStamp   = QDateTime::fromMSecsSinceEpoch(StampIn);
+
+    return (true);
+}
+
+
+/**
+@brief  Check the event is active (raised).
+@param  None.
+@return True if the event is active, otherwise - False.
+*/
+bool Event::isActive()
+{
+    return (mActive);
+}
+
+
+/**
+@brief  Check the event is waiting for debounce.
+@param  None.
+@return True if a new state is waiting, otherwise - False.
+*/
+bool Event::isPending()
+{
+    return (mPending);
+}
+
+
+/**
+@brief  Check the condition of the algorithm.
+@param  ValueIn - formatted value.
+@return True if the event must be active, otherwise - False.
+@details Hysteresis is applied to an active event.
+*/
+bool Event::isRaised(const double ValueIn)
+{
+    double Hyst = ((mActive) ? mHyst : 0.0);
+
+    if(mAlg == ALG__OUTLIM)
+    {
+        return ((ValueIn < static_cast<double>(mMin) + Hyst || ValueIn > static_cast<double>(mMax) - Hyst) ? true : false);
+    }
+    else if(mAlg == ALG__REF_EQ)
+    {
+        return ((qAbs(ValueIn - static_cast<double>(mRef)) <= Hyst) ? true : false);
+    }
+    else if(mAlg == ALG__REF_GREATER)
+    {
+        return ((ValueIn > static_cast<double>(mRef) - Hyst) ? true : false);
+    }
+    else if(mAlg == ALG__REF_LESS)
+    {
+        return ((ValueIn < static_cast<double>(mRef) + Hyst) ? true : false);
+    }
+
+    return (false);
+}
@@ -71,6 +71,9 @@ public:
     static const QString FIELD__ERR;
     static const QString FIELD__STAMP;
     static const QString FIELD__STAMP_CONF;
+    static const QString FIELD__HYST;
+    static const QString FIELD__DEBOUNCE;
+    static const QString FIELD__ACTIVE;
 
     /**
     @brief Algorithms
@@ -128,6 +131,18 @@ public:
     */
     quint16 mValue;
 
+    /**
+    @brief Hysteresis.
+    @details An active event is cleared when the value is back by Hyst from the limits (reference).
+    */
+    double mHyst;
+
+    /**
+    @brief Debounce (msec).
+    @details A new state must hold Debounce msec before the event is raised or cleared.
+    */
+    quint32 mDebounce;
+
 
     /**
     Public methods
@@ -213,6 +228,29 @@ public:
     */
     bool isConfirmed();
 
+    /**
+    @brief  Evaluate a new value.
+    @param  ValueIn - formatted value;
+    @param  RawValueIn - raw-value;
+    @param  StampIn - date and time of the value (msec since epoch).
+    @return True if the event has been raised or cleared (the event is ready), otherwise - False.
+    */
+    bool evaluate(const double ValueIn, const quint16 RawValueIn, const qint64 StampIn);
+
+    /**
+    @brief  Check the event is active (raised).
+    @param  None.
+    @return True if the event is active, otherwise - False.
+    */
+    bool isActive();
+
+    /**
+    @brief  Check the event is waiting for debounce.
+    @param  None.
+    @return True if a new state is waiting, otherwise - False.
+    */
+    bool isPending();
+
 
 private:
 
@@ -225,6 +263,30 @@ private:
     */
     QDateTime mStamp;
     QDateTime mStampConfirmed;
+
+    /**
+    @brief State.
+    */
+    bool mActive;
+
+    /**
+    @brief A new state is waiting for debounce since mPendingSince (msec since epoch).
+    */
+    bool mPending;
+    qint64 mPendingSince;
+
+
+    /**
+    Private methods
+    */
+
+    /**
+    @brief  Check the condition of the algorithm.
+    @param  ValueIn - formatted value.
+    @return True if the event must be active, otherwise - False.
+    @details Hysteresis is applied to an active event.
+    */
+    bool isRaised(const double ValueIn);
 };
 
 #endif // EVENT_H
@@ -29,6 +29,10 @@
 #define ARG_KEY_SNAME  "--sname"
 #define ARG_KEY_SDESC  "--sdesc"
 
+#define ARG_KEY_BENCH_STORE   "--bench-store"
+#define ARG_KEY_BENCH_TAGS    "--bench-tags"
+#define ARG_KEY_BENCH_SAMPLES "--bench-samples"
+
 
 //* Service
 //** if define: WinService
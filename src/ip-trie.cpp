@@ -0,0 +1,264 @@
+/* Copyright (C) 2019 ATgroup09
+*  Contact: atgroup09@gmail.com
+*
+*  This file is part of the HMI server component.
+*
+*  The code in this page is free software: you can
+*  redistribute it and/or modify it under the terms of the GNU
+*  General Public License (GNU GPL) as published by the Free Software
+*  Foundation, either version 3 of the License, or (at your option)
+*  any later version.  The code is distributed WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS
+*  FOR A PARTICULAR PURPOSE.  See the GNU GPL for more details.
+*
+*  As additional permission under GNU GPL version 3 section 7, you
+*  may distribute non-source (e.g., minimized or compacted) forms of
+*  that code without the copy of the GNU GPL normally required by
+*  section 4, provided you include this license notice and a URL
+*  through which recipients can access the Corresponding Source.
+*/
+
+#include "ip-trie.h"
+
+
+/**
+@brief  Constructor.
+@param  None.
+@return None.
+*/
+IpTrieNode::IpTrieNode()
+{
+    mChild[0] = nullptr;
+    mChild[1] = nullptr;
+}
+
+
+/**
+@brief  Destructor.
+@param  None.
+@return None.
+@detailed Children are deleted.
+*/
+IpTrieNode::~IpTrieNode()
+{
+    if(mChild[0]) delete mChild[0];
+    if(mChild[1]) delete mChild[1];
+}
+
+
+/**
+@brief  Constructor.
+@param  None.
+@return None.
+*/
+IpTrie::IpTrie(QObject *parent) : QObject(parent)
+{
+    mRoot = new IpTrieNode();
+    mSize = 0;
+}
+
+
+/**
+@brief  Destructor.
+@param  None.
+@return None.
+*/
+IpTrie::~IpTrie()
+{
+    delete mRoot;
+}
+
+
+/**
+@brief  Convert address to 128 bits (IPv4 as IPv4-mapped IPv6).
+@param  HostIn - address;
+@param  BytesIn - pointer to array of 16 bytes;
+@param  IsIPv4In - link to sign of IPv4-address.
+@return True if converted, otherwise - False.
+*/
+bool IpTrie::toBytes(const QHostAddress &HostIn, quint8 *BytesIn, bool &IsIPv4In)
+{
+    if(HostIn.isNull() || !BytesIn) return (false);
+
+    bool Ok = false;
+    quint32 IPv4 = HostIn.toIPv4Address(&Ok);
+
+    IsIPv4In = Ok;
+
+    if(Ok)
+    {
+        //IPv4 or IPv4-mapped IPv6 (::ffff:a.b.c.d)
+        for(int i=0; i<10; i++) BytesIn[i] = 0;
+        BytesIn[10] = 0xFF;
+        BytesIn[11] = 0xFF;
+        BytesIn[12] = static_cast<quint8>((IPv4>>24) & 0xFF);
+        BytesIn[13] = static_cast<quint8>((IPv4>>16) & 0xFF);
+        BytesIn[14] = static_cast<quint8>((IPv4>>8) & 0xFF);
+        BytesIn[15] = static_cast<quint8>(IPv4 & 0xFF);
+    }
+    else
+    {
+        Q_IPV6ADDR IPv6 = HostIn.toIPv6Address();
+        for(int i=0; i<16; i++) BytesIn[i] = IPv6[i];
+    }
+
+    return (true);
+}
+
+
+/**
+@brief  Parse address or subnet.
+@param  SubnetIn - address or subnet ("192.168.1.7", "192.168.1.0/24", "2001:db8::/32");
+@param  HostIn - link to address;
+@param  PrefixIn - link to the length of prefix (-1 - full address).
+@return True if parsed, otherwise - False.
+*/
+bool IpTrie::parse(const QString &SubnetIn, QHostAddress &HostIn, int &PrefixIn)
+{
+    QString Subnet = SubnetIn.trimmed();
+
+    if(Subnet.contains('/'))
+    {
+        QPair<QHostAddress, int> Pair = QHostAddress::parseSubnet(Subnet);
+        if(Pair.first.isNull()) return (false);
+
+        HostIn   = Pair.first;
+        PrefixIn = Pair.second;
+    }
+    else
+    {
+        if(!HostIn.setAddress(Subnet)) return (false);
+        PrefixIn = -1;
+    }
+
+    return (true);
+}
+
+
+/**
+@brief  Add a rule.
+@param  SubnetIn - address or subnet ("192.168.1.7", "192.168.1.0/24", "2001:db8::/32");
+@param  ValueIn - value of the rule;
+@param  PortIn - port of the rule (0 - all ports).
+@return True if the rule is added, otherwise - False.
+@detailed The rule with the same prefix and port is replaced.
+*/
+bool IpTrie::add(const QString &SubnetIn, quint8 ValueIn, quint16 PortIn)
+{
+    QHostAddress Host;
+    int Prefix;
+
+    if(IpTrie::parse(SubnetIn, Host, Prefix))
+    {
+        return (this->add(Host, Prefix, ValueIn, PortIn));
+    }
+
+    return (false);
+}
+
+
+/**
+@brief  Add a rule.
+@param  HostIn - address;
+@param  PrefixIn - the length of prefix (-1 - full address);
+@param  ValueIn - value of the rule;
+@param  PortIn - port of the rule (0 - all ports).
+@return True if the rule is added, otherwise - False.
+@detailed The rule is rejected if the prefix of IPv4-address is over /32 (over /128 for IPv6).
+*/
+bool IpTrie::add(const QHostAddress &HostIn, int PrefixIn, quint8 ValueIn, quint16 PortIn)
+{
+    quint8 Bytes[16];
+    bool IsIPv4;
+
+    if(!IpTrie::toBytes(HostIn, Bytes, IsIPv4)) return (false);
+
+    //length of prefix in 128 bits (prefix of IPv4-mapped IPv6 "::ffff:a.b.c.d/n" is already in 128 bits)
+    int Len = ((PrefixIn < 0) ? BITS : ((IsIPv4 && HostIn.protocol() != QAbstractSocket::IPv6Protocol) ? (96+PrefixIn) : PrefixIn));
+
+    //malformed prefix is rejected (not clamped to the full address): the caller logs the rule
+    if(Len > BITS || (IsIPv4 && Len < 96)) return (false);
+
+    IpTrieNode *Node = mRoot;
+    int Bit;
+
+    for(int i=0; i<Len; i++)
+    {
+        Bit = ((Bytes[i>>3]>>(7-(i & 7))) & 1);
+        if(!Node->mChild[Bit]) Node->mChild[Bit] = new IpTrieNode();
+        Node = Node->mChild[Bit];
+    }
+
+    if(!Node->mRules.contains(PortIn)) mSize++;
+
+    Node->mRules.insert(PortIn, ValueIn);
+
+    return (true);
+}
+
+
+/**
+@brief  Find the longest matched rule.
+@param  HostIn - address;
+@param  PortIn - port (rules with other port than 0 or PortIn are skipped);
+@param  ValueIn - link to value of the rule.
+@return True if a rule is found, otherwise - False.
+@detailed The rule of PortIn is preferred to the rule of all ports with the same prefix.
+*/
+bool IpTrie::find(const QHostAddress &HostIn, quint16 PortIn, quint8 &ValueIn)
+{
+    quint8 Bytes[16];
+    bool IsIPv4;
+
+    if(mSize == 0 || !IpTrie::toBytes(HostIn, Bytes, IsIPv4)) return (false);
+
+    IpTrieNode *Node = mRoot;
+    bool Res = false;
+    int Bit;
+
+    for(int i=0; Node; i++)
+    {
+        if(!Node->mRules.isEmpty())
+        {
+            QMap<quint16, quint8>::const_iterator It = Node->mRules.constFind(PortIn);
+            if(It == Node->mRules.constEnd()) It = Node->mRules.constFind(0);
+
+            if(It != Node->mRules.constEnd())
+            {
+                ValueIn = It.value();
+                Res     = true;
+            }
+        }
+
+        if(i >= BITS) break;
+
+        Bit  = ((Bytes[i>>3]>>(7-(i & 7))) & 1);
+        Node = Node->mChild[Bit];
+    }
+
+    return (Res);
+}
+
+
+/**
+@brief  Clear the trie.
+@param  None.
+@return None.
+*/
+void IpTrie::clear()
+{
+    delete mRoot;
+    mRoot = new IpTrieNode();
+    mSize = 0;
+}
+
+
+/**
+@brief  Get the number of rules.
+@param  None.
+@return The number of rules.
+*/
+quint32 IpTrie::size()
+{
+    return (mSize);
+}
@@ -0,0 +1,186 @@
+/* Copyright (C) 2019 ATgroup09
+*  Contact: atgroup09@gmail.com
+*
+*  This file is part of the HMI server component.
+*
+*  The code in this page is free software: you can
+*  redistribute it and/or modify it under the terms of the GNU
+*  General Public License (GNU GPL) as published by the Free Software
+*  Foundation, either version 3 of the License, or (at your option)
+*  any later version.  The code is distributed WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS
+*  FOR A PARTICULAR PURPOSE.  See the GNU GPL for more details.
+*
+*  As additional permission under GNU GPL version 3 section 7, you
+*  may distribute non-source (e.g., minimized or compacted) forms of
+*  that code without the copy of the GNU GPL normally required by
+*  section 4, provided you include this license notice and a URL
+*  through which recipients can access the Corresponding Source.
+*/
+
+#ifndef IP_TRIE_H
+#define IP_TRIE_H
+
+#include <QObject>
+#include <QString>
+#include <QHostAddress>
+#include <QPair>
+#include <QMap>
+
+
+/**
+@brief Node of IP-trie.
+*/
+class IpTrieNode
+{
+public:
+
+    IpTrieNode();
+    ~IpTrieNode();
+
+    /**
+    @brief Children (bit 0, bit 1).
+    */
+    IpTrieNode *mChild[2];
+
+    /**
+    @brief Rules of the prefix (port => value, port 0 - all ports).
+    @detailed Empty if the node is not a prefix of a rule.
+    */
+    QMap<quint16, quint8> mRules;
+};
+
+
+/**
+@brief    Binary prefix trie of IP-addresses (IPv4 and IPv6).
+@detailed IPv4 is stored as IPv4-mapped IPv6 (::ffff:a.b.c.d), so one trie is used for both.
+          Lookup returns the value of the longest matched prefix.
+*/
+class IpTrie : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /**
+    @brief  Constructor.
+    @param  None.
+    @return None.
+    */
+    explicit IpTrie(QObject *parent = nullptr);
+
+    /**
+    @brief  Destructor.
+    @param  None.
+    @return None.
+    */
+    virtual ~IpTrie();
+
+
+    /**
+    Public constants
+    */
+
+    /**
+    @brief The number of bits of address.
+    */
+    static const int BITS = 128;
+
+    /**
+    @brief Values of rules of black-list
+    */
+    static const quint8 DENY  = 0;
+    static const quint8 ALLOW = 1;
+
+
+    /**
+    Public methods
+    */
+
+    /**
+    @brief  Add a rule.
+    @param  SubnetIn - address or subnet ("192.168.1.7", "192.168.1.0/24", "2001:db8::/32");
+    @param  ValueIn - value of the rule;
+    @param  PortIn - port of the rule (0 - all ports).
+    @return True if the rule is added, otherwise - False.
+    @detailed The rule with the same prefix and port is replaced.
+    */
+    bool add(const QString &SubnetIn, quint8 ValueIn, quint16 PortIn);
+
+    /**
+    @brief  Add a rule.
+    @param  HostIn - address;
+    @param  PrefixIn - the length of prefix (-1 - full address);
+    @param  ValueIn - value of the rule;
+    @param  PortIn - port of the rule (0 - all ports).
+    @return True if the rule is added, otherwise - False.
+    @detailed The rule is rejected if the prefix of IPv4-address is over /32 (over /128 for IPv6).
+    */
+    bool add(const QHostAddress &HostIn, int PrefixIn, quint8 ValueIn, quint16 PortIn);
+
+    /**
+    @brief  Find the longest matched rule.
+    @param  HostIn - address;
+    @param  PortIn - port (rules with other port than 0 or PortIn are skipped);
+    @param  ValueIn - link to value of the rule.
+    @return True if a rule is found, otherwise - False.
+    @detailed The rule of PortIn is preferred to the rule of all ports with the same prefix.
+    */
+    bool find(const QHostAddress &HostIn, quint16 PortIn, quint8 &ValueIn);
+
+    /**
+    @brief  Clear the trie.
+    @param  None.
+    @return None.
+    */
+    void clear();
+
+    /**
+    @brief  Get the number of rules.
+    @param  None.
+    @return The number of rules.
+    */
+    quint32 size();
+
+    /**
+    @brief  Parse address or subnet.
+    @param  SubnetIn - address or subnet ("192.168.1.7", "192.168.1.0/24", "2001:db8::/32");
+    @param  HostIn - link to address;
+    @param  PrefixIn - link to the length of prefix (-1 - full address).
+    @return True if parsed, otherwise - False.
+    */
+    static bool parse(const QString &SubnetIn, QHostAddress &HostIn, int &PrefixIn);
+
+
+private:
+
+    /**
+    Private options
+    */
+
+    /**
+    @brief Root node.
+    */
+    IpTrieNode *mRoot;
+
+    /**
+    @brief The number of rules.
+    */
+    quint32 mSize;
+
+
+    /**
+    Private methods
+    */
+
+    /**
+    @brief  Convert address to 128 bits (IPv4 as IPv4-mapped IPv6).
+    @param  HostIn - address;
+    @param  BytesIn - pointer to array of 16 bytes;
+    @param  IsIPv4In - link to sign of IPv4-address.
+    @return True if converted, otherwise - False.
+    */
+    static bool toBytes(const QHostAddress &HostIn, quint8 *BytesIn, bool &IsIPv4In);
+};
+
+#endif // IP_TRIE_H
@@ -0,0 +1,525 @@
+/* Copyright (C) 2019 ATgroup09
+*  Contact: atgroup09@gmail.com
+*
+*  Log functions.
+*
+*  The code in this page is free software: you can
+*  redistribute it and/or modify it under the terms of the GNU
+*  General Public License (GNU GPL) as published by the Free Software
+*  Foundation, either version 3 of the License, or (at your option)
+*  any later version.  The code is distributed WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS
+*  FOR A PARTICULAR PURPOSE.  See the GNU GPL for more details.
+*
+*  As additional permission under GNU GPL version 3 section 7, you
+*  may distribute non-source (e.g., minimized or compacted) forms of
+*  that code without the copy of the GNU GPL normally required by
+*  section 4, provided you include this license notice and a URL
+*  through which recipients can access the Corresponding Source.
+*/
+
+#include "log-writer.h"
+
+
+/**
+@brief  Constructor.
+@param  SizeIn - the number of slots (rounded up to power of 2).
+@return None.
+*/
+LogRing::LogRing(quint32 SizeIn)
+{
+    quint32 Size = SIZE_MIN;
+
+    while(Size < SizeIn && Size < SIZE_MAX) Size<<= 1;
+
+    mSlots  = new LogRingSlot[Size];
+    mMask   = Size-1;
+    mDeqPos = 0;
+    mEnqPos.storeRelease(0);
+
+    for(quint32 i=0; i<Size; i++) mSlots[i].mSeq.storeRelease(i);
+}
+
+
+/**
+@brief  Destructor.
+@param  None.
+@return None.
+*/
+LogRing::~LogRing()
+{
+    delete [] mSlots;
+}
+
+
+/**
+@brief  Put message into the buffer.
+@param  FileIn - path to Log-file;
+@param  DataIn - Log-message.
+@return True if the message is put, otherwise (the buffer is full) - False.
+@detailed Is called by producers (thread-safe).
+*/
+bool LogRing::push(const QString &FileIn, const QByteArray &DataIn)
+{
+    quint32 Pos = mEnqPos.loadAcquire();
+    LogRingSlot *Slot;
+    qint32 Diff;
+
+    for(;;)
+    {
+        Slot = &mSlots[Pos & mMask];
+        Diff = static_cast<qint32>(Slot->mSeq.loadAcquire() - Pos);
+
+        if(Diff == 0)
+        {
+            //the slot is free: try to own it
+            if(mEnqPos.testAndSetOrdered(Pos, Pos+1)) break;
+            Pos = mEnqPos.loadAcquire();
+        }
+        else if(Diff < 0)
+        {
+            //the slot is not taken by consumer yet: the buffer is full
+            return (false);
+        }
+        else
+        {
+            //the slot is owned by other producer
+            Pos = mEnqPos.loadAcquire();
+        }
+    }
+
+    Slot->mFile = FileIn;
+    Slot->mData = DataIn;
+    Slot->mSeq.storeRelease(Pos+1);
+
+    return (true);
+}
+
+
+/**
+@brief  Take message from the buffer.
+@param  FileIn - link to path to Log-file;
+@param  DataIn - link to Log-message.
+@return True if the message is taken, otherwise (the buffer is empty) - False.
+@detailed Is called by consumer only (one thread).
+*/
+bool LogRing::pop(QString &FileIn, QByteArray &DataIn)
+{
+    LogRingSlot *Slot = &mSlots[mDeqPos & mMask];
+    qint32 Diff = static_cast<qint32>(Slot->mSeq.loadAcquire() - (mDeqPos+1));
+
+    if(Diff < 0) return (false);
+
+    FileIn = Slot->mFile;
+    DataIn = Slot->mData;
+    Slot->mFile.clear();
+    Slot->mData.clear();
+
+    //the slot is free for producer of next round
+    Slot->mSeq.storeRelease(mDeqPos+mMask+1);
+    mDeqPos++;
+
+    return (true);
+}
+
+
+/**
+@brief  Get the number of slots.
+@param  None.
+@return The number of slots.
+*/
+quint32 LogRing::size()
+{
+    return (mMask+1);
+}
+
+
+/**
+@brief  Constructor.
+@param  SegmentIn - path to rotated segment;
+@param  FileIn - path to Log-file;
+@param  KeepIn - the number of kept segments;
+@param  GzipIn - compress the segment.
+@return None.
+*/
+LogRotateTask::LogRotateTask(const QString &SegmentIn, const QString &FileIn, quint16 KeepIn, bool GzipIn)
+{
+    mSegment = SegmentIn;
+    mFile    = FileIn;
+    mKeep    = KeepIn;
+    mGzip    = GzipIn;
+}
+
+
+/**
+@brief  Run the task.
+@param  None.
+@return None.
+*/
+void LogRotateTask::run()
+{
+    //compress
+    if(mGzip)
+    {
+        QFile Segment(mSegment);
+
+        if(Segment.open(QIODevice::ReadOnly))
+        {
+            QByteArray Data = Segment.readAll();
+            QByteArray Packed;
+            Segment.close();
+
+            if(LogRotateTask::gzip(Data, Packed))
+            {
+                QFile Gz(mSegment+QString(".gz"));
+
+                if(Gz.open(QIODevice::WriteOnly|QIODevice::Truncate))
+                {
+                    bool Ok = ((Gz.write(Packed) == Packed.size()) ? true : false);
+                    Gz.close();
+
+                    if(Ok) Segment.remove();
+                    else   Gz.remove();
+                }
+            }
+        }
+    }
+
+    //remove the oldest segments: "{File}.yyyyMMdd-hhmmss[-N][.gz]" are sorted by stamp and N
+    //(by name "-N" is sorted before ".gz"), other files are skipped
+    QFileInfo Info(mFile);
+    QDir Dir = Info.absoluteDir();
+    QStringList Names = Dir.entryList(QStringList() << (Info.fileName()+QString(".*")), QDir::Files, QDir::Name);
+    QRegularExpression Re(QString("^%1\\.(\\d{8}-\\d{6})(?:-(\\d+))?(?:\\.gz)?$").arg(QRegularExpression::escape(Info.fileName())));
+    QRegularExpressionMatch Match;
+    QMap<QString, QString> Segments;
+
+    for(int i=0; i<Names.size(); i++)
+    {
+        Match = Re.match(Names.at(i));
+        if(!Match.hasMatch()) continue;
+
+        Segments.insert(QString("%1-%2").arg(Match.captured(1), Match.captured(2).rightJustified(10, QChar('0'))), Names.at(i));
+    }
+
+    QMap<QString, QString>::const_iterator It = Segments.constBegin();
+
+    for(int i=0; i<(Segments.size()-static_cast<int>(mKeep)); i++, ++It)
+    {
+        Dir.remove(It.value());
+    }
+}
+
+
+/**
+@brief  Pack data into gzip-format.
+@param  DataIn - data;
+@param  OutIn - link to packed data.
+@return True if packed, otherwise - False.
+@detailed qCompress() returns [4 bytes of size][2 bytes of zlib-header][deflate][4 bytes of adler32],
+          deflate-block is wrapped by gzip-header and trailer (CRC-32, size).
+*/
+bool LogRotateTask::gzip(const QByteArray &DataIn, QByteArray &OutIn)
+{
+    QByteArray Z = qCompress(DataIn, 9);
+
+    if(Z.size() < 10) return (false);
+
+    quint32 Crc  = crc32(DataIn);
+    quint32 Size = static_cast<quint32>(DataIn.size());
+    int i;
+
+    OutIn.clear();
+    OutIn.reserve(Z.size()+12);
+
+    //header: ID1 ID2 CM FLG MTIME(4) XFL OS
+    const char Header[10] = { '\x1f', '\x8b', '\x08', 0, 0, 0, 0, 0, 0, '\xff' };
+    OutIn.append(Header, 10);
+
+    OutIn.append(Z.constData()+6, Z.size()-10);
+
+    for(i=0; i<4; i++) OutIn.append(static_cast<char>((Crc>>(8*i)) & 0xFF));
+    for(i=0; i<4; i++) OutIn.append(static_cast<char>((Size>>(8*i)) & 0xFF));
+
+    return (true);
+}
+
+
+/**
+@brief  Rename Log-file to a new segment.
+@param  FileIn - path to Log-file;
+@param  SegmentIn - link to path to the segment.
+@return True if renamed, otherwise - False.
+@detailed The name of segment is "{FileIn}.yyyyMMdd-hhmmss[-N]".
+*/
+bool LogRotateTask::toSegment(const QString &FileIn, QString &SegmentIn)
+{
+    QString Segment = FileIn+QString(".")+QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss");
+    SegmentIn = Segment;
+
+    for(int i=1; QFile::exists(SegmentIn) || QFile::exists(SegmentIn+QString(".gz")); i++)
+    {
+        SegmentIn = Segment+QString("-%1").arg(QString::number(i));
+    }
+
+    return (QFile::rename(FileIn, SegmentIn));
+}
+
+
+/**
+@brief  Constructor.
+@param  RingIn - pointer to ring buffer;
+@param  FlushIn - flush interval (msec).
+@return None.
+*/
+LogWriter::LogWriter(LogRing *RingIn, int FlushIn, QObject *parent) : QObject(parent)
+{
+    mRing  = RingIn;
+    mFlush = FlushIn;
+    mTimer = new QTimer(this);
+    mDropped.storeRelease(0);
+    mWaked.storeRelease(0);
+
+    mToday   = QDate::currentDate();
+    mMaxSize = 0;
+    mDaily   = false;
+    mKeep    = 0;
+    mGzip    = false;
+    mPool    = new QThreadPool();
+    mPool->setMaxThreadCount(1);
+
+    connect(mTimer, &QTimer::timeout, this, &LogWriter::flush);
+}
+
+
+/**
+@brief  Destructor.
+@param  None.
+@return None.
+*/
+LogWriter::~LogWriter()
+{
+    this->closeFiles();
+    delete mTimer;
+
+    mPool->waitForDone();
+    delete mPool;
+}
+
+
+/**
+@brief  Get the number of dropped messages and reset it.
+@param  None.
+@return The number of dropped messages.
+*/
+quint32 LogWriter::takeDropped()
+{
+    return (mDropped.fetchAndStoreOrdered(0));
+}
+
+
+/**
+@brief  Increase the number of dropped messages.
+@param  None.
+@return None.
+@detailed Is called by producers (thread-safe).
+*/
+void LogWriter::drop()
+{
+    mDropped.fetchAndAddOrdered(1);
+}
+
+
+/**
+@brief  Wake the writer (flush before timer).
+@param  None.
+@return None.
+@detailed Is called by producers (thread-safe); the writer is waked once until next flush.
+*/
+void LogWriter::wake()
+{
+    if(mWaked.testAndSetOrdered(0, 1))
+    {
+        QMetaObject::invokeMethod(this, "flush", Qt::QueuedConnection);
+    }
+}
+
+
+/**
+@brief  Set rotation.
+@param  MaxSizeIn - max. size of Log-file (bytes, 0 - is not used);
+@param  DailyIn - rotate every day;
+@param  KeepIn - the number of kept segments;
+@param  GzipIn - compress segments.
+@return None.
+@detailed Is called before start.
+*/
+void LogWriter::setRotation(qint64 MaxSizeIn, bool DailyIn, quint16 KeepIn, bool GzipIn)
+{
+    mMaxSize = MaxSizeIn;
+    mDaily   = DailyIn;
+    mKeep    = KeepIn;
+    mGzip    = GzipIn;
+}
+
+
+/**
+@brief  Start.
+@param  None.
+@return None.
+*/
+void LogWriter::start()
+{
+    mTimer->setInterval(mFlush);
+    mTimer->setSingleShot(false);
+    mTimer->start();
+}
+
+
+/**
+@brief  Stop.
+@param  None.
+@return None.
+@details Write all messages, close files and stop timer.
+*/
+void LogWriter::stop()
+{
+    if(mTimer->isActive()) mTimer->stop();
+
+    this->flush();
+    this->closeFiles();
+
+    mPool->waitForDone();
+}
+
+
+/**
+@brief  Write all messages from ring buffer.
+@param  None.
+@return None.
+*/
+void LogWriter::flush()
+{
+    mWaked.storeRelease(0);
+    mToday = QDate::currentDate();
+
+    QString File;
+    QByteArray Data;
+    bool Cout = false;
+
+    while(mRing->pop(File, Data))
+    {
+        this->write(File, Data);
+        if(File.isEmpty()) Cout = true;
+    }
+
+    quint32 Dropped = this->takeDropped();
+
+    if(Dropped)
+    {
+        QByteArray Msg = QString("LogWriter: %1 messages dropped (buffer is full)\r\n\r\n").arg(QString::number(Dropped)).toUtf8();
+        QList<QString> Keys = mFiles.keys();
+
+        for(int i=0; i<Keys.size(); i++) this->write(Keys.at(i), Msg);
+        if(Keys.isEmpty()) this->write(QString(), Msg);
+    }
+
+    QHash<QString, QFile *>::iterator It;
+    for(It = mFiles.begin(); It != mFiles.end(); ++It) It.value()->flush();
+
+    if(Cout) std::cout.flush();
+}
+
+
+/**
+@brief  Write message.
+@param  FileIn - path to Log-file (empty - std::cout);
+@param  DataIn - Log-message.
+@return None.
+*/
+void LogWriter::write(const QString &FileIn, const QByteArray &DataIn)
+{
+    if(FileIn.isEmpty())
+    {
+        std::cout << DataIn.constData();
+        return;
+    }
+
+    QFile *File = mFiles.value(FileIn, nullptr);
+
+    if(File)
+    {
+        bool BySize = ((mMaxSize > 0 && File->pos() > 0 && (File->pos()+DataIn.size()) > mMaxSize) ? true : false);
+        bool ByDay  = ((mDaily && mFileDays.value(FileIn) != mToday) ? true : false);
+
+        if(BySize || ByDay)
+        {
+            this->rotate(FileIn);
+            File = nullptr;
+        }
+    }
+
+    if(!File)
+    {
+        File = new QFile(FileIn);
+
+        if(!File->open(QIODevice::WriteOnly|QIODevice::Text|QIODevice::Append))
+        {
+            delete File;
+            return;
+        }
+
+        mFiles.insert(FileIn, File);
+        mFileDays.insert(FileIn, QFileInfo(FileIn).lastModified().date());
+        if(File->pos() == 0) mFileDays.insert(FileIn, mToday);
+    }
+
+    File->write(DataIn);
+}
+
+
+/**
+@brief  Rotate Log-file.
+@param  FileIn - path to Log-file.
+@return None.
+@detailed The file is closed, renamed and passed to LogRotateTask; it is reopened by next write.
+*/
+void LogWriter::rotate(const QString &FileIn)
+{
+    QFile *File = mFiles.take(FileIn);
+
+    if(File)
+    {
+        File->close();
+        delete File;
+    }
+
+    mFileDays.remove(FileIn);
+
+    QString Name;
+
+    if(LogRotateTask::toSegment(FileIn, Name))
+    {
+        mPool->start(new LogRotateTask(Name, FileIn, mKeep, mGzip));
+    }
+}
+
+
+/**
+@brief  Close all Log-files.
+@param  None.
+@return None.
+*/
+void LogWriter::closeFiles()
+{
+    QHash<QString, QFile *>::iterator It;
+
+    for(It = mFiles.begin(); It != mFiles.end(); ++It)
+    {
+        It.value()->close();
+        delete It.value();
+    }
+
+    mFiles.clear();
+    mFileDays.clear();
+}
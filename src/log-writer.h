@@ -0,0 +1,434 @@
+/* Copyright (C) 2019 ATgroup09
+*  Contact: atgroup09@gmail.com
+*
+*  Log functions.
+*
+*  The code in this page is free software: you can
+*  redistribute it and/or modify it under the terms of the GNU
+*  General Public License (GNU GPL) as published by the Free Software
+*  Foundation, either version 3 of the License, or (at your option)
+*  any later version.  The code is distributed WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS
+*  FOR A PARTICULAR PURPOSE.  See the GNU GPL for more details.
+*
+*  As additional permission under GNU GPL version 3 section 7, you
+*  may distribute non-source (e.g., minimized or compacted) forms of
+*  that code without the copy of the GNU GPL normally required by
+*  section 4, provided you include this license notice and a URL
+*  through which recipients can access the Corresponding Source.
+*/
+
+#ifndef LOG_WRITER_H
+#define LOG_WRITER_H
+
+#include <iostream>
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <QHash>
+#include <QMap>
+#include <QRegularExpression>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDate>
+#include <QDateTime>
+#include <QTimer>
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QAtomicInteger>
+
+#include "bit.h"
+
+
+/**
+@brief      Slot of ring buffer of Log-messages.
+*/
+class LogRingSlot
+{
+public:
+
+    /**
+    @brief Sequence number (see LogRing).
+    */
+    QAtomicInteger<quint32> mSeq;
+
+    /**
+    @brief Path to Log-file (empty - std::cout).
+    */
+    QString mFile;
+
+    /**
+    @brief Log-message (UTF-8).
+    */
+    QByteArray mData;
+};
+
+
+/**
+@brief      Ring buffer of Log-messages.
+@detailed   Bounded lock-free queue: many producers (any thread calls Log::log), one consumer (LogWriter).
+            Every slot has a sequence number:
+              Seq == Pos     - the slot is free for producer of position Pos;
+              Seq == Pos + 1 - the slot is filled, consumer can take it.
+*/
+class LogRing
+{
+public:
+
+    /**
+    @brief  Constructor.
+    @param  SizeIn - the number of slots (rounded up to power of 2).
+    @return None.
+    */
+    explicit LogRing(quint32 SizeIn);
+
+    /**
+    @brief  Destructor.
+    @param  None.
+    @return None.
+    */
+    ~LogRing();
+
+
+    /**
+    Public constants
+    */
+
+    /**
+    @brief Limites of size
+    */
+    static const quint32 SIZE_MIN = 64;
+    static const quint32 SIZE_MAX = 1048576;
+
+
+    /**
+    Public methods
+    */
+
+    /**
+    @brief  Put message into the buffer.
+    @param  FileIn - path to Log-file;
+    @param  DataIn - Log-message.
+    @return True if the message is put, otherwise (the buffer is full) - False.
+    @detailed Is called by producers (thread-safe).
+    */
+    bool push(const QString &FileIn, const QByteArray &DataIn);
+
+    /**
+    @brief  Take message from the buffer.
+    @param  FileIn - link to path to Log-file;
+    @param  DataIn - link to Log-message.
+    @return True if the message is taken, otherwise (the buffer is empty) - False.
+    @detailed Is called by consumer only (one thread).
+    */
+    bool pop(QString &FileIn, QByteArray &DataIn);
+
+    /**
+    @brief  Get the number of slots.
+    @param  None.
+    @return The number of slots.
+    */
+    quint32 size();
+
+
+private:
+
+    /**
+    Private options
+    */
+
+    /**
+    @brief Slots.
+    */
+    LogRingSlot *mSlots;
+
+    /**
+    @brief Mask of index (size - 1).
+    */
+    quint32 mMask;
+
+    /**
+    @brief Position of producers.
+    */
+    QAtomicInteger<quint32> mEnqPos;
+
+    /**
+    @brief Position of consumer.
+    */
+    quint32 mDeqPos;
+};
+
+
+/**
+@brief      Task of rotation of Log-file.
+@detailed   Is run in thread pool of LogWriter: compresses a rotated segment (gzip)
+            and removes the oldest segments.
+*/
+class LogRotateTask : public QRunnable
+{
+public:
+
+    /**
+    @brief  Constructor.
+    @param  SegmentIn - path to rotated segment;
+    @param  FileIn - path to Log-file;
+    @param  KeepIn - the number of kept segments;
+    @param  GzipIn - compress the segment.
+    @return None.
+    */
+    LogRotateTask(const QString &SegmentIn, const QString &FileIn, quint16 KeepIn, bool GzipIn);
+
+
+    /**
+    Public methods
+    */
+
+    /**
+    @brief  Run the task.
+    @param  None.
+    @return None.
+    */
+    void run();
+
+    /**
+    @brief  Pack data into gzip-format.
+    @param  DataIn - data;
+    @param  OutIn - link to packed data.
+    @return True if packed, otherwise - False.
+    */
+    static bool gzip(const QByteArray &DataIn, QByteArray &OutIn);
+
+    /**
+    @brief  Rename Log-file to a new segment.
+    @param  FileIn - path to Log-file;
+    @param  SegmentIn - link to path to the segment.
+    @return True if renamed, otherwise - False.
+    @detailed The name of segment is "{FileIn}.yyyyMMdd-hhmmss[-N]".
+    */
+    static bool toSegment(const QString &FileIn, QString &SegmentIn);
+
+
+private:
+
+    /**
+    Private options
+    */
+
+    /**
+    @brief Path to rotated segment.
+    */
+    QString mSegment;
+
+    /**
+    @brief Path to Log-file.
+    */
+    QString mFile;
+
+    /**
+    @brief The number of kept segments.
+    */
+    quint16 mKeep;
+
+    /**
+    @brief Compress the segment.
+    */
+    bool mGzip;
+};
+
+
+/**
+@brief      Writer of Log-messages.
+@detailed   Works in own thread: takes messages from ring buffer by timer and writes them in batch.
+            Log-files are kept opened.
+            Log-file is rotated by size and/or day: it is renamed to "File.yyyyMMdd-hhmmss",
+            the segment is compressed and the oldest segments are removed by LogRotateTask.
+*/
+class LogWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    /**
+    @brief  Constructor.
+    @param  RingIn - pointer to ring buffer;
+    @param  FlushIn - flush interval (msec).
+    @return None.
+    */
+    explicit LogWriter(LogRing *RingIn, int FlushIn, QObject *parent = nullptr);
+
+    /**
+    @brief  Destructor.
+    @param  None.
+    @return None.
+    */
+    virtual ~LogWriter();
+
+
+    /**
+    Public methods
+    */
+
+    /**
+    @brief  Get the number of dropped messages and reset it.
+    @param  None.
+    @return The number of dropped messages.
+    */
+    quint32 takeDropped();
+
+    /**
+    @brief  Increase the number of dropped messages.
+    @param  None.
+    @return None.
+    @detailed Is called by producers (thread-safe).
+    */
+    void drop();
+
+    /**
+    @brief  Wake the writer (flush before timer).
+    @param  None.
+    @return None.
+    @detailed Is called by producers (thread-safe); the writer is waked once until next flush.
+    */
+    void wake();
+
+    /**
+    @brief  Set rotation.
+    @param  MaxSizeIn - max. size of Log-file (bytes, 0 - is not used);
+    @param  DailyIn - rotate every day;
+    @param  KeepIn - the number of kept segments;
+    @param  GzipIn - compress segments.
+    @return None.
+    @detailed Is called before start.
+    */
+    void setRotation(qint64 MaxSizeIn, bool DailyIn, quint16 KeepIn, bool GzipIn);
+
+
+public slots:
+
+    /**
+    @brief  Start.
+    @param  None.
+    @return None.
+    */
+    void start();
+
+    /**
+    @brief  Stop.
+    @param  None.
+    @return None.
+    @details Write all messages, close files and stop timer.
+    */
+    void stop();
+
+    /**
+    @brief  Write all messages from ring buffer.
+    @param  None.
+    @return None.
+    */
+    void flush();
+
+
+private:
+
+    /**
+    Private options
+    */
+
+    /**
+    @brief Pointer to ring buffer.
+    */
+    LogRing *mRing;
+
+    /**
+    @brief Flush timer.
+    */
+    QTimer *mTimer;
+
+    /**
+    @brief Flush interval (msec).
+    */
+    int mFlush;
+
+    /**
+    @brief Opened Log-files.
+    */
+    QHash<QString, QFile *> mFiles;
+
+    /**
+    @brief Dates of opening of Log-files.
+    */
+    QHash<QString, QDate> mFileDays;
+
+    /**
+    @brief Current date (is refreshed by flush).
+    */
+    QDate mToday;
+
+    /**
+    @brief Rotation :: Max. size of Log-file (bytes, 0 - is not used).
+    */
+    qint64 mMaxSize;
+
+    /**
+    @brief Rotation :: Rotate every day.
+    */
+    bool mDaily;
+
+    /**
+    @brief Rotation :: The number of kept segments.
+    */
+    quint16 mKeep;
+
+    /**
+    @brief Rotation :: Compress segments.
+    */
+    bool mGzip;
+
+    /**
+    @brief Pool of rotation tasks (one thread).
+    */
+    QThreadPool *mPool;
+
+    /**
+    @brief The number of dropped messages.
+    */
+    QAtomicInteger<quint32> mDropped;
+
+    /**
+    @brief Sign of wake request.
+    */
+    QAtomicInteger<quint32> mWaked;
+
+
+    /**
+    Private methods
+    */
+
+    /**
+    @brief  Write message.
+    @param  FileIn - path to Log-file (empty - std::cout);
+    @param  DataIn - Log-message.
+    @return None.
+    */
+    void write(const QString &FileIn, const QByteArray &DataIn);
+
+    /**
+    @brief  Rotate Log-file.
+    @param  FileIn - path to Log-file.
+    @return None.
+    @detailed The file is closed, renamed and passed to LogRotateTask; it is reopened by next write.
+    */
+    void rotate(const QString &FileIn);
+
+    /**
+    @brief  Close all Log-files.
+    @param  None.
+    @return None.
+    */
+    void closeFiles();
+};
+
+#endif // LOG_WRITER_H
@@ -20,6 +20,39 @@
 
 #include "log.h"
 
+#ifdef Q_OS_UNIX
+#include <csignal>
+#endif
+
+
+/**
+@brief      Levels
+*/
+const QString Log::LEVEL__ERROR_STR = "error";
+const QString Log::LEVEL__WARN_STR  = "warn";
+const QString Log::LEVEL__INFO_STR  = "info";
+const QString Log::LEVEL__DEBUG_STR = "debug";
+const QString Log::LEVEL__TRACE_STR = "trace";
+
+
+/**
+@brief      Options of the writer.
+*/
+LogRing *Log::mRing = nullptr;
+QAtomicPointer<LogWriter> Log::mWriter;
+QAtomicInt Log::mUsers(0);
+QThread *Log::mThread = nullptr;
+bool Log::mBlock = false;
+QAtomicInt Log::mLevel(Log::LEVEL__INFO);
+qint64 Log::mRotSize = 0;
+bool Log::mRotDaily = false;
+quint16 Log::mRotKeep = 0;
+bool Log::mRotGzip = false;
+QMutex Log::mWriteMutex;
+QHash<QString, qint64> Log::mWriteSizes;
+QHash<QString, QDate> Log::mWriteDays;
+QThreadPool *Log::mRotPool = nullptr;
+
 
 /**
 @brief      Constructor.
@@ -52,46 +85,165 @@ Log::~Log()
             EndLrIn - on/off \r\n in end.
 @return     None.
 @detailed   If LogFile_in is NULL or Empty, then used std::cout.
+            The message has level LEVEL__INFO.
 */
 void Log::log(const QString &LogMessage_in, const QString &LogFile_in, bool LogUse_in = false, bool StampUseIn = true, bool EndLrIn = true)
 {
-    if(LogUse_in)
+    if(LogUse_in && Log::isLevel(LEVEL__INFO))
     {
-        QString Buff;
+        Log::logAt(LEVEL__INFO, LogMessage_in, LogFile_in, StampUseIn, EndLrIn);
+    }
+}
 
-        if(StampUseIn)
-        {
-            Buff.append((QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss")));
-            Buff.append("\r\n");
-        }
 
-        if(!LogMessage_in.isEmpty())
-        {
-            Buff.append(LogMessage_in);
-            Buff.append("\r\n");
-        }
+/**
+@brief      Log with level (without check of level, see LOG_AT).
+@param      LevelIn - level;
+            LogMessage_in - Log-message;
+            LogFile_in - path to Log-file;
+            StampIn - on/off TimeStamp;
+            EndLrIn - on/off \r\n in end.
+@return     None.
+@detailed   If LogFile_in is NULL or Empty, then used std::cout.
+*/
+void Log::logAt(quint8 LevelIn, const QString &LogMessage_in, const QString &LogFile_in, bool StampUseIn, bool EndLrIn)
+{
+    QString Buff;
+
+    if(StampUseIn)
+    {
+        Buff.append((QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss")));
+        if(LevelIn != LEVEL__INFO) Buff.append(QString(" [%1]").arg(Log::fromLevel(LevelIn)));
+        Buff.append("\r\n");
+    }
+
+    if(!LogMessage_in.isEmpty())
+    {
+        Buff.append(LogMessage_in);
+        Buff.append("\r\n");
+    }
+
+    if(EndLrIn) Buff.append("\r\n");
+
+    if(!Buff.isEmpty())
+    {
+        QByteArray Data = Buff.toUtf8();
+        bool Pushed = false;
+
+        //the writer is not deleted while it is used (see stop())
+        mUsers.fetchAndAddOrdered(1);
 
-        if(EndLrIn) Buff.append("\r\n");
+        LogWriter *Writer = mWriter.loadAcquire();
 
-        if(!Buff.isEmpty())
+        if(Writer)
         {
-            if(!LogFile_in.isEmpty())
+            Pushed = mRing->push(LogFile_in, Data);
+
+            if(!Pushed)
             {
-                QFile File(LogFile_in.toStdString().data());
+                Writer->wake();
 
-                if(File.open(QIODevice::ReadWrite|QIODevice::Text|QIODevice::Append))
+                if(mBlock)
+                {
+                    //the writer may be stopped while waiting: the message is written immediately then
+                    while(!Pushed && (Writer = mWriter.loadAcquire()) != nullptr)
+                    {
+                        QThread::yieldCurrentThread();
+                        Writer->wake();
+                        Pushed = mRing->push(LogFile_in, Data);
+                    }
+                }
+                else
                 {
-                    File.atEnd();
-                    File.write(Buff.toUtf8());
-                    File.close();
+                    Writer->drop();
+                    Pushed = true;
                 }
             }
-            else
+        }
+
+        mUsers.fetchAndAddOrdered(-1);
+
+        if(!Pushed) Log::write(LogFile_in, Data, true);
+    }
+}
+
+
+/**
+@brief      Write data to a file immediately (without the writer and level).
+@param      FileIn - path to a file (empty - std::cout);
+            DataIn - data;
+            RotateIn - the file is Log-file (is rotated, see setRotation()).
+@return     None.
+@detailed   Other files (e.g. files of archive) are never rotated.
+*/
+void Log::write(const QString &FileIn, const QByteArray &DataIn, bool RotateIn)
+{
+    if(!FileIn.isEmpty())
+    {
+        QMutexLocker Locker(&mWriteMutex);
+
+        bool Rotate = ((RotateIn && (mRotSize > 0 || mRotDaily)) ? true : false);
+        if(Rotate) Log::rotate(FileIn, DataIn.size());
+
+        QFile File(FileIn);
+
+        if(File.open(QIODevice::ReadWrite|QIODevice::Text|QIODevice::Append))
+        {
+            File.atEnd();
+            File.write(DataIn);
+            if(Rotate) mWriteSizes.insert(FileIn, File.pos());
+            File.close();
+        }
+    }
+    else
+    {
+        std::cout << DataIn.constData();
+    }
+}
+
+
+/**
+@brief      Rotate Log-file before immediate writing.
+@param      FileIn - path to Log-file;
+            SizeIn - size of data.
+@return     None.
+@detailed   Is called under mWriteMutex. The file is renamed in this thread,
+            the segment is compressed and the oldest segments are removed by LogRotateTask in mRotPool.
+*/
+void Log::rotate(const QString &FileIn, qint64 SizeIn)
+{
+    QDate Today = QDate::currentDate();
+
+    if(!mWriteSizes.contains(FileIn))
+    {
+        QFileInfo Info(FileIn);
+
+        mWriteSizes.insert(FileIn, ((Info.exists()) ? Info.size() : 0));
+        mWriteDays.insert(FileIn, ((Info.exists()) ? Info.lastModified().date() : Today));
+    }
+
+    qint64 Size = mWriteSizes.value(FileIn);
+    bool BySize = ((mRotSize > 0 && Size > 0 && (Size+SizeIn) > mRotSize) ? true : false);
+    bool ByDay  = ((mRotDaily && Size > 0 && mWriteDays.value(FileIn) != Today) ? true : false);
+
+    if(BySize || ByDay)
+    {
+        QString Segment;
+
+        if(LogRotateTask::toSegment(FileIn, Segment))
+        {
+            if(!mRotPool)
             {
-                std::cout << Buff.toStdString();
+                mRotPool = new QThreadPool();
+                mRotPool->setMaxThreadCount(1);
             }
+
+            mRotPool->start(new LogRotateTask(Segment, FileIn, mRotKeep, mRotGzip));
+            mWriteSizes.insert(FileIn, 0);
         }
     }
+
+    if(mWriteSizes.value(FileIn) == 0) mWriteDays.insert(FileIn, Today);
 }
 
 
@@ -147,3 +299,199 @@ void Log::log(const QString &LogMessage_in)
 {
     Log::log(LogMessage_in, QString(""), true, true, true);
 }
+
+
+/**
+@brief      Start the writer (asynchronous log).
+@param      BuffIn - size of ring buffer (the number of messages);
+            FlushIn - flush interval (msec);
+            BlockIn - true: wait if the buffer is full, false: drop the message.
+@return     True if the writer is started (or has been started), otherwise - False.
+@detailed   The buffer is created once, so BuffIn is used by first start only.
+*/
+bool Log::start(quint32 BuffIn, int FlushIn, bool BlockIn)
+{
+    if(mWriter.loadAcquire()) return (true);
+    if(FlushIn <= 0) return (false);
+
+    if(!mRing) mRing = new LogRing(BuffIn);
+    mBlock = BlockIn;
+
+    LogWriter *Writer = new LogWriter(mRing, FlushIn);
+    Writer->setRotation(mRotSize, mRotDaily, mRotKeep, mRotGzip);
+
+    mThread = new QThread();
+    Writer->moveToThread(mThread);
+
+    QObject::connect(mThread, &QThread::started, Writer, &LogWriter::start);
+    QObject::connect(mThread, &QThread::finished, Writer, &LogWriter::deleteLater);
+
+    mThread->start();
+
+    //the files are rotated by the writer now, the kept state of immediate writing is old
+    mWriteMutex.lock();
+    mWriteSizes.clear();
+    mWriteDays.clear();
+    mWriteMutex.unlock();
+
+    mWriter.storeRelease(Writer);
+
+    return (true);
+}
+
+
+/**
+@brief      Stop the writer.
+@param      None.
+@return     None.
+@detailed   All messages are written, files are closed; next messages are written immediately.
+            Producers should be stopped before (the messages of producers are not lost anyway).
+*/
+void Log::stop()
+{
+    LogWriter *Writer = mWriter.fetchAndStoreOrdered(nullptr);
+
+    if(Writer)
+    {
+        //wait for producers that have taken the writer before
+        while(mUsers.loadAcquire() > 0) QThread::yieldCurrentThread();
+
+        QMetaObject::invokeMethod(Writer, "stop", Qt::BlockingQueuedConnection);
+
+        mThread->quit();
+        mThread->wait();
+        delete mThread;
+        mThread = nullptr;
+
+        //the rest of messages (the writer is stopped, so this thread is the only consumer)
+        QString File;
+        QByteArray Data;
+
+        while(mRing->pop(File, Data)) Log::write(File, Data, true);
+    }
+
+    //segments rotated by immediate writing
+    if(mRotPool) mRotPool->waitForDone();
+}
+
+
+/**
+@brief      Set rotation of Log-files.
+@param      MaxSizeIn - max. size of Log-file (bytes, 0 - is not used);
+            DailyIn - rotate every day;
+            KeepIn - the number of kept segments;
+            GzipIn - compress segments.
+@return     None.
+@detailed   Is applied by next start of the writer and by immediate writing.
+*/
+void Log::setRotation(qint64 MaxSizeIn, bool DailyIn, quint16 KeepIn, bool GzipIn)
+{
+    mRotSize  = MaxSizeIn;
+    mRotDaily = DailyIn;
+    mRotKeep  = KeepIn;
+    mRotGzip  = GzipIn;
+}
+
+
+/**
+@brief      Check level.
+@param      LevelIn - level.
+@return     True if the level is enabled, otherwise - False.
+*/
+bool Log::isLevel(quint8 LevelIn)
+{
+    return (((LevelIn <= mLevel.loadAcquire()) ? true : false));
+}
+
+
+/**
+@brief      Set level.
+@param      LevelIn - level (messages of higher levels are skipped).
+@return     None.
+@detailed   Can be called from any thread.
+*/
+void Log::setLevel(quint8 LevelIn)
+{
+    mLevel.storeRelease(((LevelIn > LEVEL__TRACE) ? LEVEL__TRACE : LevelIn));
+}
+
+
+/**
+@brief      Get level.
+@param      None.
+@return     Level.
+*/
+quint8 Log::getLevel()
+{
+    return (static_cast<quint8>(mLevel.loadAcquire()));
+}
+
+
+/**
+@brief      Convert name of level to level.
+@param      LevelIn - name of level ("error", "warn", "info", "debug", "trace");
+            DefIn - level by default.
+@return     Level.
+*/
+quint8 Log::toLevel(const QString &LevelIn, quint8 DefIn)
+{
+    QString Level = LevelIn.trimmed().toLower();
+
+    if(Level == LEVEL__ERROR_STR) return (LEVEL__ERROR);
+    if(Level == LEVEL__WARN_STR)  return (LEVEL__WARN);
+    if(Level == LEVEL__INFO_STR)  return (LEVEL__INFO);
+    if(Level == LEVEL__DEBUG_STR) return (LEVEL__DEBUG);
+    if(Level == LEVEL__TRACE_STR) return (LEVEL__TRACE);
+
+    return (DefIn);
+}
+
+
+/**
+@brief      Convert level to name of level.
+@param      LevelIn - level.
+@return     Name of level.
+*/
+QString Log::fromLevel(quint8 LevelIn)
+{
+    switch(LevelIn)
+    {
+        case LEVEL__ERROR: return (LEVEL__ERROR_STR);
+        case LEVEL__WARN:  return (LEVEL__WARN_STR);
+        case LEVEL__INFO:  return (LEVEL__INFO_STR);
+        case LEVEL__DEBUG: return (LEVEL__DEBUG_STR);
+    }
+
+    return (LEVEL__TRACE_STR);
+}
+
+
+#ifdef Q_OS_UNIX
+/**
+@brief      Handler of signals SIGUSR1, SIGUSR2.
+@param      SigIn - signal.
+@return     None.
+*/
+static void onLevelSignal(int SigIn)
+{
+    quint8 Level = Log::getLevel();
+
+    if(SigIn == SIGUSR1 && Level < Log::LEVEL__TRACE) Log::setLevel(Level+1);
+    if(SigIn == SIGUSR2 && Level > Log::LEVEL__ERROR) Log::setLevel(Level-1);
+}
+#endif
+
+
+/**
+@brief      Change level by signals (Unix only).
+@param      None.
+@return     None.
+@detailed   SIGUSR1 - more verbose (up to LEVEL__TRACE), SIGUSR2 - less verbose (down to LEVEL__ERROR).
+*/
+void Log::initSignals()
+{
+#ifdef Q_OS_UNIX
+    std::signal(SIGUSR1, onLevelSignal);
+    std::signal(SIGUSR2, onLevelSignal);
+#endif
+}
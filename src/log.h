@@ -26,11 +26,38 @@
 #include <QString>
 #include <QDateTime>
 #include <QFile>
+#include <QThread>
+#include <QAtomicInt>
+#include <QAtomicPointer>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include "log-writer.h"
+
+
+/**
+@brief      Log with level.
+@param      MsgIn - Log-message (expression);
+            FileIn - path to Log-file;
+            UseIn - on/off Log;
+            ... - StampUseIn, EndLrIn (optional).
+@detailed   The message is formatted only if the Log is on and the level is enabled.
+*/
+#define LOG_AT(LevelIn, MsgIn, FileIn, UseIn, ...) \
+    do { if((UseIn) && Log::isLevel(LevelIn)) Log::logAt((LevelIn), (MsgIn), (FileIn), ##__VA_ARGS__); } while(0)
+
+#define LOG_ERROR(MsgIn, FileIn, UseIn, ...) LOG_AT(Log::LEVEL__ERROR, MsgIn, FileIn, UseIn, ##__VA_ARGS__)
+#define LOG_WARN(MsgIn, FileIn, UseIn, ...)  LOG_AT(Log::LEVEL__WARN,  MsgIn, FileIn, UseIn, ##__VA_ARGS__)
+#define LOG_INFO(MsgIn, FileIn, UseIn, ...)  LOG_AT(Log::LEVEL__INFO,  MsgIn, FileIn, UseIn, ##__VA_ARGS__)
+#define LOG_DEBUG(MsgIn, FileIn, UseIn, ...) LOG_AT(Log::LEVEL__DEBUG, MsgIn, FileIn, UseIn, ##__VA_ARGS__)
+#define LOG_TRACE(MsgIn, FileIn, UseIn, ...) LOG_AT(Log::LEVEL__TRACE, MsgIn, FileIn, UseIn, ##__VA_ARGS__)
 
 
 /**
 @brief      Log.
 @detailed   Send Log-messages to STD or File.
+            If the writer is started (see Log::start()), then messages are put into ring buffer
+            and written by the writer in own thread, otherwise they are written immediately.
 */
 class Log : public QObject
 {
@@ -41,6 +68,26 @@ public:
     explicit Log(QObject *parent = nullptr);
     ~Log();
 
+    /**
+    Public constants
+    */
+
+    /**
+    @brief      Levels
+    */
+    static const quint8 LEVEL__ERROR = 0;
+    static const quint8 LEVEL__WARN  = 1;
+    static const quint8 LEVEL__INFO  = 2;
+    static const quint8 LEVEL__DEBUG = 3;
+    static const quint8 LEVEL__TRACE = 4;
+
+    static const QString LEVEL__ERROR_STR;
+    static const QString LEVEL__WARN_STR;
+    static const QString LEVEL__INFO_STR;
+    static const QString LEVEL__DEBUG_STR;
+    static const QString LEVEL__TRACE_STR;
+
+
     /**
     Public methods
     */
@@ -54,6 +101,7 @@ public:
                 EndLrIn - on/off \r\n in end.
     @return     None.
     @detailed   If LogFile_in is NULL or Empty, then used std::cout.
+                The message has level LEVEL__INFO.
     */
     static void log(const QString &LogMessage_in, const QString &LogFile_in, bool LogUse_in, bool StampUseIn, bool EndLrIn);
 
@@ -95,6 +143,178 @@ public:
     */
     static void log(const QString &LogMessage_in);
 
+    /**
+    @brief      Log with level (without check of level, see LOG_AT).
+    @param      LevelIn - level;
+                LogMessage_in - Log-message;
+                LogFile_in - path to Log-file;
+                StampIn - on/off TimeStamp;
+                EndLrIn - on/off \r\n in end.
+    @return     None.
+    @detailed   If LogFile_in is NULL or Empty, then used std::cout.
+    */
+    static void logAt(quint8 LevelIn, const QString &LogMessage_in, const QString &LogFile_in, bool StampUseIn = true, bool EndLrIn = true);
+
+    /**
+    @brief      Check level.
+    @param      LevelIn - level.
+    @return     True if the level is enabled, otherwise - False.
+    */
+    static bool isLevel(quint8 LevelIn);
+
+    /**
+    @brief      Set level.
+    @param      LevelIn - level (messages of higher levels are skipped).
+    @return     None.
+    @detailed   Can be called from any thread.
+    */
+    static void setLevel(quint8 LevelIn);
+
+    /**
+    @brief      Get level.
+    @param      None.
+    @return     Level.
+    */
+    static quint8 getLevel();
+
+    /**
+    @brief      Convert name of level to level.
+    @param      LevelIn - name of level ("error", "warn", "info", "debug", "trace");
+                DefIn - level by default.
+    @return     Level.
+    */
+    static quint8 toLevel(const QString &LevelIn, quint8 DefIn);
+
+    /**
+    @brief      Convert level to name of level.
+    @param      LevelIn - level.
+    @return     Name of level.
+    */
+    static QString fromLevel(quint8 LevelIn);
+
+    /**
+    @brief      Change level by signals (Unix only).
+    @param      None.
+    @return     None.
+    @detailed   SIGUSR1 - more verbose (up to LEVEL__TRACE), SIGUSR2 - less verbose (down to LEVEL__ERROR).
+    */
+    static void initSignals();
+
+    /**
+    @brief      Start the writer (asynchronous log).
+    @param      BuffIn - size of ring buffer (the number of messages);
+                FlushIn - flush interval (msec);
+                BlockIn - true: wait if the buffer is full, false: drop the message.
+    @return     True if the writer is started (or has been started), otherwise - False.
+    */
+    static bool start(quint32 BuffIn, int FlushIn, bool BlockIn);
+
+    /**
+    @brief      Stop the writer.
+    @param      None.
+    @return     None.
+    @detailed   All messages are written, files are closed; next messages are written immediately.
+    */
+    static void stop();
+
+    /**
+    @brief      Set rotation of Log-files.
+    @param      MaxSizeIn - max. size of Log-file (bytes, 0 - is not used);
+                DailyIn - rotate every day;
+                KeepIn - the number of kept segments;
+                GzipIn - compress segments.
+    @return     None.
+    @detailed   Is applied by next start of the writer and by immediate writing.
+    */
+    static void setRotation(qint64 MaxSizeIn, bool DailyIn, quint16 KeepIn, bool GzipIn);
+
+    /**
+    @brief      Write data to a file immediately (without the writer and level).
+    @param      FileIn - path to a file (empty - std::cout);
+                DataIn - data;
+                RotateIn - the file is Log-file (is rotated, see setRotation()).
+    @return     None.
+    @detailed   Other files (e.g. files of archive) are never rotated.
+    */
+    static void write(const QString &FileIn, const QByteArray &DataIn, bool RotateIn = false);
+
+
+private:
+
+    /**
+    Private options
+    */
+
+    /**
+    @brief      Ring buffer (is kept until exit).
+    */
+    static LogRing *mRing;
+
+    /**
+    @brief      Writer (nullptr - the writer is not started).
+    */
+    static QAtomicPointer<LogWriter> mWriter;
+
+    /**
+    @brief      The number of producers that use the writer.
+    @detailed   The writer is deleted by stop() when there are no producers.
+    */
+    static QAtomicInt mUsers;
+
+    /**
+    @brief      Thread of the writer.
+    */
+    static QThread *mThread;
+
+    /**
+    @brief      Wait if the buffer is full.
+    */
+    static bool mBlock;
+
+    /**
+    @brief      Level.
+    */
+    static QAtomicInt mLevel;
+
+    /**
+    @brief      Rotation (see setRotation()).
+    */
+    static qint64 mRotSize;
+    static bool mRotDaily;
+    static quint16 mRotKeep;
+    static bool mRotGzip;
+
+    /**
+    @brief      Mutex of immediate writing (rotation without the writer).
+    */
+    static QMutex mWriteMutex;
+
+    /**
+    @brief      Sizes and dates of Log-files written immediately.
+    @detailed   Are read from the file once and kept by writing (the file is not checked by each write).
+    */
+    static QHash<QString, qint64> mWriteSizes;
+    static QHash<QString, QDate> mWriteDays;
+
+    /**
+    @brief      Pool of rotation tasks of immediate writing (one thread, is created by first rotation).
+    */
+    static QThreadPool *mRotPool;
+
+
+    /**
+    Private methods
+    */
+
+    /**
+    @brief      Rotate Log-file before immediate writing.
+    @param      FileIn - path to Log-file;
+                SizeIn - size of data.
+    @return     None.
+    @detailed   Is called under mWriteMutex. The file is renamed in this thread,
+                the segment is compressed and the oldest segments are removed by LogRotateTask in mRotPool.
+    */
+    static void rotate(const QString &FileIn, qint64 SizeIn);
 };
 
 #endif // LOG_H
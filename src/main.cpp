@@ -22,6 +22,7 @@
 
 #include "global.h"
 #include "args.h"
+#include "arh-store.h"
 
 #ifdef SERVICE
 #include "service.h"
@@ -35,6 +36,10 @@
 
     --config PathToConfigFile [ --sname ServiceName --sdesc ServiceDescription --log PathToLogOutFile ]
 
+    Benchmark of the embedded store of archive (write throughput and bytes per sample):
+
+    --bench-store PathToEmptyDir [ --bench-tags 20000 --bench-samples 600 ]
+
     [  ] - optional arguments
 */
 
@@ -43,6 +48,14 @@ int main(int argc, char *argv[])
     QHash<QString, QString> ParsedArgs;
     Args::parse(argc, argv, ParsedArgs);
 
+    if(ParsedArgs.contains(QString(ARG_KEY_BENCH_STORE)))
+    {
+        ArhStore::bench(ParsedArgs.value(QString(ARG_KEY_BENCH_STORE)),
+                        ParsedArgs.value(QString(ARG_KEY_BENCH_TAGS), QString("20000")).toInt(),
+                        ParsedArgs.value(QString(ARG_KEY_BENCH_SAMPLES), QString("600")).toInt());
+        return (0);
+    }
+
 #ifdef SERVICE
     QString SName = ParsedArgs.value(Service::ARG_KEY__SNAME, QString(SERVICE_NAME));
     Service sc(argc, argv, SName);
@@ -21,6 +21,42 @@
 #include "modbus-cli.h"
 
 
+/**
+@brief  Pack registers into raw bytes (big-endian).
+@param  RawDataIn - pointer to registers;
+@param  RegNbIn - the number of registers.
+@return Raw bytes.
+*/
+static QByteArray regsToBytes(const uint16_t *RawDataIn, int RegNbIn)
+{
+    QByteArray Bytes;
+
+    for(int i=0; i<RegNbIn; i++)
+    {
+        Bytes.append(static_cast<char>((RawDataIn[i]>>8) & 0xFF));
+        Bytes.append(static_cast<char>(RawDataIn[i] & 0xFF));
+    }
+
+    return (Bytes);
+}
+
+
+/**
+@brief  Unpack raw bytes (big-endian) into registers.
+@param  BytesIn - raw bytes;
+@param  RawDataIn - pointer to registers;
+@param  RegNbIn - the number of registers.
+@return None.
+*/
+static void bytesToRegs(const QByteArray &BytesIn, uint16_t *RawDataIn, int RegNbIn)
+{
+    for(int i=0; i<RegNbIn && (2*i+1)<BytesIn.size(); i++)
+    {
+        RawDataIn[i] = static_cast<uint16_t>((static_cast<quint8>(BytesIn.at(2*i))<<8) | static_cast<quint8>(BytesIn.at(2*i+1)));
+    }
+}
+
+
 /**
 @brief      Constant: the functions.
 */
@@ -44,6 +80,7 @@ HelperModBusClient::HelperModBusClient(QObject *parent) : QObject(parent)
     mCtx                = nullptr;
     mInited             = false;
     mConnected          = false;
+    mException          = 0;
 }
 
 
@@ -104,6 +141,30 @@ QString HelperModBusClient::getError()
 }
 
 
+/**
+@brief  Get ModBus exception code.
+@param  None.
+@return Exception code of last Error (MODBUS_EXCEPTION_...).
+@detailed If last Error is not a ModBus exception, then returns 0
+          The code is kept by the last read/write operation.
+*/
+int HelperModBusClient::getException()
+{
+    return (mException);
+}
+
+
+/**
+@brief  (static) Convert errno into ModBus exception code.
+@param  ErrNoIn - errno.
+@return Exception code (MODBUS_EXCEPTION_...), 0 if errno is not a ModBus exception.
+*/
+int HelperModBusClient::toException(const int ErrNoIn)
+{
+    return (((ErrNoIn >= EMBXILFUN && ErrNoIn <= EMBXGTAR) ? (ErrNoIn-MODBUS_ENOBASE) : 0));
+}
+
+
 /**
 @brief  Init.
 @param  None.
@@ -141,7 +202,8 @@ bool HelperModBusClient::connect()
 #endif
         }
 
-        mConnected = ((modbus_connect(mCtx) == 0) ? true : false);
+        //replay: the bus is not used
+        mConnected = ((Capture::isReplay()) ? true : ((modbus_connect(mCtx) == 0) ? true : false));
     }
 
     if(mConnected)
@@ -168,7 +230,7 @@ void HelperModBusClient::disconnect()
 {
     if(this->isInited())
     {
-        if(mConnected) modbus_close(mCtx);
+        if(mConnected && !Capture::isReplay()) modbus_close(mCtx);
         modbus_free(mCtx);
         mCtx = nullptr;
     }
@@ -205,20 +267,28 @@ int HelperModBusClient::readBits(uint8_t *RawDataIn, int RegAddrIn, int RegNbIn,
 {
     int _Res = -1;
 
+    mException = 0;
+
     if(this->isConnected())
     {
-        switch(FuncIn)
-        {
-            case FUNC__READ_COIL_REGS:
-                _Res = modbus_read_bits(mCtx, RegAddrIn, RegNbIn, RawDataIn);
-                break;
-
-            case FUNC__READ_DISC_REGS:
-                _Res = modbus_read_input_bits(mCtx, RegAddrIn, RegNbIn, RawDataIn);
-                break;
+        if(FuncIn != FUNC__READ_COIL_REGS && FuncIn != FUNC__READ_DISC_REGS) return (_Res);
 
-            default:
-                return (_Res);
+        if(Capture::isReplay())
+        {
+            QByteArray Response;
+            _Res = this->replay(this->toRequest(FuncIn, RegAddrIn, RegNbIn, QByteArray()), Response);
+            for(int i=0; i<RegNbIn && i<Response.size(); i++) RawDataIn[i] = static_cast<uint8_t>(Response.at(i));
+        }
+        else
+        {
+            _Res = ((FuncIn == FUNC__READ_COIL_REGS) ? modbus_read_bits(mCtx, RegAddrIn, RegNbIn, RawDataIn) : modbus_read_input_bits(mCtx, RegAddrIn, RegNbIn, RawDataIn));
+
+            if(Capture::isCapture())
+            {
+                int ErrNo = errno;
+                this->capture(this->toRequest(FuncIn, RegAddrIn, RegNbIn, QByteArray()), _Res, ErrNo, ((_Res > 0) ? QByteArray(reinterpret_cast<const char *>(RawDataIn), _Res) : QByteArray()));
+                errno = ErrNo;
+            }
         }
 
         if(_Res != ERROR_RES)
@@ -229,6 +299,8 @@ int HelperModBusClient::readBits(uint8_t *RawDataIn, int RegAddrIn, int RegNbIn,
         {
             int ErrNo = this->getErrorNo();
             QString ErrStr = this->getError();
+            //the exception is kept before the signal (slots may change errno)
+            mException = toException(ErrNo);
             emit sigError(ErrNo, ErrStr);
         }
     }
@@ -250,20 +322,28 @@ int HelperModBusClient::readRegs(uint16_t *RawDataIn, int RegAddrIn, int RegNbIn
 {
     int _Res = -1;
 
+    mException = 0;
+
     if(this->isConnected())
     {
-        switch(FuncIn)
-        {
-            case FUNC__READ_HOLDING_REGS:
-                _Res = modbus_read_registers(mCtx, RegAddrIn, RegNbIn, RawDataIn);
-                break;
+        if(FuncIn != FUNC__READ_HOLDING_REGS && FuncIn != FUNC__READ_INPUT_REGS) return (_Res);
 
-            case FUNC__READ_INPUT_REGS:
-                _Res = modbus_read_input_registers(mCtx, RegAddrIn, RegNbIn, RawDataIn);
-                break;
-
-            default:
-                return (_Res);
+        if(Capture::isReplay())
+        {
+            QByteArray Response;
+            _Res = this->replay(this->toRequest(FuncIn, RegAddrIn, RegNbIn, QByteArray()), Response);
+            bytesToRegs(Response, RawDataIn, RegNbIn);
+        }
+        else
+        {
+            _Res = ((FuncIn == FUNC__READ_HOLDING_REGS) ? modbus_read_registers(mCtx, RegAddrIn, RegNbIn, RawDataIn) : modbus_read_input_registers(mCtx, RegAddrIn, RegNbIn, RawDataIn));
+
+            if(Capture::isCapture())
+            {
+                int ErrNo = errno;
+                this->capture(this->toRequest(FuncIn, RegAddrIn, RegNbIn, QByteArray()), _Res, ErrNo, ((_Res > 0) ? regsToBytes(RawDataIn, _Res) : QByteArray()));
+                errno = ErrNo;
+            }
         }
 
         if(_Res != ERROR_RES)
@@ -274,6 +354,8 @@ int HelperModBusClient::readRegs(uint16_t *RawDataIn, int RegAddrIn, int RegNbIn
         {
             int ErrNo = this->getErrorNo();
             QString ErrStr = this->getError();
+            //the exception is kept before the signal (slots may change errno)
+            mException = toException(ErrNo);
             emit sigError(ErrNo, ErrStr);
         }
     }
@@ -308,9 +390,29 @@ int HelperModBusClient::writeCoilRegs(uint8_t *RawDataIn, int RegAddrIn, int Reg
 {
     int _Res = -1;
 
+    mException = 0;
+
     if(this->isConnected())
     {
-        _Res = modbus_write_bits(mCtx, RegAddrIn, RegNbIn, RawDataIn);
+        QByteArray Request;
+        if(Capture::isReplay() || Capture::isCapture()) Request = this->toRequest(FUNC__WRITE_COIL_REGS, RegAddrIn, RegNbIn, QByteArray(reinterpret_cast<const char *>(RawDataIn), RegNbIn));
+
+        if(Capture::isReplay())
+        {
+            QByteArray Response;
+            _Res = this->replay(Request, Response);
+        }
+        else
+        {
+            _Res = modbus_write_bits(mCtx, RegAddrIn, RegNbIn, RawDataIn);
+
+            if(Capture::isCapture())
+            {
+                int ErrNo = errno;
+                this->capture(Request, _Res, ErrNo, QByteArray());
+                errno = ErrNo;
+            }
+        }
 
         if(_Res != ERROR_RES)
         {
@@ -320,6 +422,8 @@ int HelperModBusClient::writeCoilRegs(uint8_t *RawDataIn, int RegAddrIn, int Reg
         {
             int ErrNo = this->getErrorNo();
             QString ErrStr = this->getError();
+            //the exception is kept before the signal (slots may change errno)
+            mException = toException(ErrNo);
             emit sigError(ErrNo, ErrStr);
         }
     }
@@ -354,9 +458,29 @@ int HelperModBusClient::writeHoldingRegs(uint16_t *RawDataIn, int RegAddrIn, int
 {
     int _Res = -1;
 
+    mException = 0;
+
     if(this->isConnected())
     {
-        _Res = modbus_write_registers(mCtx, RegAddrIn, RegNbIn, RawDataIn);
+        QByteArray Request;
+        if(Capture::isReplay() || Capture::isCapture()) Request = this->toRequest(FUNC__WRITE_HOLDING_REGS, RegAddrIn, RegNbIn, regsToBytes(RawDataIn, RegNbIn));
+
+        if(Capture::isReplay())
+        {
+            QByteArray Response;
+            _Res = this->replay(Request, Response);
+        }
+        else
+        {
+            _Res = modbus_write_registers(mCtx, RegAddrIn, RegNbIn, RawDataIn);
+
+            if(Capture::isCapture())
+            {
+                int ErrNo = errno;
+                this->capture(Request, _Res, ErrNo, QByteArray());
+                errno = ErrNo;
+            }
+        }
 
         if(_Res != ERROR_RES)
         {
@@ -366,6 +490,8 @@ int HelperModBusClient::writeHoldingRegs(uint16_t *RawDataIn, int RegAddrIn, int
         {
             int ErrNo = this->getErrorNo();
             QString ErrStr = this->getError();
+            //the exception is kept before the signal (slots may change errno)
+            mException = toException(ErrNo);
             emit sigError(ErrNo, ErrStr);
         }
     }
@@ -412,3 +538,88 @@ void HelperModBusClient::setDevBaseAddr(int DevBaseAddrIn)
     int _DevBaseAddr = ((DevBaseAddrIn > 0) ? DevBaseAddrIn : 1);
     if(mCtx != nullptr) modbus_set_slave(mCtx, _DevBaseAddr);
 }
+
+
+/**
+@brief  Get bus (for capture and replay).
+@param  None.
+@return Bus (serial port or "IP:Port").
+*/
+QString HelperModBusClient::getBus()
+{
+    return (QString(""));
+}
+
+
+/**
+@brief  Get protocol (for capture and replay).
+@param  None.
+@return Protocol (Capture::PROTO__*).
+*/
+quint8 HelperModBusClient::getProto()
+{
+    return (Capture::PROTO__MODBUS_RTU);
+}
+
+
+/**
+@brief  Pack request (for capture and replay).
+@param  FuncIn - the function code;
+@param  RegAddrIn - the address of first register of the data block;
+@param  RegNbIn - the number of registers;
+@param  PayloadIn - written data.
+@return Raw request: [DevBaseAddr][Func][RegAddr:2][RegNb:2][Payload].
+*/
+QByteArray HelperModBusClient::toRequest(int FuncIn, int RegAddrIn, int RegNbIn, const QByteArray &PayloadIn)
+{
+    QByteArray Request;
+
+    Request.reserve(6+PayloadIn.size());
+    Request.append(static_cast<char>(mDevBaseAddr & 0xFF));
+    Request.append(static_cast<char>(FuncIn & 0xFF));
+    Request.append(static_cast<char>((RegAddrIn>>8) & 0xFF));
+    Request.append(static_cast<char>(RegAddrIn & 0xFF));
+    Request.append(static_cast<char>((RegNbIn>>8) & 0xFF));
+    Request.append(static_cast<char>(RegNbIn & 0xFF));
+    Request.append(PayloadIn);
+
+    return (Request);
+}
+
+
+/**
+@brief  Take response from capture (replay mode).
+@param  RequestIn - raw request;
+@param  ResponseIn - link to raw response.
+@return Result of the captured transaction, or -1 (errno = ETIMEDOUT) if the request is not captured.
+@detailed errno is set by the captured transaction.
+*/
+int HelperModBusClient::replay(const QByteArray &RequestIn, QByteArray &ResponseIn)
+{
+    qint32 Res   = ERROR_RES;
+    qint32 ErrNo = ETIMEDOUT;
+
+    if(!Capture::replay(this->getProto(), this->getBus(), RequestIn, Res, ErrNo, ResponseIn))
+    {
+        Res   = ERROR_RES;
+        ErrNo = ETIMEDOUT;
+    }
+
+    errno = ErrNo;
+
+    return (Res);
+}
+
+
+/**
+@brief  Write transaction to capture (capture mode).
+@param  RequestIn - raw request;
+@param  ResIn - result;
+@param  ErrNoIn - errno;
+@param  ResponseIn - raw response.
+@return None.
+*/
+void HelperModBusClient::capture(const QByteArray &RequestIn, int ResIn, int ErrNoIn, const QByteArray &ResponseIn)
+{
+    Capture::record(this->getProto(), this->getBus(), RequestIn, ResIn, ((ResIn == ERROR_RES) ? ErrNoIn : 0), ResponseIn);
+}
@@ -22,8 +22,10 @@
 #define HELPERMODBUSCLIENT_H
 
 #include <iostream>
+#include <cerrno>
 #include <QObject>
 #include <QString>
+#include <QByteArray>
 
 #if defined(_WIN32) && !defined(__CYGWIN__)
 #include <winsock2.h>
@@ -33,6 +35,7 @@
 #include "lib/modbus/include/modbus.h"
 
 #include "global.h"
+#include "capture.h"
 
 
 /**
@@ -125,6 +128,36 @@ public:
     */
     QString getError();
 
+    /**
+    @brief  Get ModBus exception code.
+    @param  None.
+    @return Exception code of last Error (MODBUS_EXCEPTION_...).
+    @detailed If last Error is not a ModBus exception, then returns 0
+              The code is kept by the last read/write operation.
+    */
+    int getException();
+
+    /**
+    @brief  (static) Convert errno into ModBus exception code.
+    @param  ErrNoIn - errno.
+    @return Exception code (MODBUS_EXCEPTION_...), 0 if errno is not a ModBus exception.
+    */
+    static int toException(const int ErrNoIn);
+
+    /**
+    @brief  Get bus (for capture and replay).
+    @param  None.
+    @return Bus (serial port or "IP:Port").
+    */
+    virtual QString getBus();
+
+    /**
+    @brief  Get protocol (for capture and replay).
+    @param  None.
+    @return Protocol (Capture::PROTO__*).
+    */
+    virtual quint8 getProto();
+
 
 signals:
 
@@ -316,6 +349,45 @@ protected:
     @brief Connection status
     */
     bool mConnected;
+
+    /**
+    @brief ModBus exception code of the last read/write operation
+    */
+    int mException;
+
+
+    /**
+    Protected methods
+    */
+
+    /**
+    @brief  Pack request (for capture and replay).
+    @param  FuncIn - the function code;
+    @param  RegAddrIn - the address of first register of the data block;
+    @param  RegNbIn - the number of registers;
+    @param  PayloadIn - written data.
+    @return Raw request: [DevBaseAddr][Func][RegAddr:2][RegNb:2][Payload].
+    */
+    QByteArray toRequest(int FuncIn, int RegAddrIn, int RegNbIn, const QByteArray &PayloadIn);
+
+    /**
+    @brief  Take response from capture (replay mode).
+    @param  RequestIn - raw request;
+    @param  ResponseIn - link to raw response.
+    @return Result of the captured transaction, or -1 (errno = ETIMEDOUT) if the request is not captured.
+    @detailed errno is set by the captured transaction.
+    */
+    int replay(const QByteArray &RequestIn, QByteArray &ResponseIn);
+
+    /**
+    @brief  Write transaction to capture (capture mode).
+    @param  RequestIn - raw request;
+    @param  ResIn - result;
+    @param  ErrNoIn - errno;
+    @param  ResponseIn - raw response.
+    @return None.
+    */
+    void capture(const QByteArray &RequestIn, int ResIn, int ErrNoIn, const QByteArray &ResponseIn);
 };
 
 #endif // HELPERMODBUSCLIENT_H
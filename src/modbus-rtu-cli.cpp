@@ -171,3 +171,25 @@ int HelperModBusRTUClient::convSerialMode(const QString &ModeIn)
 {
     return ((ModeIn == "RS485") ? SERIAL_PORT_MODE__RS485 : SERIAL_PORT_MODE__RS232);
 }
+
+
+/**
+@brief      Method: Get bus (for capture and replay).
+@param      None.
+@return     Name of serial port.
+*/
+QString HelperModBusRTUClient::getBus()
+{
+    return (mSerialPortNum);
+}
+
+
+/**
+@brief      Method: Get protocol (for capture and replay).
+@param      None.
+@return     Capture::PROTO__MODBUS_RTU.
+*/
+quint8 HelperModBusRTUClient::getProto()
+{
+    return (Capture::PROTO__MODBUS_RTU);
+}
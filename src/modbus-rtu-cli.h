@@ -171,6 +171,20 @@ public:
     */
     static int convSerialMode(const QString &ModeIn);
 
+    /**
+    @brief      Method: Get bus (for capture and replay).
+    @param      None.
+    @return     Name of serial port.
+    */
+    QString getBus();
+
+    /**
+    @brief      Method: Get protocol (for capture and replay).
+    @param      None.
+    @return     Capture::PROTO__MODBUS_RTU.
+    */
+    quint8 getProto();
+
 
 public slots:
 
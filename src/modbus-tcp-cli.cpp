@@ -75,3 +75,25 @@ bool HelperModBusTCPClient::init()
 
     return (this->isInited());
 }
+
+
+/**
+@brief      Method: Get bus (for capture and replay).
+@param      None.
+@return     "IP:Port".
+*/
+QString HelperModBusTCPClient::getBus()
+{
+    return (QString("%1:%2").arg(mIP, QString::number(mPort)));
+}
+
+
+/**
+@brief      Method: Get protocol (for capture and replay).
+@param      None.
+@return     Capture::PROTO__MODBUS_TCP.
+*/
+quint8 HelperModBusTCPClient::getProto()
+{
+    return (Capture::PROTO__MODBUS_TCP);
+}
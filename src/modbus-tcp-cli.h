@@ -74,6 +74,21 @@ public:
     Public methods
     */
 
+    /**
+    @brief      Method: Get bus (for capture and replay).
+    @param      None.
+    @return     "IP:Port".
+    */
+    QString getBus();
+
+    /**
+    @brief      Method: Get protocol (for capture and replay).
+    @param      None.
+    @return     Capture::PROTO__MODBUS_TCP.
+    */
+    quint8 getProto();
+
+
 public slots:
 
     /**
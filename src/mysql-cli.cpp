@@ -27,6 +27,94 @@
 const quint32 HelperMySQL::ERROR__INIT            = 1;
 
 
+/**
+@brief      Constant: Server error codes (LOAD DATA LOCAL INFILE is refused)
+*/
+const quint32 HelperMySQL::ERROR__INFILE_NOT_ALLOWED = 1148;
+const quint32 HelperMySQL::ERROR__INFILE_DISABLED    = 3948;
+const quint32 HelperMySQL::ERROR__INFILE_REJECTED    = 2068;
+
+
+/**
+@brief      Local infile: data in memory and the read position
+*/
+struct HelperMySQLInfile
+{
+    const QByteArray *mData;
+    int mPos;
+};
+
+
+/**
+@brief      Local infile handler: Init.
+@param      PtrIn - link to pointer of handler data;
+            FileIn - name of file (is not used);
+            UserDataIn - pointer to HelperMySQLInfile.
+@return     0 if OK.
+*/
+static int helperMySQLInfileInit(void **PtrIn, const char *FileIn, void *UserDataIn)
+{
+    (void)FileIn;
+
+    HelperMySQLInfile *Infile = static_cast<HelperMySQLInfile *>(UserDataIn);
+    Infile->mPos = 0;
+    *PtrIn       = Infile;
+
+    return (0);
+}
+
+
+/**
+@brief      Local infile handler: Read the next block.
+@param      PtrIn - pointer to HelperMySQLInfile;
+            BuffIn - buffer;
+            BuffLenIn - size of buffer.
+@return     The number of bytes (0 at the end of data).
+*/
+static int helperMySQLInfileRead(void *PtrIn, char *BuffIn, unsigned int BuffLenIn)
+{
+    HelperMySQLInfile *Infile = static_cast<HelperMySQLInfile *>(PtrIn);
+
+    int Len = qMin(static_cast<int>(BuffLenIn), Infile->mData->size() - Infile->mPos);
+
+    if(Len > 0)
+    {
+        std::memcpy(BuffIn, Infile->mData->constData() + Infile->mPos, static_cast<size_t>(Len));
+        Infile->mPos+= Len;
+    }
+
+    return ((Len > 0) ? Len : 0);
+}
+
+
+/**
+@brief      Local infile handler: End.
+@param      PtrIn - pointer to HelperMySQLInfile.
+@return     None.
+*/
+static void helperMySQLInfileEnd(void *PtrIn)
+{
+    (void)PtrIn;
+}
+
+
+/**
+@brief      Local infile handler: Error.
+@param      PtrIn - pointer to HelperMySQLInfile;
+            BuffIn - buffer of error message;
+            BuffLenIn - size of buffer.
+@return     Error code (reading from memory has no errors).
+*/
+static int helperMySQLInfileError(void *PtrIn, char *BuffIn, unsigned int BuffLenIn)
+{
+    (void)PtrIn;
+
+    if(BuffLenIn > 0) BuffIn[0] = '\0';
+
+    return (0);
+}
+
+
 /**
 @brief      Constant: Host names
 */
@@ -52,8 +140,11 @@ HelperMySQL::HelperMySQL(QObject *parent) : QObject(parent)
     mDB              = QString("");
     mPort            = 3306;
     mCharacterSet    = HelperMySQL::CHARSET__UTF8;
+    mLocalInfile     = false;
     mInited          = false;
     mConnected       = false;
+    mStmtErrNo       = 0;
+    mStmtError       = QString("");
 }
 
 
@@ -129,6 +220,110 @@ MYSQL_RES *HelperMySQL::getResultset()
 }
 
 
+/**
+@brief      Method: Get Error code of the last prepared statement.
+@detailed   if no errors, then returns 0
+@param      None.
+@return     Error code.
+*/
+quint32 HelperMySQL::getStmtErrorNo()
+{
+    return (mStmtErrNo);
+}
+
+
+/**
+@brief      Method: Get Error message of the last prepared statement.
+@detailed   if no errors, then returns empty string
+@param      None.
+@return     Error message.
+*/
+QString HelperMySQL::getStmtError()
+{
+    return (mStmtError);
+}
+
+
+/**
+@brief      Method: Get prepared statement.
+@detailed   statements are cached by text of query until disconnect
+@param      QueryIn - SQL-query with placeholders (?).
+@return     Pointer to prepared statement or NULL.
+*/
+MYSQL_STMT *HelperMySQL::getStmt(const QString &QueryIn)
+{
+    MYSQL_STMT *Stmt = mListStmts.value(QueryIn, nullptr);
+
+    if(Stmt == nullptr && this->isConnected() && !QueryIn.isEmpty())
+    {
+        Stmt = mysql_stmt_init(mMySQL);
+
+        if(Stmt != nullptr)
+        {
+            QByteArray Query = QueryIn.toUtf8();
+
+            if(mysql_stmt_prepare(Stmt, Query.constData(), static_cast<unsigned long>(Query.size())) == 0)
+            {
+                mListStmts.insert(QueryIn, Stmt);
+            }
+            else
+            {
+                mStmtErrNo = mysql_stmt_errno(Stmt);
+                mStmtError = QString(mysql_stmt_error(Stmt));
+                mysql_stmt_close(Stmt);
+                Stmt = nullptr;
+                emit sigError(mStmtErrNo, mStmtError);
+            }
+        }
+        else
+        {
+            mStmtErrNo = this->getErrorNo();
+            mStmtError = this->getError();
+            emit sigError(mStmtErrNo, mStmtError);
+        }
+    }
+
+    return (Stmt);
+}
+
+
+/**
+@brief      Method: Get the number of cached prepared statements.
+@param      None.
+@return     The number of statements.
+*/
+int HelperMySQL::sizeStmts()
+{
+    return (mListStmts.size());
+}
+
+
+/**
+@brief      Method: Check refusal of LOAD DATA LOCAL INFILE.
+@param      None.
+@return     True if the last error means that the server (or the client library) does not allow local infile, otherwise - false.
+*/
+bool HelperMySQL::isInfileRefused()
+{
+    quint32 ErrNo = this->getErrorNo();
+
+    return ((ErrNo == HelperMySQL::ERROR__INFILE_NOT_ALLOWED || ErrNo == HelperMySQL::ERROR__INFILE_DISABLED || ErrNo == HelperMySQL::ERROR__INFILE_REJECTED) ? true : false);
+}
+
+
+/**
+@brief      Method: Get the number of rows changed by the last query.
+@param      None.
+@return     The number of rows (INSERT, UPDATE, DELETE).
+*/
+quint64 HelperMySQL::getAffectedRows()
+{
+    my_ulonglong Res = ((this->isConnected()) ? mysql_affected_rows(mMySQL) : 0);
+
+    return ((Res == static_cast<my_ulonglong>(-1)) ? 0 : static_cast<quint64>(Res));
+}
+
+
 /**
 @brief      Public slot: Init.
 @param      None.
@@ -165,6 +360,12 @@ bool HelperMySQL::connect()
 {
     if(this->init())
     {
+        if(mLocalInfile)
+        {
+            unsigned int LocalInfile = 1;
+            mysql_options(mMySQL, MYSQL_OPT_LOCAL_INFILE, &LocalInfile);
+        }
+
         MYSQL *pMySQL = ((mDB.isEmpty()) ? mysql_real_connect(mMySQL, mHost.toUtf8().data(), mUser.toUtf8().data(), mPasswd.toUtf8().data(), nullptr, 0, nullptr, 0) : mysql_real_connect(mMySQL, mHost.toUtf8().data(), mUser.toUtf8().data(), mPasswd.toUtf8().data(), mDB.toUtf8().data(), 0, nullptr, 0));
         mConnected    = ((pMySQL != nullptr) ? true : false);
     }
@@ -191,9 +392,12 @@ bool HelperMySQL::connect()
 */
 void HelperMySQL::disconnect()
 {
+    this->closeStmts();
+
     if(this->isInited())
     {
-        if(mConnected) mysql_close(mMySQL);
+        //the handle is released even if the connection has failed
+        mysql_close(mMySQL);
         mMySQL = nullptr;
     }
 
@@ -335,3 +539,181 @@ bool HelperMySQL::sendQuery(const QString &QueryIn)
 
     return ((Res == 0) ? true : false);
 }
+
+
+/**
+@brief      Public slot: Send Query and get one value.
+@param      QueryIn - SQL-query (SELECT);
+            ValueIn - link to value of the first column of the first row (empty if no rows or NULL).
+@return     True if query was sent successfully, otherwise - false.
+*/
+bool HelperMySQL::selectValue(const QString &QueryIn, QString &ValueIn)
+{
+    ValueIn = QString("");
+
+    if(!this->sendQuery(QueryIn)) return (false);
+
+    MYSQL_RES *Result = this->getResultset();
+
+    if(Result != nullptr)
+    {
+        MYSQL_ROW Row = mysql_fetch_row(Result);
+        if(Row != nullptr && mysql_num_fields(Result) > 0 && Row[0] != nullptr) ValueIn = QString::fromUtf8(Row[0]);
+
+        mysql_free_result(Result);
+    }
+
+    return (true);
+}
+
+
+/**
+@brief      Public slot: Start transaction.
+@param      None.
+@return     True if transaction was started successfully, otherwise - false.
+*/
+bool HelperMySQL::begin()
+{
+    return (this->sendQuery(QString("START TRANSACTION")));
+}
+
+
+/**
+@brief      Public slot: Commit transaction.
+@param      None.
+@return     True if transaction was committed successfully, otherwise - false.
+*/
+bool HelperMySQL::commit()
+{
+    my_bool Res = ((this->isConnected()) ? mysql_commit(mMySQL) : 1);
+
+    if(Res == 0)
+    {
+        emit sigQuerySent();
+    }
+    else
+    {
+        quint32 ErrNo  = this->getErrorNo();
+        QString ErrStr = this->getError();
+        emit sigError(ErrNo, ErrStr);
+    }
+
+    return ((Res == 0) ? true : false);
+}
+
+
+/**
+@brief      Public slot: Rollback transaction.
+@param      None.
+@return     True if transaction was rolled back successfully, otherwise - false.
+*/
+bool HelperMySQL::rollback()
+{
+    my_bool Res = ((this->isConnected()) ? mysql_rollback(mMySQL) : 1);
+
+    if(Res != 0)
+    {
+        quint32 ErrNo  = this->getErrorNo();
+        QString ErrStr = this->getError();
+        emit sigError(ErrNo, ErrStr);
+    }
+
+    return ((Res == 0) ? true : false);
+}
+
+
+/**
+@brief      Public slot: Execute prepared statement.
+@param      StmtIn - prepared statement (see getStmt());
+            BindIn - parameters (the number of placeholders).
+@return     True if statement was executed successfully, otherwise - false.
+*/
+bool HelperMySQL::sendStmt(MYSQL_STMT *StmtIn, MYSQL_BIND *BindIn)
+{
+    qint32 Res = -1;
+
+    if(this->isConnected() && StmtIn != nullptr && BindIn != nullptr)
+    {
+        if(mysql_stmt_bind_param(StmtIn, BindIn) == 0)
+        {
+            Res = mysql_stmt_execute(StmtIn);
+        }
+
+        mStmtErrNo = mysql_stmt_errno(StmtIn);
+        mStmtError = QString(mysql_stmt_error(StmtIn));
+    }
+    else
+    {
+        mStmtErrNo = HelperMySQL::ERROR__INIT;
+        mStmtError = QString("The statement is not prepared!");
+    }
+
+    if(Res == 0)
+    {
+        emit sigQuerySent();
+    }
+    else
+    {
+        emit sigError(mStmtErrNo, mStmtError);
+    }
+
+    return ((Res == 0) ? true : false);
+}
+
+
+/**
+@brief      Public slot: Close all prepared statements.
+@param      None.
+@return     None.
+*/
+void HelperMySQL::closeStmts()
+{
+    QHash<QString, MYSQL_STMT *>::iterator It;
+
+    for(It = mListStmts.begin(); It != mListStmts.end(); ++It)
+    {
+        if(It.value() != nullptr) mysql_stmt_close(It.value());
+    }
+
+    mListStmts.clear();
+}
+
+
+/**
+@brief      Public slot: Send LOAD DATA LOCAL INFILE query with data from memory.
+@param      QueryIn - SQL-query "LOAD DATA LOCAL INFILE ...";
+            DataIn - content of the file.
+@return     True if query was sent successfully, otherwise - false.
+@detailed   the data is read by the local infile handler, no temporary file is used
+            mLocalInfile must be set before connect()
+*/
+bool HelperMySQL::sendInfile(const QString &QueryIn, const QByteArray &DataIn)
+{
+    qint32 Res = -1;
+
+    if(this->isConnected() && !QueryIn.isEmpty())
+    {
+        HelperMySQLInfile Infile;
+        Infile.mData = &DataIn;
+        Infile.mPos  = 0;
+
+        QByteArray Query = QueryIn.toUtf8();
+
+        mysql_set_local_infile_handler(mMySQL, helperMySQLInfileInit, helperMySQLInfileRead, helperMySQLInfileEnd, helperMySQLInfileError, &Infile);
+        Res = mysql_real_query(mMySQL, Query.constData(), static_cast<unsigned long>(Query.size()));
+        mysql_set_local_infile_default(mMySQL);
+    }
+
+    if(Res == 0)
+    {
+        emit sigQuerySent();
+    }
+    else
+    {
+        quint32 ErrNo  = this->getErrorNo();
+        QString ErrStr = this->getError();
+        emit sigError(ErrNo, ErrStr);
+    }
+
+    return ((Res == 0) ? true : false);
+}
@@ -3,6 +3,9 @@
 
 #include <QObject>
 #include <QString>
+#include <QHash>
+#include <QByteArray>
+#include <cstring>
 #include <sys/types.h>
 
 #if defined(_WIN32) && !defined(__CYGWIN__)
@@ -34,6 +37,14 @@ public:
     */
     static const quint32 ERROR__INIT;
 
+    /**
+    @brief      Constant: Server error codes (LOAD DATA LOCAL INFILE is refused)
+    @detailed   ER_NOT_ALLOWED_COMMAND, ER_CLIENT_LOCAL_FILES_DISABLED, CR_LOAD_DATA_LOCAL_INFILE_REJECTED
+    */
+    static const quint32 ERROR__INFILE_NOT_ALLOWED;
+    static const quint32 ERROR__INFILE_DISABLED;
+    static const quint32 ERROR__INFILE_REJECTED;
+
     /**
     @brief      Constant: Host names
     */
@@ -84,6 +95,12 @@ public:
     */
     QString mCharacterSet;
 
+    /**
+    @brief      Option: Allow LOAD DATA LOCAL INFILE (see sendInfile())
+    @detailed   false by default
+    */
+    bool mLocalInfile;
+
 
     /**
     Public methods
@@ -130,6 +147,51 @@ public:
     */
     MYSQL_RES *getResultset();
 
+    /**
+    @brief      Method: Get Error code of the last prepared statement.
+    @detailed   if no errors, then returns 0
+    @param      None.
+    @return     Error code.
+    */
+    quint32 getStmtErrorNo();
+
+    /**
+    @brief      Method: Get Error message of the last prepared statement.
+    @detailed   if no errors, then returns empty string
+    @param      None.
+    @return     Error message.
+    */
+    QString getStmtError();
+
+    /**
+    @brief      Method: Get prepared statement.
+    @detailed   statements are cached by text of query until disconnect
+    @param      QueryIn - SQL-query with placeholders (?).
+    @return     Pointer to prepared statement or NULL.
+    */
+    MYSQL_STMT *getStmt(const QString &QueryIn);
+
+    /**
+    @brief      Method: Get the number of cached prepared statements.
+    @param      None.
+    @return     The number of statements.
+    */
+    int sizeStmts();
+
+    /**
+    @brief      Method: Check refusal of LOAD DATA LOCAL INFILE.
+    @param      None.
+    @return     True if the last error means that the server (or the client library) does not allow local infile, otherwise - false.
+    */
+    bool isInfileRefused();
+
+    /**
+    @brief      Method: Get the number of rows changed by the last query.
+    @param      None.
+    @return     The number of rows (INSERT, UPDATE, DELETE).
+    */
+    quint64 getAffectedRows();
+
 
 signals:
 
@@ -258,6 +320,60 @@ public slots:
     */
     bool sendQuery(const QString &QueryIn);
 
+    /**
+    @brief      Public slot: Send Query and get one value.
+    @param      QueryIn - SQL-query (SELECT);
+                ValueIn - link to value of the first column of the first row (empty if no rows or NULL).
+    @return     True if query was sent successfully, otherwise - false.
+    */
+    bool selectValue(const QString &QueryIn, QString &ValueIn);
+
+    /**
+    @brief      Public slot: Start transaction.
+    @param      None.
+    @return     True if transaction was started successfully, otherwise - false.
+    */
+    bool begin();
+
+    /**
+    @brief      Public slot: Commit transaction.
+    @param      None.
+    @return     True if transaction was committed successfully, otherwise - false.
+    */
+    bool commit();
+
+    /**
+    @brief      Public slot: Rollback transaction.
+    @param      None.
+    @return     True if transaction was rolled back successfully, otherwise - false.
+    */
+    bool rollback();
+
+    /**
+    @brief      Public slot: Execute prepared statement.
+    @param      StmtIn - prepared statement (see getStmt());
+                BindIn - parameters (the number of placeholders).
+    @return     True if statement was executed successfully, otherwise - false.
+    */
+    bool sendStmt(MYSQL_STMT *StmtIn, MYSQL_BIND *BindIn);
+
+    /**
+    @brief      Public slot: Close all prepared statements.
+    @param      None.
+    @return     None.
+    */
+    void closeStmts();
+
+    /**
+    @brief      Public slot: Send LOAD DATA LOCAL INFILE query with data from memory.
+    @param      QueryIn - SQL-query "LOAD DATA LOCAL INFILE ...";
+                DataIn - content of the file.
+    @return     True if query was sent successfully, otherwise - false.
+    @detailed   the data is read by the local infile handler, no temporary file is used
+                mLocalInfile must be set before connect()
+    */
+    bool sendInfile(const QString &QueryIn, const QByteArray &DataIn);
+
 
 private:
 
@@ -286,6 +402,21 @@ private:
                 0 for disable the locker
     */
     quint32 mLocker;
+
+    /**
+    @brief      Option: Prepared statements (query => statement)
+    */
+    QHash<QString, MYSQL_STMT *> mListStmts;
+
+    /**
+    @brief      Option: Error code of the last prepared statement
+    */
+    quint32 mStmtErrNo;
+
+    /**
+    @brief      Option: Error message of the last prepared statement
+    */
+    QString mStmtError;
 };
 
 #endif // HELPERMYSQL_H
@@ -617,6 +617,29 @@ bool Network::isListDevicesEmpty()
 }
 
 
+/**
+@brief  Get ID of a device.
+@param  IdxIn - index of list of devices (0...ListDevices.size()-1).
+@return ID or 0.
+*/
+quint16 Network::getDeviceID(const int IdxIn)
+{
+    quint16 Res  = 0;
+    quint16 Size = this->sizeListDevices();
+
+    if(IdxIn >= 0 && Size > 0)
+    {
+        if(IdxIn < Size)
+        {
+            Device *Dev = mListDevices.at(IdxIn);
+            if(Dev) Res = Dev->mID;
+        }
+    }
+
+    return (Res);
+}
+
+
 /**
 @brief  Get value of option `ArhFile` of a device.
 @param  IdxIn - index of list of devices (0...ListDevices.size()-1).
@@ -663,6 +686,52 @@ QString Network::getDeviceArhTable(const int IdxIn)
 }
 
 
+/**
+@brief  Get value of option `ArhStore` of a device.
+@param  IdxIn - index of list of devices (0...ListDevices.size()-1).
+@return Value of the option.
+*/
+bool Network::getDeviceArhStore(const int IdxIn)
+{
+    bool Res = false;
+    quint16 Size = this->sizeListDevices();
+
+    if(IdxIn >= 0 && Size > 0)
+    {
+        if(IdxIn < Size)
+        {
+            Device *Dev = mListDevices.at(IdxIn);
+            if(Dev) Res = Dev->mArhStore;
+        }
+    }
+
+    return (Res);
+}
+
+
+/**
+@brief  Get ID of register of a device by variable name.
+@param  DevID - device ID;
+@param  VarIn - variable name.
+@return ID of register or 0 if the device or the variable is not found.
+*/
+quint16 Network::getDeviceRegID(const quint16 DevID, const QString &VarIn)
+{
+    Device *Dev;
+
+    for(int i=0; i<mListDevices.size(); i++)
+    {
+        Dev = mListDevices.at(i);
+        if(Dev)
+        {
+           if(Dev->mAllow && Dev->mID == DevID) return (Dev->getRegID(VarIn));
+        }
+    }
+
+    return (0);
+}
+
+
 /**
 @brief  Get SQL-package of a Device data.
 @param  ProfileIn - name of profile;
@@ -690,6 +759,60 @@ int Network::getDeviceSql(const QString &ProfileIn, bool EventsIn, const int Idx
 }
 
 
+/**
+@brief  Get archive rows of a Device data.
+@param  ProfileIn - name of profile;
+@param  EventsIn - true for event values, false for current values;
+@param  IdxIn - index of list of devices (0...ListDevices.size()-1);
+@param  ListRowsIn - link to list of rows.
+@return The number of packed values.
+*/
+int Network::getDeviceArh(const QString &ProfileIn, bool EventsIn, const int IdxIn, QList<ArhRow> &ListRowsIn)
+{
+    int Res = 0;
+
+    quint16 Size = this->sizeListDevices();
+
+    if(IdxIn >= 0 && Size > 0)
+    {
+        if(IdxIn < Size)
+        {
+            Device *Dev = mListDevices.at(IdxIn);
+            if(Dev) Res = Dev->toArh(ProfileIn, EventsIn, ListRowsIn);
+        }
+    }
+
+    return (Res);
+}
+
+
+/**
+@brief  Evaluate events of a Device.
+@param  IdxIn - index of list of devices (0...ListDevices.size()-1);
+@param  StampIn - date and time of survey cycle (msec since epoch);
+@param  ListRowsIn - link to list of archive rows;
+@param  ListEventsIn - link to list of JSON-objects.
+@return The number of raised or cleared events.
+*/
+int Network::evaluateDeviceEvents(const int IdxIn, const qint64 StampIn, QList<ArhRow> &ListRowsIn, QJsonArray &ListEventsIn)
+{
+    int Res = 0;
+
+    quint16 Size = this->sizeListDevices();
+
+    if(IdxIn >= 0 && Size > 0)
+    {
+        if(IdxIn < Size)
+        {
+            Device *Dev = mListDevices.at(IdxIn);
+            if(Dev && Dev->mAllow) Res = Dev->evaluateEvents(StampIn, ListRowsIn, ListEventsIn);
+        }
+    }
+
+    return (Res);
+}
+
+
 /**
 @brief  Start randomized surey.
 @param  None.
@@ -719,7 +842,7 @@ bool Network::survey()
 */
 bool Network::survey(const bool RandomIn)
 {
-    Log::log(QString("Network::survey(%1)").arg(((RandomIn) ? QString("randomized") : QString("real"))), mFileLog, mUseLog);
+    LOG_DEBUG(QString("Network::survey(%1)").arg(((RandomIn) ? QString("randomized") : QString("real"))), mFileLog, mUseLog);
 
     if(this->isCorrect())
     {
@@ -734,29 +857,7 @@ bool Network::survey(const bool RandomIn)
                {
                    if(!RandomIn)
                    {
-                       if(mProtoComm == PROTO_COMM__SERIAL)
-                       {
-                           QString PortDev = ((!mSerialPortDev.isEmpty()) ? mSerialPortDev : QString(""));
-
-                           if(mProtoData == PROTO_DATA__MODBUS_RTU)
-                           {
-                               if(PortDev.isEmpty()) PortDev = ((!mSerialPortPref.isEmpty()) ? HelperModBusRTUClient::convSerialNum(mSerialPortPref, mSerialPort) : HelperModBusRTUClient::convSerialNum(mSerialPort));
-                               Dev->readRegisters(PortDev, mSerialSpd, mSerialPrty, mSerialDataBits, mSerialStopBits, mSerialMode);
-                           }
-                           else if(mProtoData == PROTO_DATA__DCON)
-                           {
-                               if(PortDev.isEmpty()) PortDev = ((!mSerialPortPref.isEmpty()) ? SerialPort::comToCode(mSerialPortPref, mSerialPort) : SerialPort::comToCode(mSerialPort));
-                               Dev->readRegisters(PortDev, mSerialSpd, mSerialPrty, mSerialDataBits, mSerialStopBits);
-                           }
-                       }
-                       else if(mProtoComm == PROTO_COMM__ETH)
-                       {
-                           Dev->readRegisters();
-                       }
-                       else
-                       {
-                           Dev->readDummyRegisters();
-                       }
+                       this->readDevice(Dev);
                    }
                    else
                    {
@@ -770,7 +871,179 @@ bool Network::survey(const bool RandomIn)
     }
     else
     {
-        Log::log(QString("The configuration is incorrect!"), mFileLog, mUseLog, false);
+        LOG_ERROR(QString("The configuration is incorrect!"), mFileLog, mUseLog, false);
+    }
+
+    return (false);
+}
+
+
+/**
+@brief  Read registers of a device.
+@param  DevIn - pointer to device.
+@return The number of registers that had been reading.
+*/
+quint16 Network::readDevice(Device *DevIn)
+{
+    quint16 Num = 0;
+
+    if(DevIn)
+    {
+        if(mProtoComm == PROTO_COMM__SERIAL)
+        {
+            QString PortDev = ((!mSerialPortDev.isEmpty()) ? mSerialPortDev : QString(""));
+
+            if(mProtoData == PROTO_DATA__MODBUS_RTU)
+            {
+                if(PortDev.isEmpty()) PortDev = ((!mSerialPortPref.isEmpty()) ? HelperModBusRTUClient::convSerialNum(mSerialPortPref, mSerialPort) : HelperModBusRTUClient::convSerialNum(mSerialPort));
+                Num = DevIn->readRegisters(PortDev, mSerialSpd, mSerialPrty, mSerialDataBits, mSerialStopBits, mSerialMode);
+            }
+            else if(mProtoData == PROTO_DATA__DCON)
+            {
+                if(PortDev.isEmpty()) PortDev = ((!mSerialPortPref.isEmpty()) ? SerialPort::comToCode(mSerialPortPref, mSerialPort) : SerialPort::comToCode(mSerialPort));
+                Num = DevIn->readRegisters(PortDev, mSerialSpd, mSerialPrty, mSerialDataBits, mSerialStopBits);
+            }
+        }
+        else if(mProtoComm == PROTO_COMM__ETH)
+        {
+            Num = DevIn->readRegisters();
+        }
+        else
+        {
+            Num = DevIn->readDummyRegisters();
+        }
+    }
+
+    return (Num);
+}
+
+
+/**
+@brief  Read data (on demand).
+@param  DevID - Device ID.
+@param  ListVarsIn - list of variable names (empty list - all registers of the device).
+@param  ObjIn - link to JsonObject-data.
+@return True if the data has read, otherwise - False.
+@detailed Only groups of registers that contain the variables are read.
+          ObjIn = { RegVar:RegValue, ... }
+*/
+bool Network::read(quint16 DevID, const QStringList &ListVarsIn, QJsonObject &ObjIn)
+{
+    LOG_DEBUG(QString("Network::read(DevID:%1,Vars:%2)").arg(QString::number(DevID), ListVarsIn.join(",")), mFileLog, mUseLog);
+
+    if(this->isCorrect())
+    {
+        Device *Dev;
+
+        for(int i=0; i<mListDevices.size(); i++)
+        {
+            Dev = mListDevices.at(i);
+            if(Dev)
+            {
+               if(Dev->mAllow && Dev->mID == DevID)
+               {
+                   QJsonObject Obj;
+                   quint16 Num;
+
+                   Dev->setReadFilter(ListVarsIn);
+                   Num = this->readDevice(Dev);
+                   Dev->clearReadFilter();
+
+                   Dev->toJson(Obj);
+
+                   if(ListVarsIn.isEmpty())
+                   {
+                       ObjIn = Obj;
+                   }
+                   else
+                   {
+                       for(int j=0; j<ListVarsIn.size(); j++)
+                       {
+                           if(Obj.contains(ListVarsIn.at(j))) ObjIn.insert(ListVarsIn.at(j), Obj.value(ListVarsIn.at(j)));
+                       }
+                   }
+
+                   return ((Num > 0) ? true : false);
+               }
+            }
+        }
+    }
+    else
+    {
+        LOG_ERROR(QString("The configuration is incorrect!"), mFileLog, mUseLog, false);
+    }
+
+    return (false);
+}
+
+
+/**
+@brief  Push current raw-values into trends of registers.
+@param  StampIn - date and time of survey cycle (msec since epoch).
+@return The number of registers that have trend.
+*/
+quint32 Network::pushTrends(const qint64 StampIn)
+{
+    quint32 Num = 0;
+    Device *Dev;
+
+    for(int i=0; i<mListDevices.size(); i++)
+    {
+        Dev = mListDevices.at(i);
+        if(Dev)
+        {
+           if(Dev->mAllow) Num+= Dev->pushTrends(StampIn);
+        }
+    }
+
+    return (Num);
+}
+
+
+/**
+@brief  Get settings of compression of archive of registers.
+@param  MapCompIn - link to map of compressions (key = DevID << 16 | RegID).
+@return The number of registers with compression.
+*/
+quint32 Network::getArhComp(QHash<quint32, ArhComp> &MapCompIn)
+{
+    quint32 Num = 0;
+    Device *Dev;
+
+    for(int i=0; i<mListDevices.size(); i++)
+    {
+        Dev = mListDevices.at(i);
+        if(Dev)
+        {
+           if(Dev->mAllow) Num+= Dev->toArhComp(MapCompIn);
+        }
+    }
+
+    return (Num);
+}
+
+
+/**
+@brief  Read trends of a device.
+@param  DevID - Device ID.
+@param  ListVarsIn - list of variable names (empty list - all registers of the device).
+@param  ObjIn - link to JsonObject-data.
+@return True if the device has trends, otherwise - False.
+@detailed ObjIn = { RegVar:[[msec, RegValue], ...], ... }
+*/
+bool Network::readTrend(quint16 DevID, const QStringList &ListVarsIn, QJsonObject &ObjIn)
+{
+    LOG_DEBUG(QString("Network::readTrend(DevID:%1,Vars:%2)").arg(QString::number(DevID), ListVarsIn.join(",")), mFileLog, mUseLog);
+
+    Device *Dev;
+
+    for(int i=0; i<mListDevices.size(); i++)
+    {
+        Dev = mListDevices.at(i);
+        if(Dev)
+        {
+           if(Dev->mAllow && Dev->mID == DevID) return ((Dev->toTrendJson(ListVarsIn, ObjIn) > 0) ? true : false);
+        }
     }
 
     return (false);
@@ -786,7 +1059,25 @@ bool Network::survey(const bool RandomIn)
 */
 bool Network::write(quint16 DevID, QJsonObject &ObjIn)
 {
-    Log::log(QString("Network::write(DevID:%1)").arg(QString::number(DevID)), mFileLog, mUseLog);
+    int Ex;
+    return (this->write(DevID, ObjIn, Ex));
+}
+
+
+/**
+@brief  Write data.
+@param  DevID - Device ID.
+@param  ObjIn - link to JsonObject-data;
+@param  ExIn - link to result of writing (see Device::getWriteException()).
+@return True if the data has written, otherwise - False.
+@detailed ObjIn = { RegVar:RegValue, ... }
+*/
+bool Network::write(quint16 DevID, QJsonObject &ObjIn, int &ExIn)
+{
+    LOG_DEBUG(QString("Network::write(DevID:%1)").arg(QString::number(DevID)), mFileLog, mUseLog);
+
+    quint16 Num = 0;
+    ExIn = -1;
 
     if(this->isCorrect())
     {
@@ -806,22 +1097,24 @@ bool Network::write(quint16 DevID, QJsonObject &ObjIn)
                        if(mProtoData == PROTO_DATA__MODBUS_RTU)
                        {
                            if(PortDev.isEmpty()) PortDev = ((!mSerialPortPref.isEmpty()) ? HelperModBusRTUClient::convSerialNum(mSerialPortPref, mSerialPort) : HelperModBusRTUClient::convSerialNum(mSerialPort));
-                           Dev->writeRegisters(PortDev, mSerialSpd, mSerialPrty, mSerialDataBits, mSerialStopBits, mSerialMode, ObjIn);
+                           Num  = Dev->writeRegisters(PortDev, mSerialSpd, mSerialPrty, mSerialDataBits, mSerialStopBits, mSerialMode, ObjIn);
+                           ExIn = Dev->getWriteException();
                        }
                    }
                    else if(mProtoComm == PROTO_COMM__ETH)
                    {
-                       Dev->writeRegisters(ObjIn);
+                       Num  = Dev->writeRegisters(ObjIn);
+                       ExIn = Dev->getWriteException();
                    }
                }
             }
         }
 
-        return (true);
+        return ((Num > 0 && ExIn == 0) ? true : false);
     }
     else
     {
-        Log::log(QString("The configuration is incorrect!"), mFileLog, mUseLog, false);
+        LOG_ERROR(QString("The configuration is incorrect!"), mFileLog, mUseLog, false);
     }
 
     return (false);
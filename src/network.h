@@ -23,6 +23,7 @@
 
 #include <QObject>
 #include <QString>
+#include <QStringList>
 #include <QFile>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -366,6 +367,13 @@ public:
     */
     bool isListDevicesEmpty();
 
+    /**
+    @brief  Get ID of a device.
+    @param  IdxIn - index of list of devices (0...ListDevices.size()-1).
+    @return ID or 0.
+    */
+    quint16 getDeviceID(const int IdxIn);
+
     /**
     @brief  Get value of option `ArhFile` of a device.
     @param  IdxIn - index of list of devices (0...ListDevices.size()-1).
@@ -380,6 +388,21 @@ public:
     */
     QString getDeviceArhTable(const int IdxIn);
 
+    /**
+    @brief  Get value of `ArhStore` of a device.
+    @param  IdxIn - index of list of devices (0...ListDevices.size()-1).
+    @return Value of the option.
+    */
+    bool getDeviceArhStore(const int IdxIn);
+
+    /**
+    @brief  Get ID of register of a device by variable name.
+    @param  DevID - device ID;
+    @param  VarIn - variable name.
+    @return ID of register or 0 if the device or the variable is not found.
+    */
+    quint16 getDeviceRegID(const quint16 DevID, const QString &VarIn);
+
     /**
     @brief  Get SQL-package of a Device data.
     @param  ProfileIn - name of profile;
@@ -390,6 +413,26 @@ public:
     */
     int getDeviceSql(const QString &ProfileIn, bool EventsIn, const int IdxIn, QList<QString> &ListStringsIn);
 
+    /**
+    @brief  Get archive rows of a Device data.
+    @param  ProfileIn - name of profile;
+    @param  EventsIn - true for event values, false for current values;
+    @param  IdxIn - index of list of devices (0...ListDevices.size()-1);
+    @param  ListRowsIn - link to list of rows.
+    @return The number of packed values.
+    */
+    int getDeviceArh(const QString &ProfileIn, bool EventsIn, const int IdxIn, QList<ArhRow> &ListRowsIn);
+
+    /**
+    @brief  Evaluate events of a Device.
+    @param  IdxIn - index of list of devices (0...ListDevices.size()-1);
+    @param  StampIn - date and time of survey cycle (msec since epoch);
+    @param  ListRowsIn - link to list of archive rows;
+    @param  ListEventsIn - link to list of JSON-objects.
+    @return The number of raised or cleared events.
+    */
+    int evaluateDeviceEvents(const int IdxIn, const qint64 StampIn, QList<ArhRow> &ListRowsIn, QJsonArray &ListEventsIn);
+
     /**
     @brief  Start randomized surey.
     @param  None.
@@ -413,6 +456,51 @@ public:
     */
     bool write(quint16 DevID, QJsonObject &ObjIn);
 
+    /**
+    @brief  Write data.
+    @param  DevID - Device ID.
+    @param  ObjIn - link to JsonObject-data;
+    @param  ExIn - link to result of writing (see Device::getWriteException()).
+    @return True if the data has written, otherwise - False.
+    @detailed ObjIn = { RegVar:RegValue, ... }
+    */
+    bool write(quint16 DevID, QJsonObject &ObjIn, int &ExIn);
+
+    /**
+    @brief  Read data (on demand).
+    @param  DevID - Device ID.
+    @param  ListVarsIn - list of variable names (empty list - all registers of the device).
+    @param  ObjIn - link to JsonObject-data.
+    @return True if the data has read, otherwise - False.
+    @detailed Only groups of registers that contain the variables are read.
+              ObjIn = { RegVar:RegValue, ... }
+    */
+    bool read(quint16 DevID, const QStringList &ListVarsIn, QJsonObject &ObjIn);
+
+    /**
+    @brief  Push current raw-values into trends of registers.
+    @param  StampIn - date and time of survey cycle (msec since epoch).
+    @return The number of registers that have trend.
+    */
+    quint32 pushTrends(const qint64 StampIn);
+
+    /**
+    @brief  Get settings of compression of archive of registers.
+    @param  MapCompIn - link to map of compressions (key = DevID << 16 | RegID).
+    @return The number of registers with compression.
+    */
+    quint32 getArhComp(QHash<quint32, ArhComp> &MapCompIn);
+
+    /**
+    @brief  Read trends of a device.
+    @param  DevID - Device ID.
+    @param  ListVarsIn - list of variable names (empty list - all registers of the device).
+    @param  ObjIn - link to JsonObject-data.
+    @return True if the device has trends, otherwise - False.
+    @detailed ObjIn = { RegVar:[[msec, RegValue], ...], ... }
+    */
+    bool readTrend(quint16 DevID, const QStringList &ListVarsIn, QJsonObject &ObjIn);
+
 
 private:
 
@@ -437,6 +525,13 @@ private:
     */
     quint16 parseDataDevices(const QJsonDocument &DocIn);
 
+    /**
+    @brief  Read registers of a device.
+    @param  DevIn - pointer to device.
+    @return The number of registers that had been reading.
+    */
+    quint16 readDevice(Device *DevIn);
+
     /**
     @brief  Start survey.
     @param  RandomIn - true if the survey is randomized.
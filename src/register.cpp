@@ -44,6 +44,16 @@ const QString Register::FIELD__ERR         = "Err";
 const QString Register::FIELD__RAND_MIN    = "RandMin";
 const QString Register::FIELD__RAND_MAX    = "RandMax";
 
+//** trend
+const QString Register::FIELD__TREND       = "Trend";
+const QString Register::FIELD__TREND_DECIM = "TrendDecim";
+
+//** compression of archive
+const QString Register::FIELD__ARH_DEADBAND     = "ArhDeadband";
+const QString Register::FIELD__ARH_DEADBAND_PCT = "ArhDeadbandPct";
+const QString Register::FIELD__ARH_SW_DOOR      = "ArhSwDoor";
+const QString Register::FIELD__ARH_MAX_INTERVAL = "ArhMaxInterval";
+
 //** device
 const QString Register::FIELD__DEV_ID      = "DevID";
 const QString Register::FIELD__DEV_CLASS   = "DevClass";
@@ -151,14 +161,24 @@ void Register::byDefault()
     mAlg           = QString("");
     mRandMin       = 0;
     mRandMax       = 0;
+    mTrendDepth    = Trend::DEPTH_OFF;
+    mTrendDecim    = Trend::DECIM_MIN;
+    mArhDeadband    = 0.0;
+    mArhDeadbandPct = 0.0;
+    mArhSwDoor      = 0.0;
+    mArhMaxInterval = 0;
     mExLast        = -1;
     mErrLast       = 0;
     mSignLast      = 0;
 
+    mEvalDone      = false;
+    mEvalValue     = 0;
+
     mListTargetsToCalc.clear();
     mListValuesToCalc.clear();
     this->clearListEvents();
     this->refreshStamp();
+    mTrend.init(Trend::DEPTH_OFF, Trend::DECIM_MIN);
 }
 
 
@@ -191,6 +211,12 @@ bool Register::fromJson(const QJsonObject &DataIn)
         mAllowRand  = mAllowMask.contains(ALLOW_CODE__RAND);
         mRandMin    = static_cast<quint16>(DataIn.value(FIELD__RAND_MIN).toInt(0));
         mRandMax    = static_cast<quint16>(DataIn.value(FIELD__RAND_MAX).toInt(0));
+        mTrendDepth = static_cast<quint32>(DataIn.value(FIELD__TREND).toInt(Trend::DEPTH_OFF));
+        mTrendDecim = static_cast<quint16>(DataIn.value(FIELD__TREND_DECIM).toInt(Trend::DECIM_MIN));
+        mArhDeadband    = DataIn.value(FIELD__ARH_DEADBAND).toDouble(0.0);
+        mArhDeadbandPct = DataIn.value(FIELD__ARH_DEADBAND_PCT).toDouble(0.0);
+        mArhSwDoor      = DataIn.value(FIELD__ARH_SW_DOOR).toDouble(0.0);
+        mArhMaxInterval = static_cast<quint32>(DataIn.value(FIELD__ARH_MAX_INTERVAL).toInt(0));
 
         QJsonArray Targets = DataIn.value(FIELD__TARGETS).toArray();
 
@@ -201,6 +227,9 @@ bool Register::fromJson(const QJsonObject &DataIn)
             if(!mFileEvents.isEmpty()) this->readFileEvents(mFileEvents);
             if(!Targets.isEmpty()) this->parseDataTargets(Targets);
         }
+
+        //the memory of trend is allocated once
+        if(mAllowHmi && mClass != CLASS__CALC) mTrend.init(mTrendDepth, mTrendDecim);
     }
 
     return (this->isCorrect());
@@ -329,6 +358,42 @@ void Register::toString(QString &StringIn)
     StringIn+= QString::number(mValue);
     StringIn+= QString("\r\n");
 
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__TREND;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(mTrendDepth);
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__TREND_DECIM;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(mTrendDecim);
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__ARH_DEADBAND;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(mArhDeadband);
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__ARH_DEADBAND_PCT;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(mArhDeadbandPct);
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__ARH_SW_DOOR;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(mArhSwDoor);
+    StringIn+= QString("\r\n");
+
+    StringIn+= QString(" - ");
+    StringIn+= FIELD__ARH_MAX_INTERVAL;
+    StringIn+= QString(" = ");
+    StringIn+= QString::number(mArhMaxInterval);
+    StringIn+= QString("\r\n");
+
     QString Buff;
     packStampISO(mStamp, Buff);
     StringIn+= QString(" - ");
@@ -417,6 +482,71 @@ void Register::toJson(QJsonObject &ObjIn)
 }
 
 
+/**
+@brief  Push the current raw-value into the trend.
+@param  StampIn - date and time of survey cycle (msec since epoch).
+@return True if the trend is on, otherwise - False.
+@detailed The trend is not kept for calculated registers (the value is not a raw word).
+*/
+bool Register::pushTrend(const qint64 StampIn)
+{
+    if(!mTrend.isEnabled()) return (false);
+
+    mTrend.push(StampIn, mValue);
+
+    return (true);
+}
+
+
+/**
+@brief  Pack the trend to JSON buffer.
+@param  ObjIn - link to JsonObject.
+@return True if the trend is on, otherwise - False.
+@detailed { ..., Register.mVar:[[msec, FormattedValue], ...] } (from the oldest sample)
+*/
+bool Register::toTrendJson(QJsonObject &ObjIn)
+{
+    if(!mTrend.isEnabled() || mVar.isEmpty()) return (false);
+
+    QJsonArray Arr;
+    QJsonValue Val;
+    int Size = mTrend.size();
+
+    for(int i=0; i<Size; i++)
+    {
+        packFormattedValue(mTrend.valueAt(i), mType, mOffset, mRound, Val);
+
+        QJsonArray Point;
+        Point.append(QJsonValue(static_cast<double>(mTrend.stampAt(i))));
+        Point.append(Val);
+        Arr.append(Point);
+    }
+
+    ObjIn.insert(mVar, QJsonValue(Arr));
+
+    return (true);
+}
+
+
+/**
+@brief  Get settings of compression of archive.
+@param  CompIn - link to compression.
+@return True if the compression is on, otherwise - False.
+@detailed Required: mAllowArh = true
+*/
+bool Register::toArhComp(ArhComp &CompIn)
+{
+    if(!mAllowArh) return (false);
+
+    CompIn.mDeadband    = ((mArhDeadband > 0.0) ? mArhDeadband : 0.0);
+    CompIn.mDeadbandPct = ((mArhDeadbandPct > 0.0) ? mArhDeadbandPct : 0.0);
+    CompIn.mSwDoor      = ((mArhSwDoor > 0.0) ? mArhSwDoor : 0.0);
+    CompIn.mMaxInterval = mArhMaxInterval;
+
+    return (CompIn.isEnabled());
+}
+
+
 /**
 @brief (static) Pack value of the register into String-buffer in SQL-format (only value).
 @param  StampIn - datetime stamp;
@@ -582,6 +712,97 @@ int Register::toSqlEventValue(const QString &ProfileIn, QList<QString> &ListStri
 }
 
 
+/**
+@brief (static) Pack value of the register into archive row.
+@param  StampIn - datetime stamp;
+@param  ProfileIn - name of profile;
+@param  DevIdIn - device ID;
+@param  RegIdIn - register ID;
+@param  ValueIn - formatted value;
+@param  ExIn - exception code;
+@param  ErrIn - error code;
+@param  SignIn - sign code;
+@param  RoundIn - round (for float);
+@param  RowIn - link to row.
+@return None.
+@detailed Binary analogue of toSqlValue() (bool is packed as 0 or 1).
+*/
+void Register::toArhValue(const QDateTime &StampIn, const QString &ProfileIn, const quint16 DevIdIn, const quint16 RegIdIn, const QJsonValue &ValueIn, const int ExIn, const int ErrIn, const int SignIn, const qint8 RoundIn, ArhRow &RowIn)
+{
+    RowIn.mStamp   = StampIn;
+    RowIn.mProfile = ProfileIn;
+    RowIn.mDevID   = DevIdIn;
+    RowIn.mRegID   = RegIdIn;
+    RowIn.mValue   = ((ValueIn.isBool()) ? ((ValueIn.toBool()) ? 1.0 : 0.0) : setRound(ValueIn.toDouble(0.0), RoundIn));
+    RowIn.mEx      = static_cast<qint32>(ExIn);
+    RowIn.mErr     = static_cast<qint32>(ErrIn);
+    RowIn.mSign    = static_cast<qint32>(SignIn);
+}
+
+
+/**
+@brief  Pack current value of the register into list of archive rows.
+@param  ProfileIn - name of profile;
+@param  ListRowsIn - link to list of rows.
+@return The number of packed values.
+@detailed Required: mAllowArh = true
+*/
+int Register::toArhCurrentValue(const QString &ProfileIn, QList<ArhRow> &ListRowsIn)
+{
+    if(mAllowArh)
+    {
+        QJsonValue Value;
+        this->packFormattedValue(Value);
+
+        ArhRow Row;
+        toArhValue(mStamp, ProfileIn, mDevID, mID, Value, mExLast, mErrLast, mSignLast, mRound, Row);
+        ListRowsIn.append(Row);
+
+        return (1);
+    }
+
+    return (0);
+}
+
+
+/**
+@brief  Pack event values of the register into list of archive rows.
+@param  ProfileIn - name of profile;
+@param  ListRowsIn - link to list of rows.
+@return The number of packed values.
+@detailed Required: mAllowArh = true
+*/
+int Register::toArhEventValue(const QString &ProfileIn, QList<ArhRow> &ListRowsIn)
+{
+    int Res = 0;
+
+    if(mAllowArh)
+    {
+        Event *Ev = nullptr;
+        QJsonValue Value;
+        ArhRow Row;
+
+        for(int i=0; i<mListEvents.size(); i++)
+        {
+            Ev = mListEvents.at(i);
+
+            if(Ev)
+            {
+                if(Ev->isReady())
+                {
+                    packFormattedValue(Ev->mValue, mType, mOffset, mRound, Value);
+                    toArhValue(Ev->getStamp(), ProfileIn, mDevID, mID, Value, Ev->mEx, Ev->mErr, Ev->mSign, mRound, Row);
+                    ListRowsIn.append(Row);
+                    Res++;
+                }
+            }
+        }
+    }
+
+    return (Res);
+}
+
+
 /**
 @brief (static) Unpack Raw-value (uint16) into Int.
 @param  RawValueIn - raw-value.
@@ -648,6 +869,40 @@ float Register::setRound(float In, qint8 RoundIn)
 }
 
 
+/**
+@brief  Round.
+@param  In - Double;
+@param  RoundIn - round;
+@return Rounded Double.
+@detailed Result = round(In, RoundIn), float-noise of widened values is dropped (12.3f -> 12.3).
+*/
+double Register::setRound(double In, qint8 RoundIn)
+{
+    if(std::floor(In) == In) return (In);
+
+    qint8 Round = RoundIn;
+    if(Round < ROUND_MIN) Round = ROUND_MIN;
+    if(Round > ROUND_MAX) Round = ROUND_MAX;
+
+    double Pow = std::pow(10.0, static_cast<double>(Round));
+    return (std::round(In*Pow)/Pow);
+}
+
+
+/**
+@brief (static) Format number of archive row for SQL.
+@param  In - value.
+@return Formatted value.
+@detailed Integral values are formatted without fraction.
+*/
+QString Register::toSqlNumber(const double In)
+{
+    if(std::floor(In) == In && std::fabs(In) < 1e15) return (QString::number(static_cast<qint64>(In)));
+
+    return (QString::number(In, 'g', 15));
+}
+
+
 /**
 @brief (static) Unpack Raw-value (uint16) into Float.
 @param  RawValueIn - raw-value;
@@ -849,6 +1104,91 @@ bool Register::isEventsReady()
 }
 
 
+/**
+@brief  Evaluate events by the current value.
+@param  StampIn - date and time of survey cycle (msec since epoch);
+@param  ListRowsIn - link to list of archive rows (for mAllowArh = true);
+@param  ListEventsIn - link to list of JSON-objects (for mAllowHmi = true).
+@return The number of raised or cleared events.
+@detailed Only a changed value (or an event waiting for debounce) is evaluated.
+          A row of a raised event has codes of the event, a row of a cleared event has codes by default.
+          ListEventsIn = [ { ID, Var, Alg, Active:0|1, Value, Stamp:msec, Ex, Err, Sign }, ... ]
+*/
+int Register::evaluateEvents(const qint64 StampIn, QList<ArhRow> &ListRowsIn, QJsonArray &ListEventsIn)
+{
+    int Res = 0;
+    int EvSize = mListEvents.size();
+    Event *Ev = nullptr;
+    int i;
+
+    if(EvSize == 0) return (0);
+
+    //calculated values depend on targets, so they are always evaluated
+    if(mEvalDone && mClass != CLASS__CALC && mValue == mEvalValue)
+    {
+        bool Pending = false;
+        for(i=0; i<EvSize && !Pending; i++)
+        {
+            Ev = mListEvents.at(i);
+            if(Ev) Pending = Ev->isPending();
+        }
+
+        if(!Pending) return (0);
+    }
+
+    mEvalDone  = true;
+    mEvalValue = mValue;
+
+    QJsonValue Value;
+    this->packFormattedValue(Value);
+    double ValueNum = ((Value.isBool()) ? ((Value.toBool()) ? 1.0 : 0.0) : Value.toDouble(0.0));
+
+    for(i=0; i<EvSize; i++)
+    {
+        Ev = mListEvents.at(i);
+
+        if(Ev)
+        {
+            if(Ev->evaluate(ValueNum, mValue, StampIn))
+            {
+                bool Active = Ev->isActive();
+                int Ex      = ((Active) ? Ev->mEx : -1);
+                int Err     = ((Active) ? Ev->mErr : 0);
+                int Sign    = ((Active) ? Ev->mSign : 0);
+
+                if(mAllowArh)
+                {
+                    ArhRow Row;
+                    toArhValue(Ev->getStamp(), QString(""), mDevID, mID, Value, Ex, Err, Sign, mRound, Row);
+                    ListRowsIn.append(Row);
+                }
+
+                if(mAllowHmi)
+                {
+                    QJsonObject Obj;
+                    Obj.insert(FIELD__ID, QJsonValue(mID));
+                    Obj.insert(FIELD__VAR, QJsonValue(mVar));
+                    Obj.insert(Event::FIELD__ALG, QJsonValue(Ev->mAlg));
+                    Obj.insert(Event::FIELD__ACTIVE, QJsonValue(((Active) ? 1 : 0)));
+                    Obj.insert(FIELD__VALUE, Value);
+                    Obj.insert(FIELD__STAMP, QJsonValue(static_cast<double>(StampIn)));
+                    Obj.insert(FIELD__EX, QJsonValue(Ex));
+                    Obj.insert(FIELD__ERR, QJsonValue(Err));
+                    Obj.insert(FIELD__SIGN, QJsonValue(Sign));
+                    ListEventsIn.append(Obj);
+                }
+
+                //the transition is delivered here, legacy readers of ready events must not repeat it
+                Ev->confirm();
+                Res++;
+            }
+        }
+    }
+
+    return (Res);
+}
+
+
 /**
 @brief  Normilize options.
 @param  None.
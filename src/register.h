@@ -21,6 +21,7 @@
 #ifndef REGISTER_H
 #define REGISTER_H
 
+#include <cmath>
 #include <QObject>
 #include <QChar>
 #include <QStringList>
@@ -39,6 +40,9 @@
 #include "global.h"
 #include "event.h"
 #include "type.h"
+#include "arh-row.h"
+#include "trend.h"
+#include "arh-comp.h"
 
 
 /**
@@ -93,6 +97,16 @@ public:
     static const QString FIELD__RAND_MIN;
     static const QString FIELD__RAND_MAX;
 
+    //** trend
+    static const QString FIELD__TREND;
+    static const QString FIELD__TREND_DECIM;
+
+    //** compression of archive
+    static const QString FIELD__ARH_DEADBAND;
+    static const QString FIELD__ARH_DEADBAND_PCT;
+    static const QString FIELD__ARH_SW_DOOR;
+    static const QString FIELD__ARH_MAX_INTERVAL;
+
     //** device
     static const QString FIELD__DEV_ID;
     static const QString FIELD__DEV_CLASS;
@@ -248,6 +262,25 @@ public:
     */
     quint16 mValue;
 
+    /**
+    @brief Depth of trend (the number of samples, 0 - off).
+    */
+    quint32 mTrendDepth;
+
+    /**
+    @brief Decimation of trend (every TrendDecim-th survey cycle).
+    */
+    quint16 mTrendDecim;
+
+    /**
+    @brief Compression of archive: absolute deadband, deadband in percent, deviation of swinging door (0 - off)
+           and maximal interval between archived rows (sec, 0 - off).
+    */
+    double mArhDeadband;
+    double mArhDeadbandPct;
+    double mArhSwDoor;
+    quint32 mArhMaxInterval;
+
     /**
     @brief Path to a file that contains list of event settings (JSON).
     */
@@ -330,6 +363,30 @@ public:
     */
     void toJson(QJsonObject &ObjIn);
 
+    /**
+    @brief  Push the current raw-value into the trend.
+    @param  StampIn - date and time of survey cycle (msec since epoch).
+    @return True if the trend is on, otherwise - False.
+    @detailed The trend is not kept for calculated registers (the value is not a raw word).
+    */
+    bool pushTrend(const qint64 StampIn);
+
+    /**
+    @brief  Pack the trend to JSON buffer.
+    @param  ObjIn - link to JsonObject.
+    @return True if the trend is on, otherwise - False.
+    @detailed { ..., Register.mVar:[[msec, FormattedValue], ...] } (from the oldest sample)
+    */
+    bool toTrendJson(QJsonObject &ObjIn);
+
+    /**
+    @brief  Get settings of compression of archive.
+    @param  CompIn - link to compression.
+    @return True if the compression is on, otherwise - False.
+    @detailed Required: mAllowArh = true
+    */
+    bool toArhComp(ArhComp &CompIn);
+
     /**
     @brief  Pack value of the register into String-buffer in SQL-format (only value).
     @param  StampIn - datetime stamp;
@@ -396,6 +453,41 @@ public:
     */
     int toSqlEventValue(const QString &ProfileIn, QList<QString> &ListStringsIn);
 
+    /**
+    @brief (static) Pack value of the register into archive row.
+    @param  StampIn - datetime stamp;
+    @param  ProfileIn - name of profile;
+    @param  DevIdIn - device ID;
+    @param  RegIdIn - register ID;
+    @param  ValueIn - formatted value;
+    @param  ExIn - exception code;
+    @param  ErrIn - error code;
+    @param  SignIn - sign code;
+    @param  RoundIn - round (for float);
+    @param  RowIn - link to row.
+    @return None.
+    @detailed Binary analogue of toSqlValue() (bool is packed as 0 or 1).
+    */
+    static void toArhValue(const QDateTime &StampIn, const QString &ProfileIn, const quint16 DevIdIn, const quint16 RegIdIn, const QJsonValue &ValueIn, const int ExIn, const int ErrIn, const int SignIn, const qint8 RoundIn, ArhRow &RowIn);
+
+    /**
+    @brief  Pack current value of the register into list of archive rows.
+    @param  ProfileIn - name of profile;
+    @param  ListRowsIn - link to list of rows.
+    @return The number of packed values.
+    @detailed Required: mAllowArh = true
+    */
+    int toArhCurrentValue(const QString &ProfileIn, QList<ArhRow> &ListRowsIn);
+
+    /**
+    @brief  Pack event values of the register into list of archive rows.
+    @param  ProfileIn - name of profile;
+    @param  ListRowsIn - link to list of rows.
+    @return The number of packed values.
+    @detailed Required: mAllowArh = true
+    */
+    int toArhEventValue(const QString &ProfileIn, QList<ArhRow> &ListRowsIn);
+
     /**
     @brief  Unpack Raw-value (uint16) into Int.
     @param  RawValueIn - raw-value.
@@ -440,6 +532,23 @@ public:
     */
     static float setRound(float In, qint8 RoundIn);
 
+    /**
+    @brief  Round.
+    @param  In - Double;
+    @param  RoundIn - round;
+    @return Rounded Double.
+    @detailed Result = round(In, RoundIn), float-noise of widened values is dropped (12.3f -> 12.3).
+    */
+    static double setRound(double In, qint8 RoundIn);
+
+    /**
+    @brief (static) Format number of archive row for SQL.
+    @param  In - value.
+    @return Formatted value.
+    @detailed Integral values are formatted without fraction.
+    */
+    static QString toSqlNumber(const double In);
+
     /**
     @brief  Unpack Raw-value (uint16) into Float.
     @param  RawValueIn - raw-value;
@@ -520,6 +629,18 @@ public:
     */
     bool isEventsReady();
 
+    /**
+    @brief  Evaluate events by the current value.
+    @param  StampIn - date and time of survey cycle (msec since epoch);
+    @param  ListRowsIn - link to list of archive rows (for mAllowArh = true);
+    @param  ListEventsIn - link to list of JSON-objects (for mAllowHmi = true).
+    @return The number of raised or cleared events.
+    @detailed Only a changed value (or an event waiting for debounce) is evaluated.
+              A row of a raised event has codes of the event, a row of a cleared event has codes by default.
+              ListEventsIn = [ { ID, Var, Alg, Active:0|1, Value, Stamp:msec, Ex, Err, Sign }, ... ]
+    */
+    int evaluateEvents(const qint64 StampIn, QList<ArhRow> &ListRowsIn, QJsonArray &ListEventsIn);
+
     /**
     @brief  Normilize options.
     @param  None.
@@ -694,6 +815,17 @@ private:
     */
     QList<Event *> mListEvents;
 
+    /**
+    @brief Trend.
+    */
+    Trend mTrend;
+
+    /**
+    @brief The last evaluated raw-value (events).
+    */
+    bool mEvalDone;
+    quint16 mEvalValue;
+
 
     /**
     Private methods
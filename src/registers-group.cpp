@@ -192,6 +192,28 @@ int RegsGroup::toSqlEventValue(const QString &ProfileIn, QList<QString> &ListStr
 }
 
 
+/**
+@brief  Pack registers into list of archive rows.
+@param  ProfileIn - name of profile;
+@param  EventsIn - true for event values, false for current values;
+@param  ListRowsIn - link to list of rows.
+@return The number of packed values.
+*/
+int RegsGroup::toArhValue(const QString &ProfileIn, bool EventsIn, QList<ArhRow> &ListRowsIn)
+{
+    int Res = 0;
+    Register *Reg = nullptr;
+
+    for(int i=0; i<mListRegisters.size(); i++)
+    {
+        Reg = mListRegisters.at(i);
+        if(Reg) Res+= ((EventsIn == true) ? Reg->toArhEventValue(ProfileIn, ListRowsIn) : Reg->toArhCurrentValue(ProfileIn, ListRowsIn));
+    }
+
+    return (Res);
+}
+
+
 /**
 @brief  Check class of the group.
 @param  ClassIn - class of a register.
@@ -381,6 +403,52 @@ Register *RegsGroup::getByID(quint16 IDIn)
 }
 
 
+/**
+@brief  Check a register by variable name.
+@param  VarIn - variable name.
+@return True if the group contains a register with the variable name, otherwise - False.
+*/
+bool RegsGroup::hasVar(const QString &VarIn)
+{
+    Register *Reg = nullptr;
+    int Len = mListRegisters.size();
+
+    for(int i=0; i<Len; i++)
+    {
+        Reg = mListRegisters.at(i);
+        if(Reg != nullptr)
+        {
+           if(Reg->mVar == VarIn) return (true);
+        }
+    }
+
+    return (false);
+}
+
+
+/**
+@brief  Get ID of register by variable name.
+@param  VarIn - variable name.
+@return ID of register or 0 if the group does not contain the variable.
+*/
+quint16 RegsGroup::getIDByVar(const QString &VarIn)
+{
+    Register *Reg = nullptr;
+    int Len = mListRegisters.size();
+
+    for(int i=0; i<Len; i++)
+    {
+        Reg = mListRegisters.at(i);
+        if(Reg != nullptr)
+        {
+           if(Reg->mVar == VarIn) return (Reg->mID);
+        }
+    }
+
+    return (0);
+}
+
+
 /**
 @brief  Get value of register by ID.
 @param  IDIn - ID of register.
@@ -538,7 +606,7 @@ quint16 RegsGroup::getValues(quint16 *ValuesIn)
 */
 quint16 RegsGroup::setValues(quint16 *ValuesIn, quint16 LenIn)
 {
-    Log::log(QString("RegsGroup::setValues(Class=%1,FirstAddr=%2,Len=%3)").arg(mClass, QString::number(this->getFirstAddr()), QString::number(LenIn)), mFileLog, mUseLog);
+    LOG_DEBUG(QString("RegsGroup::setValues(Class=%1,FirstAddr=%2,Len=%3)").arg(mClass, QString::number(this->getFirstAddr()), QString::number(LenIn)), mFileLog, mUseLog);
 
     quint16 Num = 0;
 
@@ -547,6 +615,7 @@ quint16 RegsGroup::setValues(quint16 *ValuesIn, quint16 LenIn)
         Register *Reg   = nullptr;
         int Len         = ((LenIn <= mListRegisters.size()) ? LenIn : mListRegisters.size());
         QString LogBuff = QString("");
+        bool Trace      = ((mUseLog && Log::isLevel(Log::LEVEL__TRACE)) ? true : false);
 
         for(int i=0; i<Len; i++)
         {
@@ -554,14 +623,14 @@ quint16 RegsGroup::setValues(quint16 *ValuesIn, quint16 LenIn)
 
             if(Reg)
             {
-                if(mUseLog) LogBuff+= ((i < (Len-1)) ? QString("%1 ").arg(QString::number(ValuesIn[i])) : QString("%1").arg(QString::number(ValuesIn[i])));
+                if(Trace) LogBuff+= ((i < (Len-1)) ? QString("%1 ").arg(QString::number(ValuesIn[i])) : QString("%1").arg(QString::number(ValuesIn[i])));
                 Reg->mValue = ValuesIn[i];
                 Reg->refreshStamp();
                 Num++;
             }
         }
 
-        Log::log(LogBuff, mFileLog, mUseLog, false);
+        LOG_TRACE(LogBuff, mFileLog, mUseLog, false);
     }
 
     return (Num);
@@ -714,3 +783,80 @@ quint16 RegsGroup::randomize()
 
     return (Num);
 }
+
+
+/**
+@brief  Push current raw-values into trends of registers.
+@param  StampIn - date and time of survey cycle (msec since epoch).
+@return The number of registers that have trend.
+*/
+quint16 RegsGroup::pushTrends(const qint64 StampIn)
+{
+    quint16 Num = 0;
+    Register *Reg = nullptr;
+
+    for(int i=0; i<mListRegisters.size(); i++)
+    {
+        Reg = mListRegisters.at(i);
+        if(Reg)
+        {
+            if(Reg->pushTrend(StampIn)) Num++;
+        }
+    }
+
+    return (Num);
+}
+
+
+/**
+@brief  Pack trends of registers to JSON buffer.
+@param  ListVarsIn - list of variable names (empty list - all registers);
+@param  ObjIn - link to JsonObject.
+@return The number of packed trends.
+@detailed ObjIn = { RegVar:[[msec, RegValue], ...], ... }
+*/
+quint16 RegsGroup::toTrendJson(const QStringList &ListVarsIn, QJsonObject &ObjIn)
+{
+    quint16 Num = 0;
+    Register *Reg = nullptr;
+
+    for(int i=0; i<mListRegisters.size(); i++)
+    {
+        Reg = mListRegisters.at(i);
+        if(Reg)
+        {
+            if(!ListVarsIn.isEmpty() && !ListVarsIn.contains(Reg->mVar)) continue;
+            if(Reg->toTrendJson(ObjIn)) Num++;
+        }
+    }
+
+    return (Num);
+}
+
+
+/**
+@brief  Get settings of compression of archive of registers.
+@param  MapCompIn - link to map of compressions (key = DevID << 16 | RegID).
+@return The number of registers with compression.
+*/
+quint16 RegsGroup::toArhComp(QHash<quint32, ArhComp> &MapCompIn)
+{
+    quint16 Num = 0;
+    Register *Reg = nullptr;
+
+    for(int i=0; i<mListRegisters.size(); i++)
+    {
+        Reg = mListRegisters.at(i);
+        if(Reg)
+        {
+            ArhComp Comp;
+            if(Reg->toArhComp(Comp))
+            {
+                MapCompIn.insert(((static_cast<quint32>(Reg->mDevID) << 16) | Reg->mID), Comp);
+                Num++;
+            }
+        }
+    }
+
+    return (Num);
+}
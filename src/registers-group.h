@@ -21,6 +21,8 @@
 #ifndef REGS_GROUP_H
 #define REGS_GROUP_H
 
+#include <QHash>
+
 #include "log.h"
 #include "register.h"
 
@@ -131,6 +133,15 @@ public:
     */
     int toSqlEventValue(const QString &ProfileIn, QList<QString> &ListStringsIn);
 
+    /**
+    @brief  Pack registers into list of archive rows.
+    @param  ProfileIn - name of profile;
+    @param  EventsIn - true for event values, false for current values;
+    @param  ListRowsIn - link to list of rows.
+    @return The number of packed values.
+    */
+    int toArhValue(const QString &ProfileIn, bool EventsIn, QList<ArhRow> &ListRowsIn);
+
     /**
     @brief  Check class of the group.
     @param  ClassIn - class of a register.
@@ -242,6 +253,20 @@ public:
     */
     QList<quint16 *> getValuesByID(const QList<quint16> &ListIDsIn);
 
+    /**
+    @brief  Check a register by variable name.
+    @param  VarIn - variable name.
+    @return True if the group contains a register with the variable name, otherwise - False.
+    */
+    bool hasVar(const QString &VarIn);
+
+    /**
+    @brief  Get ID of register by variable name.
+    @param  VarIn - variable name.
+    @return ID of register or 0 if the group does not contain the variable.
+    */
+    quint16 getIDByVar(const QString &VarIn);
+
     /**
     @brief  Get all registers of the group.
     @param  None.
@@ -340,6 +365,29 @@ public:
     */
     quint16 randomize();
 
+    /**
+    @brief  Push current raw-values into trends of registers.
+    @param  StampIn - date and time of survey cycle (msec since epoch).
+    @return The number of registers that have trend.
+    */
+    quint16 pushTrends(const qint64 StampIn);
+
+    /**
+    @brief  Pack trends of registers to JSON buffer.
+    @param  ListVarsIn - list of variable names (empty list - all registers);
+    @param  ObjIn - link to JsonObject.
+    @return The number of packed trends.
+    @detailed ObjIn = { RegVar:[[msec, RegValue], ...], ... }
+    */
+    quint16 toTrendJson(const QStringList &ListVarsIn, QJsonObject &ObjIn);
+
+    /**
+    @brief  Get settings of compression of archive of registers.
+    @param  MapCompIn - link to map of compressions (key = DevID << 16 | RegID).
+    @return The number of registers with compression.
+    */
+    quint16 toArhComp(QHash<quint32, ArhComp> &MapCompIn);
+
 
 private:
 
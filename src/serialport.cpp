@@ -84,6 +84,7 @@ SerialPort::SerialPort(QObject *parent) : QObject(parent)
 
     mError           = QSerialPort::NoError;
     mWaitReadyRead   = 10000;
+    mReplayOpened    = false;
 
     //connect(&mPort, SIGNAL(error(QSerialPort::SerialPortError)), this, SLOT(handleMainPortErrors(QSerialPort::SerialPortError)));
     //connect(&mPort, SIGNAL(readyRead()), this, SLOT(read()));
@@ -285,7 +286,7 @@ QSerialPort::FlowControl SerialPort::flowctrlToCode(const QString &ValueIn)
 */
 bool SerialPort::isOpened()
 {
-    return (mPort.isOpen());
+    return (((mReplayOpened || mPort.isOpen()) ? true : false));
 }
 
 
@@ -296,6 +297,8 @@ bool SerialPort::isOpened()
 */
 QSerialPort::SerialPortError SerialPort::getError()
 {
+    if(mReplayOpened) return (mError);
+
     mError = mPort.error();
 
     return (mError);
@@ -336,6 +339,15 @@ bool SerialPort::open(QIODevice::OpenMode OpenModeIn)
        this->close();
     }
 
+    //replay: the bus is not used
+    if(Capture::isReplay())
+    {
+        mReplayOpened = true;
+        mError        = QSerialPort::NoError;
+        emit sigPortOpened();
+        return (true);
+    }
+
     mPort.setPortName(mPortN);
 
     if(mPort.setBaudRate(mPortSpeed) &&
@@ -376,7 +388,9 @@ void SerialPort::close()
 {
     if(this->isOpened())
     {
-        mPort.close();
+        if(mReplayOpened) mReplayOpened = false;
+        else              mPort.close();
+
         emit sigPortClosed();
     }
 }
@@ -391,7 +405,16 @@ qint64 SerialPort::write(const QByteArray &DataIn)
 {
     qint64 NumBytes = 0;
 
-    if(this->isOpened()) NumBytes = mPort.write(DataIn);
+    mRequest = DataIn;
+
+    if(mReplayOpened)
+    {
+        NumBytes = DataIn.size();
+    }
+    else if(this->isOpened())
+    {
+        NumBytes = mPort.write(DataIn);
+    }
 
     return (NumBytes);
 }
@@ -406,13 +429,25 @@ QByteArray SerialPort::read()
 {
     mInputBuff.clear();
 
-    if(this->isOpened())
+    if(mReplayOpened)
+    {
+        qint32 Res   = 0;
+        qint32 ErrNo = QSerialPort::TimeoutError;
+
+        if(!Capture::replay(Capture::PROTO__DCON, mPortN, mRequest, Res, ErrNo, mInputBuff)) ErrNo = QSerialPort::TimeoutError;
+        mError = static_cast<QSerialPort::SerialPortError>(ErrNo);
+
+        emit sigPortReadyRead(mInputBuff);
+    }
+    else if(this->isOpened())
     {
         qint16 WaitReadyRead = ((mWaitReadyRead > 0) ? mWaitReadyRead : 1000);
         mInputBuff = mPort.readAll();
 
         while(mPort.waitForReadyRead(WaitReadyRead)) mInputBuff += mPort.readAll();
 
+        if(Capture::isCapture()) Capture::record(Capture::PROTO__DCON, mPortN, mRequest, mInputBuff.size(), mPort.error(), mInputBuff);
+
         emit sigPortReadyRead(mInputBuff);
     }
 
@@ -28,6 +28,8 @@
 #include <QIODevice>
 #include <QtSerialPort/QSerialPort>
 
+#include "capture.h"
+
 
 /**
 @brief   Serial port.
@@ -328,6 +330,16 @@ private:
     */
     QByteArray mInputBuff;
 
+    /**
+    @brief  Last written request (for capture and replay)
+    */
+    QByteArray mRequest;
+
+    /**
+    @brief  Replay: the port is "opened" (the bus is not used)
+    */
+    bool mReplayOpened;
+
 
 private slots:
 
@@ -42,7 +42,16 @@ Server::Server(QString ConfigFileIn, QString LogOutFileIn, QObject *parent) : QO
 {
     mConfigFile      = ConfigFileIn;
     mSurveyTimer     = new QTimer(this);
+    mPingTimer       = new QTimer(this);
     mWebSocketServer = nullptr;
+    mArh             = nullptr;
+    mArhEvent        = nullptr;
+    mArhEventThread  = nullptr;
+    mHistPool        = new QThreadPool(this);
+
+    mEventSeq        = 0;
+
+    qRegisterMetaType<QList<SnapshotDevice> >("QList<SnapshotDevice>");
 
     if(!LogOutFileIn.isEmpty())
     {
@@ -51,8 +60,10 @@ Server::Server(QString ConfigFileIn, QString LogOutFileIn, QObject *parent) : QO
     }
 
     connect(mSurveyTimer, &QTimer::timeout, this, &Server::startSurvey);
+    connect(mPingTimer, &QTimer::timeout, this, &Server::pingCli);
     connect(this, &Server::surveyCompleted, this, &Server::sendSurveyDataToCli);
     connect(this, &Server::surveyDataToCliSent, this, &Server::startSurveyDelay);
+    connect(&mConfig, &Config::networkSurveyed, this, &Server::evaluateEvents);
 }
 
 
@@ -65,6 +76,10 @@ Server::~Server()
 {
     this->stop();
     delete mSurveyTimer;
+    delete mPingTimer;
+    delete mHistPool;
+    Capture::stop();
+    Log::stop();
 }
 
 
@@ -90,19 +105,64 @@ bool Server::initArhThread()
     {
         Log::log(QString("Server::initArhThread()"), mConfig.mFileLog, mConfig.mUseLog);
 
-        mArh = new Archive(&mConfig.mListNetworks, Archive::MODE__PERIODIC);
-        mArh->readFileConfig(mConfig.mFileArh);
+        //all profiles read the same snapshot, each one in its own thread
+        int Size = Archive::sizeProfiles(mConfig.mFileArh);
+
+        for(int i=0; i<Size; i++)
+        {
+            Archive *Arh = new Archive(&mConfig.mListNetworks, Archive::MODE__PERIODIC);
+            Arh->readFileConfig(mConfig.mFileArh, i, mConfig.mUseEvent);
+
+            QThread *Thread = new QThread();
+            Arh->moveToThread(Thread);
+
+            connect(Thread, &QThread::started, Arh, &Archive::start);
+            connect(this, &Server::stopped, Arh, &Archive::stop);
+            connect(this, &Server::surveyCompleted, Arh, &Archive::accumulate);
+            //the thread is quit directly, so stop() can wait for it
+            connect(Arh, &Archive::sigStopped, Thread, &QThread::quit, Qt::DirectConnection);
+            connect(Thread, &QThread::finished, Arh, &Archive::deleteLater);
+            connect(Thread, &QThread::finished, Thread, &QThread::deleteLater);
+
+            mListArh.append(Arh);
+            mListArhThreads.append(Thread);
+            Thread->start();
+        }
+
+        mArh = ((mListArh.isEmpty()) ? nullptr : mListArh.first());
+
+        return (!mListArh.isEmpty());
+    }
+
+    return (false);
+}
+
+
+/**
+@brief  Init. thread of Archive (event).
+@param  None.
+@return True if OK, otherwise - False.
+*/
+bool Server::initArhEventThread()
+{
+    if(mConfig.mUseEvent && !mConfig.mFileArh.isEmpty())
+    {
+        Log::log(QString("Server::initArhEventThread()"), mConfig.mFileLog, mConfig.mUseLog);
+
+        mArhEvent = new Archive(&mConfig.mListNetworks, Archive::MODE__EVENT);
+        mArhEvent->readFileConfig(mConfig.mFileArh);
 
-        mArhThread = new QThread();
-        mArh->moveToThread(mArhThread);
+        mArhEventThread = new QThread();
+        mArhEvent->moveToThread(mArhEventThread);
 
-        connect(mArhThread, &QThread::started, mArh, &Archive::start);
-        connect(this, &Server::stopped, mArh, &Archive::stop);
-        connect(mArh, &Archive::sigStopped, mArhThread, &QThread::quit);
-        connect(mArhThread, &QThread::finished, mArh, &Archive::deleteLater);
-        connect(mArhThread, &QThread::finished, mArhThread, &QThread::deleteLater);
+        connect(mArhEventThread.data(), &QThread::started, mArhEvent, &Archive::start);
+        connect(this, &Server::stopped, mArhEvent, &Archive::stop);
+        connect(this, &Server::eventsDetected, mArhEvent, &Archive::addEvents);
+        connect(mArhEvent, &Archive::sigStopped, mArhEventThread.data(), &QThread::quit, Qt::DirectConnection);
+        connect(mArhEventThread.data(), &QThread::finished, mArhEvent, &Archive::deleteLater);
+        connect(mArhEventThread.data(), &QThread::finished, mArhEventThread.data(), &QThread::deleteLater);
 
-        mArhThread->start();
+        mArhEventThread->start();
 
         return (true);
     }
@@ -111,6 +171,33 @@ bool Server::initArhThread()
 }
 
 
+/**
+@brief  Init. capture or replay of bus traffic.
+@param  None.
+@return True if capture or replay is started, otherwise - False.
+*/
+bool Server::initCapture()
+{
+    if(!mConfig.mFileReplay.isEmpty())
+    {
+        bool Res = Capture::startReplay(mConfig.mFileReplay, mConfig.mReplayLoop);
+        Log::log(QString("Server::initCapture(replay %1) = %2 records").arg(mConfig.mFileReplay, QString::number(Capture::size())), mConfig.mFileLog, mConfig.mUseLog);
+        return (Res);
+    }
+
+    if(!mConfig.mFileCapture.isEmpty())
+    {
+        bool Res = Capture::startCapture(mConfig.mFileCapture);
+        Log::log(QString("Server::initCapture(capture %1) = %2").arg(mConfig.mFileCapture, ((Res) ? QString("OK") : QString("Error"))), mConfig.mFileLog, mConfig.mUseLog);
+        return (Res);
+    }
+
+    Capture::stop();
+
+    return (false);
+}
+
+
 /**
 @brief  Init. thread of WebSocket-server.
 @param  None.
@@ -130,11 +217,19 @@ bool Server::initWsThread()
             Log::log(QString("WebSocketServer '%1' is listening on port %2").arg(mWebSocketServer->serverName(), QString::number(mWebSocketServer->serverPort())), mConfig.mFileLog, mConfig.mUseLog);
             connect(mWebSocketServer, &QWebSocketServer::newConnection, this, &Server::cliConnected);
 
+            if(mConfig.mPingInterval != Config::PING_INTERVAL_OFF)
+            {
+                mPingTimer->setInterval(static_cast<int>(mConfig.mPingInterval));
+                mPingTimer->setSingleShot(false);
+                mPingTimer->start();
+                mPingTick.start();
+            }
+
             return (true);
         }
         else
         {
-            Log::log(QString("WebSocketServer has terminated with error! %1").arg(mWebSocketServer->errorString()), mConfig.mFileLog, mConfig.mUseLog);
+            LOG_ERROR(QString("WebSocketServer has terminated with error! %1").arg(mWebSocketServer->errorString()), mConfig.mFileLog, mConfig.mUseLog);
         }
     }
 
@@ -175,11 +270,25 @@ bool Server::start()
 {
     if(this->readConfig())
     {
+        Log::setLevel(mConfig.mLogLevel);
+        Log::initSignals();
+
+        //rotation is used by the writer and by immediate writing (LogFlush = 0)
+        Log::setRotation(static_cast<qint64>(mConfig.mLogMaxSize)*1024, mConfig.mLogDaily, mConfig.mLogKeep, mConfig.mLogGzip);
+
+        if(mConfig.mUseLog && mConfig.mLogFlush != Config::LOG_FLUSH_OFF)
+        {
+            Log::start(mConfig.mLogBuff, static_cast<int>(mConfig.mLogFlush), mConfig.mLogBlock);
+        }
+
         Log::log(QString("Server::start()"), mConfig.mFileLog, mConfig.mUseLog);
 
+        this->initCapture();
+
         this->initWsCli();
         this->initWsThread();
         this->initArhThread();
+        this->initArhEventThread();
 
         if(mConfig.mFirstSurveyNow)
         {
@@ -209,12 +318,34 @@ bool Server::stop()
     Log::log(QString("Server::stop()"), mConfig.mFileLog, mConfig.mUseLog);
 
     if(mSurveyTimer->isActive()) mSurveyTimer->stop();
+    if(mPingTimer->isActive()) mPingTimer->stop();
 
     this->stopWsThread();
     mWsClients.clear();
 
+    qDeleteAll(mCliMsg);
+    mCliMsg.clear();
+
+    //queries of history read the store of Archive
+    mHistPool->clear();
+    mHistPool->waitForDone();
+
     emit stopped();
 
+    //archives log and write DB until they are stopped (Log::stop() is called after)
+    for(int i=0; i<mListArhThreads.size(); i++)
+    {
+        if(mListArhThreads.at(i)) mListArhThreads.at(i)->wait();
+    }
+
+    if(mArhEventThread) mArhEventThread->wait();
+
+    mArh      = nullptr;
+    mListArh.clear();
+    mListArhThreads.clear();
+    mArhEvent = nullptr;
+    mArhEventThread = nullptr;
+
     return (true);
 }
 
@@ -232,15 +363,7 @@ bool Server::hasCliBlocked(QWebSocket *WebSocketIn)
         {
             if(this->size(WebSocketIn->peerAddress()) < mConfig.mConnPerCli)
             {
-                QString Key = WebSocketIn->peerAddress().toString();
-
-                if(mConfig.mListWsBlack.contains(Key))
-                {
-                    quint16 BloPort = mConfig.mListWsBlack.value(Key, static_cast<quint16>(0));
-                    quint16 CliPort = WebSocketIn->peerPort();
-                    if(BloPort == 0 || BloPort == CliPort) return (true);
-                }
-                return (false);
+                return (mConfig.isBlocked(WebSocketIn->peerAddress(), WebSocketIn->peerPort()));
             }
         }
         return (true);
@@ -254,10 +377,11 @@ bool Server::hasCliBlocked(QWebSocket *WebSocketIn)
 @brief  Check life-time.
 @param  ClientIn - connected client.
 @return true - expired, false - not expired.
+@detailed Is not used (always false) if ping is on.
 */
 bool Server::hasCliTimeExpired(Client *ClientIn)
 {
-    if(ClientIn && mConfig.mConnLifeTime > Config::CONN_LIFE_TIME_MIN)
+    if(ClientIn && mConfig.mPingInterval == Config::PING_INTERVAL_OFF && mConfig.mConnLifeTime > Config::CONN_LIFE_TIME_MIN)
     {
         QDateTime CurrentStamp = QDateTime::currentDateTime();
         QDateTime ClientStamp  = ClientIn->getStampActivity(static_cast<qint16>(mConfig.mConnLifeTime));
@@ -336,6 +460,32 @@ void Server::disconnectMarkedCli()
 }
 
 
+/**
+@brief  Get client by ID.
+@param  IdIn - ID of client (see Client::mID).
+@return Pointer to Client or nullptr.
+*/
+Client *Server::getCli(const quint64 IdIn)
+{
+    if(!mClients.isEmpty())
+    {
+        Client *pClient = nullptr;
+        int Size = mClients.size();
+
+        for(int i=0; i<Size; i++)
+        {
+            pClient = mClients.at(i);
+            if(pClient)
+            {
+                 if(pClient->mID == IdIn) return (pClient);
+            }
+        }
+    }
+
+    return (nullptr);
+}
+
+
 /**
 @brief  Get client by WebSocket pointer.
 @param  WebSocketIn - connected client (WebSocket).
@@ -407,11 +557,14 @@ void Server::cliConnected()
     if(!this->hasCliBlocked(pClient->mWebSocket))
     {
         pClient->mWebSocket->setParent(this);
+        pClient->mRole = mConfig.getRole(pClient->mWebSocket->peerAddress());
         connect(pClient->mWebSocket, &QWebSocket::disconnected, this, &Server::cliDisconnected);
         connect(pClient->mWebSocket, &QWebSocket::textMessageReceived, this, &Server::cliProcessMessage);
+        connect(pClient->mWebSocket, &QWebSocket::pong, this, &Server::cliPong);
         mClients << pClient;
-        Log::log(QString("%1 has connected").arg(getPeerID(pClient->mWebSocket)), mConfig.mFileLog, mConfig.mUseLog, false);
+        Log::log(QString("%1 has connected (%2)").arg(getPeerID(pClient->mWebSocket), ((pClient->mRole == Config::ROLE__MANAGER) ? Config::ROLE__MANAGER_STR : Config::ROLE__VIEWER_STR)), mConfig.mFileLog, mConfig.mUseLog, false);
         Log::log(QString("clients = %1").arg(QString::number(mClients.size())), mConfig.mFileLog, mConfig.mUseLog, false);
+        this->sendSnapshotToCli(pClient);
     }
     else
     {
@@ -449,16 +602,108 @@ void Server::cliDisconnected()
 */
 void Server::cliProcessMessage(const QString &MessageIn)
 {
-    Log::log(QString("Server::cliProcessMessage()"), mConfig.mFileLog, mConfig.mUseLog);
+    LOG_DEBUG(QString("Server::cliProcessMessage()"), mConfig.mFileLog, mConfig.mUseLog);
 
     QWebSocket *pSender = qobject_cast<QWebSocket *>(sender());
     Client *pClient     = this->getCli(pSender);
 
     if(pClient)
     {
-        mCliMsg.append(MessageIn);
-        Log::log(QString("%1 has send message").arg(getPeerID(pClient->mWebSocket)), mConfig.mFileLog, mConfig.mUseLog, false);
-        Log::log(MessageIn, mConfig.mFileLog, mConfig.mUseLog, false);
+        pClient->refreshPing();
+        LOG_DEBUG(QString("%1 has send message").arg(getPeerID(pClient->mWebSocket)), mConfig.mFileLog, mConfig.mUseLog, false);
+        LOG_DEBUG(MessageIn, mConfig.mFileLog, mConfig.mUseLog, false);
+
+        QJsonObject Obj = QJsonDocument::fromJson(MessageIn.toUtf8()).object();
+        QString Cmd     = Obj.value(Config::FIELD__CMD).toString(Config::CMD__WRITE);
+
+        if(Cmd == Config::CMD__READ)
+        {
+            //the survey is performed by this thread, so the bus is free now
+            this->read(pClient, Obj);
+        }
+        else if(Cmd == Config::CMD__HISTORY)
+        {
+            this->history(pClient, Obj);
+        }
+        else if(Cmd == Config::CMD__TREND)
+        {
+            this->trend(pClient, Obj);
+        }
+        else if(Cmd == Config::CMD__EVENT)
+        {
+            this->event(pClient, Obj);
+        }
+        else
+        {
+            mCliMsg.append(new ClientMsg(pClient->mWebSocket, MessageIn));
+        }
+    }
+}
+
+
+/**
+@brief  Pong from the client.
+@param  ElapsedTimeIn - roundtrip time (msec);
+@param  PayloadIn - payload of ping.
+@return None.
+*/
+void Server::cliPong(quint64 ElapsedTimeIn, const QByteArray &PayloadIn)
+{
+    Q_UNUSED(ElapsedTimeIn);
+    Q_UNUSED(PayloadIn);
+
+    QWebSocket *pSender = qobject_cast<QWebSocket *>(sender());
+    Client *pClient     = this->getCli(pSender);
+
+    if(pClient) pClient->refreshPing();
+}
+
+
+/**
+@brief  Ping connected clients.
+@param  None.
+@return None.
+@detailed Clients that missed PingMiss pong are disconnected.
+          The tick is skipped if the interval is overrun (the main thread was blocked by a survey):
+          pong could not be read then, so it is not counted as missed.
+*/
+void Server::pingCli()
+{
+    qint64 Elapsed = mPingTick.restart();
+
+    if(Elapsed > static_cast<qint64>(mConfig.mPingInterval)*3/2)
+    {
+        LOG_DEBUG(QString("Ping is skipped (%1 msec since the last ping)").arg(QString::number(Elapsed)), mConfig.mFileLog, mConfig.mUseLog);
+        return;
+    }
+
+    if(!mClients.isEmpty())
+    {
+        Client *pClient = nullptr;
+        int Size = mClients.size();
+
+        for(int i=0; i<Size; i++)
+        {
+            pClient = mClients.at(i);
+
+            if(pClient)
+            {
+                if(pClient->mWebSocket->state() != QAbstractSocket::ConnectedState) continue;
+
+                if(pClient->getPingMissed() >= mConfig.mPingMiss)
+                {
+                    Log::log(QString("%1 has missed %2 pong").arg(getPeerID(pClient->mWebSocket), QString::number(pClient->getPingMissed())), mConfig.mFileLog, mConfig.mUseLog, false);
+                    pClient->refreshPing();
+                    mClientsMarked.append(pClient);
+                }
+                else
+                {
+                    pClient->ping();
+                }
+            }
+        }
+
+        this->disconnectMarkedCli();
     }
 }
 
@@ -491,6 +736,7 @@ void Server::initWsCli()
                 pClient->mWebSocket = new QWebSocket(Uri);
                 pClient->mWebSocket->setParent(this);
                 connect(pClient->mWebSocket, &QWebSocket::disconnected, this, &Server::cliDisconnected);
+                connect(pClient->mWebSocket, &QWebSocket::pong, this, &Server::cliPong);
                 mClients << pClient;
             }
         }
@@ -498,34 +744,250 @@ void Server::initWsCli()
 }
 
 
+/**
+@brief  Send last-known survey data to a client.
+@param  ClientIn - connected client.
+@return None.
+@detailed The cached data is completed by field "Age" (msec), a new survey is not started.
+*/
+void Server::sendSnapshotToCli(Client *ClientIn)
+{
+    std::shared_ptr<const Snapshot> Snap = Snapshot::get();
+
+    if(ClientIn && Snap && !Snap->mJson.isEmpty())
+    {
+        if(ClientIn->mWebSocket->state() == QAbstractSocket::ConnectedState)
+        {
+            qint64 Age = QDateTime::currentMSecsSinceEpoch()-Snap->mStamp;
+
+            //insert "Age" as first field of the cached JSON-object (without re-encoding)
+            QStringRef Rest = Snap->mJson.midRef(1);
+            bool Empty = Rest.trimmed().startsWith(QChar('}'));
+
+            QString Data = QString("{\"%1\":%2").arg(Config::FIELD__AGE, QString::number(Age));
+            if(!Empty) Data+= QString(",");
+            Data+= Rest;
+
+            ClientIn->mWebSocket->sendTextMessage(Data);
+            LOG_DEBUG(QString("%1 has received last-known data (age %2 msec)").arg(getPeerID(ClientIn->mWebSocket), QString::number(Age)), mConfig.mFileLog, mConfig.mUseLog, false);
+        }
+    }
+}
+
+
 /**
 @brief  Write data.
 @param  None.
 @return None.
+@detailed If a message has ReqID, then the reply is sent to the client.
 */
 void Server::write()
 {
-    Log::log(QString("Server::write(start)"), mConfig.mFileLog, mConfig.mUseLog);
+    LOG_DEBUG(QString("Server::write(start)"), mConfig.mFileLog, mConfig.mUseLog);
 
     if(!mCliMsg.isEmpty())
     {
         bool Res;
         int  Len = mCliMsg.size();
-        QString CliMsg;
+        ClientMsg *CliMsg;
+        QJsonObject Reply;
 
         for(int i=0; i<Len; i++)
         {
             CliMsg = mCliMsg.takeFirst();
-            Res = mConfig.write(CliMsg);
+            if(!CliMsg) continue;
+
+            Reply = QJsonObject();
+            Res   = mConfig.write(CliMsg->mMsg, Reply);
             if(Res)
             {
-                Log::log(QString("Server::write(done)"), mConfig.mFileLog, mConfig.mUseLog);
+                LOG_DEBUG(QString("Server::write(done)"), mConfig.mFileLog, mConfig.mUseLog);
+            }
+
+            //acknowledge
+            if(Reply.contains(Config::FIELD__REQ_ID) && CliMsg->mWebSocket)
+            {
+                if(CliMsg->mWebSocket->state() == QAbstractSocket::ConnectedState)
+                {
+                    Reply.insert(Config::FIELD__LATENCY, QJsonValue(CliMsg->getLatency()));
+                    QJsonDocument Doc(Reply);
+                    CliMsg->mWebSocket->sendTextMessage(QString(Doc.toJson(QJsonDocument::Compact)));
+                }
             }
+
+            delete CliMsg;
+        }
+    }
+}
+
+
+/**
+@brief  Read data on demand of a client.
+@param  ClientIn - connected client;
+@param  ObjIn - request message.
+@return None.
+@detailed The reply is sent only to the client.
+*/
+void Server::read(Client *ClientIn, const QJsonObject &ObjIn)
+{
+    LOG_DEBUG(QString("Server::read()"), mConfig.mFileLog, mConfig.mUseLog);
+
+    if(ClientIn && mConfig.isCorrect())
+    {
+        QJsonObject Reply;
+        mConfig.readData(ObjIn, Reply);
+
+        if(ClientIn->mWebSocket->state() == QAbstractSocket::ConnectedState)
+        {
+            QJsonDocument Doc(Reply);
+            ClientIn->mWebSocket->sendTextMessage(QString(Doc.toJson(QJsonDocument::Compact)));
+        }
+    }
+}
+
+
+/**
+@brief  Read trends on demand of a client.
+@param  ClientIn - connected client;
+@param  ObjIn - request message.
+@return None.
+@detailed The reply is sent only to the client.
+*/
+void Server::trend(Client *ClientIn, const QJsonObject &ObjIn)
+{
+    LOG_DEBUG(QString("Server::trend()"), mConfig.mFileLog, mConfig.mUseLog);
+
+    if(ClientIn && mConfig.isCorrect())
+    {
+        QJsonObject Reply;
+        mConfig.readTrend(ObjIn, Reply);
+
+        if(ClientIn->mWebSocket->state() == QAbstractSocket::ConnectedState)
+        {
+            QJsonDocument Doc(Reply);
+            ClientIn->mWebSocket->sendTextMessage(QString(Doc.toJson(QJsonDocument::Compact)));
         }
     }
 }
 
 
+/**
+@brief  Subscribe a client to events of registers.
+@param  ClientIn - connected client;
+@param  ObjIn - request message.
+@return None.
+@detailed ObjIn = { SrvID, Cmd:"event", ReqID, Sub:0|1, Seq:n }
+          Reply = { SrvID, Cmd:"event", ReqID, Res:0|1, Seq:n }
+          Kept messages after Seq (the last sequence number received by the client) are sent again after the reply,
+          Res = 0 if some of them are not kept anymore (the client should read the current data).
+*/
+void Server::event(Client *ClientIn, const QJsonObject &ObjIn)
+{
+    LOG_DEBUG(QString("Server::event()"), mConfig.mFileLog, mConfig.mUseLog);
+
+    if(ClientIn)
+    {
+        ClientIn->mSubEvents = ((ObjIn.value(Config::FIELD__SUB).toInt(1)) ? true : false);
+
+        //sequence number of the first kept message
+        quint64 First = mEventSeq - static_cast<quint64>(mEventBuff.size()) + 1;
+        qint64 Seq    = static_cast<qint64>(ObjIn.value(Config::FIELD__SEQ).toDouble(-1.0));
+        bool Res      = true;
+        int From      = mEventBuff.size();
+
+        if(ClientIn->mSubEvents && Seq >= 0 && static_cast<quint64>(Seq) < mEventSeq)
+        {
+            if(static_cast<quint64>(Seq) + 1 < First)
+            {
+                Res  = false;
+                From = 0;
+            }
+            else
+            {
+                From = static_cast<int>(static_cast<quint64>(Seq) + 1 - First);
+            }
+        }
+
+        QJsonObject Reply;
+        Reply.insert(Config::FIELD__SRV_ID, QJsonValue(mConfig.mID));
+        Reply.insert(Config::FIELD__CMD, QJsonValue(Config::CMD__EVENT));
+        Reply.insert(Config::FIELD__REQ_ID, ObjIn.value(Config::FIELD__REQ_ID));
+        Reply.insert(Config::FIELD__RES, QJsonValue(((Res) ? 1 : 0)));
+        Reply.insert(Config::FIELD__SEQ, QJsonValue(static_cast<double>(mEventSeq)));
+
+        if(ClientIn->mWebSocket->state() == QAbstractSocket::ConnectedState)
+        {
+            QJsonDocument Doc(Reply);
+            ClientIn->mWebSocket->sendTextMessage(QString(Doc.toJson(QJsonDocument::Compact)));
+
+            for(int i=From; i<mEventBuff.size(); i++) ClientIn->mWebSocket->sendTextMessage(mEventBuff.at(i));
+        }
+    }
+}
+
+
+/**
+@brief  Query history on demand of a client.
+@param  ClientIn - connected client;
+@param  ObjIn - request message.
+@return None.
+@detailed The query is run by the thread pool, the reply is sent by chunks only to the client:
+          ObjIn = { SrvID, NetID, DevID, Cmd:"history", ReqID, Var, From:sec, To:sec, Points:N, Alg:"minmax"|"lttb" }
+          Reply = { SrvID, NetID, DevID, Cmd:"history", ReqID, Var, Res:0|1, Chunk:n, Last:0|1, Data:[[msec, value], ...] }
+*/
+void Server::history(Client *ClientIn, const QJsonObject &ObjIn)
+{
+    LOG_DEBUG(QString("Server::history()"), mConfig.mFileLog, mConfig.mUseLog);
+
+    if(ClientIn && mConfig.isCorrect())
+    {
+        QJsonObject Head;
+        quint16 DevID, RegID;
+        bool Res = mConfig.toHistoryHead(ObjIn, Head, DevID, RegID);
+
+        qint64 From = static_cast<qint64>(ObjIn.value(Config::FIELD__FROM).toDouble(0.0)) * 1000;
+        qint64 To   = static_cast<qint64>(ObjIn.value(Config::FIELD__TO).toDouble(0.0)) * 1000 + 999;
+        int Points  = ObjIn.value(Config::FIELD__POINTS).toInt(ArhHistoryTask::POINTS__DEF);
+        quint8 Alg  = ArhDownsampler::toAlg(ObjIn.value(Config::FIELD__ALG).toString(ArhDownsampler::ALG__MINMAX_STR));
+
+        if(Points < 2) Points = 2;
+        if(Points > ArhHistoryTask::POINTS__MAX) Points = ArhHistoryTask::POINTS__MAX;
+
+        ArhStore *Store = ((mArh) ? mArh->getStore() : nullptr);
+
+        if(Res && Store && From <= To)
+        {
+            mHistPool->start(new ArhHistoryTask(Store, this, ClientIn->mID, Head, DevID, RegID, From, To, Points, Alg));
+        }
+        else
+        {
+            if(!Store) LOG_WARN(QString("The store of archive is not opened!"), mConfig.mFileLog, mConfig.mUseLog);
+
+            this->sendHistory(ClientIn->mID, ArhHistoryTask::toChunk(Head, false, 0, true, QVector<ArhPoint>()));
+        }
+    }
+}
+
+
+/**
+@brief  Send a chunk of history to a client.
+@param  CliIdIn - ID of the client;
+@param  DataIn - JSON-message.
+@return None.
+@details Is called by tasks of history (queued), the chunk is dropped if the client has gone.
+*/
+void Server::sendHistory(quint64 CliIdIn, const QString &DataIn)
+{
+    //the client is found by ID: the socket may be deleted while the task was running
+    Client *pClient = this->getCli(CliIdIn);
+
+    if(pClient)
+    {
+        if(pClient->mWebSocket->state() == QAbstractSocket::ConnectedState) pClient->mWebSocket->sendTextMessage(DataIn);
+    }
+}
+
+
 /**
 @brief  Start survey shot.
 @param  None.
@@ -534,7 +996,7 @@ void Server::write()
 */
 void Server::startSurvey()
 {
-    Log::log(QString("Server::startSurvey()"), mConfig.mFileLog, mConfig.mUseLog);
+    LOG_DEBUG(QString("Server::startSurvey()"), mConfig.mFileLog, mConfig.mUseLog);
 
     mDataToSend.clear();
 
@@ -548,12 +1010,21 @@ void Server::startSurvey()
         if(Res)
         {
            mConfig.toJsonString(mDataToSend);
-           Log::log(mDataToSend, mConfig.mFileLog, mConfig.mUseLog, false);
+           LOG_TRACE(mDataToSend, mConfig.mFileLog, mConfig.mUseLog, false);
+
+           //publish the consistent data of the cycle for Archive and new clients
+           Snapshot *Snap = new Snapshot();
+           Snap->mJson = mDataToSend;
+           mConfig.toSnapshot(*Snap);
+           Snapshot::publish(Snap);
+
+           //trends get the stamp of the published cycle (the snapshot is owned by Snapshot now)
+           mConfig.pushTrends(Snap->mStamp);
         }
     }
     else
     {
-        Log::log(QString("The configuration is incorrect!"), mConfig.mFileLog, mConfig.mUseLog, false);
+        LOG_ERROR(QString("The configuration is incorrect!"), mConfig.mFileLog, mConfig.mUseLog, false);
     }
 
     emit surveyCompleted();
@@ -568,7 +1039,7 @@ void Server::startSurvey()
 */
 void Server::sendSurveyDataToCli()
 {
-    Log::log(QString("Server::sendSurveyDataToCli()"), mConfig.mFileLog, mConfig.mUseLog);
+    LOG_DEBUG(QString("Server::sendSurveyDataToCli()"), mConfig.mFileLog, mConfig.mUseLog);
 
     if(!mClients.isEmpty())
     {
@@ -611,18 +1082,82 @@ void Server::sendSurveyDataToCli()
         }
         else
         {
-            Log::log(QString("The data to send is empty!"), mConfig.mFileLog, mConfig.mUseLog, false);
+            LOG_DEBUG(QString("The data to send is empty!"), mConfig.mFileLog, mConfig.mUseLog, false);
         }
     }
     else
     {
-        Log::log(QString("The list of clients is empty!"), mConfig.mFileLog, mConfig.mUseLog, false);
+        LOG_DEBUG(QString("The list of clients is empty!"), mConfig.mFileLog, mConfig.mUseLog, false);
     }
 
     emit surveyDataToCliSent();
 }
 
 
+/**
+@brief  Evaluate events of registers of a surveyed network.
+@param  NetIdxIn - index of list of networks.
+@return None.
+@detailed Is called (directly) by the survey as soon as the network has been surveyed:
+          transitions are sent to subscribed clients at once (ahead of survey data) and passed to the event archive.
+*/
+void Server::evaluateEvents(const int NetIdxIn)
+{
+    QList<SnapshotDevice> ListDevs;
+    QJsonArray ListEvents;
+    qint64 Stamp = QDateTime::currentMSecsSinceEpoch();
+
+    if(mConfig.evaluateEvents(NetIdxIn, Stamp, ListDevs, ListEvents) > 0)
+    {
+        if(!ListEvents.isEmpty())
+        {
+            QString Data("");
+            mConfig.toEventString(++mEventSeq, Stamp, ListEvents, Data);
+            LOG_DEBUG(Data, mConfig.mFileLog, mConfig.mUseLog, false);
+
+            //the message is kept for clients that reconnect
+            if(mConfig.mEventBuff > 0)
+            {
+                mEventBuff.append(Data);
+                while(static_cast<quint32>(mEventBuff.size()) > mConfig.mEventBuff) mEventBuff.removeFirst();
+            }
+
+            this->sendEventsToCli(Data);
+        }
+
+        if(!ListDevs.isEmpty() && mArhEvent) emit eventsDetected(ListDevs);
+    }
+}
+
+
+/**
+@brief  Send events of registers to subscribed clients.
+@param  DataIn - JSON-message (see Config::toEventString()).
+@return None.
+@detailed Events are sent at once (the survey is still running), expired clients are disconnected by sendSurveyDataToCli().
+*/
+void Server::sendEventsToCli(const QString &DataIn)
+{
+    LOG_DEBUG(QString("Server::sendEventsToCli()"), mConfig.mFileLog, mConfig.mUseLog);
+
+    Client *pClient = nullptr;
+
+    for(int i=0; i<mClients.size(); i++)
+    {
+        pClient = mClients.at(i);
+
+        if(pClient && pClient->mSubEvents)
+        {
+            if(pClient->mWebSocket->state() == QAbstractSocket::ConnectedState)
+            {
+                pClient->mWebSocket->sendTextMessage(DataIn);
+                pClient->mWebSocket->flush();
+            }
+        }
+    }
+}
+
+
 /**
 @brief  Start survey delay.
 @param  None.
@@ -630,7 +1165,7 @@ void Server::sendSurveyDataToCli()
 */
 void Server::startSurveyDelay()
 {
-    Log::log(QString("Server::startSurveyDelay(%1 msec)").arg(QString::number(mConfig.mSurveyDelay)), mConfig.mFileLog, mConfig.mUseLog);
+    LOG_DEBUG(QString("Server::startSurveyDelay(%1 msec)").arg(QString::number(mConfig.mSurveyDelay)), mConfig.mFileLog, mConfig.mUseLog);
 
     if(mSurveyTimer->isActive()) mSurveyTimer->stop();
 
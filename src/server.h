@@ -26,7 +26,10 @@
 #include <QMap>
 #include <QString>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QThread>
+#include <QThreadPool>
+#include <QPointer>
 #include <QtWebSockets>
 #include <QDebug>
 
@@ -34,7 +37,9 @@
 #include "log.h"
 #include "config.h"
 #include "arh.h"
+#include "arh-history.h"
 #include "client.h"
+#include "capture.h"
 
 QT_FORWARD_DECLARE_CLASS(QWebSocketServer)
 QT_FORWARD_DECLARE_CLASS(QWebSocket)
@@ -86,6 +91,15 @@ public slots:
     */
     bool stop();
 
+    /**
+    @brief  Send a chunk of history to a client.
+    @param  CliIdIn - ID of the client;
+    @param  DataIn - JSON-message.
+    @return None.
+    @details Is called by tasks of history (queued), the chunk is dropped if the client has gone.
+    */
+    void sendHistory(quint64 CliIdIn, const QString &DataIn);
+
 
 private:
 
@@ -133,16 +147,58 @@ private:
     */
     QTimer *mSurveyTimer;
 
+    /**
+    @brief Ping timer (one for all clients).
+    */
+    QTimer *mPingTimer;
+
+    /**
+    @brief Time since the last ping of clients.
+    @detailed The tick of ping is not counted as missed if the main thread was blocked (see pingCli()).
+    */
+    QElapsedTimer mPingTick;
+
     /**
     @brief Arhive.
     */
     Archive *mArh;
-    QThread *mArhThread;
+
+    /**
+    @brief List of archives (one per profile).
+    @details The first archive is mArh (it owns the store).
+    */
+    QList<Archive *> mListArh;
+
+    /**
+    @brief Threads of archives (they are joined by stop()).
+    */
+    QList<QPointer<QThread> > mListArhThreads;
+
+    /**
+    @brief Arhive of events.
+    */
+    Archive *mArhEvent;
+    QPointer<QThread> mArhEventThread;
+
+    /**
+    @brief Sequence number of the last event message.
+    */
+    quint64 mEventSeq;
+
+    /**
+    @brief Last event messages (Config::mEventBuff at most) for clients that reconnect.
+    */
+    QList<QString> mEventBuff;
+
+    /**
+    @brief Thread pool of history queries.
+    */
+    QThreadPool *mHistPool;
 
     /**
     @brief Messages from clients
     */
-    QList<QString> mCliMsg;
+    QList<ClientMsg *> mCliMsg;
 
 
     /**
@@ -163,6 +219,20 @@ private:
     */
     bool initArhThread();
 
+    /**
+    @brief  Init. thread of Archive (event).
+    @param  None.
+    @return True if OK, otherwise - False.
+    */
+    bool initArhEventThread();
+
+    /**
+    @brief  Init. capture or replay of bus traffic.
+    @param  None.
+    @return True if capture or replay is started, otherwise - False.
+    */
+    bool initCapture();
+
     /**
     @brief  Init. thread of WebSocket-server.
     @param  None.
@@ -188,6 +258,7 @@ private:
     @brief  Check life-time.
     @param  ClientIn - connected client.
     @return true - expired, false - not expired.
+    @detailed Is not used (always false) if ping is on.
     */
     bool hasCliTimeExpired(Client *ClientIn);
 
@@ -219,6 +290,13 @@ private:
     */
     Client *getCli(QWebSocket *WebSocketIn);
 
+    /**
+    @brief  Get client by ID.
+    @param  IdIn - ID of client (see Client::mID).
+    @return Pointer to Client or nullptr.
+    */
+    Client *getCli(const quint64 IdIn);
+
     /**
     @brief  Get the number of clients by IP.
     @param  HostIn - host address of a client.
@@ -233,13 +311,63 @@ private:
     */
     void initWsCli();
 
+    /**
+    @brief  Send last-known survey data to a client.
+    @param  ClientIn - connected client.
+    @return None.
+    @detailed The cached data is completed by field "Age" (msec), a new survey is not started.
+    */
+    void sendSnapshotToCli(Client *ClientIn);
+
     /**
     @brief  Write data.
     @param  None.
     @return None.
+    @detailed If a message has ReqID, then the reply is sent to the client.
     */
     void write();
 
+    /**
+    @brief  Read data on demand of a client.
+    @param  ClientIn - connected client;
+    @param  ObjIn - request message.
+    @return None.
+    @detailed The reply is sent only to the client.
+    */
+    void read(Client *ClientIn, const QJsonObject &ObjIn);
+
+    /**
+    @brief  Read trends on demand of a client.
+    @param  ClientIn - connected client;
+    @param  ObjIn - request message.
+    @return None.
+    @detailed The reply is sent only to the client.
+    */
+    void trend(Client *ClientIn, const QJsonObject &ObjIn);
+
+    /**
+    @brief  Query history on demand of a client.
+    @param  ClientIn - connected client;
+    @param  ObjIn - request message.
+    @return None.
+    @detailed The query is run by the thread pool, the reply is sent by chunks only to the client:
+              ObjIn = { SrvID, NetID, DevID, Cmd:"history", ReqID, Var, From:sec, To:sec, Points:N, Alg:"minmax"|"lttb" }
+              Reply = { SrvID, NetID, DevID, Cmd:"history", ReqID, Var, Res:0|1, Chunk:n, Last:0|1, Data:[[msec, value], ...] }
+    */
+    void history(Client *ClientIn, const QJsonObject &ObjIn);
+
+    /**
+    @brief  Subscribe a client to events of registers.
+    @param  ClientIn - connected client;
+    @param  ObjIn - request message.
+    @return None.
+    @detailed ObjIn = { SrvID, Cmd:"event", ReqID, Sub:0|1, Seq:n }
+              Reply = { SrvID, Cmd:"event", ReqID, Res:0|1, Seq:n }
+              Kept messages after Seq (the last sequence number received by the client) are sent again after the reply,
+              Res = 0 if some of them are not kept anymore (the client should read the current data).
+    */
+    void event(Client *ClientIn, const QJsonObject &ObjIn);
+
 
 private slots:
 
@@ -268,6 +396,24 @@ private slots:
     */
     void cliProcessMessage(const QString &MessageIn);
 
+    /**
+    @brief  Pong from the client.
+    @param  ElapsedTimeIn - roundtrip time (msec);
+    @param  PayloadIn - payload of ping.
+    @return None.
+    */
+    void cliPong(quint64 ElapsedTimeIn, const QByteArray &PayloadIn);
+
+    /**
+    @brief  Ping connected clients.
+    @param  None.
+    @return None.
+    @detailed Clients that missed PingMiss pong are disconnected.
+              The tick is skipped if the interval is overrun (the main thread was blocked by a survey):
+              pong could not be read then, so it is not counted as missed.
+    */
+    void pingCli();
+
     /**
     @brief  Start survey shot.
     @param  None.
@@ -284,6 +430,23 @@ private slots:
     */
     void sendSurveyDataToCli();
 
+    /**
+    @brief  Evaluate events of registers of a surveyed network.
+    @param  NetIdxIn - index of list of networks.
+    @return None.
+    @detailed Is called (directly) by the survey as soon as the network has been surveyed:
+              transitions are sent to subscribed clients at once (ahead of survey data) and passed to the event archive.
+    */
+    void evaluateEvents(const int NetIdxIn);
+
+    /**
+    @brief  Send events of registers to subscribed clients.
+    @param  DataIn - JSON-message (see Config::toEventString()).
+    @return None.
+    @detailed Events are sent at once (the survey is still running), expired clients are disconnected by sendSurveyDataToCli().
+    */
+    void sendEventsToCli(const QString &DataIn);
+
     /**
     @brief  Start survey delay.
     @param  None.
@@ -313,6 +476,13 @@ signals:
     */
     void stopped();
 
+    /**
+    @brief  Events of registers have been raised or cleared.
+    @param  ListDevicesIn - list of devices with rows of events.
+    @return None.
+    */
+    void eventsDetected(const QList<SnapshotDevice> &ListDevicesIn);
+
     /**
     @brief  The Survey data have completed.
     @param  None.
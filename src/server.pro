@@ -38,15 +38,18 @@ TEMPLATE = app
 SOURCES+= \
            main.cpp \
            log.cpp \
+           log-writer.cpp \
            args.cpp \
            bit.cpp \
            json.cpp \
+           capture.cpp \
            serialport.cpp \
            modbus-cli.cpp \
            modbus-rtu-cli.cpp \
            modbus-tcp-cli.cpp \
            dcon7000.cpp \
            mysql-cli.cpp \
+           ip-trie.cpp \
            config.cpp \
            network.cpp \
            device.cpp \
@@ -56,16 +59,26 @@ SOURCES+= \
            register.cpp \
            registers-group.cpp \
            event.cpp \
+           snapshot.cpp \
            client.cpp \
            server.cpp \
            service.cpp \
-           arh.cpp
+           arh.cpp \
+           arh-spool.cpp \
+           arh-aggr.cpp \
+           arh-codec.cpp \
+           arh-store.cpp \
+           arh-history.cpp \
+           trend.cpp \
+           arh-comp.cpp
 
 HEADERS+= \
            log.h \
+           log-writer.h \
            args.h \
            bit.h \
            json.h \
+           capture.h \
            serialport.h \
            modbus-cli.h \
            modbus-rtu-cli.h \
@@ -73,19 +86,29 @@ HEADERS+= \
            dcon7000.h \
            mysql-cli.h \
            global.h \
+           ip-trie.h \
            config.h \
            network.h \
            device.h \
            device-modbus-rtu.h \
            device-modbus-tcp.h \
            device-dcon7000.h \
+           arh-row.h \
            register.h \
            registers-group.h \
            event.h \
+           snapshot.h \
            client.h \
            server.h \
            service.h \
-           arh.h
+           arh.h \
+           arh-spool.h \
+           arh-aggr.h \
+           arh-codec.h \
+           arh-store.h \
+           arh-history.h \
+           trend.h \
+           arh-comp.h
 
 # ModBus
 # include files
@@ -115,6 +138,29 @@ CONFIG(debug, debug|release) {
      unix: LIBS += -L$$PWD/lib/mysql -lmysqlclient
 }
 
+# SQLite (optional driver of archive: qmake CONFIG+=sqlite)
+sqlite {
+    DEFINES+= WITH_SQLITE
+
+    SOURCES+= \
+               sqlite-cli.cpp \
+               arh-checkpoint.cpp
+
+    HEADERS+= \
+               sqlite-cli.h \
+               arh-checkpoint.h
+
+    # unix: the system library (headers in the default path)
+    unix: LIBS += -lsqlite3
+    # win32: the library is not bundled, the path is given by the environment variable SQLITE_DIR
+    win32 {
+        SQLITE_DIR = $$(SQLITE_DIR)
+        isEmpty(SQLITE_DIR): error("SQLite is not bundled: set SQLITE_DIR to the directory with sqlite3.h and sqlite3.lib")
+        INCLUDEPATH += $$SQLITE_DIR
+        LIBS += -L$$SQLITE_DIR -lsqlite3
+    }
+}
+
 # QtService
 # include files
 INCLUDEPATH += lib/qtservice/src
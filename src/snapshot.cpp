@@ -0,0 +1,76 @@
+/* Copyright (C) 2019 ATgroup09
+*  Contact: atgroup09@gmail.com
+*
+*  This file is part of the HMI server component.
+*
+*  The code in this page is free software: you can
+*  redistribute it and/or modify it under the terms of the GNU
+*  General Public License (GNU GPL) as published by the Free Software
+*  Foundation, either version 3 of the License, or (at your option)
+*  any later version.  The code is distributed WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS
+*  FOR A PARTICULAR PURPOSE.  See the GNU GPL for more details.
+*
+*  As additional permission under GNU GPL version 3 section 7, you
+*  may distribute non-source (e.g., minimized or compacted) forms of
+*  that code without the copy of the GNU GPL normally required by
+*  section 4, provided you include this license notice and a URL
+*  through which recipients can access the Corresponding Source.
+*/
+
+#include "snapshot.h"
+
+
+/**
+@brief Current snapshot.
+*/
+std::shared_ptr<const Snapshot> Snapshot::mCurrent;
+
+/**
+@brief Version of the current snapshot.
+*/
+std::atomic<quint64> Snapshot::mVersionCurrent(0);
+
+
+/**
+@brief  Publish a snapshot.
+@param  SnapIn - snapshot (is owned by the class).
+@return Version of the snapshot.
+@details Is called only by the survey thread.
+*/
+quint64 Snapshot::publish(Snapshot *SnapIn)
+{
+    if(SnapIn == nullptr) return (version());
+
+    SnapIn->mVersion = mVersionCurrent.load(std::memory_order_relaxed) + 1;
+    SnapIn->mStamp   = QDateTime::currentMSecsSinceEpoch();
+
+    std::shared_ptr<const Snapshot> Snap(SnapIn);
+    std::atomic_store_explicit(&mCurrent, Snap, std::memory_order_release);
+    mVersionCurrent.store(Snap->mVersion, std::memory_order_release);
+
+    return (Snap->mVersion);
+}
+
+
+/**
+@brief  Get the current snapshot.
+@param  None.
+@return Pointer to snapshot (nullptr if it has not been published).
+@details Thread-safe, no device locks are taken.
+*/
+std::shared_ptr<const Snapshot> Snapshot::get()
+{
+    return (std::atomic_load_explicit(&mCurrent, std::memory_order_acquire));
+}
+
+
+/**
+@brief  Get version of the current snapshot.
+@param  None.
+@return Version (0 if it has not been published).
+*/
+quint64 Snapshot::version()
+{
+    return (mVersionCurrent.load(std::memory_order_acquire));
+}
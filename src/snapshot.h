@@ -0,0 +1,144 @@
+/* Copyright (C) 2019 ATgroup09
+*  Contact: atgroup09@gmail.com
+*
+*  This file is part of the HMI server component.
+*
+*  The code in this page is free software: you can
+*  redistribute it and/or modify it under the terms of the GNU
+*  General Public License (GNU GPL) as published by the Free Software
+*  Foundation, either version 3 of the License, or (at your option)
+*  any later version.  The code is distributed WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS
+*  FOR A PARTICULAR PURPOSE.  See the GNU GPL for more details.
+*
+*  As additional permission under GNU GPL version 3 section 7, you
+*  may distribute non-source (e.g., minimized or compacted) forms of
+*  that code without the copy of the GNU GPL normally required by
+*  section 4, provided you include this license notice and a URL
+*  through which recipients can access the Corresponding Source.
+*/
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <memory>
+#include <atomic>
+#include <QString>
+#include <QList>
+#include <QDateTime>
+#include <QMetaType>
+
+#include "arh-row.h"
+
+
+/**
+@brief Data of a device in snapshot.
+*/
+class SnapshotDevice
+{
+public:
+
+    /**
+    @brief Network ID.
+    */
+    quint16 mNetID;
+
+    /**
+    @brief Device ID.
+    */
+    quint16 mDevID;
+
+    /**
+    @brief Archive file of the device.
+    */
+    QString mArhFile;
+
+    /**
+    @brief Archive table of the device.
+    */
+    QString mArhTable;
+
+    /**
+    @brief The device is written into the embedded store of archive.
+    */
+    bool mArhStore;
+
+    /**
+    @brief Current values of archived registers (profile is empty).
+    */
+    QList<ArhRow> mListRows;
+};
+
+//** devices with rows of events are passed to the event archive by queued signal
+Q_DECLARE_METATYPE(SnapshotDevice)
+
+
+/**
+@brief Immutable snapshot of survey data.
+@details Is built by the survey (main thread) at the end of each cycle and published atomically
+         (atomic std::shared_ptr, RCU-like): readers (Archive, WebSocket) take the current snapshot
+         without device locks and keep it while they use it, a new snapshot does not change it.
+*/
+class Snapshot
+{
+public:
+
+    /**
+    @brief Version (1, 2, ...).
+    */
+    quint64 mVersion;
+
+    /**
+    @brief Date and time of publication (msec since epoch).
+    */
+    qint64 mStamp;
+
+    /**
+    @brief Survey data in JSON (see Config::toJsonString()).
+    */
+    QString mJson;
+
+    /**
+    @brief Data of devices.
+    */
+    QList<SnapshotDevice> mListDevices;
+
+
+    /**
+    @brief  Publish a snapshot.
+    @param  SnapIn - snapshot (is owned by the class).
+    @return Version of the snapshot.
+    @details Is called only by the survey thread.
+    */
+    static quint64 publish(Snapshot *SnapIn);
+
+    /**
+    @brief  Get the current snapshot.
+    @param  None.
+    @return Pointer to snapshot (nullptr if it has not been published).
+    @details Thread-safe, no device locks are taken.
+    */
+    static std::shared_ptr<const Snapshot> get();
+
+    /**
+    @brief  Get version of the current snapshot.
+    @param  None.
+    @return Version (0 if it has not been published).
+    */
+    static quint64 version();
+
+
+private:
+
+    /**
+    @brief Current snapshot.
+    */
+    static std::shared_ptr<const Snapshot> mCurrent;
+
+    /**
+    @brief Version of the current snapshot.
+    */
+    static std::atomic<quint64> mVersionCurrent;
+};
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,402 @@
+/* Copyright (C) 2019 ATgroup09
+*  Contact: atgroup09@gmail.com
+*
+*  SQLite DB helper.
+*
+*  The code in this page is free software: you can
+*  redistribute it and/or modify it under the terms of the GNU
+*  General Public License (GNU GPL) as published by the Free Software
+*  Foundation, either version 3 of the License, or (at your option)
+*  any later version.  The code is distributed WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS
+*  FOR A PARTICULAR PURPOSE.  See the GNU GPL for more details.
+*
+*  As additional permission under GNU GPL version 3 section 7, you
+*  may distribute non-source (e.g., minimized or compacted) forms of
+*  that code without the copy of the GNU GPL normally required by
+*  section 4, provided you include this license notice and a URL
+*  through which recipients can access the Corresponding Source.
+*/
+
+#include "sqlite-cli.h"
+
+
+/**
+@brief      Constant: Class error codes
+*/
+const quint32 HelperSQLite::ERROR__OPEN            = SQLITE_CANTOPEN;
+
+
+/**
+@brief      Constructor.
+@param      None.
+@return     None.
+*/
+HelperSQLite::HelperSQLite(QObject *parent) : QObject(parent)
+{
+    mFile            = QString("");
+    mBusyTimeout     = HelperSQLite::BUSY_TIMEOUT__DEF;
+    mAutoCheckpoint  = true;
+    mDb              = nullptr;
+    mErrNo           = 0;
+    mError           = QString("");
+}
+
+
+/**
+@brief      Destructor.
+@param      None.
+@return     None.
+*/
+HelperSQLite::~HelperSQLite()
+{
+    this->disconnect();
+}
+
+
+/**
+@brief      Method: Check connection.
+@param      None.
+@return     True if the database is opened, otherwise - false.
+*/
+bool HelperSQLite::isConnected()
+{
+    return ((mDb != nullptr) ? true : false);
+}
+
+
+/**
+@brief      Method: Get Error code.
+@detailed   if no errors, then returns 0
+@param      None.
+@return     Error code.
+*/
+quint32 HelperSQLite::getErrorNo()
+{
+    return (mErrNo);
+}
+
+
+/**
+@brief      Method: Get Error message.
+@detailed   if no errors, then returns empty string
+@param      None.
+@return     Error message.
+*/
+QString HelperSQLite::getError()
+{
+    return (mError);
+}
+
+
+/**
+@brief      Method: Get prepared statement.
+@detailed   statements are cached by text of query until disconnect
+@param      QueryIn - SQL-query with placeholders (?).
+@return     Pointer to prepared statement or NULL.
+*/
+sqlite3_stmt *HelperSQLite::getStmt(const QString &QueryIn)
+{
+    sqlite3_stmt *Stmt = mListStmts.value(QueryIn, nullptr);
+
+    if(Stmt == nullptr && this->isConnected() && !QueryIn.isEmpty())
+    {
+        QByteArray Query = QueryIn.toUtf8();
+
+        if(this->toResult(sqlite3_prepare_v2(mDb, Query.constData(), Query.size(), &Stmt, nullptr)) && Stmt != nullptr)
+        {
+            mListStmts.insert(QueryIn, Stmt);
+        }
+        else
+        {
+            if(Stmt != nullptr) sqlite3_finalize(Stmt);
+            Stmt = nullptr;
+        }
+    }
+
+    return (Stmt);
+}
+
+
+/**
+@brief      Method: Get the number of cached prepared statements.
+@param      None.
+@return     The number of statements.
+*/
+int HelperSQLite::sizeStmts()
+{
+    return (mListStmts.size());
+}
+
+
+/**
+@brief      Method: Get the number of rows changed by the last query.
+@param      None.
+@return     The number of rows (INSERT, UPDATE, DELETE).
+*/
+int HelperSQLite::getChanges()
+{
+    return ((this->isConnected()) ? sqlite3_changes(mDb) : 0);
+}
+
+
+/**
+@brief      Public slot: Open the database.
+@param      None.
+@return     True if the database was opened successfully, otherwise - false.
+@detailed   The file is created if it does not exist, WAL mode is set.
+*/
+bool HelperSQLite::connect()
+{
+    this->disconnect();
+
+    if(mFile.isEmpty())
+    {
+        mErrNo = HelperSQLite::ERROR__OPEN;
+        mError = QString("The database file is not set!");
+        emit sigError(mErrNo, mError);
+        return (false);
+    }
+
+    bool Res = this->toResult(sqlite3_open_v2(mFile.toUtf8().constData(), &mDb, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX, nullptr));
+
+    if(Res)
+    {
+        sqlite3_busy_timeout(mDb, mBusyTimeout);
+
+        //WAL: a commit appends pages to the log (no rollback journal), synchronous=NORMAL syncs only on checkpoint
+        Res = this->sendQuery(QString("PRAGMA journal_mode=WAL; PRAGMA synchronous=NORMAL;"));
+
+        if(Res && !mAutoCheckpoint) Res = this->sendQuery(QString("PRAGMA wal_autocheckpoint=0;"));
+    }
+
+    if(Res)
+    {
+        emit sigConnected();
+    }
+    else
+    {
+        quint32 ErrNo  = mErrNo;
+        QString ErrStr = mError;
+
+        //the handle is released even if the opening has failed
+        this->disconnect();
+
+        mErrNo = ErrNo;
+        mError = ErrStr;
+    }
+
+    return (this->isConnected());
+}
+
+
+/**
+@brief      Public slot: Close the database.
+@param      None.
+@return     None.
+*/
+void HelperSQLite::disconnect()
+{
+    this->closeStmts();
+
+    if(mDb != nullptr)
+    {
+        sqlite3_close_v2(mDb);
+        mDb = nullptr;
+
+        emit sigDisconnected();
+    }
+}
+
+
+/**
+@brief      Public slot: Send Query.
+@param      QueryIn - SQL-query (one or more statements).
+@return     True if query was sent successfully, otherwise - false.
+*/
+bool HelperSQLite::sendQuery(const QString &QueryIn)
+{
+    bool Res = false;
+
+    if(this->isConnected() && !QueryIn.isEmpty())
+    {
+        char *Err = nullptr;
+        Res = this->toResult(sqlite3_exec(mDb, QueryIn.toUtf8().constData(), nullptr, nullptr, &Err));
+        if(Err != nullptr) sqlite3_free(Err);
+    }
+    else
+    {
+        mErrNo = HelperSQLite::ERROR__OPEN;
+        mError = QString("The database is not opened!");
+        emit sigError(mErrNo, mError);
+    }
+
+    if(Res) emit sigQuerySent();
+
+    return (Res);
+}
+
+
+/**
+@brief      Public slot: Send Query and get one value.
+@param      QueryIn - SQL-query (SELECT);
+            ValueIn - link to value of the first column of the first row (empty if no rows or NULL).
+@return     True if query was sent successfully, otherwise - false.
+*/
+bool HelperSQLite::selectValue(const QString &QueryIn, QString &ValueIn)
+{
+    ValueIn = QString("");
+
+    if(!this->isConnected() || QueryIn.isEmpty())
+    {
+        mErrNo = HelperSQLite::ERROR__OPEN;
+        mError = QString("The database is not opened!");
+        emit sigError(mErrNo, mError);
+        return (false);
+    }
+
+    sqlite3_stmt *Stmt = nullptr;
+    bool Res = this->toResult(sqlite3_prepare_v2(mDb, QueryIn.toUtf8().constData(), -1, &Stmt, nullptr));
+
+    if(Res)
+    {
+        int Step = sqlite3_step(Stmt);
+        Res = this->toResult(((Step == SQLITE_DONE || Step == SQLITE_ROW) ? SQLITE_OK : Step));
+
+        if(Step == SQLITE_ROW && sqlite3_column_type(Stmt, 0) != SQLITE_NULL)
+        {
+            ValueIn = QString::fromUtf8(reinterpret_cast<const char *>(sqlite3_column_text(Stmt, 0)));
+        }
+    }
+
+    if(Stmt != nullptr) sqlite3_finalize(Stmt);
+    if(Res) emit sigQuerySent();
+
+    return (Res);
+}
+
+
+/**
+@brief      Public slot: Start transaction.
+@param      None.
+@return     True if transaction was started successfully, otherwise - false.
+@detailed   The write lock is taken at once (BEGIN IMMEDIATE).
+*/
+bool HelperSQLite::begin()
+{
+    return (this->sendQuery(QString("BEGIN IMMEDIATE")));
+}
+
+
+/**
+@brief      Public slot: Commit transaction.
+@param      None.
+@return     True if transaction was committed successfully, otherwise - false.
+*/
+bool HelperSQLite::commit()
+{
+    return (this->sendQuery(QString("COMMIT")));
+}
+
+
+/**
+@brief      Public slot: Rollback transaction.
+@param      None.
+@return     True if transaction was rolled back successfully, otherwise - false.
+@detailed   Nothing is done if a transaction is not active (SQLite may roll it back itself).
+*/
+bool HelperSQLite::rollback()
+{
+    if(this->isConnected() && sqlite3_get_autocommit(mDb)) return (true);
+
+    return (this->sendQuery(QString("ROLLBACK")));
+}
+
+
+/**
+@brief      Public slot: Execute prepared statement.
+@param      StmtIn - prepared statement with bound parameters (see getStmt()).
+@return     True if statement was executed successfully, otherwise - false.
+@detailed   The statement is reset and its parameters are cleared.
+*/
+bool HelperSQLite::sendStmt(sqlite3_stmt *StmtIn)
+{
+    bool Res = false;
+
+    if(this->isConnected() && StmtIn != nullptr)
+    {
+        int Step = sqlite3_step(StmtIn);
+        Res = this->toResult(((Step == SQLITE_DONE || Step == SQLITE_ROW) ? SQLITE_OK : Step));
+
+        sqlite3_reset(StmtIn);
+        sqlite3_clear_bindings(StmtIn);
+    }
+    else
+    {
+        mErrNo = HelperSQLite::ERROR__OPEN;
+        mError = QString("The statement is not prepared!");
+        emit sigError(mErrNo, mError);
+    }
+
+    if(Res) emit sigQuerySent();
+
+    return (Res);
+}
+
+
+/**
+@brief      Public slot: Close all prepared statements.
+@param      None.
+@return     None.
+*/
+void HelperSQLite::closeStmts()
+{
+    QHash<QString, sqlite3_stmt *>::iterator It;
+
+    for(It = mListStmts.begin(); It != mListStmts.end(); ++It)
+    {
+        if(It.value() != nullptr) sqlite3_finalize(It.value());
+    }
+
+    mListStmts.clear();
+}
+
+
+/**
+@brief      Public slot: Checkpoint WAL.
+@param      TruncateIn - true to truncate WAL (waits for the writer), false - passive (does not wait);
+            LogIn      - link to the number of frames in WAL;
+            CkptIn     - link to the number of checkpointed frames.
+@return     True if the checkpoint was run, otherwise - false.
+*/
+bool HelperSQLite::checkpoint(const bool TruncateIn, int &LogIn, int &CkptIn)
+{
+    LogIn  = 0;
+    CkptIn = 0;
+
+    if(!this->isConnected()) return (false);
+
+    return (this->toResult(sqlite3_wal_checkpoint_v2(mDb, nullptr, ((TruncateIn) ? SQLITE_CHECKPOINT_TRUNCATE : SQLITE_CHECKPOINT_PASSIVE), &LogIn, &CkptIn)));
+}
+
+
+/**
+@brief      Method: Keep the error of the last operation.
+@param      ResIn - result code of SQLite.
+@return     True if the result code is not an error, otherwise - false.
+*/
+bool HelperSQLite::toResult(const int ResIn)
+{
+    if(ResIn == SQLITE_OK)
+    {
+        mErrNo = 0;
+        mError = QString("");
+        return (true);
+    }
+
+    mErrNo = static_cast<quint32>(ResIn);
+    mError = ((mDb != nullptr) ? QString::fromUtf8(sqlite3_errmsg(mDb)) : QString::fromUtf8(sqlite3_errstr(ResIn)));
+    emit sigError(mErrNo, mError);
+
+    return (false);
+}
@@ -0,0 +1,289 @@
+/* Copyright (C) 2019 ATgroup09
+*  Contact: atgroup09@gmail.com
+*
+*  SQLite DB helper.
+*
+*  The code in this page is free software: you can
+*  redistribute it and/or modify it under the terms of the GNU
+*  General Public License (GNU GPL) as published by the Free Software
+*  Foundation, either version 3 of the License, or (at your option)
+*  any later version.  The code is distributed WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS
+*  FOR A PARTICULAR PURPOSE.  See the GNU GPL for more details.
+*
+*  As additional permission under GNU GPL version 3 section 7, you
+*  may distribute non-source (e.g., minimized or compacted) forms of
+*  that code without the copy of the GNU GPL normally required by
+*  section 4, provided you include this license notice and a URL
+*  through which recipients can access the Corresponding Source.
+*/
+
+#ifndef HELPERSQLITE_H
+#define HELPERSQLITE_H
+
+#include <QObject>
+#include <QString>
+#include <QHash>
+
+#include <sqlite3.h>
+
+
+/**
+@brief   SQLite DB Helper
+@details The database is opened in WAL mode: readers do not block the writer and a commit is a sequential append to the WAL.
+*/
+class HelperSQLite : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    explicit HelperSQLite(QObject *parent = nullptr);
+    ~HelperSQLite();
+
+    /**
+    Public constants
+    */
+
+    /**
+    @brief      Constant: Class error codes
+    */
+    static const quint32 ERROR__OPEN;
+
+    /**
+    @brief      Constant: Busy timeout by default (msec)
+    */
+    static const int BUSY_TIMEOUT__DEF = 5000;
+
+
+    /**
+    Public options
+    */
+
+    /**
+    @brief      Option: Path to the database file
+    */
+    QString mFile;
+
+    /**
+    @brief      Option: Busy timeout (msec)
+    @detailed   the time to wait for a lock held by another connection
+    */
+    int mBusyTimeout;
+
+    /**
+    @brief      Option: Automatic checkpoint of WAL
+    @detailed   true by default, false if WAL is checkpointed by another connection (see ArhCheckpoint)
+    */
+    bool mAutoCheckpoint;
+
+
+    /**
+    Public methods
+    */
+
+    /**
+    @brief      Method: Check connection.
+    @param      None.
+    @return     True if the database is opened, otherwise - false.
+    */
+    bool isConnected();
+
+    /**
+    @brief      Method: Get Error code.
+    @detailed   if no errors, then returns 0
+    @param      None.
+    @return     Error code.
+    */
+    quint32 getErrorNo();
+
+    /**
+    @brief      Method: Get Error message.
+    @detailed   if no errors, then returns empty string
+    @param      None.
+    @return     Error message.
+    */
+    QString getError();
+
+    /**
+    @brief      Method: Get prepared statement.
+    @detailed   statements are cached by text of query until disconnect
+    @param      QueryIn - SQL-query with placeholders (?).
+    @return     Pointer to prepared statement or NULL.
+    */
+    sqlite3_stmt *getStmt(const QString &QueryIn);
+
+    /**
+    @brief      Method: Get the number of cached prepared statements.
+    @param      None.
+    @return     The number of statements.
+    */
+    int sizeStmts();
+
+    /**
+    @brief      Method: Get the number of rows changed by the last query.
+    @param      None.
+    @return     The number of rows (INSERT, UPDATE, DELETE).
+    */
+    int getChanges();
+
+
+signals:
+
+    /**
+    Signals
+    */
+
+    /**
+    @brief      Signal: The database was opened successfully.
+    @param      None.
+    @return     None.
+    */
+    void sigConnected();
+
+    /**
+    @brief      Signal: The database was closed.
+    @param      None.
+    @return     None.
+    */
+    void sigDisconnected();
+
+    /**
+    @brief      Signal: Query was sent successfully.
+    @param      None.
+    @return     None.
+    */
+    void sigQuerySent();
+
+    /**
+    @brief      Signal: Error.
+    @param      ErrorNoIn  - error code;
+                ErrorStrIn - error message.
+    @return     None.
+    */
+    void sigError(quint32 ErrorNoIn, QString ErrorStrIn);
+
+
+public slots:
+
+    /**
+    Public slots
+    */
+
+    /**
+    @brief      Public slot: Open the database.
+    @param      None.
+    @return     True if the database was opened successfully, otherwise - false.
+    @detailed   The file is created if it does not exist, WAL mode is set.
+    */
+    bool connect();
+
+    /**
+    @brief      Public slot: Close the database.
+    @param      None.
+    @return     None.
+    */
+    void disconnect();
+
+    /**
+    @brief      Public slot: Send Query.
+    @param      QueryIn - SQL-query (one or more statements).
+    @return     True if query was sent successfully, otherwise - false.
+    */
+    bool sendQuery(const QString &QueryIn);
+
+    /**
+    @brief      Public slot: Send Query and get one value.
+    @param      QueryIn - SQL-query (SELECT);
+                ValueIn - link to value of the first column of the first row (empty if no rows or NULL).
+    @return     True if query was sent successfully, otherwise - false.
+    */
+    bool selectValue(const QString &QueryIn, QString &ValueIn);
+
+    /**
+    @brief      Public slot: Start transaction.
+    @param      None.
+    @return     True if transaction was started successfully, otherwise - false.
+    @detailed   The write lock is taken at once (BEGIN IMMEDIATE).
+    */
+    bool begin();
+
+    /**
+    @brief      Public slot: Commit transaction.
+    @param      None.
+    @return     True if transaction was committed successfully, otherwise - false.
+    */
+    bool commit();
+
+    /**
+    @brief      Public slot: Rollback transaction.
+    @param      None.
+    @return     True if transaction was rolled back successfully, otherwise - false.
+    */
+    bool rollback();
+
+    /**
+    @brief      Public slot: Execute prepared statement.
+    @param      StmtIn - prepared statement with bound parameters (see getStmt()).
+    @return     True if statement was executed successfully, otherwise - false.
+    @detailed   The statement is reset and its parameters are cleared.
+    */
+    bool sendStmt(sqlite3_stmt *StmtIn);
+
+    /**
+    @brief      Public slot: Close all prepared statements.
+    @param      None.
+    @return     None.
+    */
+    void closeStmts();
+
+    /**
+    @brief      Public slot: Checkpoint WAL.
+    @param      TruncateIn - true to truncate WAL (waits for the writer), false - passive (does not wait);
+                LogIn      - link to the number of frames in WAL;
+                CkptIn     - link to the number of checkpointed frames.
+    @return     True if the checkpoint was run, otherwise - false.
+    */
+    bool checkpoint(const bool TruncateIn, int &LogIn, int &CkptIn);
+
+
+private:
+
+    /**
+    Private options
+    */
+
+    /**
+    @brief      Option: Connection descriptor
+    */
+    sqlite3 *mDb;
+
+    /**
+    @brief      Option: Prepared statements (query => statement)
+    */
+    QHash<QString, sqlite3_stmt *> mListStmts;
+
+    /**
+    @brief      Option: Error code of the last operation
+    */
+    quint32 mErrNo;
+
+    /**
+    @brief      Option: Error message of the last operation
+    */
+    QString mError;
+
+
+    /**
+    Private methods
+    */
+
+    /**
+    @brief      Method: Keep the error of the last operation.
+    @param      ResIn - result code of SQLite.
+    @return     True if the result code is not an error, otherwise - false.
+    */
+    bool toResult(const int ResIn);
+};
+
+#endif // HELPERSQLITE_H
@@ -0,0 +1,198 @@
+/* Copyright (C) 2019 ATgroup09
+*  Contact: atgroup09@gmail.com
+*
+*  This file is part of the HMI server component.
+*
+*  The code in this page is free software: you can
+*  redistribute it and/or modify it under the terms of the GNU
+*  General Public License (GNU GPL) as published by the Free Software
+*  Foundation, either version 3 of the License, or (at your option)
+*  any later version.  The code is distributed WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS
+*  FOR A PARTICULAR PURPOSE.  See the GNU GPL for more details.
+*
+*  As additional permission under GNU GPL version 3 section 7, you
+*  may distribute non-source (e.g., minimized or compacted) forms of
+*  that code without the copy of the GNU GPL normally required by
+*  section 4, provided you include this license notice and a URL
+*  through which recipients can access the Corresponding Source.
+*/
+
+#include "trend.h"
+
+
+/**
+@brief  Constructor.
+@param  None.
+@return None.
+*/
+Trend::Trend()
+{
+    mBase  = 0;
+    mHead  = 0;
+    mSize  = 0;
+    mDecim = DECIM_MIN;
+    mTick  = 0;
+}
+
+
+/**
+@brief  Allocate the buffer.
+@param  DepthIn - the number of samples (0 - trend is off);
+@param  DecimIn - decimation (every Decim-th sample is kept).
+@return None.
+*/
+void Trend::init(const quint32 DepthIn, const quint16 DecimIn)
+{
+    quint32 Depth = ((DepthIn > DEPTH_MAX) ? DEPTH_MAX : DepthIn);
+
+    mListValues.fill(0, static_cast<int>(Depth));
+    mListStamps.fill(0, static_cast<int>(Depth));
+    mListValues.squeeze();
+    mListStamps.squeeze();
+
+    mDecim = ((DecimIn < DECIM_MIN) ? DECIM_MIN : DecimIn);
+
+    this->clear();
+}
+
+
+/**
+@brief  Clear the buffer (the memory is kept).
+@param  None.
+@return None.
+*/
+void Trend::clear()
+{
+    mBase = 0;
+    mHead = 0;
+    mSize = 0;
+    mTick = 0;
+}
+
+
+/**
+@brief  Check the trend is on.
+@param  None.
+@return True if the buffer is allocated, otherwise - False.
+*/
+bool Trend::isEnabled() const
+{
+    return (!mListValues.isEmpty());
+}
+
+
+/**
+@brief  Push a sample.
+@param  StampIn - date and time (msec since epoch);
+@param  RawValueIn - raw-value.
+@return None.
+@details The oldest sample is overwritten when the buffer is full.
+*/
+void Trend::push(const qint64 StampIn, const quint16 RawValueIn)
+{
+    if(mListValues.isEmpty()) return;
+
+    quint16 Tick = mTick;
+    mTick = (mTick + 1) % mDecim;
+    if(Tick != 0) return;
+
+    if(mSize == 0) mBase = StampIn;
+
+    //offsets of quint32 cover ~49 days: the base is moved rarely
+    if(StampIn < mBase || StampIn - mBase > static_cast<qint64>(0xFFFFFFFF))
+    {
+        if(!this->rebase(StampIn))
+        {
+            //the clock has gone back or the gap is too long: the trend is restarted
+            mBase = StampIn;
+            mHead = 0;
+            mSize = 0;
+        }
+    }
+
+    int Depth = mListValues.size();
+    int Idx   = (mHead + mSize) % Depth;
+
+    mListValues[Idx] = RawValueIn;
+    mListStamps[Idx] = static_cast<quint32>(StampIn - mBase);
+
+    if(mSize < Depth)
+    {
+        mSize++;
+    }
+    else
+    {
+        mHead = (mHead + 1) % Depth;
+    }
+}
+
+
+/**
+@brief  Get the number of samples.
+@param  None.
+@return The number of samples.
+*/
+int Trend::size() const
+{
+    return (mSize);
+}
+
+
+/**
+@brief  Get date and time of a sample.
+@param  IdxIn - index of sample (0 - the oldest).
+@return Date and time (msec since epoch).
+*/
+qint64 Trend::stampAt(const int IdxIn) const
+{
+    if(IdxIn < 0 || IdxIn >= mSize) return (0);
+
+    return (mBase + static_cast<qint64>(mListStamps.at((mHead + IdxIn) % mListStamps.size())));
+}
+
+
+/**
+@brief  Get raw-value of a sample.
+@param  IdxIn - index of sample (0 - the oldest).
+@return Raw-value.
+*/
+quint16 Trend::valueAt(const int IdxIn) const
+{
+    if(IdxIn < 0 || IdxIn >= mSize) return (0);
+
+    return (mListValues.at((mHead + IdxIn) % mListValues.size()));
+}
+
+
+/**
+@brief  Get the allocated memory.
+@param  None.
+@return The number of bytes.
+*/
+qint64 Trend::memory() const
+{
+    return (static_cast<qint64>(mListValues.capacity()) * static_cast<qint64>(sizeof(quint16)) + static_cast<qint64>(mListStamps.capacity()) * static_cast<qint64>(sizeof(quint32)));
+}
+
+
+/**
+@brief  Move the base of time stamps to the oldest sample.
+@param  StampIn - date and time of the new sample (msec since epoch).
+@return True if the new sample fits the offsets, otherwise - False.
+*/
+bool Trend::rebase(const qint64 StampIn)
+{
+    if(mSize == 0 || StampIn < mBase) return (false);
+
+    int Depth = mListStamps.size();
+    quint32 Shift = mListStamps.at(mHead);
+
+    if(StampIn - (mBase + Shift) > static_cast<qint64>(0xFFFFFFFF)) return (false);
+
+    for(int i=0; i<mSize; i++) mListStamps[(mHead + i) % Depth]-= Shift;
+
+    mBase+= Shift;
+
+    return (true);
+}
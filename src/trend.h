@@ -0,0 +1,175 @@
+/* Copyright (C) 2019 ATgroup09
+*  Contact: atgroup09@gmail.com
+*
+*  This file is part of the HMI server component.
+*
+*  The code in this page is free software: you can
+*  redistribute it and/or modify it under the terms of the GNU
+*  General Public License (GNU GPL) as published by the Free Software
+*  Foundation, either version 3 of the License, or (at your option)
+*  any later version.  The code is distributed WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS
+*  FOR A PARTICULAR PURPOSE.  See the GNU GPL for more details.
+*
+*  As additional permission under GNU GPL version 3 section 7, you
+*  may distribute non-source (e.g., minimized or compacted) forms of
+*  that code without the copy of the GNU GPL normally required by
+*  section 4, provided you include this license notice and a URL
+*  through which recipients can access the Corresponding Source.
+*/
+
+#ifndef TREND_H
+#define TREND_H
+
+#include <QVector>
+
+
+/**
+@brief Fixed-size ring buffer of trend of one register.
+@details Keeps the last Depth raw values (quint16) with time stamps packed as quint32 offsets (msec)
+         from a base stamp: 6 bytes per sample, the memory is allocated once by init().
+         Every Decim-th pushed sample is kept.
+*/
+class Trend
+{
+public:
+
+    /**
+    @brief  Constructor.
+    @param  None.
+    @return None.
+    */
+    Trend();
+
+
+    /**
+    Public constants
+    */
+
+    /**
+    @brief Limites
+    */
+    static const quint32 DEPTH_OFF = 0;
+    static const quint32 DEPTH_MAX = 86400;
+    static const quint16 DECIM_MIN = 1;
+
+
+    /**
+    Public methods
+    */
+
+    /**
+    @brief  Allocate the buffer.
+    @param  DepthIn - the number of samples (0 - trend is off);
+    @param  DecimIn - decimation (every Decim-th sample is kept).
+    @return None.
+    */
+    void init(const quint32 DepthIn, const quint16 DecimIn);
+
+    /**
+    @brief  Clear the buffer (the memory is kept).
+    @param  None.
+    @return None.
+    */
+    void clear();
+
+    /**
+    @brief  Check the trend is on.
+    @param  None.
+    @return True if the buffer is allocated, otherwise - False.
+    */
+    bool isEnabled() const;
+
+    /**
+    @brief  Push a sample.
+    @param  StampIn - date and time (msec since epoch);
+    @param  RawValueIn - raw-value.
+    @return None.
+    @details The oldest sample is overwritten when the buffer is full.
+    */
+    void push(const qint64 StampIn, const quint16 RawValueIn);
+
+    /**
+    @brief  Get the number of samples.
+    @param  None.
+    @return The number of samples.
+    */
+    int size() const;
+
+    /**
+    @brief  Get date and time of a sample.
+    @param  IdxIn - index of sample (0 - the oldest).
+    @return Date and time (msec since epoch).
+    */
+    qint64 stampAt(const int IdxIn) const;
+
+    /**
+    @brief  Get raw-value of a sample.
+    @param  IdxIn - index of sample (0 - the oldest).
+    @return Raw-value.
+    */
+    quint16 valueAt(const int IdxIn) const;
+
+    /**
+    @brief  Get the allocated memory.
+    @param  None.
+    @return The number of bytes.
+    */
+    qint64 memory() const;
+
+
+private:
+
+    /**
+    Private options
+    */
+
+    /**
+    @brief Raw-values.
+    */
+    QVector<quint16> mListValues;
+
+    /**
+    @brief Time stamps (msec from mBase).
+    */
+    QVector<quint32> mListStamps;
+
+    /**
+    @brief Base of time stamps (msec since epoch).
+    */
+    qint64 mBase;
+
+    /**
+    @brief Index of the oldest sample.
+    */
+    int mHead;
+
+    /**
+    @brief The number of samples.
+    */
+    int mSize;
+
+    /**
+    @brief Decimation.
+    */
+    quint16 mDecim;
+
+    /**
+    @brief Counter of pushed samples for decimation.
+    */
+    quint16 mTick;
+
+
+    /**
+    Private methods
+    */
+
+    /**
+    @brief  Move the base of time stamps to the oldest sample.
+    @param  StampIn - date and time of the new sample (msec since epoch).
+    @return True if the new sample fits the offsets, otherwise - False.
+    */
+    bool rebase(const qint64 StampIn);
+};
+
+#endif // TREND_H